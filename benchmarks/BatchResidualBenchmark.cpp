@@ -0,0 +1,105 @@
+/**
+ * @file BatchResidualBenchmark.cpp
+ * @brief 批量残留扫描基准：30个程序逐个遍历与合并自动机一次遍历的耗时和访问的条目数
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_batch_residual [程序数，默认30] [条目数，默认200000]
+ * 条目是内存中的名称列表，访问次数即真实扫描中枚举目录项、注册表子键的次数。
+ */
+
+#include "BenchCommon.h"
+#include "services/ResidualMatcher.h"
+
+using namespace YG;
+
+namespace {
+    
+    String MakeWord(BenchRandom& random, size_t length) {
+        String word;
+        for (size_t i = 0; i < length; ++i) {
+            word += static_cast<wchar_t>(L'a' + random.Below(26));
+        }
+        return word;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t programCount = BenchArg(argc, argv, 1, 30);
+    size_t entryCount = BenchArg(argc, argv, 2, 200000);
+    
+    BenchRandom random(7);
+    std::vector<ProgramInfo> programs(programCount);
+    for (auto& program : programs) {
+        program.displayName = MakeWord(random, 5) + L" " + MakeWord(random, 6);
+        program.publisher = MakeWord(random, 8) + L" Inc";
+        program.installLocation = L"C:\\Program Files\\" + MakeWord(random, 7);
+        program.uninstallString = L"C:\\Program Files\\Uninstall\\" + MakeWord(random, 6) + L".exe";
+    }
+    
+    // 约2%的条目带某个程序的名称
+    std::vector<String> entries(entryCount);
+    for (auto& entry : entries) {
+        entry = MakeWord(random, 4 + random.Below(12));
+        if (programCount > 0 && random.Below(50) == 0) {
+            entry += programs[random.Below(static_cast<std::uint32_t>(programCount))].displayName;
+        }
+    }
+    
+    std::vector<ResidualMatcher> single(programCount);
+    for (size_t i = 0; i < programCount; ++i) {
+        single[i].AddProgram(programs[i], static_cast<std::uint32_t>(i));
+        single[i].Build();
+    }
+    ResidualMatcher combined;
+    double buildMs = MeasureMs([&]() {
+        for (size_t i = 0; i < programCount; ++i) {
+            combined.AddProgram(programs[i], static_cast<std::uint32_t>(i));
+        }
+        combined.Build();
+    });
+    std::printf("%zu programs, %zu patterns, combined build %.2f ms\n",
+                programCount, combined.GetPatterns().size(), buildMs);
+    
+    // 逐个程序扫描：每个程序把全部条目遍历一遍
+    std::vector<size_t> perProgramHits(programCount);
+    size_t perProgramVisits = 0;
+    double perProgramMs = MeasureMs([&]() {
+        for (size_t i = 0; i < programCount; ++i) {
+            for (const String& entry : entries) {
+                ++perProgramVisits;
+                ResidualMatch match;
+                if (single[i].FindBest(entry, match)) {
+                    perProgramHits[i]++;
+                }
+            }
+        }
+    });
+    
+    // 批量扫描：全部条目遍历一遍，命中归属到模式所属的程序
+    std::vector<size_t> combinedHits(programCount);
+    size_t combinedVisits = 0;
+    double combinedMs = MeasureMs([&]() {
+        for (const String& entry : entries) {
+            ++combinedVisits;
+            ResidualMatch match;
+            if (combined.FindBest(entry, match)) {
+                combinedHits[match.owner]++;
+            }
+        }
+    });
+    
+    // 条目只属于一个程序时，两种方式归属到各程序的命中数相同
+    BenchCheck(perProgramHits == combinedHits, "combined pass attributes hits differently from per-program passes");
+    
+    size_t totalHits = 0;
+    for (size_t hits : combinedHits) {
+        totalHits += hits;
+    }
+    std::printf("per program: %8.1f ms, %zu entries visited\n", perProgramMs, perProgramVisits);
+    std::printf("combined:    %8.1f ms, %zu entries visited, %zu hits attributed to the same programs\n",
+                combinedMs, combinedVisits, totalHits);
+    return 0;
+}
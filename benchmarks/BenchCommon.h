@@ -0,0 +1,89 @@
+/**
+ * @file BenchCommon.h
+ * @brief 基准测试公共工具（计时、可复现的随机数、结果校验）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+
+namespace YG {
+    
+    /**
+     * @brief 可复现的伪随机数（线性同余），同一种子在各平台上生成相同的数据
+     */
+    class BenchRandom {
+    public:
+        explicit BenchRandom(std::uint32_t seed = 1) : m_state(seed) {}
+        
+        std::uint32_t Next() {
+            m_state = m_state * 1103515245u + 12345u;
+            return m_state >> 8;
+        }
+        
+        std::uint32_t Below(std::uint32_t bound) {
+            return bound ? Next() % bound : 0;
+        }
+    
+    private:
+        std::uint32_t m_state;      ///< 当前状态
+    };
+    
+    /**
+     * @brief 执行一次并返回耗时(毫秒)
+     */
+    template<typename Func>
+    double MeasureMs(Func&& func) {
+        auto start = std::chrono::steady_clock::now();
+        std::forward<Func>(func)();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+    /**
+     * @brief 执行runs次，返回最短耗时(毫秒)
+     */
+    template<typename Func>
+    double BestOfMs(int runs, Func&& func) {
+        double best = -1.0;
+        for (int i = 0; i < runs; ++i) {
+            double elapsed = MeasureMs(func);
+            if (best < 0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        return best;
+    }
+    
+    /**
+     * @brief 校验结果，失败时输出原因并以1退出（Release下assert不生效）
+     */
+    inline void BenchCheck(bool condition, const char* what) {
+        if (!condition) {
+            std::fprintf(stderr, "FAILED: %s\n", what);
+            std::exit(1);
+        }
+    }
+    
+    /**
+     * @brief 读取第index个命令行参数作为非负整数，缺省或无效时返回defaultValue
+     */
+    inline size_t BenchArg(int argc, char** argv, int index, size_t defaultValue) {
+        if (index < argc) {
+            char* end = nullptr;
+            long long value = std::strtoll(argv[index], &end, 10);
+            if (end != argv[index] && *end == '\0' && value >= 0) {
+                return static_cast<size_t>(value);
+            }
+        }
+        return defaultValue;
+    }
+
+} // namespace YG
@@ -0,0 +1,117 @@
+/**
+ * @file DedupBenchmark.cpp
+ * @brief 程序列表去重基准：哈希去重与原逐对比较在10k/100k条目上的耗时
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_dedup [最大规模，默认100000]
+ */
+
+#include "BenchCommon.h"
+#include "services/ProgramDeduplicator.h"
+#include <algorithm>
+#include <cwctype>
+
+using namespace YG;
+
+namespace {
+    
+    const size_t s_pairwiseLimit = 10000;   // 逐对比较为O(n²)，只在不超过该规模时运行
+    
+    String Fold(String text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](wchar_t ch) { return static_cast<wchar_t>(std::towlower(ch)); });
+        return text;
+    }
+    
+    String StripArchitecture(String name) {
+        static const wchar_t* suffixes[] = { L" (x64)", L" (x86)", L" (64-bit)", L" (32-bit)",
+                                             L" x64", L" x86", L" 64-bit", L" 32-bit" };
+        for (const wchar_t* suffix : suffixes) {
+            size_t pos = name.find(suffix);
+            if (pos != String::npos) {
+                name = name.substr(0, pos);
+            }
+        }
+        return name;
+    }
+    
+    // 原MainWindow::RemoveDuplicatePrograms的判断：每次比较都重新转换两边的名称
+    bool IsSameProgram(const ProgramInfo& a, const ProgramInfo& b) {
+        String nameA = Fold(!a.displayName.empty() ? a.displayName : a.name);
+        String nameB = Fold(!b.displayName.empty() ? b.displayName : b.name);
+        if (nameA == nameB && a.version == b.version && a.publisher == b.publisher) {
+            return true;
+        }
+        if (StripArchitecture(nameA) == StripArchitecture(nameB) &&
+            a.publisher == b.publisher && a.version == b.version) {
+            return true;
+        }
+        return !a.installLocation.empty() && !b.installLocation.empty() &&
+               Fold(a.installLocation) == Fold(b.installLocation);
+    }
+    
+    std::vector<size_t> PairwiseUniqueIndices(const std::vector<ProgramInfo>& programs) {
+        std::vector<size_t> kept;
+        for (size_t i = 0; i < programs.size(); ++i) {
+            bool duplicate = false;
+            for (size_t keptIndex : kept) {
+                if (IsSameProgram(programs[i], programs[keptIndex])) {
+                    duplicate = true;
+                    break;
+                }
+            }
+            if (!duplicate) {
+                kept.push_back(i);
+            }
+        }
+        return kept;
+    }
+    
+    // 约一半为重复项：名称大小写、架构后缀不同，三分之一带安装路径
+    std::vector<ProgramInfo> MakeInventory(size_t count, std::uint32_t distinct, std::uint32_t seed) {
+        static const wchar_t* architectures[] = { L"", L" (x64)", L" x86", L" 64-bit" };
+        BenchRandom random(seed);
+        std::vector<ProgramInfo> programs(count);
+        for (auto& program : programs) {
+            std::uint32_t key = random.Below(distinct);
+            program.displayName = (random.Below(2) ? L"App " : L"APP ") + std::to_wstring(key) + architectures[random.Below(4)];
+            program.publisher = L"Publisher " + std::to_wstring(key % 7);
+            program.version = L"1." + std::to_wstring(random.Below(3));
+            if (random.Below(3) == 0) {
+                program.installLocation = L"C:\\Program Files\\P" + std::to_wstring(random.Below(distinct));
+            }
+        }
+        return programs;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxCount = BenchArg(argc, argv, 1, 100000);
+    
+    // 与逐对比较的结果一致
+    for (std::uint32_t round = 0; round < 20; ++round) {
+        std::vector<ProgramInfo> programs = MakeInventory(2000, 300 + round * 50, round + 1);
+        BenchCheck(ProgramDeduplicator::FindUniqueIndices(programs) == PairwiseUniqueIndices(programs),
+                   "hash deduplication differs from the pairwise reference");
+    }
+    std::printf("equivalent to the pairwise reference on 20 randomised 2000-entry inventories\n");
+    
+    for (size_t count = 10000; count <= maxCount; count *= 10) {
+        std::vector<ProgramInfo> programs = MakeInventory(count, static_cast<std::uint32_t>(count / 2), 1);
+        
+        DeduplicationStats stats;
+        double hashMs = BestOfMs(3, [&]() { ProgramDeduplicator::RemoveDuplicates(programs, &stats); });
+        std::printf("%7zu entries: hash %8.1f ms (kept %zu, name %zu, path %zu)",
+                    count, hashMs, stats.keptCount, stats.nameDuplicates, stats.pathDuplicates);
+        
+        if (count <= s_pairwiseLimit) {
+            double pairwiseMs = MeasureMs([&]() { PairwiseUniqueIndices(programs); });
+            std::printf(", pairwise %10.1f ms", pairwiseMs);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
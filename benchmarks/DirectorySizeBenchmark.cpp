@@ -0,0 +1,49 @@
+/**
+ * @file DirectorySizeBenchmark.cpp
+ * @brief 目录大小统计基准：冷缓存（单线程/多线程）与热缓存的耗时
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_directory_size [第一层目录数，默认40] [每次元数据访问延迟微秒，默认50]
+ * 目录树为root\\D<i>\\S<j>，每个第一层目录10个子目录，每个子目录30个文件。
+ */
+
+#include "BenchCommon.h"
+#include "FileSystemFixture.h"
+#include "utils/DirectorySizeEngine.h"
+
+using namespace YG;
+
+int main(int argc, char** argv) {
+    size_t topDirs = BenchArg(argc, argv, 1, 40);
+    unsigned latencyUs = static_cast<unsigned>(BenchArg(argc, argv, 2, 50));
+    
+    const String root = L"C:\\Program Files\\YGBench";
+    auto memory = std::make_shared<MemoryFileSystemSource>();
+    DWORD64 expectedBytes = FileSystemFixture::BuildInstallTree(*memory, root, topDirs, 10, 30);
+    DWORD64 expectedDirectories = 1 + topDirs + topDirs * 10;
+    std::printf("synthetic tree: %llu directories, %llu files, %llu bytes\n",
+                static_cast<unsigned long long>(expectedDirectories),
+                static_cast<unsigned long long>(topDirs * 10 * 30), static_cast<unsigned long long>(expectedBytes));
+    
+    auto source = std::make_shared<LatencyFileSystemSource>(memory, latencyUs);
+    for (size_t threads : { static_cast<size_t>(1), static_cast<size_t>(8) }) {
+        DirectorySizeEngine engine(source, threads);
+        
+        DirectorySizeResult cold;
+        double coldMs = MeasureMs([&]() { engine.Calculate(root, cold); });
+        BenchCheck(cold.totalBytes == expectedBytes && cold.directoryCount == expectedDirectories,
+                   "cold traversal total differs from the generated tree");
+        
+        DirectorySizeResult warm;
+        double warmMs = MeasureMs([&]() { engine.Calculate(root, warm); });
+        BenchCheck(warm.totalBytes == expectedBytes && warm.cacheHits == expectedDirectories,
+                   "warm traversal did not reuse every cached directory");
+        
+        std::printf("latency %u us, %zu thread(s): cold %8.1f ms, warm %8.1f ms (%llu/%llu cache hits)\n",
+                    latencyUs, threads, coldMs, warmMs, static_cast<unsigned long long>(warm.cacheHits),
+                    static_cast<unsigned long long>(expectedDirectories));
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file FileSystemFixture.cpp
+ * @brief 基准测试用的合成目录树与延迟数据源实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "FileSystemFixture.h"
+#include <chrono>
+#include <thread>
+
+namespace YG {
+    
+    LatencyFileSystemSource::LatencyFileSystemSource(std::shared_ptr<IFileSystemSource> inner, unsigned latencyUs)
+        : m_inner(std::move(inner)), m_latencyUs(latencyUs), m_callCount(0) {
+    }
+    
+    void LatencyFileSystemSource::Delay() {
+        m_callCount++;
+        if (m_latencyUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(m_latencyUs));
+        }
+    }
+    
+    DWORD LatencyFileSystemSource::GetEntry(const String& path, FileSystemEntry& entry) {
+        Delay();
+        return m_inner->GetEntry(path, entry);
+    }
+    
+    DWORD LatencyFileSystemSource::ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) {
+        Delay();
+        return m_inner->ListDirectory(directoryPath, entries);
+    }
+    
+    DWORD LatencyFileSystemSource::SetAttributes(const String& path, DWORD attributes) {
+        Delay();
+        return m_inner->SetAttributes(path, attributes);
+    }
+    
+    DWORD LatencyFileSystemSource::RemoveEntry(const String& path, bool directory) {
+        Delay();
+        return m_inner->RemoveEntry(path, directory);
+    }
+    
+    DWORD LatencyFileSystemSource::MoveEntry(const String& fromPath, const String& toPath) {
+        Delay();
+        return m_inner->MoveEntry(fromPath, toPath);
+    }
+    
+    DWORD LatencyFileSystemSource::MakeDirectory(const String& path) {
+        m_callCount++;
+        return m_inner->MakeDirectory(path);
+    }
+    
+    DWORD LatencyFileSystemSource::ReadFileData(const String& path, std::vector<BYTE>& data) {
+        m_callCount++;
+        return m_inner->ReadFileData(path, data);
+    }
+    
+    DWORD LatencyFileSystemSource::WriteFileData(const String& path, const std::vector<BYTE>& data) {
+        m_callCount++;
+        return m_inner->WriteFileData(path, data);
+    }
+    
+    DWORD64 FileSystemFixture::BuildInstallTree(MemoryFileSystemSource& fileSystem, const String& root,
+                                                size_t topDirs, size_t subDirs, size_t filesPerDir) {
+        fileSystem.AddDirectory(root);
+        
+        DWORD64 totalBytes = 0;
+        for (size_t top = 0; top < topDirs; ++top) {
+            String topPath = root + L"\\D" + std::to_wstring(top);
+            fileSystem.AddDirectory(topPath);
+            
+            for (size_t sub = 0; sub < subDirs; ++sub) {
+                String subPath = topPath + L"\\S" + std::to_wstring(sub);
+                fileSystem.AddDirectory(subPath);
+                
+                for (size_t file = 0; file < filesPerDir; ++file) {
+                    DWORD64 size = (top * 131 + sub * 17 + file * 7) % 4096 + 1;
+                    fileSystem.AddFile(subPath + L"\\f" + std::to_wstring(file) + L".dll", size);
+                    totalBytes += size;
+                }
+            }
+        }
+        return totalBytes;
+    }
+
+} // namespace YG
@@ -0,0 +1,80 @@
+/**
+ * @file FileSystemFixture.h
+ * @brief 基准测试用的合成目录树（MemoryFileSystemSource夹具）与延迟数据源
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "utils/FileSystemSource.h"
+#include <memory>
+#include <atomic>
+
+namespace YG {
+    
+    /**
+     * @brief 每次访问磁盘元数据前等待固定时间的文件系统数据源
+     *
+     * 包装另一个数据源，GetEntry、ListDirectory、SetAttributes和RemoveEntry各等待一次，
+     * 模拟真实文件系统的系统调用开销；单核环境下也能体现并行遍历、并行删除的收益。
+     * 另外统计经过的全部操作数，用于比较与耗时无关的调用次数。
+     */
+    class LatencyFileSystemSource : public IFileSystemSource {
+    public:
+        /**
+         * @brief 构造函数
+         * @param inner 实际的数据源
+         * @param latencyUs 每次操作的延迟(微秒)
+         */
+        LatencyFileSystemSource(std::shared_ptr<IFileSystemSource> inner, unsigned latencyUs);
+        
+        DWORD GetEntry(const String& path, FileSystemEntry& entry) override;
+        DWORD ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) override;
+        DWORD SetAttributes(const String& path, DWORD attributes) override;
+        DWORD RemoveEntry(const String& path, bool directory) override;
+        DWORD MoveEntry(const String& fromPath, const String& toPath) override;
+        DWORD MakeDirectory(const String& path) override;
+        DWORD ReadFileData(const String& path, std::vector<BYTE>& data) override;
+        DWORD WriteFileData(const String& path, const std::vector<BYTE>& data) override;
+    
+        /**
+         * @brief 经过的操作数（含不等待的操作）
+         */
+        size_t GetCallCount() const { return m_callCount.load(); }
+    
+    private:
+        /**
+         * @brief 计数并等待一次延迟
+         */
+        void Delay();
+        
+        std::shared_ptr<IFileSystemSource> m_inner;     ///< 实际的数据源
+        unsigned m_latencyUs;                           ///< 每次操作的延迟(微秒)
+        std::atomic<size_t> m_callCount;                ///< 经过的操作数
+    };
+    
+    /**
+     * @brief 合成目录树夹具
+     */
+    class FileSystemFixture {
+    public:
+        /**
+         * @brief 生成两层的安装目录：root\\D<i>\\S<j>\\f<k>.dll
+         *
+         * 共1 + topDirs + topDirs × subDirs个目录，每个叶子目录filesPerDir个文件，
+         * 文件大小由位置决定（1~4096字节），结果可复现。
+         * @param fileSystem 内存文件系统
+         * @param root 根目录
+         * @param topDirs 第一层目录数
+         * @param subDirs 每个第一层目录下的子目录数
+         * @param filesPerDir 每个叶子目录的文件数
+         * @return DWORD64 全部文件的字节数
+         */
+        static DWORD64 BuildInstallTree(MemoryFileSystemSource& fileSystem, const String& root,
+                                        size_t topDirs, size_t subDirs, size_t filesPerDir);
+    };
+
+} // namespace YG
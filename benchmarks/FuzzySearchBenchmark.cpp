@@ -0,0 +1,96 @@
+/**
+ * @file FuzzySearchBenchmark.cpp
+ * @brief 模糊搜索基准：字符掩码预筛后评分的耗时，结果与逐行完整评分比对
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_fuzzy_search [条目数，默认50000]
+ */
+
+#include "BenchCommon.h"
+#include "ProgramFixture.h"
+#include "services/ProgramSearchIndex.h"
+#include "services/FuzzyMatcher.h"
+#include <algorithm>
+
+using namespace YG;
+
+namespace {
+    
+    const size_t s_maxResults = 500;
+    const int s_publisherPenalty = 16;      // 与ProgramSearchIndex中发布者匹配的扣分一致
+    
+    int ScoreText(const FuzzyMatcher& matcher, const String& text) {
+        std::vector<std::uint8_t> classes(text.size());
+        FuzzyMatcher::ClassifyCharacters(text.c_str(), text.size(), classes.data());
+        return matcher.Score(ProgramSearchIndex::Fold(text), classes.data());
+    }
+    
+    // 不预筛、不复用索引：每行现转小写、现标注字符类别后评分
+    FuzzySearchResult FullScan(const ProgramTable& table, const ProgramSearchIndex& index, const String& keyword) {
+        FuzzySearchResult result;
+        FuzzyMatcher matcher(keyword);
+        for (std::uint32_t row = 0; row < index.GetRowCount(); ++row) {
+            ProgramId id = index.GetId(row);
+            int score = ScoreText(matcher, table.GetTitle(id));
+            int publisherScore = ScoreText(matcher, table.GetPublisher(id));
+            if (publisherScore != FuzzyMatcher::NoMatch) {
+                score = (std::max)(score, publisherScore - s_publisherPenalty);
+            }
+            if (score != FuzzyMatcher::NoMatch) {
+                result.matches.push_back({ row, score });
+            }
+        }
+        result.totalMatches = result.matches.size();
+        result.candidateCount = index.GetRowCount();
+        
+        std::stable_sort(result.matches.begin(), result.matches.end(),
+                         [&index](const FuzzySearchMatch& a, const FuzzySearchMatch& b) {
+            if (a.score != b.score) {
+                return a.score > b.score;
+            }
+            return index.GetFoldedTitle(a.row).size() < index.GetFoldedTitle(b.row).size();
+        });
+        result.matches.resize((std::min)(s_maxResults, result.matches.size()));
+        return result;
+    }
+    
+    bool SameMatches(const FuzzySearchResult& a, const FuzzySearchResult& b) {
+        if (a.totalMatches != b.totalMatches || a.matches.size() != b.matches.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.matches.size(); ++i) {
+            if (a.matches[i].row != b.matches[i].row || a.matches[i].score != b.matches[i].score) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = BenchArg(argc, argv, 1, 50000);
+    
+    ProgramTablePtr table = ProgramTable::Build(ProgramFixture::MakeInventory(count));
+    ProgramSearchIndexPtr index = ProgramSearchIndex::Build(*table);
+    std::printf("%zu entries, top %zu results per query\n", count, s_maxResults);
+    
+    const wchar_t* queries[] = { L"vscode", L"vsc", L"vb", L"adobe", L"7z", L"npp", L"chrome", L"micro", L"m", L"xq" };
+    for (const wchar_t* query : queries) {
+        FuzzySearchResult result;
+        double indexMs = BestOfMs(5, [&]() { result = index->FuzzySearch(query, s_maxResults); });
+        FuzzySearchResult expected;
+        double scanMs = MeasureMs([&]() { expected = FullScan(*table, *index, query); });
+        BenchCheck(SameMatches(result, expected), "prefiltered fuzzy search differs from the full scan");
+        
+        std::printf("  %-8ls %6zu matches, %6zu scored: index %7.3f ms, full scan %7.2f ms",
+                    query, result.totalMatches, result.candidateCount, indexMs, scanMs);
+        if (!result.matches.empty()) {
+            std::printf("  best: %ls", table->GetTitle(index->GetId(result.matches[0].row)));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file ProgramFixture.cpp
+ * @brief 基准测试用的合成程序清单实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "ProgramFixture.h"
+#include "BenchCommon.h"
+
+namespace YG {
+    
+    namespace {
+        
+        const wchar_t* s_commonWords[] = {
+            L"Microsoft", L"Visual", L"Studio", L"Code", L"Adobe", L"Reader", L"Google", L"Chrome",
+            L"Runtime", L"Redistributable", L"Update", L"Driver", L"NVIDIA", L"Intel", L"Python",
+            L"Java", L"Tools", L"SDK", L"Office", L"Player"
+        };
+        
+        const wchar_t* s_publishers[] = {
+            L"Microsoft Corporation", L"Adobe Inc.", L"Google LLC", L"JetBrains", L"Mozilla",
+            L"NVIDIA Corporation", L"Intel Corporation", L"Oracle"
+        };
+        
+        struct KnownProgram {
+            const wchar_t* name;
+            const wchar_t* publisher;
+        };
+        
+        const KnownProgram s_knownPrograms[] = {
+            { L"Microsoft Visual Studio Code", L"Microsoft Corporation" },
+            { L"Microsoft Visual Studio Community 2022", L"Microsoft Corporation" },
+            { L"Microsoft Visual C++ 2015-2022 Redistributable (x64)", L"Microsoft Corporation" },
+            { L"VirtualBox", L"Oracle" },
+            { L"Adobe Acrobat Reader DC", L"Adobe Inc." },
+            { L"7-Zip 23.01 (x64)", L"Igor Pavlov" },
+            { L"Notepad++ (64-bit x64)", L"Notepad++ Team" },
+            { L"Google Chrome", L"Google LLC" }
+        };
+        
+        const size_t s_vocabularySize = 3000;
+        
+        template<typename T, size_t N>
+        const T& Pick(BenchRandom& random, const T (&items)[N]) {
+            return items[random.Below(static_cast<std::uint32_t>(N))];
+        }
+        
+        String MakeWord(BenchRandom& random) {
+            String word;
+            size_t length = 4 + random.Below(7);
+            for (size_t i = 0; i < length; ++i) {
+                word += static_cast<wchar_t>(L'a' + random.Below(26));
+            }
+            word[0] = static_cast<wchar_t>(word[0] - L'a' + L'A');
+            return word;
+        }
+        
+        String MakeDate(BenchRandom& random) {
+            std::uint32_t year = 2015 + random.Below(10);
+            std::uint32_t month = 1 + random.Below(12);
+            std::uint32_t day = 1 + random.Below(28);
+            if (random.Below(2)) {
+                return std::to_wstring(year) + L"-" + std::to_wstring(month) + L"-" + std::to_wstring(day);
+            }
+            return std::to_wstring(year * 10000 + month * 100 + day);
+        }
+    
+    } // namespace
+    
+    std::vector<ProgramInfo> ProgramFixture::MakeInventory(size_t count, std::uint32_t seed) {
+        BenchRandom random(seed);
+        std::vector<String> vocabulary;
+        vocabulary.reserve(s_vocabularySize);
+        for (size_t i = 0; i < s_vocabularySize; ++i) {
+            vocabulary.push_back(MakeWord(random));
+        }
+        
+        std::vector<ProgramInfo> programs(count);
+        for (size_t i = 0; i < count; ++i) {
+            ProgramInfo& program = programs[i];
+            if (i < sizeof(s_knownPrograms) / sizeof(s_knownPrograms[0])) {
+                program.displayName = s_knownPrograms[i].name;
+                program.publisher = s_knownPrograms[i].publisher;
+            } else {
+                program.displayName = String(Pick(random, s_commonWords)) + L" " +
+                                      vocabulary[random.Below(s_vocabularySize)] + L" " +
+                                      Pick(random, s_commonWords) + L" " + std::to_wstring(i);
+                if (random.Below(7) == 0) {
+                    program.displayName += L" Beta";
+                }
+                program.publisher = random.Below(4) ? String(Pick(random, s_publishers))
+                                                    : vocabulary[random.Below(300)];
+            }
+            
+            program.version = std::to_wstring(random.Below(20)) + L"." + std::to_wstring(random.Below(100));
+            if (random.Below(9) == 0) {
+                program.version += L"-beta";
+            }
+            program.estimatedSize = random.Below(10) ? static_cast<DWORD64>(random.Below(2000)) << 20 : 0;
+            if (random.Below(5)) {
+                program.installDate = MakeDate(random);
+            }
+            program.registryKey = L"HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall\\Bench" +
+                                  std::to_wstring(i);
+        }
+        return programs;
+    }
+
+} // namespace YG
@@ -0,0 +1,36 @@
+/**
+ * @file ProgramFixture.h
+ * @brief 基准测试用的合成程序清单
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 合成程序清单夹具
+     *
+     * 清单开头是几款常见软件（供模糊搜索的缩写查询命中），其余条目由常见单词和
+     * 随机生成的单词组成名称，发布者、版本（部分带-beta）、大小（约一成为0）和
+     * 安装日期（约两成缺失，混用多种日期格式）按固定种子生成，结果可复现。
+     * 每个条目的注册表键互不相同，可直接用于ProgramTable::Build。
+     */
+    class ProgramFixture {
+    public:
+        /**
+         * @brief 生成程序清单
+         * @param count 条目数
+         * @param seed 随机种子
+         * @return std::vector<ProgramInfo> 程序清单
+         */
+        static std::vector<ProgramInfo> MakeInventory(size_t count, std::uint32_t seed = 7);
+    };
+
+} // namespace YG
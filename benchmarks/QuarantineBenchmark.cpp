@@ -0,0 +1,86 @@
+/**
+ * @file QuarantineBenchmark.cpp
+ * @brief 隔离区基准：同卷改名隔离、恢复与直接删除在不同目录树规模下的耗时
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_quarantine [每次文件系统操作延迟微秒，默认50]
+ * 每个卷一棵目录树（20或40个目录，每个目录250个文件）。隔离、恢复只改名顶层目录，
+ * 文件系统调用次数与树的大小无关；内存文件系统的改名要逐个改写子项路径，
+ * 因此延迟为0时测得的耗时仍随树增长，真实卷上的同卷改名没有这部分开销。
+ */
+
+#include "BenchCommon.h"
+#include "FileSystemFixture.h"
+#include "services/QuarantineStore.h"
+#include "services/ResidualDeleter.h"
+
+using namespace YG;
+
+namespace {
+    
+    const String s_journalDirectory = L"C:\\Users\\Bench\\AppData\\Roaming\\YGUninstaller\\Quarantine";
+    const String s_roots[] = { L"C:\\Program Files\\App", L"D:\\Data\\App" };
+    
+    std::shared_ptr<MemoryFileSystemSource> MakeVolumes(size_t directories, std::vector<ResidualItem>& items) {
+        auto memory = std::make_shared<MemoryFileSystemSource>();
+        memory->AddDirectory(L"C:\\Users\\Bench\\AppData\\Roaming");
+        items.clear();
+        for (const String& root : s_roots) {
+            FileSystemFixture::BuildInstallTree(*memory, root, directories, 1, 250);
+            items.emplace_back(root, L"App", ResidualType::Directory);
+        }
+        return memory;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned latencyUs = static_cast<unsigned>(BenchArg(argc, argv, 1, 50));
+    size_t firstQuarantineCalls = 0;
+    
+    for (size_t directories : { static_cast<size_t>(20), static_cast<size_t>(40) }) {
+        const size_t fileCount = 2 * directories * 250;
+        std::vector<ResidualItem> items;
+        FileSystemEntry entry;
+        
+        // 直接删除（每卷默认线程数）
+        auto deleteMemory = MakeVolumes(directories, items);
+        auto deleteSource = std::make_shared<LatencyFileSystemSource>(deleteMemory, latencyUs);
+        ResidualDeleter deleter(deleteSource);
+        ResidualDeleteResult deleteResult;
+        double deleteMs = MeasureMs([&]() { deleter.Delete(items, nullptr, deleteResult); });
+        BenchCheck(deleteResult.deletedFiles == fileCount, "delete did not remove every generated file");
+        
+        // 隔离后恢复
+        auto quarantineMemory = MakeVolumes(directories, items);
+        auto quarantineSource = std::make_shared<LatencyFileSystemSource>(quarantineMemory, latencyUs);
+        QuarantineStore store(s_journalDirectory, quarantineSource);
+        QuarantineBatch batch;
+        ErrorCode error = ErrorCode::Success;
+        double quarantineMs = MeasureMs([&]() { error = store.Quarantine(items, L"App", nullptr, batch); });
+        BenchCheck(error == ErrorCode::Success && batch.entries.size() == items.size() &&
+                   quarantineMemory->GetEntry(s_roots[0], entry) != ERROR_SUCCESS,
+                   "quarantine did not move every item");
+        size_t quarantineCalls = quarantineSource->GetCallCount();
+        if (firstQuarantineCalls == 0) {
+            firstQuarantineCalls = quarantineCalls;
+        }
+        BenchCheck(quarantineCalls == firstQuarantineCalls, "quarantine file system calls grew with the tree size");
+        
+        size_t restoredCount = 0;
+        double restoreMs = MeasureMs([&]() { error = store.Restore(batch.id, restoredCount); });
+        BenchCheck(error == ErrorCode::Success && restoredCount == items.size() &&
+                   quarantineMemory->GetEntry(s_roots[1] + L"\\D0\\S0\\f0.dll", entry) == ERROR_SUCCESS,
+                   "restore did not bring every item back");
+        
+        size_t restoreCalls = quarantineSource->GetCallCount() - quarantineCalls;
+        
+        std::printf("%5zu files, latency %u us: delete %8.1f ms (%6zu calls), quarantine %6.2f ms (%zu calls), "
+                    "restore %6.2f ms (%zu calls)\n",
+                    fileCount, latencyUs, deleteMs, deleteSource->GetCallCount(), quarantineMs, quarantineCalls,
+                    restoreMs, restoreCalls);
+    }
+    return 0;
+}
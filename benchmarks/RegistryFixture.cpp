@@ -0,0 +1,115 @@
+/**
+ * @file RegistryFixture.cpp
+ * @brief 基准测试用的合成注册表与延迟数据源实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "RegistryFixture.h"
+#include <chrono>
+#include <thread>
+
+namespace YG {
+    
+    LatencyRegistrySource::LatencyRegistrySource(std::shared_ptr<IRegistrySource> inner, unsigned openLatencyUs)
+        : m_inner(std::move(inner)), m_openLatencyUs(openLatencyUs) {
+    }
+    
+    LONG LatencyRegistrySource::OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) {
+        if (m_openLatencyUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(m_openLatencyUs));
+        }
+        return m_inner->OpenKey(hKeyParent, subKey, samDesired, hKey);
+    }
+    
+    LONG LatencyRegistrySource::CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) {
+        return m_inner->CreateKey(hKeyParent, subKey, hKey, created);
+    }
+    
+    LONG LatencyRegistrySource::CloseKey(HKEY hKey) {
+        return m_inner->CloseKey(hKey);
+    }
+    
+    LONG LatencyRegistrySource::EnumKey(HKEY hKey, DWORD index, String& name) {
+        return m_inner->EnumKey(hKey, index, name);
+    }
+    
+    LONG LatencyRegistrySource::EnumValue(HKEY hKey, DWORD index, String& name,
+                                          DWORD* type, std::vector<BYTE>* data) {
+        return m_inner->EnumValue(hKey, index, name, type, data);
+    }
+    
+    LONG LatencyRegistrySource::EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor) {
+        return m_inner->EnumValues(hKey, withData, visitor);
+    }
+    
+    LONG LatencyRegistrySource::QueryValue(HKEY hKey, const String& valueName,
+                                           DWORD* type, std::vector<BYTE>* data) {
+        return m_inner->QueryValue(hKey, valueName, type, data);
+    }
+    
+    LONG LatencyRegistrySource::SetValue(HKEY hKey, const String& valueName, DWORD type,
+                                         const BYTE* data, DWORD dataSize) {
+        return m_inner->SetValue(hKey, valueName, type, data, dataSize);
+    }
+    
+    LONG LatencyRegistrySource::QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                                             FILETIME* lastWriteTime) {
+        return m_inner->QueryInfoKey(hKey, subKeyCount, valueCount, lastWriteTime);
+    }
+    
+    LONG LatencyRegistrySource::DeleteKey(HKEY hKeyParent, const String& subKey) {
+        return m_inner->DeleteKey(hKeyParent, subKey);
+    }
+    
+    LONG LatencyRegistrySource::DeleteValue(HKEY hKey, const String& valueName) {
+        return m_inner->DeleteValue(hKey, valueName);
+    }
+    
+    size_t RegistryFixture::BuildSearchHive(MemoryRegistrySource& registry, const String& subKey, size_t fanout) {
+        HKEY root = nullptr;
+        if (registry.CreateKey(HKEY_LOCAL_MACHINE, subKey, root, nullptr) != ERROR_SUCCESS) {
+            return 0;
+        }
+        
+        size_t keyCount = 0;
+        for (size_t vendor = 0; vendor < fanout; ++vendor) {
+            HKEY vendorKey = nullptr;
+            registry.CreateKey(root, L"Vendor" + std::to_wstring(vendor), vendorKey, nullptr);
+            ++keyCount;
+            
+            for (size_t product = 0; product < fanout; ++product) {
+                HKEY productKey = nullptr;
+                registry.CreateKey(vendorKey, L"Product" + std::to_wstring(product), productKey, nullptr);
+                ++keyCount;
+                
+                for (size_t item = 0; item < fanout; ++item) {
+                    bool isTarget = (vendor == 7 && product == 7 && item == 7);
+                    HKEY itemKey = nullptr;
+                    registry.CreateKey(productKey, isTarget ? String(L"TargetApp") : L"Item" + std::to_wstring(item),
+                                       itemKey, nullptr);
+                    ++keyCount;
+                    
+                    SetString(registry, itemKey, L"Path", item + 1 == fanout ?
+                              L"C:\\Program Files\\targetapp\\app.exe" : L"C:\\Other\\shared.dll");
+                    registry.CloseKey(itemKey);
+                }
+                registry.CloseKey(productKey);
+            }
+            registry.CloseKey(vendorKey);
+        }
+        registry.CloseKey(root);
+        return keyCount;
+    }
+    
+    void RegistryFixture::SetString(IRegistrySource& registry, HKEY hKey, const String& name, const String& value) {
+        registry.SetValue(hKey, name, REG_SZ, reinterpret_cast<const BYTE*>(value.c_str()),
+                          static_cast<DWORD>((value.size() + 1) * sizeof(wchar_t)));
+    }
+    
+    void RegistryFixture::SetDword(IRegistrySource& registry, HKEY hKey, const String& name, DWORD value) {
+        registry.SetValue(hKey, name, REG_DWORD, reinterpret_cast<const BYTE*>(&value), sizeof(DWORD));
+    }
+
+} // namespace YG
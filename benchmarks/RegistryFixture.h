@@ -0,0 +1,81 @@
+/**
+ * @file RegistryFixture.h
+ * @brief 基准测试用的合成注册表（MemoryRegistrySource夹具）与延迟数据源
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "utils/RegistrySource.h"
+#include <memory>
+
+namespace YG {
+    
+    /**
+     * @brief 每次打开键前等待固定时间的注册表数据源
+     *
+     * 包装另一个数据源，模拟真实注册表打开键的系统调用开销；单核环境下也能体现并行遍历的收益。
+     */
+    class LatencyRegistrySource : public IRegistrySource {
+    public:
+        /**
+         * @brief 构造函数
+         * @param inner 实际的数据源
+         * @param openLatencyUs 每次OpenKey的延迟(微秒)
+         */
+        LatencyRegistrySource(std::shared_ptr<IRegistrySource> inner, unsigned openLatencyUs);
+        
+        LONG OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) override;
+        LONG CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) override;
+        LONG CloseKey(HKEY hKey) override;
+        LONG EnumKey(HKEY hKey, DWORD index, String& name) override;
+        LONG EnumValue(HKEY hKey, DWORD index, String& name,
+                       DWORD* type, std::vector<BYTE>* data) override;
+        LONG EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor) override;
+        LONG QueryValue(HKEY hKey, const String& valueName,
+                        DWORD* type, std::vector<BYTE>* data) override;
+        LONG SetValue(HKEY hKey, const String& valueName, DWORD type,
+                      const BYTE* data, DWORD dataSize) override;
+        LONG QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                          FILETIME* lastWriteTime) override;
+        LONG DeleteKey(HKEY hKeyParent, const String& subKey) override;
+        LONG DeleteValue(HKEY hKey, const String& valueName) override;
+    
+    private:
+        std::shared_ptr<IRegistrySource> m_inner;   ///< 实际的数据源
+        unsigned m_openLatencyUs;                   ///< 打开键的延迟(微秒)
+    };
+    
+    /**
+     * @brief 合成注册表夹具
+     */
+    class RegistryFixture {
+    public:
+        /**
+         * @brief 在HKLM\\subKey下生成三层的搜索用注册表
+         *
+         * 结构为Vendor<i>\\Product<j>\\Item<k>（每层fanout个），共fanout³+fanout²+fanout个键，
+         * 每个叶子键一个REG_SZ值"Path"。命中"targetapp"的有：键Vendor7\\Product7\\TargetApp（fanout>7时），
+         * 以及每个Product下最后一个叶子键的Path值数据，共fanout²个。
+         * @param registry 内存注册表
+         * @param subKey HKLM下的起始键
+         * @param fanout 每层的子键数
+         * @return size_t 生成的键数（不含起始键）
+         */
+        static size_t BuildSearchHive(MemoryRegistrySource& registry, const String& subKey, size_t fanout);
+        
+        /**
+         * @brief 写入字符串值
+         */
+        static void SetString(IRegistrySource& registry, HKEY hKey, const String& name, const String& value);
+        
+        /**
+         * @brief 写入DWORD值
+         */
+        static void SetDword(IRegistrySource& registry, HKEY hKey, const String& name, DWORD value);
+    };
+
+} // namespace YG
@@ -0,0 +1,83 @@
+/**
+ * @file RegistrySearchBenchmark.cpp
+ * @brief 注册表子树搜索基准：合成的1M键注册表上单线程与并行遍历的吞吐量
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_registry_search [每层子键数，默认100] [打开键延迟微秒，默认20]
+ * 默认规模为100x100x100（1,010,100个键）；延迟为0时只测无延迟的情况。
+ */
+
+#include "BenchCommon.h"
+#include "RegistryFixture.h"
+#include "services/ResidualMatcher.h"
+#include "utils/RegistryHelper.h"
+
+using namespace YG;
+
+int main(int argc, char** argv) {
+    size_t fanout = BenchArg(argc, argv, 1, 100);
+    unsigned latencyUs = static_cast<unsigned>(BenchArg(argc, argv, 2, 20));
+    
+    const String rootPath = L"SOFTWARE\\YGBench";
+    auto memory = std::make_shared<MemoryRegistrySource>();
+    size_t keyCount = 0;
+    double buildMs = MeasureMs([&]() { keyCount = RegistryFixture::BuildSearchHive(*memory, rootPath, fanout); });
+    std::printf("synthetic hive: %zu keys, built in %.0f ms\n", keyCount, buildMs);
+    
+    // 与残留扫描相同的匹配方式：编译好的模式集，每个名称和值数据只扫描一次
+    ResidualMatcher residualMatcher;
+    residualMatcher.AddPattern(L"TargetApp", PatternDisplayName, 0);
+    residualMatcher.Build();
+    RegistryTextMatcher matcher = [&residualMatcher](std::wstring_view text, std::uint32_t& pattern) {
+        ResidualMatch match;
+        if (!residualMatcher.FindBest(text, match)) {
+            return false;
+        }
+        pattern = match.pattern;
+        return true;
+    };
+    
+    std::vector<unsigned> latencies = { 0 };
+    if (latencyUs > 0) {
+        latencies.push_back(latencyUs);
+    }
+    
+    for (unsigned latency : latencies) {
+        std::shared_ptr<IRegistrySource> source = memory;
+        if (latency > 0) {
+            source = std::make_shared<LatencyRegistrySource>(memory, latency);
+        }
+        RegistryHelper::SetSource(source);
+        
+        for (size_t threads : { static_cast<size_t>(1), static_cast<size_t>(4) }) {
+            RegistrySearchOptions options;
+            options.maxResults = keyCount * 2;
+            options.maxThreads = threads;
+            
+            size_t keyHits = 0;
+            size_t valueHits = 0;
+            ErrorCode result = ErrorCode::Success;
+            double elapsedMs = MeasureMs([&]() {
+                result = RegistryHelper::SearchTree(HKEY_LOCAL_MACHINE, rootPath, matcher, options,
+                    [&](const RegistrySearchHit& hit) {
+                        if (hit.target == RegistrySearchKeyName) {
+                            ++keyHits;
+                        } else {
+                            ++valueHits;
+                        }
+                        return true;
+                    });
+            });
+            
+            BenchCheck(result == ErrorCode::Success, "SearchTree failed");
+            BenchCheck(keyHits == (fanout > 7 ? 1u : 0u) && valueHits == fanout * fanout, "unexpected hit count");
+            std::printf("latency %4u us, %zu thread(s): %9.0f ms, %9.0f keys/s (key hits %zu, value hits %zu)\n",
+                        latency, threads, elapsedMs, keyCount / (elapsedMs / 1000.0), keyHits, valueHits);
+        }
+    }
+    
+    RegistryHelper::SetSource(nullptr);
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file ResidualDeleteBenchmark.cpp
+ * @brief 残留删除基准：两个卷上的目录树在不同延迟、每卷线程数下的删除耗时
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_residual_delete [每个卷的目录数，默认20] [每次文件系统操作延迟微秒，默认50]
+ * 每个卷一棵目录树，每个目录250个文件；延迟为0时只测量删除器自身的开销。
+ */
+
+#include "BenchCommon.h"
+#include "FileSystemFixture.h"
+#include "services/ResidualDeleter.h"
+
+using namespace YG;
+
+int main(int argc, char** argv) {
+    size_t directories = BenchArg(argc, argv, 1, 20);
+    unsigned latencyUs = static_cast<unsigned>(BenchArg(argc, argv, 2, 50));
+    
+    const String roots[] = { L"C:\\Users\\Bench\\AppData\\Local\\App", L"D:\\Games\\App" };
+    const DWORD64 expectedFiles = 2 * directories * 250;
+    const DWORD64 expectedDirectories = 2 * (1 + 2 * directories);
+    std::printf("2 volumes, %llu files, %llu directories\n",
+                static_cast<unsigned long long>(expectedFiles), static_cast<unsigned long long>(expectedDirectories));
+    
+    for (unsigned latency : { 0u, latencyUs }) {
+        for (size_t threads : { static_cast<size_t>(1), static_cast<size_t>(4) }) {
+            auto memory = std::make_shared<MemoryFileSystemSource>();
+            std::vector<ResidualItem> items;
+            for (const String& root : roots) {
+                FileSystemFixture::BuildInstallTree(*memory, root, directories, 1, 250);
+                items.emplace_back(root, L"App", ResidualType::Directory);
+            }
+            
+            ResidualDeleter deleter(std::make_shared<LatencyFileSystemSource>(memory, latency), threads);
+            ResidualDeleteResult result;
+            ErrorCode error = ErrorCode::Success;
+            double elapsedMs = MeasureMs([&]() { error = deleter.Delete(items, nullptr, result); });
+            
+            FileSystemEntry entry;
+            BenchCheck(error == ErrorCode::Success && result.deletedFiles == expectedFiles &&
+                       result.deletedDirectories == expectedDirectories &&
+                       memory->GetEntry(roots[0], entry) != ERROR_SUCCESS && memory->GetEntry(roots[1], entry) != ERROR_SUCCESS,
+                       "deleter did not remove every generated file and directory");
+            
+            std::printf("latency %3u us, %zu thread(s) per volume: %9.1f ms (%zu volumes)\n",
+                        latency, threads, elapsedMs, result.volumeCount);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file ResidualListBenchmark.cpp
+ * @brief 清理列表模型基准：110k残留项的装载、逐行切换与全选，对比每次切换重算合计
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_residual_list [规模倍数，默认1，即110003项]
+ */
+
+#include "BenchCommon.h"
+#include "ui/ResidualListModel.h"
+
+using namespace YG;
+
+namespace {
+    
+    struct Totals {
+        size_t selectedCount = 0;
+        DWORD64 selectedSize = 0;
+    };
+    
+    // 分组大小悬殊，含空分组，约三分之二的项初始选中
+    std::vector<ResidualGroup> MakeGroups(size_t scale) {
+        const size_t sizes[] = { 0, 70000 * scale, 3, 0, 40000 * scale };
+        std::vector<ResidualGroup> groups;
+        for (size_t group = 0; group < sizeof(sizes) / sizeof(sizes[0]); ++group) {
+            groups.emplace_back(L"Group " + std::to_wstring(group), L"", ResidualType::File);
+            for (size_t i = 0; i < sizes[group]; ++i) {
+                ResidualItem item;
+                item.path = L"C:\\Residual\\" + std::to_wstring(group) + L"\\" + std::to_wstring(i);
+                item.size = i % 97;
+                item.isSelected = (i % 3) != 0;
+                groups.back().items.push_back(item);
+            }
+        }
+        return groups;
+    }
+    
+    // 原清理对话框的做法：每次切换后遍历全部项重算选中数和选中大小
+    Totals Recount(const std::vector<ResidualGroup>& groups) {
+        Totals totals;
+        for (const auto& group : groups) {
+            for (const auto& item : group.items) {
+                if (item.isSelected) {
+                    totals.selectedCount++;
+                    totals.selectedSize += item.size;
+                }
+            }
+        }
+        return totals;
+    }
+    
+    Totals CountModel(const ResidualListModel& model) {
+        Totals totals;
+        for (size_t row = 0; row < model.GetRowCount(); ++row) {
+            if (model.IsSelected(row)) {
+                totals.selectedCount++;
+                totals.selectedSize += model.GetItem(row).size;
+            }
+        }
+        return totals;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t scale = BenchArg(argc, argv, 1, 1);
+    std::vector<ResidualGroup> groups = MakeGroups(scale);
+    Totals initial = Recount(groups);
+    
+    ResidualListModel model;
+    double resetMs = MeasureMs([&]() { model.Reset(groups); });
+    const size_t rowCount = model.GetRowCount();
+    BenchCheck(model.GetSelectedCount() == initial.selectedCount && model.GetSelectedSize() == initial.selectedSize,
+               "initial selection totals differ from the items");
+    std::printf("%zu rows: reset %.2f ms\n", rowCount, resetMs);
+    
+    double toggleMs = MeasureMs([&]() {
+        for (size_t row = 0; row < rowCount; ++row) {
+            model.Toggle(row);
+        }
+    });
+    Totals toggled = CountModel(model);
+    BenchCheck(model.GetSelectedCount() == toggled.selectedCount && model.GetSelectedSize() == toggled.selectedSize &&
+               toggled.selectedCount == rowCount - initial.selectedCount,
+               "incremental totals differ from a recount after toggling every row");
+    std::printf("toggle every row: %.2f ms (%.1f ns per toggle)\n", toggleMs, toggleMs * 1e6 / rowCount);
+    
+    double selectAllMs = MeasureMs([&]() { model.SetAllSelected(true); });
+    BenchCheck(model.GetSelectedCount() == rowCount, "select all did not select every row");
+    double selectNoneMs = MeasureMs([&]() { model.SetAllSelected(false); });
+    BenchCheck(model.GetSelectedCount() == 0 && model.GetSelectedSize() == 0, "select none left rows selected");
+    std::printf("select all %.3f ms, select none %.3f ms\n", selectAllMs, selectNoneMs);
+    
+    // 原做法每次切换都遍历全部项，只取1000次切换估算单次耗时
+    const size_t sampleToggles = 1000;
+    volatile size_t sink = 0;
+    double recountMs = MeasureMs([&]() {
+        for (size_t i = 0; i < sampleToggles; ++i) {
+            ResidualItem& item = groups[1].items[i];
+            item.isSelected = !item.isSelected;
+            sink = sink + Recount(groups).selectedCount;
+        }
+    });
+    std::printf("recount after each toggle: %.3f ms per toggle\n", recountMs / sampleToggles);
+    return 0;
+}
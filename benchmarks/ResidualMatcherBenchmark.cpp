@@ -0,0 +1,129 @@
+/**
+ * @file ResidualMatcherBenchmark.cpp
+ * @brief 残留名称匹配基准：多模式自动机与逐项转小写查找的每个名称耗时，结果与逐模式查找比对
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_residual_matcher [名称数，默认200000]
+ */
+
+#include "BenchCommon.h"
+#include "services/ResidualMatcher.h"
+#include "services/ProgramSearchIndex.h"
+
+using namespace YG;
+
+namespace {
+    
+    // 由程序相关的片段和无关的片段拼接，约半数名称命中某个模式
+    std::vector<String> MakeNames(size_t count, std::uint32_t seed) {
+        static const wchar_t* parts[] = {
+            L"Visual", L"studio", L"CODE", L" ", L"microsoft corporation", L"VSCODE",
+            L"microsoft vs code", L"x", L"Temp", L"cache", L"VS", L"Corp", L"unins000", L"Logs"
+        };
+        const std::uint32_t partCount = static_cast<std::uint32_t>(sizeof(parts) / sizeof(parts[0]));
+        BenchRandom random(seed);
+        std::vector<String> names(count);
+        for (auto& name : names) {
+            std::uint32_t pieces = 1 + random.Below(6);
+            for (std::uint32_t i = 0; i < pieces; ++i) {
+                name += parts[random.Below(partCount)];
+            }
+        }
+        return names;
+    }
+    
+    // 逐个模式转小写查找子串，按与ResidualMatcher相同的规则选出最佳模式
+    int BruteForceBest(const ResidualMatcher& matcher, const String& name) {
+        const auto& patterns = matcher.GetPatterns();
+        String folded = ProgramSearchIndex::Fold(name);
+        int best = -1;
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            if (folded.find(ProgramSearchIndex::Fold(patterns[i].text)) == String::npos) {
+                continue;
+            }
+            if (best < 0) {
+                best = static_cast<int>(i);
+                continue;
+            }
+            const ResidualPattern& a = patterns[i];
+            const ResidualPattern& b = patterns[best];
+            bool better;
+            if (ResidualMatcher::IsStrong(a.kind) != ResidualMatcher::IsStrong(b.kind)) {
+                better = ResidualMatcher::IsStrong(a.kind);
+            } else if (a.text.size() != b.text.size()) {
+                better = a.text.size() > b.text.size();
+            } else {
+                better = a.kind < b.kind;
+            }
+            if (better) {
+                best = static_cast<int>(i);
+            }
+        }
+        return best;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = BenchArg(argc, argv, 1, 200000);
+    
+    ProgramInfo program;
+    program.displayName = L"Visual Studio Code";
+    program.name = L"VSCode";
+    program.publisher = L"Microsoft Corporation";
+    program.installLocation = L"C:\\Program Files\\Microsoft VS Code\\";
+    program.uninstallString = L"\"C:\\Program Files\\Microsoft VS Code\\unins000.exe\"";
+    
+    ResidualMatcher matcher;
+    double buildMs = MeasureMs([&]() {
+        matcher.AddProgram(program, 0);
+        matcher.Build();
+    });
+    std::printf("%zu patterns, build %.3f ms\n", matcher.GetPatterns().size(), buildMs);
+    
+    std::vector<String> names = MakeNames(count, 1);
+    size_t hits = 0;
+    for (const String& name : names) {
+        ResidualMatch match;
+        bool found = matcher.FindBest(name, match);
+        int expected = BruteForceBest(matcher, name);
+        BenchCheck(found == (expected >= 0) && (!found || static_cast<int>(match.pattern) == expected),
+                   "automaton match differs from the per-pattern reference");
+        hits += found;
+    }
+    std::printf("%zu names, %zu hits, identical to the per-pattern reference\n", count, hits);
+    
+    volatile size_t sink = 0;
+    double matcherMs = BestOfMs(3, [&]() {
+        for (const String& name : names) {
+            ResidualMatch match;
+            sink = sink + matcher.FindBest(name, match);
+        }
+    });
+    
+    // 原ScanDirectoryForResiduals的做法：每个名称都把名称和程序名重新转小写，只查程序名
+    double singleMs = BestOfMs(3, [&]() {
+        for (const String& name : names) {
+            sink = sink + (ProgramSearchIndex::Fold(name).find(ProgramSearchIndex::Fold(program.displayName)) != String::npos);
+        }
+    });
+    
+    // 同样的做法扩展到全部模式
+    double allPatternsMs = BestOfMs(3, [&]() {
+        for (const String& name : names) {
+            String folded = ProgramSearchIndex::Fold(name);
+            for (const ResidualPattern& pattern : matcher.GetPatterns()) {
+                if (folded.find(ProgramSearchIndex::Fold(pattern.text)) != String::npos) {
+                    sink = sink + 1;
+                    break;
+                }
+            }
+        }
+    });
+    
+    std::printf("automaton %.1f ns/name, fold + find one name %.1f ns/name, fold + find all patterns %.1f ns/name\n",
+                matcherMs * 1e6 / count, singleMs * 1e6 / count, allPatternsMs * 1e6 / count);
+    return 0;
+}
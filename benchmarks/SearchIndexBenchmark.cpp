@@ -0,0 +1,71 @@
+/**
+ * @file SearchIndexBenchmark.cpp
+ * @brief 搜索索引基准：逐字输入时每次按键的搜索耗时，结果与逐行子串查找比对
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_search_index [条目数，默认50000]
+ */
+
+#include "BenchCommon.h"
+#include "ProgramFixture.h"
+#include "services/ProgramSearchIndex.h"
+
+using namespace YG;
+
+namespace {
+    
+    // 原SearchPrograms的做法：每次搜索逐行转小写后查找子串
+    std::vector<ProgramId> NaiveSearch(const ProgramTable& table, const String& keyword) {
+        String folded = ProgramSearchIndex::Fold(keyword);
+        std::vector<ProgramId> ids;
+        for (ProgramId id : table.GetIds()) {
+            if (ProgramSearchIndex::Fold(table.GetTitle(id)).find(folded) != String::npos ||
+                ProgramSearchIndex::Fold(table.GetPublisher(id)).find(folded) != String::npos ||
+                ProgramSearchIndex::Fold(table.GetVersion(id)).find(folded) != String::npos) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = BenchArg(argc, argv, 1, 50000);
+    
+    ProgramTablePtr table = ProgramTable::Build(ProgramFixture::MakeInventory(count));
+    ProgramSearchIndexPtr index;
+    double buildMs = MeasureMs([&]() { index = ProgramSearchIndex::Build(*table); });
+    std::printf("%zu entries: index build %.1f ms, %zu KB, %zu grams\n",
+                count, buildMs, index->GetMemoryUsage() / 1024, index->GetGramCount());
+    
+    const wchar_t* queries[] = { L"microsoft visual studio", L"redistributable", L"driver 4", L"12.3", L"zzz", L"-beta" };
+    double worstIndexMs = 0;
+    double worstNaiveMs = 0;
+    for (const wchar_t* query : queries) {
+        String typed;
+        ProgramSearchResult previous;
+        for (const wchar_t* ch = query; *ch; ++ch) {
+            typed += *ch;
+            
+            ProgramSearchResult result;
+            double indexMs = BestOfMs(5, [&]() { result = index->Search(typed, SearchFieldAll, &previous); });
+            std::vector<ProgramId> expected;
+            double naiveMs = MeasureMs([&]() { expected = NaiveSearch(*table, typed); });
+            BenchCheck(index->ToIds(result.rows) == expected, "indexed search differs from the naive substring scan");
+            
+            worstIndexMs = (std::max)(worstIndexMs, indexMs);
+            worstNaiveMs = (std::max)(worstNaiveMs, naiveMs);
+            if (typed.size() <= 3 || ch[1] == L'\0') {
+                std::printf("  %-26ls %6zu rows, %6zu candidates%-11s index %7.3f ms, naive %7.2f ms\n",
+                            (L"'" + typed + L"'").c_str(), result.rows.size(), result.candidateCount,
+                            result.narrowed ? " (narrowed)" : "", indexMs, naiveMs);
+            }
+            previous = std::move(result);
+        }
+    }
+    std::printf("worst keystroke: index %.3f ms, naive %.2f ms\n", worstIndexMs, worstNaiveMs);
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file SortBenchmark.cpp
+ * @brief 列表排序基准：缓存的整数排序键与每次比较现算字符串键的耗时，结果与std::stable_sort比对
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ *
+ * 用法: bench_sort [条目数，默认50000]
+ */
+
+#include "BenchCommon.h"
+#include "ProgramFixture.h"
+#include "services/ProgramSorter.h"
+#include "services/ProgramSearchIndex.h"
+#include <algorithm>
+
+using namespace YG;
+
+namespace {
+    
+    const wchar_t* s_columnNames[] = { L"name", L"version", L"publisher", L"size", L"date" };
+    
+    // 原列表排序的做法：每次比较都从程序表取字符串并现转小写、现解析
+    void ReferenceSort(const ProgramTable& table, std::vector<ProgramId>& ids, ProgramSortColumn column, bool ascending) {
+        auto key = [&table, column](ProgramId id) -> std::pair<std::uint64_t, String> {
+            switch (column) {
+            case SortByName:
+                return { 0, ProgramSearchIndex::Fold(table.GetTitle(id)) };
+            case SortByVersion:
+                return { ProgramSorter::PackVersion(table.GetVersion(id)), ProgramSearchIndex::Fold(table.GetVersion(id)) };
+            case SortByPublisher:
+                return { 0, ProgramSearchIndex::Fold(table.GetPublisher(id)) };
+            case SortBySize:
+                return { table.GetEstimatedSize(id), String() };
+            default:
+                return { ProgramSorter::PackDate(table.GetInstallDate(id)), String() };
+            }
+        };
+        std::stable_sort(ids.begin(), ids.end(), [&key, ascending](ProgramId a, ProgramId b) {
+            return ascending ? key(a) < key(b) : key(b) < key(a);
+        });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = BenchArg(argc, argv, 1, 50000);
+    
+    ProgramTablePtr table = ProgramTable::Build(ProgramFixture::MakeInventory(count));
+    ProgramSorter sorter;
+    sorter.SetTable(table, true);
+    std::printf("%zu entries\n", count);
+    
+    // 依次点击列标题：首次点击某列时计算排序键，再次点击同一列为反转
+    const std::pair<ProgramSortColumn, bool> clicks[] = {
+        { SortBySize, true }, { SortByName, true }, { SortByName, false }, { SortByName, true },
+        { SortByInstallDate, false }, { SortByInstallDate, true }, { SortByVersion, true },
+        { SortByVersion, false }, { SortByPublisher, true }, { SortBySize, false }, { SortBySize, true }
+    };
+    std::vector<ProgramId> ids = table->GetIds();
+    std::vector<ProgramId> expected = ids;
+    for (const auto& click : clicks) {
+        bool reversed = false;
+        double sorterMs = MeasureMs([&]() { reversed = sorter.Sort(ids, click.first, click.second); });
+        double referenceMs = MeasureMs([&]() { ReferenceSort(*table, expected, click.first, click.second); });
+        BenchCheck(ids == expected, "cached-key sort differs from the std::stable_sort reference");
+        
+        std::printf("  %-9ls %-4s: sorter %7.2f ms%-11s reference %8.2f ms\n",
+                    s_columnNames[click.first], click.second ? "asc" : "desc",
+                    sorterMs, reversed ? " (reversed)" : "", referenceMs);
+    }
+    
+    // 排序键已缓存时重复排序的耗时
+    double warmMs = BestOfMs(5, [&]() {
+        sorter.Sort(ids, SortBySize, true);
+        sorter.Sort(ids, SortByName, true);
+    });
+    std::printf("size then name with cached keys: %.2f ms\n", warmMs);
+    return 0;
+}
@@ -65,10 +65,11 @@ namespace YG {
         String uninstallString;   // 卸载命令
         String iconPath;          // 图标路径
         String registryKey;       // 注册表键路径
-        DWORD64 estimatedSize;    // 估计大小(KB)
+        DWORD64 estimatedSize;    // 估计大小(字节)
         bool isSystemComponent;   // 是否为系统组件
+        DWORD64 registryWriteTime; // 注册表键最后写入时间(FILETIME)
         
-        ProgramInfo() : estimatedSize(0), isSystemComponent(false) {}
+        ProgramInfo() : estimatedSize(0), isSystemComponent(false), registryWriteTime(0) {}
     };
     
     // 卸载结果结构
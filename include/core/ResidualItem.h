@@ -54,13 +54,14 @@ namespace YG {
         String lastModified;        ///< 最后修改时间
         bool isSelected;            ///< 是否被选中删除
         String category;            ///< 分类名称（用于分组显示）
+        size_t programIndex;        ///< 所属程序在扫描的程序列表中的下标
         
         /**
          * @brief 默认构造函数
          */
         ResidualItem() 
             : type(ResidualType::File), riskLevel(RiskLevel::Safe), 
-              size(0), isSelected(true) {}
+              size(0), isSelected(true), programIndex(0) {}
         
         /**
          * @brief 构造函数
@@ -68,7 +69,7 @@ namespace YG {
         ResidualItem(const String& itemPath, const String& itemName, 
                     ResidualType itemType, RiskLevel risk = RiskLevel::Safe)
             : path(itemPath), name(itemName), type(itemType), 
-              riskLevel(risk), size(0), isSelected(true) {}
+              riskLevel(risk), size(0), isSelected(true), programIndex(0) {}
     };
     
     /**
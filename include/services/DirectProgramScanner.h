@@ -20,13 +20,6 @@ namespace YG {
  */
 int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs);
 
-/**
- * @brief 估算目录大小（快速版本）
- * @param directoryPath 目录路径
- * @return DWORD64 估算的目录大小（字节）
- */
-DWORD64 EstimateDirectorySize(const String& directoryPath);
-
 /**
  * @brief 从卸载字符串估算程序大小
  * @param uninstallString 卸载字符串
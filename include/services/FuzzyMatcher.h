@@ -0,0 +1,92 @@
+/**
+ * @file FuzzyMatcher.h
+ * @brief 子序列模糊匹配与评分
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <cstdint>
+#include <climits>
+#include <string_view>
+
+namespace YG {
+    
+    /**
+     * @brief 字符在原文中的位置类别，决定匹配到该字符时的加分
+     */
+    enum FuzzyCharClass : std::uint8_t {
+        FuzzyCharPlain = 0,         ///< 普通字符
+        FuzzyCharTransition,        ///< 大小写或字母数字的转换处（"VirtualBox"的B、"7Zip"的Z）
+        FuzzyCharWordStart          ///< 单词开头（文本开头或分隔符之后）
+    };
+    
+    /**
+     * @brief 模糊匹配器
+     *
+     * 关键词（去掉空白并转为小写）的每个字符按顺序出现在文本中即视为匹配，评分规则：
+     *   - 每个匹配字符得基本分，匹配在单词开头、大小写转换处额外加分，关键词首字符的加分加倍，
+     *     因此"vsc"能以首字母缩写的方式高分匹配"Visual Studio Code"
+     *   - 连续匹配的字符额外加分，字符之间的间隔按长度扣分
+     * 评分用动态规划求所有匹配位置中的最高分，文本只取前MaxTextLength个字符。
+     */
+    class FuzzyMatcher {
+    public:
+        static constexpr int NoMatch = INT_MIN;             ///< 不匹配时的评分
+        
+        /**
+         * @brief 构造函数
+         * @param pattern 关键词
+         */
+        explicit FuzzyMatcher(const String& pattern);
+        
+        /**
+         * @brief 关键词是否为空（只含空白）
+         */
+        bool IsEmpty() const { return m_pattern.empty(); }
+        
+        /**
+         * @brief 处理后的关键词（小写，无空白）
+         */
+        const String& GetPattern() const { return m_pattern; }
+        
+        /**
+         * @brief 关键词的字符掩码，文本掩码不包含其全部位时不可能匹配
+         */
+        std::uint64_t GetCharMask() const { return m_charMask; }
+        
+        /**
+         * @brief 计算评分
+         * @param foldedText 小写的文本
+         * @param charClasses 文本各字符的FuzzyCharClass，与foldedText等长
+         * @return int 评分，越高越好；不匹配时为NoMatch
+         */
+        int Score(std::wstring_view foldedText, const std::uint8_t* charClasses) const;
+        
+        /**
+         * @brief 计算小写文本的字符掩码：字母、数字各占一位，其他字符按码值散列到其余位
+         * @param foldedText 小写的文本
+         * @return std::uint64_t 字符掩码
+         */
+        static std::uint64_t MakeCharMask(std::wstring_view foldedText);
+        
+        /**
+         * @brief 按原文（未转小写）标注各字符的位置类别
+         * @param text 原文
+         * @param length 字符数
+         * @param charClasses 输出，至少length个元素
+         */
+        static void ClassifyCharacters(const wchar_t* text, size_t length, std::uint8_t* charClasses);
+        
+        static constexpr size_t MaxPatternLength = 64;      ///< 关键词超过该长度的部分被忽略
+        static constexpr size_t MaxTextLength = 256;        ///< 文本超过该长度的部分不参与匹配
+    
+    private:
+        String m_pattern;                   ///< 小写、去掉空白的关键词
+        std::uint64_t m_charMask;           ///< 关键词的字符掩码
+    };
+
+} // namespace YG
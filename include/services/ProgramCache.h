@@ -10,10 +10,14 @@
 
 #include "core/Common.h"
 #include "core/DetailedErrorCodes.h"
+#include "utils/RegistryWatcher.h"
 #include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <chrono>
+#include <memory>
+#include <functional>
+#include <cstdint>
 
 namespace YG {
     
@@ -26,12 +30,22 @@ namespace YG {
         bool includeSystemComponents;           ///< 是否包含系统组件
         size_t programCount;                    ///< 程序数量
         DWORD scanDuration;                     ///< 扫描耗时(毫秒)
+        bool dirty;                             ///< 监视到相关注册表变更，需要重新扫描
         
-        CacheItem() : includeSystemComponents(false), programCount(0), scanDuration(0) {
+        CacheItem() : includeSystemComponents(false), programCount(0), scanDuration(0), dirty(false) {
             lastUpdate = std::chrono::system_clock::now();
         }
     };
     
+    /**
+     * @brief 缓存变更监视目标
+     */
+    struct CacheWatchTarget {
+        HKEY rootKey;                   ///< 根键
+        String path;                    ///< 子键路径
+        bool systemComponentsOnly;      ///< 是否只影响包含系统组件的缓存项
+    };
+    
     /**
      * @brief 程序扫描缓存管理器
      * 
@@ -74,11 +88,24 @@ namespace YG {
          * @param includeSystemComponents 是否包含系统组件
          * @param programs 程序列表
          * @param scanDuration 扫描耗时
+         * @param changeGeneration 扫描开始时的GetChangeGeneration()，扫描期间发生变更时缓存项直接标记为脏
          * @return ErrorContext 操作结果
          */
         ErrorContext UpdateCache(bool includeSystemComponents, 
                                const std::vector<ProgramInfo>& programs,
-                               DWORD scanDuration);
+                               DWORD scanDuration,
+                               std::uint64_t changeGeneration = UINT64_MAX);
+        
+        /**
+         * @brief 原地修改已缓存的程序信息（不改变缓存时间与脏标记）
+         * 
+         * 用于把后台补全的字段写回缓存；有修改时同时重写磁盘快照。
+         * @param includeSystemComponents 是否包含系统组件
+         * @param patch 对每个程序调用，返回true表示有修改
+         * @return ErrorContext 操作结果，没有对应缓存项时返回DataNotFound
+         */
+        ErrorContext PatchCachedPrograms(bool includeSystemComponents,
+                                         const std::function<bool(ProgramInfo&)>& patch);
         
         /**
          * @brief 清除所有缓存
@@ -120,6 +147,52 @@ namespace YG {
          */
         void WarmupCache();
         
+        /**
+         * @brief 开始监视注册表变更
+         * 
+         * 监视生效后缓存不再按时间过期，只有相关目标键发生变更时才将受影响的缓存项标记为脏；
+         * 启动失败时保持原有的按时间过期策略。
+         * @param targets 监视目标
+         * @param notifier 变更通知器，为空时使用Win32RegistryChangeNotifier
+         * @return ErrorContext 操作结果
+         */
+        ErrorContext StartWatching(const std::vector<CacheWatchTarget>& targets,
+                                   std::shared_ptr<IRegistryChangeNotifier> notifier = nullptr);
+        
+        /**
+         * @brief 停止监视注册表变更，恢复按时间过期
+         */
+        void StopWatching();
+        
+        /**
+         * @brief 是否正在监视注册表变更
+         * @return bool 是否正在监视
+         */
+        bool IsWatching() const;
+        
+        /**
+         * @brief 获取变更计数，每收到一次变更通知加一
+         * @return std::uint64_t 变更计数
+         */
+        std::uint64_t GetChangeGeneration() const;
+        
+        /**
+         * @brief 设置磁盘快照路径，设置后每次UpdateCache都会写入快照
+         * @param filePath 快照文件路径，空字符串表示不持久化
+         */
+        void SetSnapshotPath(const String& filePath);
+        
+        /**
+         * @brief 从磁盘快照加载上次的程序列表
+         * 
+         * 快照内容未经校验，不会放入内存缓存（HasValidCache仍返回false），
+         * 调用方应先显示结果，再在后台重新扫描。
+         * @param includeSystemComponents 是否包含系统组件，与快照不一致时视为无效
+         * @param programs 输出程序列表
+         * @return ErrorContext 操作结果，快照缺失、损坏或版本不符时返回失败
+         */
+        ErrorContext LoadSnapshot(bool includeSystemComponents, std::vector<ProgramInfo>& programs) const;
+    
     private:
         /**
          * @brief 生成缓存键
@@ -140,11 +213,24 @@ namespace YG {
          */
         bool IsCacheExpired(const CacheItem& item) const;
         
+        /**
+         * @brief 处理变更通知，将受影响的缓存项标记为脏
+         * @param targetIndex 监视目标序号
+         */
+        void OnRegistryChanged(size_t targetIndex);
+    
     private:
         mutable std::mutex m_mutex;                           ///< 线程安全锁
         std::unordered_map<String, CacheItem> m_cache;        ///< 缓存映射表
         int m_maxCacheAge;                                    ///< 最大缓存时间(秒)
         size_t m_maxCacheSize;                                ///< 最大缓存大小
+        String m_snapshotPath;                                ///< 磁盘快照路径
+        
+        // 变更监视
+        std::shared_ptr<IRegistryChangeNotifier> m_notifier;  ///< 变更通知器
+        std::vector<CacheWatchTarget> m_watchTargets;         ///< 监视目标
+        bool m_watching;                                      ///< 是否正在监视
+        std::uint64_t m_changeGeneration;                     ///< 变更计数
         
         // 统计信息
         mutable size_t m_cacheHits;                           ///< 缓存命中次数
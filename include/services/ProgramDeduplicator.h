@@ -0,0 +1,84 @@
+/**
+ * @file ProgramDeduplicator.h
+ * @brief 基于规范化标识的程序列表去重
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+
+namespace YG {
+    
+    /**
+     * @brief 程序的规范化标识，每个程序只计算一次
+     */
+    struct ProgramIdentity {
+        String foldedName;          ///< 小写的显示名称（displayName为空时取name）
+        String baseName;            ///< 去掉架构标识（x64、32-bit等）后的名称
+        String publisher;           ///< 发布者
+        String version;             ///< 版本号
+        String installPath;         ///< 规范化的安装路径（小写、统一分隔符、去掉引号和末尾分隔符），可为空
+    };
+    
+    /**
+     * @brief 去重统计
+     */
+    struct DeduplicationStats {
+        size_t inputCount = 0;          ///< 输入程序数
+        size_t keptCount = 0;           ///< 保留的程序数
+        size_t nameDuplicates = 0;      ///< 名称、发布者、版本相同而移除的数量
+        size_t pathDuplicates = 0;      ///< 安装路径相同而移除的数量
+    };
+    
+    /**
+     * @brief 程序列表去重
+     *
+     * 两个程序满足以下任一条件即视为重复，保留先出现的一个：
+     *   - 去掉架构标识后的名称（不区分大小写）、发布者、版本都相同
+     *   - 安装路径都不为空且规范化后相同
+     * 每个程序的标识只计算一次，重复判断通过两张哈希表在一趟遍历中完成，复杂度为O(n)。
+     */
+    class ProgramDeduplicator {
+    public:
+        /**
+         * @brief 计算程序的规范化标识
+         * @param program 程序信息
+         * @return ProgramIdentity 规范化标识
+         */
+        static ProgramIdentity MakeIdentity(const ProgramInfo& program);
+        
+        /**
+         * @brief 求去重后保留的程序下标
+         * @param programs 程序列表
+         * @param stats 输出统计，可为nullptr
+         * @return std::vector<size_t> 保留的程序在programs中的下标（升序）
+         */
+        static std::vector<size_t> FindUniqueIndices(const std::vector<ProgramInfo>& programs,
+                                                     DeduplicationStats* stats = nullptr);
+        
+        /**
+         * @brief 去除重复的程序
+         * @param programs 程序列表
+         * @param stats 输出统计，可为nullptr
+         * @return std::vector<ProgramInfo> 去重后的程序列表，保持原有顺序
+         */
+        static std::vector<ProgramInfo> RemoveDuplicates(const std::vector<ProgramInfo>& programs,
+                                                         DeduplicationStats* stats = nullptr);
+    
+    private:
+        /**
+         * @brief 去掉名称中的架构标识（名称需已转为小写）
+         */
+        static String StripArchitectureSuffixes(const String& foldedName);
+        
+        /**
+         * @brief 规范化安装路径
+         */
+        static String CanonicalizePath(const String& path);
+    };
+
+} // namespace YG
@@ -11,6 +11,8 @@
 #include "core/Common.h"
 #include "core/Logger.h"
 #include "services/ProgramCache.h"
+#include "services/ProgramEnricher.h"
+#include "services/ProgramTable.h"
 #include <vector>
 #include <memory>
 #include <functional>
@@ -18,6 +20,7 @@
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <unordered_map>
 
 namespace YG {
     
@@ -28,6 +31,17 @@ namespace YG {
         const wchar_t* description;
     };
     
+    /**
+     * @brief 增量扫描的结果差异
+     */
+    struct ProgramScanDelta {
+        std::vector<ProgramInfo> added;     ///< 新出现的程序
+        std::vector<ProgramInfo> changed;   ///< 注册表键有写入、已重新读取的程序
+        std::vector<ProgramInfo> removed;   ///< 已消失的程序（上次扫描时的信息）
+        
+        bool IsEmpty() const { return added.empty() && changed.empty() && removed.empty(); }
+    };
+    
     /**
      * @brief 程序检测器类
      * 
@@ -38,6 +52,9 @@ namespace YG {
         // 扫描进度回调函数类型
         using ScanProgressCallback = std::function<void(int percentage, const String& currentItem)>;
         using ScanCompletedCallback = std::function<void(const std::vector<ProgramInfo>& programs, ErrorCode result)>;
+        // 分批结果回调：processedCount/totalCount为已处理/全部卸载注册表子键数
+        using ScanBatchCallback = std::function<void(const std::vector<ProgramInfo>& batch,
+                                                     size_t processedCount, size_t totalCount)>;
         
         /**
          * @brief 构造函数
@@ -62,6 +79,23 @@ namespace YG {
                           const ScanProgressCallback& progressCallback = nullptr,
                           const ScanCompletedCallback& completedCallback = nullptr);
         
+        /**
+         * @brief 开始流式扫描已安装的程序
+         * 
+         * 与StartScan相同，但解析出的程序按扫描顺序分批回调，每批最多batchSize个，
+         * 界面可以在最慢的注册表根键读完之前先显示前面的结果。子键总数在枚举前由
+         * RegQueryInfoKeyW的子键计数得出，进度按已处理子键数计算。Windows Store应用
+         * 在全部子键处理完后作为最后一批回调。
+         * @param includeSystemComponents 是否包含系统组件
+         * @param batchSize 每批程序数量，0表示使用默认值
+         * @param batchCallback 分批结果回调（在扫描线程中调用）
+         * @param completedCallback 完成回调（在扫描线程中调用，参数为完整列表）
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode StartStreamingScan(bool includeSystemComponents, size_t batchSize,
+                                     const ScanBatchCallback& batchCallback,
+                                     const ScanCompletedCallback& completedCallback = nullptr);
+        
         /**
          * @brief 同步扫描已安装的程序
          * @param includeSystemComponents 是否包含系统组件
@@ -71,10 +105,95 @@ namespace YG {
         ErrorCode ScanSync(bool includeSystemComponents, std::vector<ProgramInfo>& programs);
         
         /**
-         * @brief 停止当前扫描
+         * @brief 增量重新扫描已安装的程序
+         * 
+         * 只重新读取新增或最后写入时间发生变化的卸载注册表子键，其余沿用上次扫描的结果，
+         * 并剔除已消失的子键。首次调用等价于完整扫描。
+         * @param includeSystemComponents 是否包含系统组件
+         * @param programs 输出完整程序列表
+         * @param delta 输出相对上次扫描的差异（仅针对卸载注册表项）
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode RescanIncremental(bool includeSystemComponents, std::vector<ProgramInfo>& programs,
+                                    ProgramScanDelta& delta);
+        
+        /**
+         * @brief 从磁盘快照加载上次的程序列表
+         * 
+         * 成功时同时用快照中的注册表时间戳初始化增量扫描记录，
+         * 随后的StartRevalidation/RescanIncremental只需重新读取发生变化的子键。
+         * @param includeSystemComponents 是否包含系统组件
+         * @param programs 输出程序列表
+         * @return ErrorCode 操作结果，快照不可用时返回DataNotFound
+         */
+        ErrorCode LoadSnapshot(bool includeSystemComponents, std::vector<ProgramInfo>& programs);
+        
+        /**
+         * @brief 在后台线程中增量校验当前程序列表
+         * 
+         * 只重新读取新增或时间戳变化的子键，结果与RescanIncremental相同；被StopScan取消时
+         * 恢复上一次的增量记录，且不调用完成回调。
+         * @param includeSystemComponents 是否包含系统组件
+         * @param completedCallback 完成回调（在扫描线程中调用）
+         * @param progressCallback 进度回调（在扫描线程中调用，调用频率不受限制）
+         * @return ErrorCode 操作结果，已有扫描在进行时返回OperationInProgress
+         */
+        ErrorCode StartRevalidation(bool includeSystemComponents,
+                                    const ScanCompletedCallback& completedCallback = nullptr,
+                                    const ScanProgressCallback& progressCallback = nullptr);
+        
+        /**
+         * @brief 获取最近一次扫描得到的程序列表
+         * @return std::vector<ProgramInfo> 程序列表
+         */
+        std::vector<ProgramInfo> GetPrograms() const;
+        
+        /**
+         * @brief 获取最近一次后台校验（StartRevalidation）相对上次扫描的差异
+         * 
+         * 只包含卸载注册表项；Windows Store应用每次完整读取，不参与比较。
+         * @return ProgramScanDelta 差异，校验被取消或失败时为空
+         */
+        ProgramScanDelta GetLastScanDelta() const;
+        
+        /**
+         * @brief 获取最近一次扫描得到的程序表
+         * 
+         * 程序表不可修改，可在任意线程持有；补全完成后替换为打过补丁的新表。
+         * @return ProgramTablePtr 程序表，尚未扫描时为空表
+         */
+        ProgramTablePtr GetProgramTable() const;
+        
+        /**
+         * @brief 在后台补全程序列表中缺失的大小和安装日期
+         * 
+         * 扫描只返回注册表中的数据，界面显示列表后调用本方法；每补全一个程序回调一次，
+         * 整批完成后结果同时写回增量扫描记录和缓存（含磁盘快照）。再次调用会取消上一批。
+         * @param programs 程序列表
+         * @param updateCallback 补全回调（在补全线程中调用）
+         * @return size_t 需要补全的程序数量
+         */
+        size_t StartEnrichment(const std::vector<ProgramInfo>& programs,
+                               const ProgramEnricher::UpdateCallback& updateCallback);
+        
+        /**
+         * @brief 取消后台补全
+         */
+        void CancelEnrichment();
+        
+        /**
+         * @brief 停止当前扫描，等待扫描线程退出（最多3秒），不调用完成回调
          */
         void StopScan();
         
+        /**
+         * @brief 请求取消当前扫描并立即返回
+         * 
+         * 扫描线程在下一个检查点退出，退出时以OperationCancelled调用完成回调（此时已不在扫描状态），
+         * 调用方收到回调投递的消息后再开始新的扫描，界面线程无需等待。
+         */
+        void CancelScan();
+        
         /**
          * @brief 检查是否正在扫描
          * @return bool 是否正在扫描
@@ -119,20 +238,6 @@ namespace YG {
          */
         ErrorCode GetProgramIcon(const ProgramInfo& programInfo, String& iconPath);
         
-        /**
-         * @brief 计算目录大小
-         * @param directoryPath 目录路径
-         * @return DWORD64 目录大小（字节）
-         */
-        DWORD64 CalculateDirectorySize(const String& directoryPath);
-        
-        /**
-         * @brief 获取可执行文件大小
-         * @param uninstallString 卸载字符串
-         * @return DWORD64 文件大小（字节）
-         */
-        DWORD64 GetExecutableSize(const String& uninstallString);
-        
         /**
          * @brief 估算程序大小
          * @param programInfo 程序信息
@@ -140,13 +245,6 @@ namespace YG {
          */
         DWORD64 EstimateProgramSize(const ProgramInfo& programInfo);
         
-        /**
-         * @brief 从图标路径估算程序大小
-         * @param iconPath 图标路径
-         * @return DWORD64 估算的程序大小（字节）
-         */
-        DWORD64 EstimateFromIconPath(const String& iconPath);
-        
         /**
          * @brief 从路径中提取发布者信息
          * @param path 程序路径或卸载字符串
@@ -154,27 +252,6 @@ namespace YG {
          */
         String ExtractPublisherFromPath(const String& path);
         
-        /**
-         * @brief 基于程序名称和发布者估算程序大小
-         * @param programInfo 程序信息
-         * @return DWORD64 估算的程序大小（字节）
-         */
-        DWORD64 EstimateProgramSizeByName(const ProgramInfo& programInfo);
-        
-        /**
-         * @brief 从图标路径获取文件创建日期
-         * @param iconPath 图标路径
-         * @return String 日期字符串 (YYYYMMDD格式)
-         */
-        String GetDateFromIconPath(const String& iconPath);
-        
-        /**
-         * @brief 基于程序名称和发布者估算安装日期
-         * @param programInfo 程序信息
-         * @return String 估算的日期字符串 (YYYYMMDD格式)
-         */
-        String EstimateInstallDateByName(const ProgramInfo& programInfo);
-        
         /**
          * @brief 设置扫描超时时间
          * @param timeoutMs 超时时间(毫秒)
@@ -200,9 +277,11 @@ namespace YG {
          * @brief 扫描注册表卸载信息
          * @param programs 程序列表
          * @param includeSystemComponents 是否包含系统组件
+         * @param delta 非空时沿用时间戳未变化的子键记录，并输出与上次扫描的差异
          * @return ErrorCode 操作结果
          */
-        ErrorCode ScanRegistryUninstall(std::vector<ProgramInfo>& programs, bool includeSystemComponents);
+        ErrorCode ScanRegistryUninstall(std::vector<ProgramInfo>& programs, bool includeSystemComponents,
+                                        ProgramScanDelta* delta = nullptr);
         
         /**
          * @brief 扫描Windows应用商店应用
@@ -227,24 +306,6 @@ namespace YG {
          */
         ErrorCode GetProgramInfoFromRegistry(HKEY hKey, const String& subKeyName, ProgramInfo& programInfo, const RegistryPath& registryPath);
         
-        /**
-         * @brief 解析卸载字符串
-         * @param uninstallString 卸载字符串
-         * @param executablePath 输出可执行文件路径
-         * @param parameters 输出参数
-         * @return bool 是否解析成功
-         */
-        bool ParseUninstallString(const String& uninstallString, String& executablePath, String& parameters);
-        
-        /**
-         * @brief 获取文件版本信息
-         * @param filePath 文件路径
-         * @param version 输出版本号
-         * @param description 输出描述
-         * @return bool 是否成功
-         */
-        bool GetFileVersionInfo(const String& filePath, String& version, String& description);
-        
         /**
          * @brief 检查是否为系统组件
          * @param programInfo 程序信息
@@ -264,16 +325,55 @@ namespace YG {
          */
         void UpdateProgress(int percentage, const String& currentItem);
         
+        /**
+         * @brief 把累积的程序交给分批结果回调
+         * @param pending 累积的程序，回调后清空
+         * @param processedCount 已处理的子键数
+         * @param totalCount 子键总数
+         * @param flush 是否不足一批也立即回调
+         */
+        void EmitScanBatch(std::vector<ProgramInfo>& pending, size_t processedCount, size_t totalCount, bool flush);
+        
+        /**
+         * @brief 一批补全完成后写回增量扫描记录和缓存
+         * @param updates 补全结果
+         * @param includeSystemComponents 提交时是否包含系统组件
+         */
+        void OnEnrichmentCompleted(const std::vector<ProgramEnrichmentUpdate>& updates, bool includeSystemComponents);
+        
+        /**
+         * @brief 以扫描结果生成新的程序表（沿用上一张表的程序Id）
+         * @param programs 扫描结果
+         */
+        void PublishPrograms(const std::vector<ProgramInfo>& programs);
+        
+        /**
+         * @brief 卸载注册表子键的扫描记录（增量扫描使用）
+         */
+        struct RegistryEntryState {
+            DWORD64 lastWriteTime = 0;              ///< 子键最后写入时间
+            bool valid = false;                     ///< 是否为有效程序项
+            bool systemComponent = false;           ///< 是否被判定为系统组件
+            bool visible = false;                   ///< 上次扫描是否出现在结果中
+            ProgramInfo info;                       ///< 读取到的程序信息
+        };
+    
     private:
-        std::vector<ProgramInfo> m_programs;        ///< 程序列表
+        ProgramTablePtr m_programTable;             ///< 最近一次扫描的程序表（受m_mutex保护）
         std::unique_ptr<std::thread> m_scanThread;  ///< 扫描线程
         std::atomic<bool> m_scanning;               ///< 是否正在扫描
         std::atomic<bool> m_stopRequested;          ///< 是否请求停止
+        std::atomic<bool> m_reportCancellation;     ///< 被取消时是否仍调用完成回调（CancelScan）
+        ProgramScanDelta m_lastScanDelta;           ///< 最近一次后台校验的差异（受m_mutex保护）
         
         ScanProgressCallback m_progressCallback;   ///< 进度回调
         ScanCompletedCallback m_completedCallback; ///< 完成回调
+        ScanBatchCallback m_batchCallback;         ///< 分批结果回调
+        size_t m_batchSize;                         ///< 每批程序数量
+        size_t m_scanTotal;                         ///< 最近一次扫描的子键总数
         
         bool m_includeSystemComponents;             ///< 是否包含系统组件
+        bool m_incrementalScan;                     ///< 扫描线程是否执行增量扫描
         bool m_deepScanEnabled;                     ///< 是否启用深度扫描
         DWORD m_scanTimeout;                        ///< 扫描超时时间
         
@@ -282,6 +382,9 @@ namespace YG {
         DWORD m_lastScanTime;                       ///< 最后扫描耗时
         String m_lastScanTimeString;                ///< 最后扫描时间字符串
         
+        // 增量扫描记录（键为小写的完整注册表路径）
+        std::unordered_map<String, RegistryEntryState> m_registryIndex;
+        
         // 线程同步
         mutable std::mutex m_mutex;                 ///< 线程安全锁
         std::condition_variable m_stopCondition;    ///< 停止条件变量
@@ -290,6 +393,9 @@ namespace YG {
         // 缓存管理
         std::unique_ptr<ProgramCache> m_cache;      ///< 程序缓存
         
+        // 后台补全
+        std::unique_ptr<ProgramEnricher> m_enricher; ///< 大小、安装日期补全器
+        
         // 系统组件过滤列表
         static const StringVector s_systemComponentNames;
         static const StringVector s_systemPublishers;
@@ -0,0 +1,214 @@
+/**
+ * @file ProgramEnricher.h
+ * @brief 程序信息后台补全（大小、安装日期、版本）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "utils/ThreadPool.h"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 补全的字段
+     */
+    enum EnrichedField : unsigned int {
+        EnrichedNone        = 0,
+        EnrichedSize        = 1 << 0,   ///< estimatedSize
+        EnrichedInstallDate = 1 << 1,   ///< installDate
+        EnrichedVersion     = 1 << 2    ///< version
+    };
+    
+    /**
+     * @brief 单个程序的补全结果
+     */
+    struct ProgramEnrichmentUpdate {
+        String programKey;          ///< 程序标识（注册表键路径）
+        DWORD64 registryWriteTime;  ///< 提交时的注册表键写入时间，用于丢弃过时结果
+        unsigned int fields;        ///< 本次补全的字段（EnrichedField位组合）
+        DWORD64 estimatedSize;      ///< 补全后的大小（字节）
+        String installDate;         ///< 补全后的安装日期（YYYYMMDD）
+        String version;             ///< 补全后的版本（卸载程序的文件版本）
+        
+        ProgramEnrichmentUpdate() : registryWriteTime(0), fields(EnrichedNone), estimatedSize(0) {}
+        
+        /**
+         * @brief 将补全结果写入程序信息
+         * @param programInfo 程序信息
+         */
+        void ApplyTo(ProgramInfo& programInfo) const;
+    };
+    
+    /**
+     * @brief 程序信息补全器
+     *
+     * 注册表扫描只读取注册表中的数据，EstimatedSize、InstallDate或版本缺失时
+     * 由本类在独立的有界线程池中访问文件系统推断，结果逐个程序回调。
+     * 大小只取安装目录的实际大小，由共享的DirectorySizeEngine精确统计，其按"路径 + 最后写入时间"缓存，
+     * 重复扫描时基本不再枚举目录；没有安装目录时大小保持未知。文件创建时间按路径缓存。
+     */
+    class ProgramEnricher {
+    public:
+        using UpdateCallback = std::function<void(const ProgramEnrichmentUpdate& update)>;
+        using CompletedCallback = std::function<void(const std::vector<ProgramEnrichmentUpdate>& updates)>;
+        
+        /**
+         * @brief 构造函数
+         * @param threadCount 工作线程数，0表示使用默认值（不超过4，补全以磁盘IO为主）
+         */
+        explicit ProgramEnricher(size_t threadCount = 0);
+        
+        /**
+         * @brief 析构函数，取消未开始的任务并等待进行中的任务结束
+         */
+        ~ProgramEnricher();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ProgramEnricher);
+        
+        /**
+         * @brief 提交一批程序进行补全，同时取消上一批尚未处理的程序
+         * @param programs 程序列表，只处理NeedsEnrichment为true的程序
+         * @param updateCallback 每补全一个程序调用一次（在工作线程中调用）
+         * @param completedCallback 整批完成后以全部结果调用一次（在工作线程中调用，被取消的批次不调用）
+         * @return size_t 实际排队的程序数量
+         */
+        size_t Submit(const std::vector<ProgramInfo>& programs,
+                      const UpdateCallback& updateCallback,
+                      const CompletedCallback& completedCallback = nullptr);
+        
+        /**
+         * @brief 取消当前批次，正在处理的程序仍可能回调一次
+         */
+        void Cancel();
+        
+        /**
+         * @brief 获取当前批次中尚未完成的程序数量
+         * @return size_t 未完成数量
+         */
+        size_t GetPendingCount() const;
+        
+        /**
+         * @brief 清除路径缓存和目录大小缓存
+         */
+        void ClearCache();
+        
+        /**
+         * @brief 程序是否缺少需要补全的字段
+         * @param programInfo 程序信息
+         * @return bool 是否需要补全
+         */
+        static bool NeedsEnrichment(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 获取程序标识
+         * @param programInfo 程序信息
+         * @return String 程序标识，没有注册表键的程序返回空字符串
+         */
+        static String GetProgramKey(const ProgramInfo& programInfo);
+    
+    private:
+        struct Batch;
+        
+        /**
+         * @brief 路径的文件系统信息
+         */
+        struct PathFacts {
+            bool exists = false;        ///< 路径是否存在
+            DWORD64 fileSize = 0;       ///< 文件大小（目录为0）
+            String creationDate;        ///< 创建日期（YYYYMMDD）
+        };
+        
+        /**
+         * @brief 处理批次中的一个程序
+         * @param batch 批次
+         * @param index 程序序号
+         */
+        void ProcessProgram(const std::shared_ptr<Batch>& batch, size_t index);
+        
+        /**
+         * @brief 统计程序大小（安装目录的实际大小）
+         * @param programInfo 程序信息
+         * @return DWORD64 程序大小（字节），没有安装目录或目录为空、不存在时为0
+         */
+        DWORD64 ResolveSize(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 程序大小是否已确认无法统计
+         * @param programInfo 程序信息
+         * @return bool 是否不必再统计大小
+         */
+        bool IsKnownSizeMiss(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 推断安装日期（卸载程序、安装目录、注册表键、图标文件、名称经验值依次尝试）
+         * @param programInfo 程序信息
+         * @return String 日期字符串（YYYYMMDD）
+         */
+        String ResolveInstallDate(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 推断版本（卸载程序的文件版本资源，按路径缓存）
+         * @param programInfo 程序信息
+         * @return String 版本号，无法读取时为空
+         */
+        String ResolveVersion(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 卸载程序是否已确认没有可用的版本资源
+         * @param programInfo 程序信息
+         * @return bool 是否不必再读取版本
+         */
+        bool IsKnownVersionMiss(const ProgramInfo& programInfo);
+        
+        /**
+         * @brief 读取文件的版本资源
+         * @param filePath 文件路径
+         * @return String 版本号（a.b.c.d），无法读取时为空
+         */
+        static String ReadFileVersion(const String& filePath);
+        
+        /**
+         * @brief 查询路径信息（带缓存）
+         * @param path 文件或目录路径
+         * @return PathFacts 路径信息
+         */
+        PathFacts GetPathFacts(const String& path);
+        
+        /**
+         * @brief 从卸载字符串或图标路径中提取可执行文件路径（去掉引号、参数与图标索引）
+         * @param command 卸载字符串或图标路径
+         * @return String 可执行文件路径
+         */
+        static String ExtractExecutablePath(const String& command);
+        
+        /**
+         * @brief 基于程序名称和版本估算安装日期
+         * @param programInfo 程序信息
+         * @return String 估算的日期字符串（YYYYMMDD）
+         */
+        static String EstimateInstallDateByName(const ProgramInfo& programInfo);
+        
+        std::unique_ptr<ThreadPool> m_pool;                     ///< 补全线程池
+        std::atomic<std::uint64_t> m_generation;                ///< 批次代数，提交或取消时递增
+        std::shared_ptr<Batch> m_currentBatch;                  ///< 当前批次
+        mutable std::mutex m_batchMutex;                        ///< 批次锁
+        
+        std::unordered_map<String, PathFacts> m_pathCache;      ///< 路径信息缓存（键为小写路径）
+        std::unordered_map<String, String> m_versionCache;      ///< 文件版本缓存（键为小写路径，空值表示没有版本资源）
+        std::unordered_set<String> m_sizeMisses;                ///< 统计结果为0的安装目录（小写路径）
+        std::mutex m_cacheMutex;                                ///< 缓存锁
+    };
+
+} // namespace YG
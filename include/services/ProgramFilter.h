@@ -0,0 +1,120 @@
+/**
+ * @file ProgramFilter.h
+ * @brief 在程序表上执行结构化查询
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "services/ProgramTable.h"
+#include "services/ProgramSearchIndex.h"
+#include "services/ProgramQuery.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 一次查询的结果
+     */
+    struct ProgramFilterResult {
+        std::vector<std::uint32_t> rows;    ///< 匹配的行号（升序，即搜索索引的行顺序）
+        size_t candidateCount = 0;          ///< 起始条件给出、逐个校验的候选行数
+        int seedClause = -1;                ///< 用作起始的条件下标，-1表示从全部行开始
+    };
+    
+    /**
+     * @brief 程序过滤器
+     *
+     * 按代价安排查询中各条件的求值顺序：
+     *   - 先估计每个肯定条件匹配的行数：数值区间在按值排序的列上二分查找得到准确行数，
+     *     文本条件取搜索索引中倒排表的长度作为上限
+     *   - 匹配行数最少的条件作为起始，由排序列的区间或搜索索引直接得到候选行
+     *   - 其余条件按每行的校验代价（数值 < 文本相等 < 文本包含）和通过率排序，逐行校验，
+     *     任一条件不满足即跳过该行
+     * 大小、安装日期、版本的排序列在第一次用到时生成并缓存；程序表的文本变化时全部丢弃，
+     * 只有大小、日期变化时只丢弃这两列。
+     */
+    class ProgramFilter {
+    public:
+        ProgramFilter();
+        ~ProgramFilter();
+        
+        /**
+         * @brief 设置程序表及其搜索索引
+         * @param table 程序表
+         * @param index 由该表（或文本相同的表）构建的搜索索引
+         * @param textChanged 文本字段是否可能变化；补全大小和日期生成的新表传false
+         */
+        void SetTable(const ProgramTablePtr& table, const ProgramSearchIndexPtr& index, bool textChanged);
+        
+        /**
+         * @brief 执行查询
+         * @param query 编译后的查询
+         * @return ProgramFilterResult 匹配的行
+         */
+        ProgramFilterResult Execute(const ProgramQuery& query);
+    
+    private:
+        enum NumericColumn {
+            SizeColumn = 0,
+            InstallDateColumn,
+            VersionColumn,
+            NumericColumnCount
+        };
+        
+        /**
+         * @brief 按值排序的数值列
+         */
+        struct SortedColumn {
+            std::vector<std::uint64_t> values;                              ///< 行号 -> 值
+            std::vector<std::pair<std::uint64_t, std::uint32_t>> sorted;    ///< (值, 行号)升序
+            bool valid = false;                                             ///< 是否已生成
+        };
+        
+        /**
+         * @brief 条件的求值计划
+         */
+        struct ClausePlan {
+            size_t clause;          ///< 条件下标
+            size_t estimate;        ///< 条件本身匹配的行数（文本条件为上限）
+            int cost;               ///< 每行校验的相对代价
+            double passRate;        ///< 取反后的预计通过率
+        };
+        
+        /**
+         * @brief 取得数值列（按需生成）
+         */
+        const SortedColumn& GetColumn(NumericColumn column);
+        
+        /**
+         * @brief 排序列中值在[low, high]内的范围
+         */
+        static std::pair<size_t, size_t> FindRange(const SortedColumn& column, std::uint64_t low, std::uint64_t high);
+        
+        /**
+         * @brief 某行是否满足条件（不含取反），数值列须已生成
+         */
+        bool Matches(const ProgramQueryClause& clause, std::uint32_t row) const;
+        
+        /**
+         * @brief 条件作用的数值列
+         */
+        static NumericColumn ToNumericColumn(ProgramQueryField field);
+        
+        /**
+         * @brief 文本条件对应的搜索字段
+         */
+        static unsigned ToSearchFields(ProgramQueryField field);
+        
+        ProgramTablePtr m_table;                            ///< 当前程序表
+        ProgramSearchIndexPtr m_index;                      ///< 当前搜索索引
+        SortedColumn m_columns[NumericColumnCount];         ///< 数值列
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ProgramFilter);
+    };
+
+} // namespace YG
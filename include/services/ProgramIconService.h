@@ -0,0 +1,220 @@
+/**
+ * @file ProgramIconService.h
+ * @brief 程序图标后台解析服务（去重、磁盘缓存、可见行优先）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/DetailedErrorCodes.h"
+#include "services/ProgramTable.h"
+#include "utils/ThreadPool.h"
+#include <commctrl.h>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 图标来源：文件路径与其中的图标序号
+     */
+    struct IconSource {
+        String path;        ///< 展开环境变量、去掉引号后的文件路径
+        int index;          ///< 图标序号（负数表示资源ID）
+        
+        IconSource() : index(0) {}
+        IconSource(const String& iconPath, int iconIndex) : path(iconPath), index(iconIndex) {}
+    };
+    
+    /**
+     * @brief 一次解析完成的图标，投递给界面线程
+     */
+    struct ProgramIconUpdate {
+        std::uint64_t generation;                           ///< 解析时的代数，与当前代数不同的结果应丢弃
+        std::vector<std::pair<ProgramId, int>> icons;       ///< 程序Id -> 图标列表中的索引
+        
+        ProgramIconUpdate() : generation(0) {}
+    };
+    
+    /**
+     * @brief 程序图标服务
+     *
+     * 界面线程只提交请求，图标的查找、提取和加入图标列表都在工作线程中完成，
+     * 完成后通过回调返回图标列表中的索引：
+     *   - 每个程序依次尝试DisplayIcon、卸载程序、按名称猜测的主程序，第一个成功的来源即为其图标
+     *   - 同一来源（路径 + 图标序号）在一代中只提取并加入图标列表一次，多个程序共用同一索引；
+     *     正在提取的来源再被请求时，请求挂在其后等待结果
+     *   - 提取出的图标渲染为位图，按"路径 + 图标序号 + 尺寸"缓存到磁盘，并记录文件的最后写入时间，
+     *     文件未变化时下次启动直接使用缓存的位图，不再读取可执行文件
+     *   - 后提交的请求先处理，可见范围变化时可将对应请求提前，保证当前可见的行最先得到图标
+     * 图标列表被清空或替换时调用Reset进入新的一代，之前的请求和结果全部作废。
+     */
+    class ProgramIconService {
+    public:
+        using ReadyCallback = std::function<void(const ProgramIconUpdate& update)>;
+        
+        /**
+         * @brief 构造函数
+         * @param cachePath 磁盘缓存文件路径，空字符串表示不使用磁盘缓存
+         * @param readyCallback 图标就绪回调（在工作线程中调用）
+         * @param threadCount 工作线程数，0表示使用默认值（不超过2）
+         */
+        ProgramIconService(const String& cachePath, const ReadyCallback& readyCallback, size_t threadCount = 0);
+        
+        /**
+         * @brief 析构函数，丢弃未开始的请求，等待进行中的请求结束后写回磁盘缓存
+         */
+        ~ProgramIconService();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ProgramIconService);
+        
+        /**
+         * @brief 开始新的一代：丢弃全部请求和已分配的索引，并把图标列表截断到默认图标
+         * @param imageList 图标列表，nullptr表示图标列表即将销毁，此后不再向其添加图标
+         * @param defaultIndex 默认图标的索引，所有来源均失败的程序使用该索引
+         * @return std::uint64_t 新的代数
+         */
+        std::uint64_t Reset(HIMAGELIST imageList, int defaultIndex);
+        
+        /**
+         * @brief 获取当前代数
+         * @return std::uint64_t 代数
+         */
+        std::uint64_t GetGeneration() const;
+        
+        /**
+         * @brief 请求解析程序的图标，同一程序在一代中只应请求一次
+         * @param id 程序Id
+         * @param program 程序信息（只使用图标、卸载、安装位置和名称字段）
+         */
+        void Request(ProgramId id, const ProgramInfo& program);
+        
+        /**
+         * @brief 将这些程序尚未处理的请求移到队首
+         * @param ids 当前可见的程序Id
+         */
+        void Prioritize(const std::vector<ProgramId>& ids);
+        
+        /**
+         * @brief 列出程序的图标来源（按优先级），会访问文件系统查找不带目录的可执行文件
+         * @param program 程序信息
+         * @return std::vector<IconSource> 图标来源
+         */
+        static std::vector<IconSource> GetIconSources(const ProgramInfo& program);
+        
+        /**
+         * @brief 解析"路径,序号"形式的图标位置（路径可带引号和环境变量）
+         * @param location 图标位置
+         * @param source 输出图标来源
+         * @return bool 是否得到非空路径
+         */
+        static bool ParseIconLocation(const String& location, IconSource& source);
+        
+        /**
+         * @brief 获取默认磁盘缓存路径（与程序快照同目录）
+         * @return String 缓存文件路径
+         */
+        static String GetDefaultCachePath();
+        
+        static const std::uint32_t CacheMagic = 0x43494759;    ///< "YGIC"
+        static const std::uint16_t CacheSchemaVersion = 1;     ///< 磁盘缓存结构版本
+    
+    private:
+        /**
+         * @brief 一个程序的请求
+         */
+        struct Job {
+            ProgramId id;                       ///< 程序Id
+            std::uint64_t generation;           ///< 提交时的代数
+            ProgramInfo program;                ///< 程序信息
+            std::vector<IconSource> sources;    ///< 图标来源，第一次处理时解析
+            size_t nextSource;                  ///< 下一个要尝试的来源
+            bool sourcesResolved;               ///< 是否已解析来源
+        };
+        
+        /**
+         * @brief 正在提取的来源及等待其结果的请求
+         */
+        struct PendingSource {
+            std::uint64_t generation;           ///< 开始提取时的代数
+            std::vector<Job> waiters;           ///< 等待的请求
+        };
+        
+        /**
+         * @brief 缓存的图标位图
+         */
+        struct CachedIcon {
+            DWORD64 writeTime;                  ///< 提取时文件的最后写入时间
+            int size;                           ///< 图标边长
+            bool found;                         ///< 文件中是否有该图标
+            bool touched;                       ///< 本次运行中是否用到
+            std::vector<std::uint32_t> pixels;  ///< 自上而下的BGRA像素（非预乘）
+        };
+        
+        /**
+         * @brief 线程池任务：取出队首的请求并处理
+         */
+        void ProcessNext();
+        
+        /**
+         * @brief 依次尝试请求的各个来源
+         */
+        void ProcessJob(Job job);
+        
+        /**
+         * @brief 取得来源的图标并加入图标列表
+         * @return int 图标列表中的索引，失败时为-1
+         */
+        int ResolveSource(const IconSource& source, const String& sourceKey, std::uint64_t generation);
+        
+        /**
+         * @brief 提交一个线程池任务（调用方持有m_mutex）
+         */
+        void ScheduleLocked();
+        
+        /**
+         * @brief 通过回调返回结果
+         */
+        void Notify(std::uint64_t generation, const std::vector<ProgramId>& ids, int imageIndex);
+        
+        /**
+         * @brief 读取磁盘缓存（只执行一次）
+         */
+        void LoadCache();
+        
+        /**
+         * @brief 写回磁盘缓存
+         * @return ErrorContext 操作结果
+         */
+        ErrorContext SaveCache();
+        
+        String m_cachePath;                                     ///< 磁盘缓存文件路径
+        ReadyCallback m_readyCallback;                          ///< 图标就绪回调
+        std::unique_ptr<ThreadPool> m_pool;                     ///< 解析线程池
+        
+        mutable std::mutex m_mutex;                             ///< 保护以下全部成员以及图标列表的修改
+        std::uint64_t m_generation;                             ///< 当前代数
+        HIMAGELIST m_imageList;                                 ///< 图标列表
+        int m_defaultIndex;                                     ///< 默认图标索引
+        int m_iconSize;                                         ///< 图标列表的图标边长
+        std::deque<Job> m_queue;                                ///< 待处理请求，队首优先
+        std::unordered_map<String, int> m_sourceIndices;        ///< 来源键 -> 本代的图标索引（-1表示失败）
+        std::unordered_map<String, PendingSource> m_pending;    ///< 来源键 -> 正在提取的来源
+        std::unordered_map<String, CachedIcon> m_iconCache;     ///< 缓存键 -> 图标位图
+        bool m_cacheDirty;                                      ///< 缓存是否有未写回的变化
+        size_t m_activeCount;                                   ///< 正在处理的请求数
+        ULONGLONG m_lastSaveTick;                               ///< 上次写回磁盘缓存的时间
+        
+        std::mutex m_loadMutex;                                 ///< 读取磁盘缓存的锁
+        bool m_cacheLoaded;                                     ///< 是否已读取磁盘缓存（由m_loadMutex保护）
+    };
+
+} // namespace YG
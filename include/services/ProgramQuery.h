@@ -0,0 +1,117 @@
+/**
+ * @file ProgramQuery.h
+ * @brief 程序列表的结构化查询（解析与编译）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/DetailedErrorCodes.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 查询条件作用的列
+     */
+    enum ProgramQueryField {
+        QueryFieldText = 0,         ///< 名称、发布者、版本任一（不带字段名的词）
+        QueryFieldName,             ///< 名称
+        QueryFieldPublisher,        ///< 发布者
+        QueryFieldVersion,          ///< 版本
+        QueryFieldSize,             ///< 大小（字节）
+        QueryFieldInstallDate       ///< 安装日期（YYYYMMDD）
+    };
+    
+    /**
+     * @brief 查询条件的比较方式
+     */
+    enum ProgramQueryOp {
+        QueryOpContains = 0,        ///< 文本包含
+        QueryOpEquals,              ///< 文本相等
+        QueryOpRange                ///< 数值在闭区间[low, high]内
+    };
+    
+    /**
+     * @brief 编译后的一个查询条件
+     */
+    struct ProgramQueryClause {
+        ProgramQueryField field = QueryFieldText;   ///< 作用的列
+        ProgramQueryOp op = QueryOpContains;        ///< 比较方式
+        bool negated = false;                       ///< 是否取反（"-"前缀）
+        String text;                                ///< 小写的文本（QueryOpContains、QueryOpEquals）
+        std::uint64_t low = 0;                      ///< 区间下界（QueryOpRange）
+        std::uint64_t high = 0;                     ///< 区间上界（QueryOpRange）
+    };
+    
+    /**
+     * @brief 结构化查询
+     *
+     * 查询由空白分隔的条件组成，全部条件同时满足才匹配，例如：
+     *   publisher:microsoft size>500MB installed<2023-01-01 -version:beta
+     *   - 字段：name(title)、publisher(pub)、version(ver)、size、installed(date)
+     *   - "字段:值"对文本字段表示包含，"字段=值"表示相等，均不区分大小写
+     *   - size、installed以及version支持 > >= < <=；size、installed的":"和"="表示等于，
+     *     日期可只写年或年月（installed:2023 即2023年内）
+     *   - 大小可带单位B、KB、MB、GB、TB（按1024换算），可有小数
+     *   - "-"前缀表示取反；含空白的值用双引号括起
+     *   - 不带字段名的词在名称、发布者、版本中查找，未知的字段名按普通的词处理
+     * 数值比较只匹配已知大小、日期的程序；值尚未输入完的条件（如"size>"）被忽略，
+     * 便于边输入边过滤。
+     *
+     * 查询编译一次后为一组类型化的条件，由ProgramFilter在程序表上求值。
+     */
+    class ProgramQuery {
+    public:
+        ProgramQuery();
+        
+        /**
+         * @brief 编译查询
+         * @param text 查询文本
+         * @param query 输出编译结果
+         * @return ErrorContext 操作结果，值无法解析时为ParameterFormatInvalid
+         */
+        static ErrorContext Compile(const String& text, ProgramQuery& query);
+        
+        /**
+         * @brief 是否用到了字段或取反；否则与普通的关键词搜索相同
+         */
+        bool IsStructured() const { return m_structured; }
+        
+        /**
+         * @brief 是否没有任何条件
+         */
+        bool IsEmpty() const { return m_clauses.empty(); }
+        
+        /**
+         * @brief 编译后的条件，按书写顺序
+         */
+        const std::vector<ProgramQueryClause>& GetClauses() const { return m_clauses; }
+        
+        /**
+         * @brief 解析带单位的大小
+         * @param text 如"500MB"、"1.5GB"、"4096"
+         * @param bytes 输出字节数
+         * @return bool 是否解析成功
+         */
+        static bool ParseSize(const String& text, std::uint64_t& bytes);
+        
+        /**
+         * @brief 解析完整或部分日期为YYYYMMDD闭区间
+         * @param text 如"2023-01-01"、"2023-01"、"2023"
+         * @param low 输出区间下界
+         * @param high 输出区间上界
+         * @return bool 是否解析成功
+         */
+        static bool ParseDateRange(const String& text, std::uint32_t& low, std::uint32_t& high);
+    
+    private:
+        std::vector<ProgramQueryClause> m_clauses;  ///< 条件
+        bool m_structured;                          ///< 是否用到了字段或取反
+    };
+
+} // namespace YG
@@ -0,0 +1,198 @@
+/**
+ * @file ProgramSearchIndex.h
+ * @brief 程序表的搜索索引（小写字段缓冲区 + n元组倒排表）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "services/ProgramTable.h"
+#include "services/FuzzyMatcher.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
+namespace YG {
+    
+    class ProgramSearchIndex;
+    using ProgramSearchIndexPtr = std::shared_ptr<const ProgramSearchIndex>;
+    
+    /**
+     * @brief 参与搜索的字段（可组合）
+     */
+    enum SearchField : unsigned {
+        SearchFieldTitle        = 1 << 0,   ///< 显示名称（displayName为空时为name）
+        SearchFieldPublisher    = 1 << 1,   ///< 发布者
+        SearchFieldVersion      = 1 << 2,   ///< 版本
+        SearchFieldAll          = SearchFieldTitle | SearchFieldPublisher | SearchFieldVersion
+    };
+    
+    /**
+     * @brief 一次搜索的结果，可作为下一次搜索的起点
+     */
+    struct ProgramSearchResult {
+        String foldedKeyword;               ///< 小写的关键词，为空表示没有进行过搜索
+        unsigned fields = SearchFieldAll;   ///< 搜索的字段
+        std::vector<std::uint32_t> rows;    ///< 匹配的行号（升序，即程序表GetIds的顺序）
+        bool narrowed = false;              ///< 是否在上一次结果上缩小得到
+        size_t candidateCount = 0;          ///< 逐个校验的候选行数
+    };
+    
+    /**
+     * @brief 模糊搜索的一个匹配
+     */
+    struct FuzzySearchMatch {
+        std::uint32_t row;                  ///< 行号
+        int score;                          ///< 评分
+    };
+    
+    /**
+     * @brief 模糊搜索结果
+     */
+    struct FuzzySearchResult {
+        std::vector<FuzzySearchMatch> matches;  ///< 评分最高的匹配，按评分从高到低
+        size_t totalMatches = 0;                ///< 匹配总数（可能多于matches）
+        size_t candidateCount = 0;              ///< 通过字符掩码预筛、参与评分的行数
+    };
+    
+    /**
+     * @brief 程序搜索索引
+     *
+     * 由一张程序表构建一次，之后只读，可与程序表一起在刷新之间共享：
+     *   - 名称、发布者、版本预先转为小写，依次存放在一块字符缓冲区中，搜索时不再逐个转换
+     *   - 字段中每个位置起1~3个连续字符各建立一个倒排表：不超过3个字符的关键词直接取倒排表，
+     *     更长的关键词先求各三元组行集合的交集，只对交集中的行做子串校验
+     *   - 新关键词包含上一次的关键词时（例如继续输入），在上一次的结果中缩小，不再从头搜索
+     *
+     * 模糊搜索使用同一份小写字段，另外保存各字符在原文中的位置类别（单词开头、大小写转换）
+     * 和每行名称与发布者的字符掩码，掩码预筛后只对可能匹配的行评分。
+     *
+     * 补全大小和日期不改变文本字段，补全生成的新程序表可继续使用原来的索引。
+     */
+    class ProgramSearchIndex {
+    public:
+        /**
+         * @brief 由程序表构建索引，行号与table.GetIds()的下标对应
+         * @param table 程序表
+         * @return ProgramSearchIndexPtr 搜索索引
+         */
+        static ProgramSearchIndexPtr Build(const ProgramTable& table);
+        
+        /**
+         * @brief 搜索包含关键词（不区分大小写）的程序
+         * @param keyword 关键词，为空时返回全部行
+         * @param fields 搜索的字段（SearchField位组合）
+         * @param previous 同一索引上一次的搜索结果，可为nullptr
+         * @return ProgramSearchResult 搜索结果
+         */
+        ProgramSearchResult Search(const String& keyword, unsigned fields = SearchFieldAll,
+                                   const ProgramSearchResult* previous = nullptr) const;
+        
+        /**
+         * @brief 模糊搜索名称和发布者
+         *
+         * 关键词的字符按顺序出现即匹配，按FuzzyMatcher的评分排序；只匹配到发布者的评分降低。
+         * @param keyword 关键词，空白被忽略
+         * @param maxResults 最多返回的匹配数，只对这部分做排序
+         * @return FuzzySearchResult 搜索结果
+         */
+        FuzzySearchResult FuzzySearch(const String& keyword, size_t maxResults) const;
+        
+        /**
+         * @brief 某行的字段是否包含小写关键词
+         * @param row 行号
+         * @param foldedKeyword 已经过Fold的关键词
+         * @param fields 查找的字段（SearchField位组合）
+         * @return bool 是否包含
+         */
+        bool RowMatches(std::uint32_t row, const String& foldedKeyword, unsigned fields) const;
+        
+        /**
+         * @brief 估算包含小写关键词的行数上限（关键词各索引项中最短的倒排表长度），只做二分查找
+         * @param foldedKeyword 已经过Fold的关键词，为空时返回行数
+         * @return size_t 匹配行数的上限
+         */
+        size_t EstimateMatches(const String& foldedKeyword) const;
+        
+        /**
+         * @brief 行数
+         */
+        size_t GetRowCount() const { return m_ids.size(); }
+        
+        /**
+         * @brief 行号对应的程序Id
+         */
+        ProgramId GetId(std::uint32_t row) const { return m_ids[row]; }
+        
+        /**
+         * @brief 将行号列表转换为程序Id列表
+         * @param rows 行号
+         * @return std::vector<ProgramId> 程序Id
+         */
+        std::vector<ProgramId> ToIds(const std::vector<std::uint32_t>& rows) const;
+        
+        // 小写的字段内容；返回的视图在索引的生命周期内有效
+        std::wstring_view GetFoldedTitle(std::uint32_t row) const { return Field(row, TitleColumn); }
+        std::wstring_view GetFoldedPublisher(std::uint32_t row) const { return Field(row, PublisherColumn); }
+        std::wstring_view GetFoldedVersion(std::uint32_t row) const { return Field(row, VersionColumn); }
+        
+        /**
+         * @brief 索引项数量（不同的1~3元组个数）
+         */
+        size_t GetGramCount() const { return m_gramKeys.size(); }
+        
+        /**
+         * @brief 估算占用的内存（字节）
+         * @return size_t 字节数
+         */
+        size_t GetMemoryUsage() const;
+        
+        /**
+         * @brief 转为小写，与索引中字段的转换方式一致
+         * @param text 文本
+         * @return String 小写文本
+         */
+        static String Fold(const String& text);
+    
+    private:
+        enum Column : std::uint32_t {
+            TitleColumn = 0,
+            PublisherColumn,
+            VersionColumn,
+            ColumnCount
+        };
+        
+        ProgramSearchIndex();
+        
+        std::wstring_view Field(std::uint32_t row, Column column) const {
+            size_t slot = static_cast<size_t>(row) * ColumnCount + column;
+            // 每个字段以'\0'结尾，长度不含结尾符
+            return std::wstring_view(&m_chars[m_fieldOffsets[slot]], m_fieldOffsets[slot + 1] - m_fieldOffsets[slot] - 1);
+        }
+        
+        /**
+         * @brief 查找索引项的倒排表
+         * @return 倒排表范围，不存在时first == second
+         */
+        std::pair<const std::uint32_t*, const std::uint32_t*> FindPostings(std::uint64_t gram) const;
+        
+        /**
+         * @brief 将1~3个字符编码为索引项
+         */
+        static std::uint64_t MakeGram(const wchar_t* text, size_t length);
+        
+        std::vector<ProgramId> m_ids;                   ///< 行号 -> 程序Id
+        std::vector<wchar_t> m_chars;                   ///< 小写字段，每个以'\0'结尾
+        std::vector<std::uint8_t> m_charClasses;        ///< 与m_chars对应的FuzzyCharClass
+        std::vector<std::uint64_t> m_fuzzyMasks;        ///< 各行名称与发布者的字符掩码
+        std::vector<std::uint32_t> m_fieldOffsets;      ///< 行号 * ColumnCount + 列 -> m_chars中的偏移（多一个结尾项）
+        std::vector<std::uint64_t> m_gramKeys;          ///< 升序排列的索引项
+        std::vector<std::uint32_t> m_postingOffsets;    ///< 索引项下标 -> m_postings中的起始位置（多一个结尾项）
+        std::vector<std::uint32_t> m_postings;          ///< 各索引项出现的行号（升序）
+    };
+
+} // namespace YG
@@ -0,0 +1,73 @@
+/**
+ * @file ProgramSnapshot.h
+ * @brief 程序清单的磁盘快照（版本化二进制格式，可内存映射读取）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/DetailedErrorCodes.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 从快照文件读取出的数据
+     */
+    struct ProgramSnapshotData {
+        std::vector<ProgramInfo> programs;      ///< 程序列表
+        bool includeSystemComponents;           ///< 写入时是否包含系统组件
+        DWORD scanDuration;                     ///< 写入时的扫描耗时(毫秒)
+        DWORD64 createdTime;                    ///< 写入时间(FILETIME)
+        
+        ProgramSnapshotData() : includeSystemComponents(false), scanDuration(0), createdTime(0) {}
+    };
+    
+    /**
+     * @brief 程序清单快照读写
+     *
+     * 文件布局（小端）：
+     *   - 固定长度文件头：魔数、结构版本、各段偏移与长度、负载校验和
+     *   - 字符串表：去重后的字符串，每项为uint32长度前缀 + UTF-16代码单元，按4字节对齐
+     *   - 记录段：定长的ProgramInfo记录，字符串字段保存为字符串表内的偏移
+     *
+     * 读取时整个文件以只读方式映射，校验文件头与校验和后再解码；
+     * 结构版本不符、长度越界或校验失败均视为无效快照，调用方应回退到正常扫描。
+     * 写入先落到临时文件，完成后再替换目标文件，避免留下半截快照。
+     */
+    class ProgramSnapshot {
+    public:
+        static const std::uint32_t Magic = 0x53504759;     ///< "YGPS"
+        static const std::uint16_t SchemaVersion = 1;      ///< 当前结构版本
+        
+        /**
+         * @brief 写入快照
+         * @param filePath 快照文件路径
+         * @param programs 程序列表
+         * @param includeSystemComponents 是否包含系统组件
+         * @param scanDuration 扫描耗时(毫秒)
+         * @return ErrorContext 操作结果
+         */
+        static ErrorContext Save(const String& filePath, const std::vector<ProgramInfo>& programs,
+                                 bool includeSystemComponents, DWORD scanDuration);
+        
+        /**
+         * @brief 读取快照
+         * @param filePath 快照文件路径
+         * @param data 输出快照数据
+         * @return ErrorContext 操作结果，文件损坏或版本不符时返回FileCorrupted/ConfigVersionMismatch
+         */
+        static ErrorContext Load(const String& filePath, ProgramSnapshotData& data);
+        
+        /**
+         * @brief 获取默认快照路径（与配置文件同目录）
+         * @return String 快照文件路径
+         */
+        static String GetDefaultPath();
+    };
+
+} // namespace YG
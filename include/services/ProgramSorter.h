@@ -0,0 +1,103 @@
+/**
+ * @file ProgramSorter.h
+ * @brief 基于预计算排序键的程序列表排序
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "services/ProgramTable.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 排序列，与主列表的列顺序一致
+     */
+    enum ProgramSortColumn {
+        SortByName = 0,         ///< 程序名称
+        SortByVersion,          ///< 版本
+        SortByPublisher,        ///< 发布者
+        SortBySize,             ///< 大小
+        SortByInstallDate,      ///< 安装日期
+        SortColumnCount
+    };
+    
+    /**
+     * @brief 程序列表排序器
+     *
+     * 每列的排序键按程序Id预先计算为64位整数，排序时只比较整数：
+     *   - 名称、发布者：不区分大小写的字符串在全表中的名次
+     *   - 版本：按数字分段打包（"10.0" > "9.1"），分段相同时再按文本的名次
+     *   - 大小：字节数；安装日期：YYYYMMDD数值，无法识别的日期为0
+     * 排序键在第一次按该列排序时计算并缓存，程序表的文本变化时全部丢弃，只有大小、日期变化时
+     * 只丢弃这两列。
+     *
+     * 排序是稳定的，依次点击多列即得到多关键字排序。对同一列再次排序且列表未变时，
+     * 不重新排序，而是把上次的结果反转（相等的程序保持原来的相对顺序）。
+     */
+    class ProgramSorter {
+    public:
+        ProgramSorter();
+        ~ProgramSorter();
+        
+        /**
+         * @brief 设置程序表
+         * @param table 程序表
+         * @param textChanged 文本字段是否可能变化；补全大小和日期生成的新表传false
+         */
+        void SetTable(const ProgramTablePtr& table, bool textChanged);
+        
+        /**
+         * @brief 稳定排序程序Id列表
+         * @param ids 程序Id列表，原地重排
+         * @param column 排序列
+         * @param ascending 是否升序
+         * @return bool 是否通过反转上次的结果完成
+         */
+        bool Sort(std::vector<ProgramId>& ids, ProgramSortColumn column, bool ascending);
+        
+        /**
+         * @brief 解析版本号为可比较的数值（最多4段，每段16位）
+         * @param version 版本号
+         * @return std::uint64_t 打包后的版本
+         */
+        static std::uint64_t PackVersion(const String& version);
+        
+        /**
+         * @brief 解析安装日期为YYYYMMDD数值
+         *
+         * 支持"20240918"、"2024-09-18"、"2024/9/18"以及"9/18/2024"等格式。
+         * @param date 安装日期
+         * @return std::uint32_t 日期数值，无法识别时为0
+         */
+        static std::uint32_t PackDate(const String& date);
+    
+    private:
+        /**
+         * @brief 取得某列的排序键（按需计算）
+         */
+        const std::vector<std::uint64_t>& GetKeys(ProgramSortColumn column);
+        
+        /**
+         * @brief 计算文本列的名次键
+         */
+        void BuildTextKeys(ProgramSortColumn column, std::vector<std::uint64_t>& keys) const;
+        
+        ProgramTablePtr m_table;                                ///< 当前程序表
+        std::vector<std::uint64_t> m_keys[SortColumnCount];     ///< 各列的排序键（按程序Id）
+        bool m_keysValid[SortColumnCount];                      ///< 排序键是否已计算
+        
+        // 上一次排序的结果，用于同列再次排序时反转
+        std::vector<ProgramId> m_lastOrder;                     ///< 上次排序后的Id顺序
+        int m_lastColumn;                                       ///< 上次排序列，-1表示无
+        bool m_lastAscending;                                   ///< 上次是否升序
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ProgramSorter);
+    };
+
+} // namespace YG
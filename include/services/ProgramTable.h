@@ -0,0 +1,189 @@
+/**
+ * @file ProgramTable.h
+ * @brief 列式存储的只读程序表（字符串驻留，可共享快照）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "services/ProgramEnricher.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 程序行标识（32位）
+     */
+    using ProgramId = std::uint32_t;
+    
+    const ProgramId InvalidProgramId = 0xFFFFFFFFu;     ///< 无效的程序标识
+    
+    class ProgramTable;
+    using ProgramTablePtr = std::shared_ptr<const ProgramTable>;
+    
+    /**
+     * @brief 程序表
+     *
+     * 以列的形式保存程序列表，代替多处复制的std::vector<ProgramInfo>：
+     *   - 所有字符串存放在一块以'\0'分隔的字符缓冲区中，相同的字符串只保存一次；
+     *     路径类字段（安装位置、卸载命令、图标、注册表键）拆为"目录前缀 + 末段"分别驻留，
+     *     同一发布者目录、同一卸载根键下的程序共享前缀
+     *   - 每行以32位ProgramId寻址；以上一张表为基础构建时，同一程序（注册表键相同）沿用原来的Id，
+     *     界面的选择、补全结果等可以跨刷新按Id对应
+     *   - 表创建后不可修改，以shared_ptr<const ProgramTable>在线程间共享；补全大小和日期时
+     *     生成新表，只复制数值列，字符串部分与原表共享
+     *
+     * 已移除程序的Id不会分配给其他程序，对应的行标记为无效；无效行超过有效行时下次构建重新编号。
+     */
+    class ProgramTable {
+    public:
+        /**
+         * @brief 由程序列表构建程序表
+         * @param programs 程序列表（行的顺序即GetIds的顺序）
+         * @param previous 上一张程序表，用于沿用程序Id，可为nullptr
+         * @return ProgramTablePtr 新的程序表
+         */
+        static ProgramTablePtr Build(const std::vector<ProgramInfo>& programs, const ProgramTablePtr& previous = nullptr);
+        
+        /**
+         * @brief 创建空表
+         * @return ProgramTablePtr 空程序表
+         */
+        static ProgramTablePtr Empty();
+        
+        /**
+         * @brief 应用补全结果，生成新表
+         *
+         * 按程序标识和注册表写入时间匹配行，过时的结果被忽略；没有可应用的结果时返回nullptr。
+         * 新表中各行的Id与行序与本表相同。
+         * @param updates 补全结果
+         * @return ProgramTablePtr 新的程序表，或nullptr
+         */
+        ProgramTablePtr WithEnrichment(const std::vector<ProgramEnrichmentUpdate>& updates) const;
+        
+        /**
+         * @brief 有效程序的Id，按构建时的程序顺序
+         */
+        const std::vector<ProgramId>& GetIds() const { return m_ids; }
+        
+        /**
+         * @brief 有效程序数量
+         */
+        size_t GetCount() const { return m_ids.size(); }
+        
+        /**
+         * @brief Id的取值范围（含无效行），可用于按Id建立的辅助数组
+         */
+        size_t GetSlotCount() const { return m_flags.size(); }
+        
+        /**
+         * @brief 检查Id是否对应有效程序
+         */
+        bool IsValid(ProgramId id) const { return id < m_flags.size() && (m_flags[id] & RowLive) != 0; }
+        
+        /**
+         * @brief 按程序标识（注册表键路径）查找
+         * @param registryKey 注册表键路径
+         * @return ProgramId 程序Id，不存在时为InvalidProgramId
+         */
+        ProgramId FindByKey(const String& registryKey) const;
+        
+        // 字符串字段；返回的指针在表的生命周期内有效
+        const wchar_t* GetName(ProgramId id) const;
+        const wchar_t* GetDisplayName(ProgramId id) const;
+        const wchar_t* GetVersion(ProgramId id) const;
+        const wchar_t* GetPublisher(ProgramId id) const;
+        
+        /**
+         * @brief 列表中显示的名称：displayName为空时使用name
+         */
+        const wchar_t* GetTitle(ProgramId id) const;
+        
+        // 需要拼接的字段
+        String GetInstallDate(ProgramId id) const;
+        String GetInstallLocation(ProgramId id) const;
+        String GetUninstallString(ProgramId id) const;
+        String GetIconPath(ProgramId id) const;
+        String GetRegistryKey(ProgramId id) const;
+        
+        // 数值字段
+        DWORD64 GetEstimatedSize(ProgramId id) const { return m_estimatedSize[id]; }
+        DWORD64 GetRegistryWriteTime(ProgramId id) const { return m_registryWriteTime[id]; }
+        bool IsSystemComponent(ProgramId id) const { return (m_flags[id] & RowSystemComponent) != 0; }
+        
+        /**
+         * @brief 还原单个程序的ProgramInfo
+         * @param id 程序Id
+         * @return ProgramInfo 程序信息
+         */
+        ProgramInfo GetProgram(ProgramId id) const;
+        
+        /**
+         * @brief 还原全部有效程序，按GetIds的顺序
+         * @return std::vector<ProgramInfo> 程序列表
+         */
+        std::vector<ProgramInfo> ToVector() const;
+        
+        /**
+         * @brief 估算占用的内存（字节），共享的字符串部分计入每张表
+         * @return size_t 字节数
+         */
+        size_t GetMemoryUsage() const;
+    
+    private:
+        /**
+         * @brief 路径类字段：目录前缀与末段分别为字符串编号
+         */
+        struct PathRef {
+            std::uint32_t prefix;
+            std::uint32_t leaf;
+        };
+        
+        /**
+         * @brief 字符串部分，构建后不再修改，由派生的表共享
+         */
+        struct TextColumns {
+            std::vector<wchar_t> chars;                 ///< 以'\0'结尾依次存放的字符串，编号0为空串
+            std::vector<std::uint32_t> offsets;         ///< 字符串编号 -> chars中的偏移
+            
+            std::vector<std::uint32_t> name;            ///< 各行的字符串编号
+            std::vector<std::uint32_t> displayName;
+            std::vector<std::uint32_t> version;
+            std::vector<std::uint32_t> publisher;
+            std::vector<PathRef> installLocation;
+            std::vector<PathRef> uninstallString;
+            std::vector<PathRef> iconPath;
+            std::vector<PathRef> registryKey;
+            
+            std::vector<std::pair<std::uint64_t, ProgramId>> keyIndex;  ///< 按哈希排序的程序标识索引
+            
+            const wchar_t* Text(std::uint32_t stringId) const { return &chars[offsets[stringId]]; }
+            String Path(const PathRef& path) const;
+        };
+        
+        enum RowFlag : std::uint8_t {
+            RowLive             = 1 << 0,   ///< 有效行
+            RowSystemComponent  = 1 << 1    ///< 系统组件
+        };
+        
+        // 安装日期列：0为空，8位数字日期直接保存为YYYYMMDD数值，其他格式保存字符串编号并置最高位
+        static const std::uint32_t DateStringFlag = 0x80000000u;
+        
+        class Builder;
+        
+        ProgramTable();
+        
+        std::shared_ptr<const TextColumns> m_text;      ///< 字符串部分（共享）
+        std::vector<DWORD64> m_estimatedSize;           ///< 估计大小（字节）
+        std::vector<DWORD64> m_registryWriteTime;       ///< 注册表键写入时间
+        std::vector<std::uint32_t> m_installDate;       ///< 安装日期
+        std::vector<std::uint8_t> m_flags;              ///< RowFlag位组合
+        std::vector<ProgramId> m_ids;                   ///< 有效程序Id（构建顺序）
+    };
+
+} // namespace YG
@@ -0,0 +1,251 @@
+/**
+ * @file QuarantineStore.h
+ * @brief 残留项隔离区（同卷改名 + 撤销日志）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/ResidualItem.h"
+#include "utils/FileSystemSource.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 隔离的注册表值
+     */
+    struct QuarantineRegistryValue {
+        String name;                    ///< 值名称
+        DWORD type = REG_NONE;          ///< 值类型
+        std::vector<BYTE> data;         ///< 值数据
+    };
+    
+    /**
+     * @brief 隔离的注册表键
+     */
+    struct QuarantineRegistryKey {
+        String relativePath;                            ///< 相对于残留项键的路径，空表示残留项键本身
+        std::vector<QuarantineRegistryValue> values;    ///< 键中的值
+    };
+    
+    /**
+     * @brief 隔离的一个残留项
+     */
+    struct QuarantineEntry {
+        ResidualType type = ResidualType::File;         ///< 残留类型
+        String originalPath;                            ///< 原路径（文件、目录、注册表键，或"键路径\\值名称"）
+        String name;                                    ///< 名称（注册表值为值名称）
+        String storedPath;                              ///< 隔离后的路径（注册表项为空）
+        DWORD64 size = 0;                               ///< 大小（字节）
+        std::vector<QuarantineRegistryKey> registryKeys;///< 注册表项删除前的内容，父键在子键之前
+    };
+    
+    /**
+     * @brief 一次隔离操作（批次）
+     */
+    struct QuarantineBatch {
+        String id;                              ///< 批次编号（隔离目录名和日志文件名）
+        String label;                           ///< 说明（通常为程序名称）
+        DWORD64 createdTime = 0;                ///< 创建时间(FILETIME)
+        std::vector<QuarantineEntry> entries;   ///< 隔离的残留项
+        
+        /**
+         * @brief 全部残留项的大小之和
+         */
+        DWORD64 GetTotalSize() const;
+    };
+    
+    /**
+     * @brief 隔离区保留策略
+     */
+    struct QuarantineRetention {
+        DWORD maxAgeDays = 7;           ///< 批次保留天数，0表示不按时间清理
+        DWORD64 maxTotalBytes = 0;      ///< 隔离区总大小上限，超出时清理较旧的批次（最新的批次总是保留），0表示不限
+    };
+    
+    /**
+     * @brief 残留项隔离区
+     *
+     * 文件和目录不复制，而是改名移入所在卷根目录下的隐藏目录"$YGQuarantine\\<批次编号>"，
+     * 同卷改名与目录树大小无关，全部改名完成即可返回；不能改名的项（例如正在使用）报告失败，原样保留。
+     * 注册表键（含整棵子树）和值在删除前序列化到批次日志中，日志写入失败时不做任何改动。
+     * 每个批次一个日志文件（紧凑的二进制格式，带校验和），记录原路径和隔离后的路径：
+     *   - Restore按隔离的逆序把文件改名移回原处、按日志重建注册表项，原路径已被占用的项保留在隔离区
+     *   - Purge按保留策略永久删除过期的批次，删除由ResidualDeleter完成，可在后台线程中定期执行
+     * 隔离、恢复和清理互斥执行。
+     */
+    class QuarantineStore {
+    public:
+        static const std::uint32_t Magic = 0x4A514759;     ///< "YGQJ"
+        static const std::uint16_t SchemaVersion = 1;      ///< 当前日志结构版本
+        
+        /**
+         * @brief 构造函数
+         * @param journalDirectory 批次日志所在目录，不存在时自动创建
+         * @param fileSystem 文件系统数据源，为空时使用Win32FileSystemSource
+         */
+        explicit QuarantineStore(const String& journalDirectory, std::shared_ptr<IFileSystemSource> fileSystem = nullptr);
+        
+        ~QuarantineStore();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(QuarantineStore);
+        
+        /**
+         * @brief 隔离残留项
+         * @param items 残留项
+         * @param label 批次说明
+         * @param callback 进度回调，可为空；在调用线程中执行，失败项逐个报告
+         * @param batch 输出批次（只含隔离成功的项）
+         * @return ErrorCode 全部成功时返回Success，日志无法写入时返回AccessDenied，否则返回GeneralError
+         */
+        ErrorCode Quarantine(const std::vector<ResidualItem>& items, const String& label,
+                             const DeleteProgressCallback& callback, QuarantineBatch& batch);
+        
+        /**
+         * @brief 恢复批次
+         * @param batchId 批次编号
+         * @param restoredCount 输出恢复的项数
+         * @return ErrorCode 全部恢复时返回Success（批次随即移除），批次不存在时返回DataNotFound，否则返回GeneralError
+         */
+        ErrorCode Restore(const String& batchId, size_t& restoredCount);
+        
+        /**
+         * @brief 永久删除批次
+         * @param batchId 批次编号
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode Discard(const String& batchId);
+        
+        /**
+         * @brief 列出隔离区中的批次
+         * @param batches 输出批次，按创建时间从新到旧
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode ListBatches(std::vector<QuarantineBatch>& batches);
+        
+        /**
+         * @brief 按保留策略清理批次
+         * @param retention 保留策略
+         * @param purgedCount 输出清理的批次数
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode Purge(const QuarantineRetention& retention, size_t& purgedCount);
+        
+        /**
+         * @brief 启动后台清理线程：立即清理一次，之后定期清理
+         * @param retention 保留策略
+         */
+        void StartBackgroundPurge(const QuarantineRetention& retention);
+        
+        /**
+         * @brief 停止后台清理线程
+         */
+        void StopBackgroundPurge();
+        
+        /**
+         * @brief 编码批次日志
+         * @param batch 批次
+         * @return std::vector<BYTE> 日志内容
+         */
+        static std::vector<BYTE> EncodeJournal(const QuarantineBatch& batch);
+        
+        /**
+         * @brief 解码批次日志
+         * @param data 日志内容
+         * @param batch 输出批次
+         * @return bool 格式、版本和校验和是否有效
+         */
+        static bool DecodeJournal(const std::vector<BYTE>& data, QuarantineBatch& batch);
+        
+        /**
+         * @brief 获取默认的日志目录（与程序快照同目录下的Quarantine）
+         * @return String 目录路径
+         */
+        static String GetDefaultJournalDirectory();
+        
+        /**
+         * @brief 获取进程内共享的隔离区（Win32文件系统，默认日志目录）
+         * @return QuarantineStore& 共享隔离区
+         */
+        static QuarantineStore& GetShared();
+    
+    private:
+        /**
+         * @brief 批次日志路径
+         */
+        String GetJournalPath(const String& batchId) const;
+        
+        /**
+         * @brief 批次在卷上的隔离目录
+         */
+        static String GetBatchDirectory(const String& volume, const String& batchId);
+        
+        /**
+         * @brief 逐级创建目录
+         * @param path 目录路径
+         * @param createdDirectories 输出新建的目录（小写），可为nullptr
+         * @return DWORD Win32错误码，已存在时为ERROR_SUCCESS
+         */
+        DWORD EnsureDirectory(const String& path, std::vector<String>* createdDirectories = nullptr);
+        
+        /**
+         * @brief 目录是否为本次恢复中补建的目录
+         */
+        static bool IsCreatedDirectory(const std::vector<String>& createdDirectories, const String& path);
+        
+        /**
+         * @brief 把隔离的目录合并到恢复时补建的同名目录中
+         * @param fromPath 隔离后的目录
+         * @param toPath 原位置上补建的目录
+         * @param createdDirectories 本次恢复中补建的目录
+         * @return DWORD Win32错误码，子项与非补建的项重名时返回ERROR_ALREADY_EXISTS
+         */
+        DWORD MergeDirectory(const String& fromPath, const String& toPath, std::vector<String>& createdDirectories);
+        
+        /**
+         * @brief 写入批次日志（先写临时文件再改名）；批次为空时删除日志
+         */
+        ErrorCode SaveJournal(const QuarantineBatch& batch);
+        
+        /**
+         * @brief 读取批次日志
+         */
+        ErrorCode LoadJournal(const String& batchId, QuarantineBatch& batch);
+        
+        /**
+         * @brief 删除批次在各卷上已不再使用的空隔离目录
+         * @param batch 批次（只含保留的项）
+         * @param volumes 批次创建过隔离目录的卷
+         */
+        void RemoveEmptyBatchDirectories(const QuarantineBatch& batch, const std::vector<String>& volumes);
+        
+        /**
+         * @brief 删除批次的隔离目录和日志（调用方需持有m_mutex）
+         */
+        ErrorCode DiscardBatch(const QuarantineBatch& batch);
+        
+        /**
+         * @brief 后台清理线程主循环
+         */
+        void PurgeLoop(QuarantineRetention retention);
+        
+        std::shared_ptr<IFileSystemSource> m_fileSystem;    ///< 文件系统数据源
+        String m_journalDirectory;                          ///< 批次日志目录
+        std::mutex m_mutex;                                 ///< 串行化隔离、恢复和清理
+        
+        std::thread m_purgeThread;                          ///< 后台清理线程
+        std::mutex m_purgeMutex;                            ///< 保护m_stopPurge
+        std::condition_variable m_purgeWakeup;              ///< 唤醒后台清理线程
+        bool m_stopPurge;                                   ///< 是否停止后台清理
+    };
+
+} // namespace YG
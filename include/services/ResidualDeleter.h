@@ -0,0 +1,157 @@
+/**
+ * @file ResidualDeleter.h
+ * @brief 残留项的批量并行删除
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/ResidualItem.h"
+#include "utils/FileSystemSource.h"
+#include "utils/RegistrySource.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+
+namespace YG {
+    
+    /**
+     * @brief 一次批量删除的统计
+     */
+    struct ResidualDeleteResult {
+        size_t deletedItems = 0;            ///< 删除成功的残留项（含删除前已不存在的）
+        size_t failedItems = 0;             ///< 删除失败或被取消的残留项
+        DWORD64 deletedFiles = 0;           ///< 删除的文件数
+        DWORD64 deletedDirectories = 0;     ///< 删除的目录数
+        DWORD64 failedEntries = 0;          ///< 删除失败的文件和目录数
+        DWORD64 clearedReadOnly = 0;        ///< 清除了只读属性的文件和目录数
+        DWORD64 deletedRegistryKeys = 0;    ///< 删除的注册表键数（含子键）
+        DWORD64 deletedRegistryValues = 0;  ///< 删除的注册表值数
+        size_t volumeCount = 0;             ///< 涉及的卷数
+    };
+    
+    /**
+     * @brief 残留项删除引擎
+     *
+     * 文件类残留项按所在卷分组，每个卷一组工作线程，不同的卷互不等待：
+     *   - 目录展开为后序的工作列表：枚举目录时记下未完成的子项数，文件和空目录是可以直接删除的叶子，
+     *     子项全部删除后目录自身成为叶子，任一子项失败时目录及其上级都保留，不再尝试
+     *   - 只读属性取自枚举结果，删除前在同一次处理中清除，不再单独查询
+     *   - 重解析点目录只删除链接本身，不进入
+     * 注册表残留项在单独的线程中处理：先删值，再按路径从深到浅删键，每个键的子树自底向上删除。
+     * 已不存在的项视为删除成功。
+     * 每个残留项完成时记录结果，调用线程合并后按固定间隔调用进度回调：
+     * 期间失败的项逐个报告，成功的项只报告最近一个，最后总会以100%报告一次。
+     * 回调只在调用Delete的线程中执行，界面线程可直接更新控件。
+     */
+    class ResidualDeleter {
+    public:
+        /**
+         * @brief 构造函数
+         * @param fileSystem 文件系统数据源，为空时使用Win32FileSystemSource
+         * @param threadsPerVolume 每个卷的最大线程数，0表示使用默认值
+         */
+        explicit ResidualDeleter(std::shared_ptr<IFileSystemSource> fileSystem = nullptr, size_t threadsPerVolume = 0);
+        
+        ~ResidualDeleter();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ResidualDeleter);
+        
+        /**
+         * @brief 删除残留项
+         * @param items 残留项
+         * @param callback 进度回调，可为空
+         * @param result 输出统计
+         * @param cancelFlag 取消标志，可为nullptr
+         * @return ErrorCode 全部成功时返回Success，取消时返回OperationCancelled，否则返回GeneralError
+         */
+        ErrorCode Delete(const std::vector<ResidualItem>& items, const DeleteProgressCallback& callback,
+                         ResidualDeleteResult& result, const std::atomic<bool>* cancelFlag = nullptr);
+        
+        /**
+         * @brief 取得路径所在的卷（"C:"或"\\\\server\\share"，大写）
+         * @param path 文件或目录路径
+         * @return String 卷标识，无法识别时为空
+         */
+        static String GetVolumeKey(const String& path);
+        
+        /**
+         * @brief 拆分注册表值残留项的子键路径"键路径\\值名称"，默认值的路径以"\\"结尾
+         * @param subKey 残留项路径去掉根键后的部分
+         * @param name 残留项名称（默认值的名称只用于显示）
+         * @param keyPath 输出值所在的键
+         * @param valueName 输出值名称，默认值为空
+         * @return bool 路径与名称是否一致
+         */
+        static bool SplitValuePath(const String& subKey, const String& name, String& keyPath, String& valueName);
+        
+        /**
+         * @brief 删除注册表键及其整棵子树，子键总在父键之前删除
+         * @param source 注册表数据源
+         * @param rootKey 根键
+         * @param subKey 子键路径
+         * @param deletedKeys 累加删除的键数
+         * @return LONG Win32错误码，键本身不存在（或在删除前已被删除）时为ERROR_FILE_NOT_FOUND，子键已不存在不算失败
+         */
+        static LONG DeleteRegistryTree(IRegistrySource& source, HKEY rootKey, const String& subKey, DWORD64& deletedKeys);
+        
+        /**
+         * @brief 残留项是否位于注册表中
+         */
+        static bool IsRegistryItem(const ResidualItem& item) {
+            return item.type == ResidualType::RegistryKey || item.type == ResidualType::RegistryValue;
+        }
+    
+    private:
+        struct Batch;
+        struct Lane;
+        struct DirectoryNode;
+        struct DeleteTask;
+        
+        /**
+         * @brief 卷线程主循环
+         * @param batch 批次状态
+         * @param lane 所属卷
+         */
+        void LaneWorker(Batch& batch, Lane& lane);
+        
+        /**
+         * @brief 处理一个删除任务
+         */
+        void ProcessTask(Batch& batch, Lane& lane, DeleteTask& task);
+        
+        /**
+         * @brief 把任务放入卷队列，积压较多时增加线程
+         */
+        void PushTasks(Batch& batch, Lane& lane, std::vector<DeleteTask> tasks);
+        
+        /**
+         * @brief 删除文件或空目录，只读时先清除只读属性
+         * @return DWORD Win32错误码，已不存在时为ERROR_SUCCESS
+         */
+        DWORD RemoveEntry(Batch& batch, const String& path, DWORD attributes, bool directory);
+        
+        /**
+         * @brief 一个子项处理完毕：更新上级目录的未完成数，子项全部成功的目录随即删除
+         * @param batch 批次状态
+         * @param parent 上级目录，为nullptr时表示残留项本身已完成
+         * @param itemIndex 残留项下标
+         * @param error 子项的结果（Win32错误码）
+         */
+        void CompleteChild(Batch& batch, DirectoryNode* parent, size_t itemIndex, DWORD error);
+        
+        /**
+         * @brief 按顺序删除全部注册表残留项（注册表线程）
+         * @param batch 批次状态
+         * @param itemIndices 注册表残留项的下标
+         */
+        void DeleteRegistryItems(Batch& batch, const std::vector<size_t>& itemIndices);
+        
+        std::shared_ptr<IFileSystemSource> m_fileSystem;    ///< 文件系统数据源
+        size_t m_threadsPerVolume;                          ///< 每个卷的最大线程数
+    };
+
+} // namespace YG
@@ -0,0 +1,155 @@
+/**
+ * @file ResidualMatcher.h
+ * @brief 残留名称的多模式匹配（Aho-Corasick）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <string_view>
+
+namespace YG {
+    
+    /**
+     * @brief 模式的来源，数值越小越可信
+     */
+    enum ResidualPatternKind : std::uint8_t {
+        PatternDisplayName = 0,     ///< 显示名称或程序名称
+        PatternCompactName,         ///< 去掉空格的名称
+        PatternInstallFolder,       ///< 安装目录的最后一级（弱匹配）
+        PatternUninstallerStem,     ///< 卸载程序的文件名，不含扩展名（弱匹配）
+        PatternPublisher            ///< 发布者（弱匹配）
+    };
+    
+    /**
+     * @brief 一个匹配模式
+     */
+    struct ResidualPattern {
+        String text;                    ///< 原文
+        ResidualPatternKind kind;       ///< 来源
+        std::uint32_t owner;            ///< 所属程序的编号
+    };
+    
+    /**
+     * @brief 一次匹配的结果
+     */
+    struct ResidualMatch {
+        std::uint32_t pattern = 0;                      ///< 命中的模式下标
+        ResidualPatternKind kind = PatternDisplayName;  ///< 命中模式的来源
+        std::uint32_t owner = 0;                        ///< 命中模式所属程序的编号
+    };
+    
+    /**
+     * @brief 残留名称匹配器
+     *
+     * 由程序的名称、去空格名称、发布者、卸载程序文件名、安装目录名生成模式，
+     * 编译为一个Aho-Corasick自动机，每个候选名称只需从头到尾扫描一次：
+     *   - 模式中出现的字符按小写归为字符类，其余字符都归为类0，自动机的转移表按字符类展开，
+     *     匹配时每个UTF-16码元只查一次类表和一次转移表，不再为候选名称生成小写副本
+     *   - 失败转移在编译时并入转移表，每个状态的输出（含后缀状态的输出）展开为一个区间
+     *   - 短于MinPatternLength的模式、"setup"、"bin"、"x64"之类的通用名称以及"1.2.3"之类的版本号不加入
+     * 只有程序名称是强匹配。安装目录名（"Client"、"Launcher"）和卸载程序名常是短的通用词，
+     * 发布者则为同一发布者的所有程序共有，这三种都是弱匹配，命中的项不默认选中，风险评估应区别对待。
+     * 编译后只读，可在多个线程中同时匹配。
+     */
+    class ResidualMatcher {
+    public:
+        static const size_t MinPatternLength = 3;   ///< 模式的最小长度
+        
+        ResidualMatcher();
+        
+        /**
+         * @brief 添加模式，须在Build之前调用
+         * @param text 模式原文
+         * @param kind 来源
+         * @param owner 所属程序的编号
+         * @return bool 是否加入（过短、通用名称或重复时不加入）
+         */
+        bool AddPattern(const String& text, ResidualPatternKind kind, std::uint32_t owner);
+        
+        /**
+         * @brief 添加程序的全部模式
+         * @param programInfo 程序信息
+         * @param owner 程序的编号
+         */
+        void AddProgram(const ProgramInfo& programInfo, std::uint32_t owner);
+        
+        /**
+         * @brief 编译自动机
+         */
+        void Build();
+        
+        /**
+         * @brief 是否没有任何模式
+         */
+        bool IsEmpty() const { return m_patterns.empty(); }
+        
+        /**
+         * @brief 模式
+         */
+        const std::vector<ResidualPattern>& GetPatterns() const { return m_patterns; }
+        
+        /**
+         * @brief 查找最可信的匹配：强匹配优先，其次较长的模式，再次来源较可信的模式
+         * @param text 候选名称（原文，不需转小写）
+         * @param match 输出匹配结果
+         * @return bool 是否匹配
+         */
+        bool FindBest(std::wstring_view text, ResidualMatch& match) const;
+        
+        /**
+         * @brief 查找每个程序最可信的匹配
+         * @param text 候选名称（原文，不需转小写）
+         * @param matches 输出匹配结果，按程序编号升序，每个程序一项
+         * @return bool 是否匹配
+         */
+        bool FindAll(std::wstring_view text, std::vector<ResidualMatch>& matches) const;
+        
+        /**
+         * @brief 是否为强匹配（命中程序名称或去空格的名称）
+         */
+        static bool IsStrong(ResidualPatternKind kind) { return kind <= PatternCompactName; }
+        
+        /**
+         * @brief 来源的显示名称
+         */
+        static const wchar_t* GetKindName(ResidualPatternKind kind);
+        
+        /**
+         * @brief 从卸载命令中取出卸载程序的文件名（不含扩展名）
+         * @param uninstallString 卸载命令
+         * @return String 文件名，无法识别时为空
+         */
+        static String GetUninstallerStem(const String& uninstallString);
+        
+        /**
+         * @brief 取得路径的最后一级
+         * @param path 路径
+         * @return String 最后一级名称
+         */
+        static String GetFolderLeaf(const String& path);
+    
+    private:
+        /**
+         * @brief 模式a是否比b更可信
+         */
+        bool IsBetter(std::uint32_t a, std::uint32_t b) const;
+        
+        std::vector<ResidualPattern> m_patterns;        ///< 模式
+        std::vector<String> m_foldedPatterns;           ///< 小写的模式（与m_patterns对应）
+        std::vector<std::uint16_t> m_charClasses;       ///< UTF-16码元 -> 字符类
+        std::uint32_t m_classCount;                     ///< 字符类数（含类0）
+        std::vector<std::uint32_t> m_transitions;       ///< 状态 * m_classCount + 字符类 -> 状态
+        std::vector<std::uint32_t> m_outputStarts;      ///< 状态 -> m_outputs中的起始位置（多一个结尾项）
+        std::vector<std::uint32_t> m_outputs;           ///< 各状态命中的模式下标
+    };
+    
+    using ResidualMatcherPtr = std::shared_ptr<const ResidualMatcher>;
+
+} // namespace YG
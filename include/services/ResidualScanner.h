@@ -10,32 +10,68 @@
 
 #include "core/Common.h"
 #include "core/ResidualItem.h"
+#include "services/ResidualMatcher.h"
+#include "utils/ThreadPool.h"
 #include <vector>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <mutex>
+#include <functional>
 
 namespace YG {
     
     /**
      * @brief 残留文件扫描服务类
+     *
+     * 每个扫描根目录、注册表位置、快捷方式目录和服务扫描都是一个独立的扫描单元，
+     * 全部提交到共享的工作线程池并发执行；各单元的结果在全部完成后按固定顺序合并为分组。
+     * 进度按已完成的单元数计算，合并完成后才报告100%。
+     * 一次扫描可以针对多个程序（批量卸载之后），各程序的模式编译进同一个ResidualMatcher，
+     * 每个根目录和注册表位置只遍历一次，命中的项按最可信的模式归属到对应的程序。
+     * 名称匹配使用每次扫描编译一次的ResidualMatcher，只命中发布者的项为弱匹配，
+     * 风险级别至少为中等且默认不选中。
      */
     class ResidualScanner {
     private:
+        /**
+         * @brief 结果分组（合并时按此顺序输出）
+         */
+        enum ResultGroup {
+            FilesGroup = 0,     ///< 文件和文件夹
+            CacheGroup,         ///< 缓存文件
+            ConfigGroup,        ///< 配置文件
+            RegistryGroup,      ///< 注册表项
+            ShortcutGroup,      ///< 快捷方式
+            ServiceGroup,       ///< 系统服务
+            ResultGroupCount
+        };
+        
+        /**
+         * @brief 扫描单元：一个根目录、注册表位置或一类对象
+         */
+        struct ScanUnit {
+            String description;                                     ///< 进度显示文本
+            ResultGroup group;                                      ///< 结果归入的分组
+            std::function<void(std::vector<ResidualItem>&)> run;    ///< 执行扫描，结果追加到参数中
+        };
+        
         std::atomic<bool> m_isScanning;         ///< 是否正在扫描
         std::atomic<bool> m_shouldStop;         ///< 是否应该停止扫描
         std::unique_ptr<std::thread> m_scanThread; ///< 扫描线程
+        std::unique_ptr<ThreadPool> m_pool;     ///< 扫描单元的工作线程池
         mutable std::mutex m_resultsMutex;      ///< 结果访问互斥锁
+        std::mutex m_progressMutex;             ///< 串行化进度回调（各单元在不同线程中完成）
         
         std::vector<ResidualGroup> m_scanResults;   ///< 扫描结果
+        std::vector<ProgramInfo> m_scanPrograms;    ///< 本次扫描的程序（扫描线程启动后只读）
         ScanProgressCallback m_progressCallback;   ///< 进度回调
         
         // 扫描配置
         bool m_scanFiles;               ///< 是否扫描文件
         bool m_scanRegistry;            ///< 是否扫描注册表
         bool m_scanShortcuts;           ///< 是否扫描快捷方式
-        bool m_scanServices;            ///< 是否扫描服务
+        bool m_scanServices;            ///< 是否扫描服务（目前不扫描，见SetScanOptions）
         bool m_deepScan;                ///< 是否深度扫描
         
     public:
@@ -57,6 +93,14 @@ namespace YG {
          */
         ErrorCode StartScan(const ProgramInfo& programInfo, ScanProgressCallback progressCallback);
         
+        /**
+         * @brief 开始一次扫描多个程序的残留，每个位置只遍历一次
+         * @param programs 已卸载的程序列表
+         * @param progressCallback 进度回调函数
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode StartBatchScan(const std::vector<ProgramInfo>& programs, ScanProgressCallback progressCallback);
+        
         /**
          * @brief 停止扫描
          */
@@ -74,95 +118,126 @@ namespace YG {
          */
         std::vector<ResidualGroup> GetScanResults() const;
         
+        /**
+         * @brief 获取归属于某个程序的扫描结果
+         * @param programIndex 程序在StartBatchScan列表中的下标
+         * @return std::vector<ResidualGroup> 该程序的非空结果分组
+         */
+        std::vector<ResidualGroup> GetProgramScanResults(size_t programIndex) const;
+        
         /**
          * @brief 设置扫描选项
          * @param scanFiles 是否扫描文件
          * @param scanRegistry 是否扫描注册表
          * @param scanShortcuts 是否扫描快捷方式
-         * @param scanServices 是否扫描服务
+         * @param scanServices 是否扫描服务；ResidualDeleter和QuarantineStore都不支持服务项，目前不扫描服务
          * @param deepScan 是否深度扫描
          */
         void SetScanOptions(bool scanFiles, bool scanRegistry, bool scanShortcuts, 
                            bool scanServices, bool deepScan);
         
         /**
-         * @brief 删除指定的残留项
+         * @brief 删除指定的残留项（由ResidualDeleter按卷并行删除，目录连同内容一起删除）
          * @param items 要删除的残留项列表
-         * @param deleteCallback 删除进度回调
-         * @return ErrorCode 操作结果
+         * @param deleteCallback 删除进度回调，在调用线程中按固定间隔报告每项的结果
+         * @return ErrorCode 全部成功时返回Success
          */
         ErrorCode DeleteResidualItems(const std::vector<ResidualItem>& items, 
                                      DeleteProgressCallback deleteCallback);
         
+        /**
+         * @brief 把残留项移入隔离区（同卷改名，注册表项记入日志后删除），可通过QuarantineStore恢复
+         * @param items 要清理的残留项列表
+         * @param label 批次说明（通常为程序名称）
+         * @param deleteCallback 进度回调，在调用线程中按固定间隔报告每项的结果
+         * @return ErrorCode 全部成功时返回Success
+         */
+        ErrorCode QuarantineResidualItems(const std::vector<ResidualItem>& items, const String& label,
+                                          DeleteProgressCallback deleteCallback);
+    
     private:
         /**
          * @brief 扫描工作线程
-         * @param programInfo 程序信息
+         * @param programs 程序列表
          */
-        void ScanWorkerThread(const ProgramInfo& programInfo);
+        void ScanWorkerThread(const std::vector<ProgramInfo>& programs);
         
         /**
-         * @brief 扫描文件系统残留
-         * @param programInfo 程序信息
-         * @param results 扫描结果
+         * @brief 生成文件系统扫描单元（AppData、LocalAppData、ProgramData、Temp各一个）
+         * @param matcher 名称匹配器
+         * @param units 扫描单元列表
          */
-        void ScanFileSystemResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results);
+        void AddFileSystemScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units);
         
         /**
-         * @brief 扫描注册表残留
-         * @param programInfo 程序信息
-         * @param results 扫描结果
+         * @brief 生成注册表扫描单元（每个注册表位置一个）
+         * @param matcher 名称匹配器
+         * @param units 扫描单元列表
          */
-        void ScanRegistryResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results);
+        void AddRegistryScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units);
         
         /**
-         * @brief 扫描快捷方式残留
-         * @param programInfo 程序信息
-         * @param results 扫描结果
+         * @brief 生成快捷方式扫描单元（桌面、开始菜单各一个）
+         * @param matcher 名称匹配器
+         * @param units 扫描单元列表
          */
-        void ScanShortcutResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results);
+        void AddShortcutScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units);
         
         /**
-         * @brief 扫描服务残留
-         * @param programInfo 程序信息
-         * @param results 扫描结果
+         * @brief 在线程池中执行全部扫描单元，并按单元顺序合并结果
+         * @param units 扫描单元
+         * @return std::vector<ResidualGroup> 非空的结果分组
          */
-        void ScanServiceResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results);
+        std::vector<ResidualGroup> RunScanUnits(const std::vector<ScanUnit>& units);
         
         /**
          * @brief 扫描指定目录中的相关文件
          * @param directory 目录路径
-         * @param programName 程序名称
-         * @param searchPatterns 搜索模式
+         * @param matcher 名称匹配器
          * @param results 结果列表
          */
-        void ScanDirectoryForResiduals(const String& directory, const String& programName,
-                                     const std::vector<String>& searchPatterns,
+        void ScanDirectoryForResiduals(const String& directory, const ResidualMatcher& matcher,
                                      std::vector<ResidualItem>& results);
         
         /**
-         * @brief 扫描注册表键
+         * @brief 扫描注册表子树（键名称、值名称和字符串值数据）
          * @param rootKey 根键
          * @param keyPath 键路径
-         * @param programName 程序名称
+         * @param matcher 名称匹配器
          * @param results 结果列表
          */
-        void ScanRegistryKey(HKEY rootKey, const String& keyPath, const String& programName,
+        void ScanRegistryKey(HKEY rootKey, const String& keyPath, const ResidualMatcher& matcher,
                            std::vector<ResidualItem>& results);
         
         /**
-         * @brief 生成搜索模式
-         * @param programInfo 程序信息
-         * @return std::vector<String> 搜索模式列表
+         * @brief 编译各程序的名称匹配器，模式的所属编号为程序的下标
+         * @param programs 程序列表
+         * @return ResidualMatcherPtr 匹配器
          */
-        std::vector<String> GenerateSearchPatterns(const ProgramInfo& programInfo);
+        static ResidualMatcherPtr BuildMatcher(const std::vector<ProgramInfo>& programs);
         
         /**
          * @brief 评估残留项风险级别
          * @param item 残留项
+         * @param match 命中的模式
          * @return RiskLevel 风险级别
          */
-        RiskLevel EvaluateRiskLevel(const ResidualItem& item);
+        RiskLevel EvaluateRiskLevel(const ResidualItem& item, const ResidualMatch& match);
+        
+        /**
+         * @brief 按路径和类型评估风险级别
+         * @param item 残留项
+         * @return RiskLevel 风险级别
+         */
+        RiskLevel EvaluatePathRisk(const ResidualItem& item);
+        
+        /**
+         * @brief 按命中的模式设置残留项的归属、描述、风险级别和初始选择
+         * @param matcher 名称匹配器
+         * @param match 命中的模式
+         * @param item 残留项（路径和类型须已设置）
+         */
+        void ApplyMatch(const ResidualMatcher& matcher, const ResidualMatch& match, ResidualItem& item);
         
         /**
          * @brief 更新扫描进度
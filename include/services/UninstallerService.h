@@ -9,8 +9,10 @@
 #pragma once
 
 #include "core/Common.h"
+#include "core/ResidualItem.h"
 #include <functional>
 #include <memory>
+#include <vector>
 
 // 前向声明
 namespace YG {
@@ -93,32 +95,40 @@ namespace YG {
         ErrorCode ExecuteSilentUninstall(const ProgramInfo& program);
 
         /**
-         * @brief 执行强制卸载
+         * @brief 执行强制卸载（标准卸载失败时把安装目录移入隔离区）
          * @param program 程序信息
          * @return ErrorCode 操作结果
          */
         ErrorCode ExecuteForceUninstall(const ProgramInfo& program);
 
         /**
-         * @brief 执行深度卸载
+         * @brief 执行深度卸载（安装目录、卸载注册表项和快捷方式作为一个批次移入隔离区）
          * @param program 程序信息
          * @return ErrorCode 操作结果
          */
         ErrorCode ExecuteDeepUninstall(const ProgramInfo& program);
 
         /**
-         * @brief 清理注册表项
+         * @brief 收集程序的卸载注册表项
          * @param program 程序信息
-         * @return ErrorCode 操作结果
+         * @param items 输出残留项
          */
-        ErrorCode CleanupRegistryEntries(const ProgramInfo& program);
-
+        void CollectRegistryEntries(const ProgramInfo& program, std::vector<ResidualItem>& items);
+        
+        /**
+         * @brief 收集程序的开始菜单和桌面快捷方式
+         * @param program 程序信息
+         * @param items 输出残留项
+         */
+        void CollectShortcuts(const ProgramInfo& program, std::vector<ResidualItem>& items);
+        
         /**
-         * @brief 清理快捷方式
+         * @brief 把残留项作为一个批次移入隔离区；安装目录无法隔离时退回到移入回收站
          * @param program 程序信息
+         * @param items 残留项
          * @return ErrorCode 操作结果
          */
-        ErrorCode CleanupShortcuts(const ProgramInfo& program);
+        ErrorCode QuarantineLeftovers(const ProgramInfo& program, const std::vector<ResidualItem>& items);
     };
 
     // 辅助函数
@@ -10,6 +10,7 @@
 
 #include "core/Common.h"
 #include "core/ResidualItem.h"
+#include "ui/ResidualListModel.h"
 #include <vector>
 #include <memory>
 #include <commctrl.h>
@@ -49,7 +50,7 @@ namespace YG {
         HWND m_hDeleteAllButton;            ///< 删除全部按钮
         HWND m_hCancelButton;               ///< 取消按钮
         
-        std::vector<ResidualGroup> m_residualGroups;    ///< 残留项分组
+        ResidualListModel m_model;                      ///< 残留项分组及选择状态（虚拟列表的数据来源）
         std::shared_ptr<ResidualScanner> m_scanner;     ///< 扫描器
         ProgramInfo m_programInfo;                      ///< 程序信息
         CleanupResult m_result;                         ///< 对话框结果
@@ -140,12 +141,20 @@ namespace YG {
         
         /**
          * @brief 填充列表控件数据
-         * @param groupIndex 分组索引
+         * 
+         * 列表为虚拟列表，只设置行数，各行内容在LVN_GETDISPINFO中从m_model读取。
+         * @param groupIndex 分组索引（列表始终显示全部分组）
          */
         void PopulateListView(int groupIndex = -1);
         
         /**
-         * @brief 更新选择统计
+         * @brief 提供虚拟列表某一行的文本和勾选状态
+         * @param dispInfo 显示信息
+         */
+        void OnGetDispInfo(NMLVDISPINFOW* dispInfo);
+        
+        /**
+         * @brief 更新选择统计（读取模型中的合计值）
          */
         void UpdateSelectionStats();
         
@@ -156,8 +165,8 @@ namespace YG {
         void OnTreeSelectionChanged(HTREEITEM hItem);
         
         /**
-         * @brief 处理列表项选择变化
-         * @param itemIndex 项索引
+         * @brief 处理列表项勾选变化
+         * @param itemIndex 行号
          * @param selected 是否选中
          */
         void OnListItemSelectionChanged(int itemIndex, bool selected);
@@ -11,6 +11,12 @@
 #include "core/Common.h"
 #include "services/ProgramDetector.h"
 #include "services/UninstallerService.h"
+#include "services/ProgramSearchIndex.h"
+#include "services/ProgramSorter.h"
+#include "services/ProgramFilter.h"
+#include "services/ProgramIconService.h"
+#include "utils/ProgressCoalescer.h"
+#include "utils/BatchCoalescer.h"
 #include <windows.h>
 #include <commctrl.h>
 #include <vector>
@@ -80,6 +86,9 @@ namespace YG {
         
         /**
          * @brief 刷新程序列表
+         * 
+         * 在后台线程中增量扫描，立即返回；扫描期间当前列表仍可操作，完成后一次性替换。
+         * 再次刷新会异步取消进行中的扫描，待其退出后再开始新的扫描。
          * @param includeSystemComponents 是否包含系统组件
          */
         void RefreshProgramList(bool includeSystemComponents = false);
@@ -206,6 +215,26 @@ namespace YG {
          */
         LRESULT OnNotify(LPNMHDR pNMHDR);
         
+        /**
+         * @brief 为虚拟列表提供单元格的文本和图标（LVN_GETDISPINFO）
+         * @param dispInfo 显示信息
+         */
+        void OnGetDispInfo(NMLVDISPINFOW* dispInfo);
+        
+        /**
+         * @brief 虚拟列表的键盘定位：按名称前缀查找行（LVN_ODFINDITEM）
+         * @param findItem 查找信息
+         * @return int 行号，未找到时为-1
+         */
+        int FindProgramRow(const NMLVFINDITEMW* findItem) const;
+        
+        /**
+         * @brief 获取显示行对应的程序Id
+         * @param row 行号
+         * @return ProgramId 程序Id，行号无效时为InvalidProgramId
+         */
+        ProgramId GetProgramIdAtRow(int row) const;
+        
         /**
          * @brief 处理按键消息
          * @param key 按键代码
@@ -381,11 +410,37 @@ namespace YG {
         int CalculateTableWidth();
         
         /**
-         * @brief 填充程序列表
+         * @brief 以新的扫描结果填充程序列表（去重后生成程序表，显示全部程序）
          * @param programs 程序列表
          */
         void PopulateProgramList(const std::vector<ProgramInfo>& programs);
         
+        /**
+         * @brief 按m_displayIds重新显示程序表中的程序
+         */
+        void ShowProgramRows();
+        
+        /**
+         * @brief 处理后台扫描（刷新或快照校验）完成
+         * @param result 扫描结果
+         * @param generation 扫描代数，不是最近一次扫描的结果直接丢弃
+         */
+        void OnProgramScanCompleted(ErrorCode result, std::uint64_t generation);
+        
+        /**
+         * @brief 整批应用后台补全结果：生成一张新表，只重绘受影响的行
+         *
+         * 结果中含版本时同时重建搜索索引，并让排序器和过滤器的版本数据失效。
+         * @param updates 自上次应用以来积累的补全结果
+         */
+        void ApplyProgramEnrichment(const std::vector<ProgramEnrichmentUpdate>& updates);
+        
+        /**
+         * @brief 应用后台解析的程序图标，只重绘受影响的行
+         * @param update 图标结果
+         */
+        void ApplyProgramIcons(const ProgramIconUpdate& update);
+        
         
         /**
          * @brief 更新UI状态
@@ -482,6 +537,12 @@ namespace YG {
          */
         void HandleUninstallComplete(bool success);
         
+        /**
+         * @brief 开始扫描已卸载程序的残留，多个程序共用一次扫描
+         * @param programs 已卸载的程序列表
+         */
+        void StartResidualScan(const std::vector<ProgramInfo>& programs);
+        
         /**
          * @brief 处理残留扫描进度消息（在主线程中安全执行）
          * @param percentage 进度百分比
@@ -503,6 +564,11 @@ namespace YG {
          */
         void ShowCleanupDialog(const ProgramInfo& program);
         
+        /**
+         * @brief 撤销上次清理：把最近一个隔离批次恢复到原处
+         */
+        void UndoLastCleanup();
+        
         /**
          * @brief 格式化文件大小
          * @param sizeInBytes 字节大小
@@ -540,16 +606,6 @@ namespace YG {
          */
         void OnColumnHeaderClick(int column);
         
-        /**
-         * @brief 比较两个程序信息
-         * @param program1 程序1
-         * @param program2 程序2
-         * @param column 比较列
-         * @param ascending 是否升序
-         * @return int 比较结果
-         */
-        static int CompareProgramInfo(const ProgramInfo& program1, const ProgramInfo& program2, int column, bool ascending);
-        
         /**
          * @brief 创建图标列表
          * @return ErrorCode 操作结果
@@ -557,11 +613,9 @@ namespace YG {
         ErrorCode CreateImageList();
         
         /**
-         * @brief 提取程序图标
-         * @param program 程序信息
-         * @return int 图标在ImageList中的索引，-1表示失败
+         * @brief 向当前图标列表添加默认程序图标（应为列表中的第一个图标）
          */
-        int ExtractProgramIcon(const ProgramInfo& program);
+        void AddDefaultProgramIcon();
         
         /**
          * @brief 获取默认程序图标
@@ -570,27 +624,16 @@ namespace YG {
         int GetDefaultProgramIcon();
         
         /**
-         * @brief 去除程序列表中的重复项
-         * @param programs 程序列表
-         * @return std::vector<ProgramInfo> 去重后的程序列表
-         */
-        std::vector<ProgramInfo> RemoveDuplicatePrograms(const std::vector<ProgramInfo>& programs);
-        
-        /**
-         * @brief 比较两个版本字符串是否相同
-         * @param version1 版本1
-         * @param version2 版本2
-         * @return bool 是否相同
+         * @brief 获取程序图标索引，首次显示该程序时提交后台解析，解析完成前返回默认图标
+         * @param id 程序Id
+         * @return int 图标在ImageList中的索引
          */
-        bool CompareVersions(const String& version1, const String& version2);
+        int GetProgramIconIndex(ProgramId id);
         
         /**
-         * @brief 判断两个程序是否相同
-         * @param program1 程序1
-         * @param program2 程序2
-         * @return bool 是否为同一程序
+         * @brief 清空按程序Id缓存的图标，只保留默认图标
          */
-        bool IsSameProgram(const ProgramInfo& program1, const ProgramInfo& program2);
+        void ResetProgramIcons();
         
     private:
         // 窗口相关
@@ -621,36 +664,60 @@ namespace YG {
         // 服务对象
         std::unique_ptr<ProgramDetector> m_programDetector;  ///< 程序检测器
         std::unique_ptr<UninstallerService> m_uninstallerService; ///< 卸载服务
+        std::unique_ptr<ProgramSorter> m_programSorter;      ///< 程序列表排序器
+        std::unique_ptr<ProgramFilter> m_programFilter;      ///< 结构化查询过滤器
+        std::unique_ptr<ProgramIconService> m_iconService;   ///< 程序图标后台解析服务
         std::unique_ptr<MainWindowLogs> m_logManager;        ///< 日志管理器
         std::unique_ptr<MainWindowTray> m_trayManager;       ///< 系统托盘管理器
         std::unique_ptr<MainWindowSettings> m_settingsManager; ///< 设置管理器
         std::shared_ptr<ResidualScanner> m_residualScanner; ///< 残留扫描器
         
         // 数据
-        std::vector<ProgramInfo> m_programs;        ///< 程序列表
-        std::vector<ProgramInfo> m_filteredPrograms; ///< 过滤后的程序列表
+        ProgramTablePtr m_programTable;             ///< 程序表（去重后）
+        std::vector<ProgramId> m_displayIds;        ///< 当前显示的程序（搜索、排序后的顺序），下标即行号
+        std::vector<int> m_rowById;                 ///< 程序Id -> 显示行号（-1表示未显示）
+        std::vector<int> m_iconIndexById;           ///< 程序Id -> 图标索引（-1表示尚未请求，ICON_PENDING表示解析中）
+        ProgramSearchIndexPtr m_searchIndex;        ///< 程序表的搜索索引
+        ProgramSearchResult m_searchResult;         ///< 上一次的搜索结果，继续输入时在其中缩小
         String m_currentSearchKeyword;              ///< 当前搜索关键词
         bool m_includeSystemComponents;             ///< 是否包含系统组件
         bool m_showWindowsUpdates;                  ///< 是否显示Windows更新
+        bool m_fuzzySearch;                         ///< 是否使用模糊搜索（按评分排序）
         ProgramInfo m_currentUninstallingProgram;   ///< 当前正在卸载的程序
         
         
         // 状态
         bool m_isScanning;                          ///< 是否正在扫描
+        std::uint64_t m_scanGeneration;             ///< 扫描代数，每次开始后台扫描时递增
+        std::shared_ptr<ProgressCoalescer> m_scanProgress;  ///< 当前扫描的进度合并器
+        std::shared_ptr<BatchCoalescer<ProgramEnrichmentUpdate>> m_enrichmentInbox; ///< 补全结果的合并器
+        bool m_rescanPending;                       ///< 进行中的扫描取消后是否重新扫描
+        bool m_hasScannedList;                      ///< 当前列表是否来自扫描结果（含快照）
+        bool m_listedSystemComponents;              ///< 当前列表是否包含系统组件
         bool m_isUninstalling;                      ///< 是否正在卸载
+        bool m_isBatchUninstalling;                 ///< 是否正在批量卸载（全部卸载完后统一扫描残留）
         bool m_isListViewMode;                      ///< 是否使用ListView表格模式
         String m_currentUninstallTask;              ///< 当前卸载任务ID
         bool m_scrollBarsHidden;                    ///< 滚动条是否已经隐藏（避免重复操作）
         WNDPROC m_originalListViewProc;             ///< ListView原始窗口过程
         
         // 排序相关
-        int m_sortColumn;                           ///< 当前排序列
+        int m_sortColumn;                           ///< 当前排序列，-1表示未排序
         bool m_sortAscending;                       ///< 是否升序排序
         
         // 窗口类名和标题
         static constexpr const wchar_t* WINDOW_CLASS_NAME = L"YGUninstallerMainWindow";
         static constexpr const wchar_t* WINDOW_TITLE = L"YG Uninstaller";
         
+        // 模糊搜索最多显示的结果数
+        static constexpr size_t FUZZY_RESULT_LIMIT = 1000;
+        
+        // 扫描进度消息的最小投递间隔(毫秒)
+        static constexpr DWORD SCAN_PROGRESS_INTERVAL_MS = 100;
+        
+        // 图标已提交后台解析、尚未返回
+        static constexpr int ICON_PENDING = -2;
+        
         // 控件ID
         enum ControlId {
             ID_TOOLBAR = 1000,
@@ -679,6 +746,7 @@ namespace YG {
             ID_VIEW_DETAILS,
             ID_VIEW_SHOW_SYSTEM,
             ID_VIEW_SHOW_UPDATES,
+            ID_VIEW_FUZZY_SEARCH,
             
             // 工具菜单ID
             ID_TOOLS_SETTINGS = 2300,
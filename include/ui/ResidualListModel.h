@@ -0,0 +1,125 @@
+/**
+ * @file ResidualListModel.h
+ * @brief 清理对话框虚拟列表的数据模型（行索引 + 位图选择）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "core/ResidualItem.h"
+#include <vector>
+#include <cstdint>
+
+namespace YG {
+    
+    /**
+     * @brief 残留项列表模型
+     *
+     * 各分组的残留项按分组顺序依次编为行号，虚拟列表按行号读取，不再为每一项插入列表项：
+     *   - 行号到(分组, 项)通过分组起始行的前缀表二分查找，不受项数限制
+     *   - 选择状态保存为位图，选中数和选中大小随每次切换O(1)更新
+     *   - 全选、全不选按64位字整体设置，合计值直接取总数或清零
+     * 残留项自身的isSelected只在Reset时读取一次作为初始选择。
+     */
+    class ResidualListModel {
+    public:
+        ResidualListModel();
+        
+        /**
+         * @brief 替换全部数据
+         * @param groups 残留项分组
+         */
+        void Reset(const std::vector<ResidualGroup>& groups);
+        
+        /**
+         * @brief 行数（全部分组的项数之和）
+         */
+        size_t GetRowCount() const { return m_rowCount; }
+        
+        /**
+         * @brief 分组
+         */
+        const std::vector<ResidualGroup>& GetGroups() const { return m_groups; }
+        
+        /**
+         * @brief 取得行对应的残留项
+         * @param row 行号，须小于GetRowCount()
+         * @return const ResidualItem& 残留项
+         */
+        const ResidualItem& GetItem(size_t row) const;
+        
+        /**
+         * @brief 取得行所在的分组
+         * @param row 行号，须小于GetRowCount()
+         * @return size_t 分组下标
+         */
+        size_t GetGroupIndex(size_t row) const;
+        
+        /**
+         * @brief 行是否选中
+         */
+        bool IsSelected(size_t row) const {
+            return (m_selection[row / BitsPerWord] >> (row % BitsPerWord)) & 1u;
+        }
+        
+        /**
+         * @brief 设置行的选择状态，合计值O(1)更新
+         * @param row 行号
+         * @param selected 是否选中
+         * @return bool 状态是否改变
+         */
+        bool SetSelected(size_t row, bool selected);
+        
+        /**
+         * @brief 切换行的选择状态
+         * @param row 行号
+         * @return bool 切换后是否选中
+         */
+        bool Toggle(size_t row);
+        
+        /**
+         * @brief 全选或全不选
+         * @param selected 是否选中
+         */
+        void SetAllSelected(bool selected);
+        
+        /**
+         * @brief 设置[first, last)范围内各行的选择状态
+         * @param first 起始行
+         * @param last 结束行（不含）
+         * @param selected 是否选中
+         */
+        void SetRangeSelected(size_t first, size_t last, bool selected);
+        
+        size_t GetSelectedCount() const { return m_selectedCount; }     ///< 选中项数
+        DWORD64 GetSelectedSize() const { return m_selectedSize; }      ///< 选中项大小之和
+        DWORD64 GetTotalSize() const { return m_totalSize; }            ///< 全部项大小之和
+        
+        /**
+         * @brief 按行号顺序取出选中的残留项（isSelected为true）
+         * @return std::vector<ResidualItem> 选中项
+         */
+        std::vector<ResidualItem> GetSelectedItems() const;
+        
+        /**
+         * @brief 按行号顺序取出全部残留项
+         * @return std::vector<ResidualItem> 全部项
+         */
+        std::vector<ResidualItem> GetAllItems() const;
+        
+        static const size_t BitsPerWord = 64;   ///< 位图每个字的位数
+    
+    private:
+        std::vector<ResidualGroup> m_groups;        ///< 分组
+        std::vector<size_t> m_groupStarts;          ///< 各分组的起始行（多一个结尾项）
+        std::vector<std::uint64_t> m_selection;     ///< 选择位图
+        size_t m_rowCount;                          ///< 行数
+        size_t m_selectedCount;                     ///< 选中项数
+        DWORD64 m_selectedSize;                     ///< 选中项大小之和
+        DWORD64 m_totalSize;                        ///< 全部项大小之和
+    };
+
+} // namespace YG
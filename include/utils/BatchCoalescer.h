@@ -0,0 +1,82 @@
+/**
+ * @file BatchCoalescer.h
+ * @brief 合并后台逐项结果并整批投递到窗口
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <mutex>
+#include <utility>
+
+namespace YG {
+    
+    /**
+     * @brief 结果批量合并器
+     *
+     * 工作线程逐项Add，结果先进入缓冲区；窗口消息队列中最多只有一条未处理的消息，
+     * 界面线程收到消息后用Take一次取走期间积累的全部结果，整批应用。
+     * 后台每秒产出上千项结果时，界面线程处理的消息数只与其自身的处理速度有关。
+     */
+    template<typename T>
+    class BatchCoalescer {
+    public:
+        /**
+         * @brief 构造函数
+         * @param targetWindow 接收消息的窗口
+         * @param message 消息，wParam和lParam均为0
+         */
+        BatchCoalescer(HWND targetWindow, UINT message)
+            : m_targetWindow(targetWindow), m_message(message), m_posted(false) {}
+        
+        YG_DISABLE_COPY_AND_ASSIGN(BatchCoalescer);
+        
+        /**
+         * @brief 加入一项结果（任意线程）
+         * @param item 结果
+         */
+        void Add(T item) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_back(std::move(item));
+                
+                // 已有消息在队列中：界面线程取走时会一并带上这一项
+                if (m_posted) {
+                    return;
+                }
+                m_posted = true;
+            }
+            
+            if (!PostMessage(m_targetWindow, m_message, 0, 0)) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_posted = false;
+            }
+        }
+        
+        /**
+         * @brief 取走积累的全部结果并允许下一次投递（界面线程）
+         * @param items 输出结果，按加入的顺序
+         * @return bool 是否取到结果
+         */
+        bool Take(std::vector<T>& items) {
+            items.clear();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_posted = false;
+            items.swap(m_pending);
+            return !items.empty();
+        }
+    
+    private:
+        HWND m_targetWindow;            ///< 接收消息的窗口
+        UINT m_message;                 ///< 消息
+        
+        std::mutex m_mutex;             ///< 保护以下成员
+        std::vector<T> m_pending;       ///< 尚未取走的结果
+        bool m_posted;                  ///< 是否有尚未处理的消息
+    };
+
+} // namespace YG
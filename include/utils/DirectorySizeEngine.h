@@ -0,0 +1,161 @@
+/**
+ * @file DirectorySizeEngine.h
+ * @brief 精确的并行目录大小统计
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include "utils/FileSystemSource.h"
+#include "utils/ThreadPool.h"
+#include <vector>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace YG {
+    
+    /**
+     * @brief 目录统计结果
+     */
+    struct DirectorySizeResult {
+        DWORD64 totalBytes = 0;             ///< 文件总字节数
+        DWORD64 fileCount = 0;              ///< 文件数量
+        DWORD64 directoryCount = 0;         ///< 目录数量（含根目录）
+        DWORD64 skippedReparsePoints = 0;   ///< 跳过的重解析点目录（联接、符号链接等）
+        DWORD64 inaccessibleDirectories = 0;///< 无法枚举的目录
+        DWORD64 cacheHits = 0;              ///< 直接使用缓存的目录数量
+    };
+    
+    /**
+     * @brief 目录大小统计引擎
+     *
+     * 对目录树做完整遍历（不设文件数或深度上限），累加所有文件的实际大小。
+     * 遍历以工作窃取方式并行：每个线程优先处理自己队列末尾的目录（深度优先，局部性好），
+     * 空闲时从其他线程队列头部窃取。辅助遍历只在待处理目录积压时按需提交到引擎的线程池，
+     * 小目录只用调用线程；多个线程同时调用Calculate时共用同一个线程池，辅助线程总数不超过maxThreads - 1。
+     *
+     * 每个目录的直接子项汇总（文件字节数、文件数、子目录列表）按"路径 + 最后写入时间"缓存。
+     * 目录的最后写入时间在其直接子项增删或改名时变化，命中缓存时无需重新枚举该目录，
+     * 只需查询各子目录的时间戳；文件原地改写不会改变目录时间戳，此时需调用ClearCache。
+     * 缓存的目录数有上限，超出时淘汰最久未使用的目录。
+     * 重解析点目录不进入，避免联接造成重复统计或循环。
+     */
+    class DirectorySizeEngine {
+    public:
+        /**
+         * @brief 构造函数
+         * @param fileSystem 文件系统数据源，为空时使用Win32FileSystemSource
+         * @param maxThreads 单次统计的最大线程数（含调用线程），0表示使用默认值
+         * @param maxCacheEntries 缓存的最大目录数，0表示使用默认值
+         */
+        explicit DirectorySizeEngine(std::shared_ptr<IFileSystemSource> fileSystem = nullptr, size_t maxThreads = 0,
+                                     size_t maxCacheEntries = 0);
+        
+        ~DirectorySizeEngine();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(DirectorySizeEngine);
+        
+        /**
+         * @brief 统计目录大小
+         * @param directoryPath 目录路径
+         * @param result 输出统计结果
+         * @param cancelFlag 取消标志，可为nullptr
+         * @return ErrorCode 操作结果，路径不存在或不是目录时返回FileNotFound，取消时返回OperationCancelled
+         */
+        ErrorCode Calculate(const String& directoryPath, DirectorySizeResult& result,
+                            const std::atomic<bool>* cancelFlag = nullptr);
+        
+        /**
+         * @brief 统计目录大小的简便形式
+         * @param directoryPath 目录路径
+         * @return DWORD64 文件总字节数，失败时为0
+         */
+        DWORD64 GetSize(const String& directoryPath);
+        
+        /**
+         * @brief 清除目录缓存
+         */
+        void ClearCache();
+        
+        /**
+         * @brief 获取缓存的目录数量
+         * @return size_t 目录数量
+         */
+        size_t GetCacheSize() const;
+        
+        /**
+         * @brief 获取进程内共享的引擎（使用Win32文件系统，各调用方共享缓存）
+         * @return DirectorySizeEngine& 共享引擎
+         */
+        static DirectorySizeEngine& GetShared();
+    
+    private:
+        struct Traversal;
+        
+        /**
+         * @brief 目录直接子项汇总（缓存项）
+         */
+        struct DirectorySummary {
+            DWORD64 lastWriteTime = 0;              ///< 汇总时目录的最后写入时间
+            DWORD64 fileBytes = 0;                  ///< 直接文件字节数
+            DWORD64 fileCount = 0;                  ///< 直接文件数
+            DWORD64 reparsePointCount = 0;          ///< 直接子项中的重解析点目录数
+            std::vector<String> subdirectories;     ///< 直接子目录名称
+        };
+        
+        /**
+         * @brief 缓存项：汇总及其在最近使用顺序中的位置
+         */
+        struct CacheEntry {
+            DirectorySummary summary;                       ///< 目录汇总
+            std::list<String>::iterator recentPosition;     ///< 在m_recentKeys中的位置
+        };
+        
+        /**
+         * @brief 遍历线程主循环
+         * @param traversal 遍历状态
+         * @param workerIndex 线程序号（0为调用线程）
+         */
+        void WorkerLoop(Traversal& traversal, size_t workerIndex);
+        
+        /**
+         * @brief 查找缓存并标记为最近使用（调用方需持有m_cacheMutex）
+         * @param key 缓存键
+         * @param lastWriteTime 目录当前的最后写入时间
+         * @return const DirectorySummary* 时间戳一致的汇总，没有时为nullptr
+         */
+        const DirectorySummary* FindCached(const String& key, DWORD64 lastWriteTime);
+        
+        /**
+         * @brief 保存汇总，超出上限时淘汰最久未使用的目录（调用方需持有m_cacheMutex）
+         * @param key 缓存键
+         * @param summary 目录汇总
+         */
+        void StoreCached(const String& key, DirectorySummary summary);
+        
+        /**
+         * @brief 处理一个目录：使用缓存或重新枚举，并把子目录放入本线程队列
+         * @param traversal 遍历状态
+         * @param workerIndex 线程序号
+         * @param directoryPath 目录路径
+         * @param lastWriteTime 目录当前的最后写入时间
+         */
+        void ProcessDirectory(Traversal& traversal, size_t workerIndex,
+                              const String& directoryPath, DWORD64 lastWriteTime);
+        
+        std::shared_ptr<IFileSystemSource> m_fileSystem;                ///< 文件系统数据源
+        size_t m_maxThreads;                                            ///< 单次统计的最大线程数
+        size_t m_maxCacheEntries;                                       ///< 缓存的最大目录数
+        std::unordered_map<String, CacheEntry> m_cache;                 ///< 目录缓存（键为小写路径）
+        std::list<String> m_recentKeys;                                 ///< 缓存键，最近使用的在前
+        mutable std::mutex m_cacheMutex;                                ///< 缓存锁
+        std::unique_ptr<ThreadPool> m_pool;                             ///< 辅助遍历线程池（maxThreads为1时为空）
+    };
+
+} // namespace YG
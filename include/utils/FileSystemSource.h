@@ -0,0 +1,206 @@
+/**
+ * @file FileSystemSource.h
+ * @brief 可替换的文件系统数据源（Win32 / 内存目录树）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <shared_mutex>
+
+namespace YG {
+    
+    /**
+     * @brief 目录项信息
+     */
+    struct FileSystemEntry {
+        String name;                ///< 名称（不含路径）
+        DWORD attributes;           ///< 文件属性（FILE_ATTRIBUTE_*）
+        DWORD64 size;               ///< 文件大小（目录为0）
+        DWORD64 lastWriteTime;      ///< 最后写入时间(FILETIME)
+        DWORD64 creationTime;       ///< 创建时间(FILETIME)
+        
+        FileSystemEntry() : attributes(0), size(0), lastWriteTime(0), creationTime(0) {}
+        
+        bool IsDirectory() const { return (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0; }
+        bool IsReparsePoint() const { return (attributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0; }
+    };
+    
+    /**
+     * @brief 文件系统数据源接口
+     *
+     * 提供目录统计所需的只读操作，以及残留清理、隔离所需的修改操作，返回值为Win32错误码。
+     */
+    class IFileSystemSource {
+    public:
+        virtual ~IFileSystemSource() = default;
+        
+        /**
+         * @brief 查询单个路径的信息（对应GetFileAttributesExW）
+         * @param path 文件或目录路径
+         * @param entry 输出路径信息
+         * @return DWORD Win32错误码
+         */
+        virtual DWORD GetEntry(const String& path, FileSystemEntry& entry) = 0;
+        
+        /**
+         * @brief 列出目录的直接子项，不包含"."和".."
+         * @param directoryPath 目录路径
+         * @param entries 输出子项列表
+         * @return DWORD Win32错误码
+         */
+        virtual DWORD ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) = 0;
+        
+        /**
+         * @brief 设置文件属性（对应SetFileAttributesW）
+         * @param path 文件或目录路径
+         * @param attributes 新属性，目录、重解析点属性不受影响
+         * @return DWORD Win32错误码
+         */
+        virtual DWORD SetAttributes(const String& path, DWORD attributes) = 0;
+        
+        /**
+         * @brief 删除文件或空目录（对应DeleteFileW / RemoveDirectoryW）
+         * @param path 路径
+         * @param directory 是否为目录；重解析点目录只删除链接本身
+         * @return DWORD Win32错误码，只读项返回ERROR_ACCESS_DENIED，非空目录返回ERROR_DIR_NOT_EMPTY
+         */
+        virtual DWORD RemoveEntry(const String& path, bool directory) = 0;
+        
+        /**
+         * @brief 同一卷内改名或移动（对应不带MOVEFILE_COPY_ALLOWED的MoveFileExW）
+         * @param fromPath 原路径
+         * @param toPath 新路径，须不存在且上级目录已存在
+         * @return DWORD Win32错误码，跨卷时返回ERROR_NOT_SAME_DEVICE
+         */
+        virtual DWORD MoveEntry(const String& fromPath, const String& toPath) = 0;
+        
+        /**
+         * @brief 创建单级目录（对应CreateDirectoryW）
+         * @param path 目录路径，上级目录须已存在
+         * @return DWORD Win32错误码，已存在时返回ERROR_ALREADY_EXISTS
+         */
+        virtual DWORD MakeDirectory(const String& path) = 0;
+        
+        /**
+         * @brief 读取整个文件
+         * @param path 文件路径
+         * @param data 输出文件内容
+         * @return DWORD Win32错误码
+         */
+        virtual DWORD ReadFileData(const String& path, std::vector<BYTE>& data) = 0;
+        
+        /**
+         * @brief 写入整个文件，已存在时覆盖
+         * @param path 文件路径，上级目录须已存在
+         * @param data 文件内容
+         * @return DWORD Win32错误码
+         */
+        virtual DWORD WriteFileData(const String& path, const std::vector<BYTE>& data) = 0;
+    };
+    
+    /**
+     * @brief 直接调用Win32文件API的数据源（默认数据源）
+     *
+     * 目录枚举使用FindFirstFileExW(FindExInfoBasic, FIND_FIRST_EX_LARGE_FETCH)，
+     * 不查询8.3短文件名，并以较大的缓冲区批量取回目录项。
+     */
+    class Win32FileSystemSource : public IFileSystemSource {
+    public:
+        DWORD GetEntry(const String& path, FileSystemEntry& entry) override;
+        DWORD ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) override;
+        DWORD SetAttributes(const String& path, DWORD attributes) override;
+        DWORD RemoveEntry(const String& path, bool directory) override;
+        DWORD MoveEntry(const String& fromPath, const String& toPath) override;
+        DWORD MakeDirectory(const String& path) override;
+        DWORD ReadFileData(const String& path, std::vector<BYTE>& data) override;
+        DWORD WriteFileData(const String& path, const std::vector<BYTE>& data) override;
+    };
+    
+    /**
+     * @brief 内存目录树数据源
+     *
+     * 用于在没有真实磁盘数据的环境下驱动目录统计（回归测试、性能分析）。
+     * 路径不区分大小写，添加或删除子项时会更新父目录的最后写入时间，与NTFS行为一致；
+     * RemoveEntry与Win32一样拒绝删除只读项和非空目录；路径的第一级视为卷，MoveEntry不允许跨卷。
+     */
+    class MemoryFileSystemSource : public IFileSystemSource {
+    public:
+        MemoryFileSystemSource();
+        
+        /**
+         * @brief 添加文件，自动创建缺失的上级目录；文件已存在时更新大小
+         * @param path 文件路径
+         * @param size 文件大小
+         */
+        void AddFile(const String& path, DWORD64 size);
+        
+        /**
+         * @brief 添加目录，自动创建缺失的上级目录
+         * @param path 目录路径
+         * @param attributes 附加属性（例如FILE_ATTRIBUTE_REPARSE_POINT）
+         */
+        void AddDirectory(const String& path, DWORD attributes = 0);
+        
+        /**
+         * @brief 删除文件或整个目录子树
+         * @param path 路径
+         * @return bool 路径是否存在
+         */
+        bool Remove(const String& path);
+        
+        /**
+         * @brief 清空所有数据
+         */
+        void Clear();
+        
+        DWORD GetEntry(const String& path, FileSystemEntry& entry) override;
+        DWORD ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) override;
+        DWORD SetAttributes(const String& path, DWORD attributes) override;
+        DWORD RemoveEntry(const String& path, bool directory) override;
+        DWORD MoveEntry(const String& fromPath, const String& toPath) override;
+        DWORD MakeDirectory(const String& path) override;
+        DWORD ReadFileData(const String& path, std::vector<BYTE>& data) override;
+        DWORD WriteFileData(const String& path, const std::vector<BYTE>& data) override;
+    
+    private:
+        struct MemoryNode {
+            FileSystemEntry entry;                  ///< 节点信息
+            std::vector<String> children;           ///< 子项的规范化路径（按插入顺序）
+            std::vector<BYTE> data;                 ///< 文件内容（只保存WriteFileData写入的内容）
+        };
+        
+        /**
+         * @brief 规范化路径：统一为"\\"分隔、去掉末尾分隔符并转为小写
+         */
+        static String NormalizePath(const String& path);
+        
+        /**
+         * @brief 上级目录是否存在，卷根目录视为总是存在（调用方需持有锁）
+         */
+        bool HasParentDirectory(const String& key) const;
+        
+        /**
+         * @brief 获取或创建节点，并挂到父目录下（调用方需持有写锁）
+         */
+        MemoryNode& EnsureNode(const String& path, bool directory);
+        
+        /**
+         * @brief 生成下一个写入时间戳（调用方需持有写锁）
+         */
+        DWORD64 NextWriteTime();
+        
+        std::unordered_map<String, MemoryNode> m_nodes;     ///< 规范化路径 -> 节点
+        DWORD64 m_clock;                                    ///< 单调递增的伪时间
+        mutable std::shared_mutex m_mutex;                  ///< 读写锁
+        
+        YG_DISABLE_COPY_AND_ASSIGN(MemoryFileSystemSource);
+    };
+
+} // namespace YG
@@ -0,0 +1,71 @@
+/**
+ * @file ProgressCoalescer.h
+ * @brief 合并后台进度并限速投递到窗口
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <mutex>
+
+namespace YG {
+    
+    /**
+     * @brief 进度合并器
+     *
+     * 工作线程每次报告进度只覆盖保存的最新值；窗口消息队列中最多只有一条未处理的进度消息，
+     * 且两次投递之间至少间隔minIntervalMs，界面线程收到消息后用Take取走最新值。
+     * 扫描再快也不会让进度消息塞满消息队列，界面看到的总是最新的进度。
+     */
+    class ProgressCoalescer {
+    public:
+        /**
+         * @brief 构造函数
+         * @param targetWindow 接收进度消息的窗口
+         * @param message 进度消息，wParam为tag，lParam为0
+         * @param tag 随消息投递的标记，用于区分不同批次的任务
+         * @param minIntervalMs 两次投递的最小间隔(毫秒)
+         */
+        ProgressCoalescer(HWND targetWindow, UINT message, WPARAM tag, DWORD minIntervalMs);
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ProgressCoalescer);
+        
+        /**
+         * @brief 报告进度（任意线程）
+         * @param percentage 进度百分比
+         * @param currentItem 当前处理项
+         */
+        void Report(int percentage, const String& currentItem);
+        
+        /**
+         * @brief 取走最新进度并允许下一次投递（界面线程）
+         * @param percentage 输出进度百分比
+         * @param currentItem 输出当前处理项
+         * @return bool 上次取走后是否有新的进度
+         */
+        bool Take(int& percentage, String& currentItem);
+        
+        /**
+         * @brief 获取投递标记
+         * @return WPARAM 标记
+         */
+        WPARAM GetTag() const { return m_tag; }
+    
+    private:
+        HWND m_targetWindow;            ///< 接收消息的窗口
+        UINT m_message;                 ///< 进度消息
+        WPARAM m_tag;                   ///< 投递标记
+        DWORD m_minIntervalMs;          ///< 最小投递间隔
+        
+        std::mutex m_mutex;             ///< 保护以下成员
+        int m_percentage;               ///< 最新进度
+        String m_currentItem;           ///< 最新处理项
+        bool m_hasUpdate;               ///< 是否有未取走的进度
+        bool m_posted;                  ///< 是否有尚未处理的进度消息
+        ULONGLONG m_lastPostTick;       ///< 上次投递的时间
+    };
+
+} // namespace YG
@@ -9,8 +9,13 @@
 #pragma once
 
 #include "core/Common.h"
+#include "utils/RegistrySource.h"
 #include <vector>
+#include <memory>
 #include <functional>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
 
 namespace YG {
     
@@ -54,10 +59,55 @@ namespace YG {
         }
     };
     
+    /**
+     * @brief 子树搜索匹配的对象
+     */
+    enum RegistrySearchTarget : unsigned {
+        RegistrySearchKeyName = 1u << 0,        ///< 键名称
+        RegistrySearchValueName = 1u << 1,      ///< 值名称
+        RegistrySearchValueData = 1u << 2,      ///< 字符串值数据（REG_SZ、REG_EXPAND_SZ、REG_MULTI_SZ）
+        RegistrySearchAll = RegistrySearchKeyName | RegistrySearchValueName | RegistrySearchValueData
+    };
+    
+    /**
+     * @brief 子树搜索的一个命中
+     */
+    struct RegistrySearchHit {
+        String keyPath;                         ///< 键路径（相对于搜索的根键）
+        String valueName;                       ///< 值名称（命中值名称或值数据时）
+        String valueData;                       ///< 值数据（命中值数据时，REG_MULTI_SZ各项以";"分隔）
+        RegistrySearchTarget target = RegistrySearchKeyName;    ///< 命中的对象
+        std::uint32_t pattern = 0;              ///< 匹配器给出的模式编号
+        int depth = 0;                          ///< 键相对于起始键的深度（起始键的子键为1）
+    };
+    
+    /**
+     * @brief 编译好的模式集：文本命中时返回true并给出模式编号，须可在多个线程中同时调用
+     */
+    using RegistryTextMatcher = std::function<bool(std::wstring_view text, std::uint32_t& pattern)>;
+    
+    /**
+     * @brief 命中回调，调用已串行化；返回false时停止搜索
+     */
+    using RegistrySearchCallback = std::function<bool(const RegistrySearchHit& hit)>;
+    
+    /**
+     * @brief 子树搜索选项
+     */
+    struct RegistrySearchOptions {
+        unsigned targets = RegistrySearchAll;           ///< 匹配的对象（RegistrySearchTarget的组合）
+        int maxDepth = 16;                              ///< 最大深度（起始键的子键为1），起始键本身只检查值
+        size_t maxResults = 1000;                       ///< 最多报告的命中数
+        size_t maxThreads = 0;                          ///< 最大线程数（含调用线程），0表示使用默认值
+        bool skipMatchedSubtrees = false;               ///< 键名称命中后不再进入其子树
+        const std::atomic<bool>* cancelFlag = nullptr;  ///< 取消标志，可为nullptr
+    };
+    
     /**
      * @brief 注册表操作工具类
      * 
-     * 提供安全、便捷的注册表操作接口
+     * 提供安全、便捷的注册表操作接口。所有操作都经由当前的IRegistrySource完成，
+     * 默认为Win32RegistrySource，可替换为MemoryRegistrySource以离线驱动扫描流程。
      */
     class RegistryHelper {
     public:
@@ -71,6 +121,21 @@ namespace YG {
          */
         ~RegistryHelper() = default;
         
+        // 数据源
+        
+        /**
+         * @brief 替换全局注册表数据源
+         * @param source 新数据源，传入nullptr时恢复为Win32数据源
+         * @note 已在进行中的操作继续使用替换前的数据源
+         */
+        static void SetSource(std::shared_ptr<IRegistrySource> source);
+        
+        /**
+         * @brief 获取当前注册表数据源
+         * @return std::shared_ptr<IRegistrySource> 当前数据源（不为空）
+         */
+        static std::shared_ptr<IRegistrySource> GetSource();
+        
         // 键操作
         
         /**
@@ -156,6 +221,24 @@ namespace YG {
          */
         static ErrorCode ReadDWord(HKEY hKey, const String& valueName, DWORD& value);
         
+        /**
+         * @brief 将原始值数据解码为字符串（REG_SZ/REG_EXPAND_SZ，截取到第一个空字符）
+         * @param type 值类型
+         * @param data 值数据
+         * @param value 输出字符串
+         * @return bool 类型匹配时返回true
+         */
+        static bool DecodeString(DWORD type, const std::vector<BYTE>& data, String& value);
+        
+        /**
+         * @brief 将原始值数据解码为DWORD（REG_DWORD）
+         * @param type 值类型
+         * @param data 值数据
+         * @param value 输出DWORD值
+         * @return bool 类型与长度匹配时返回true
+         */
+        static bool DecodeDWord(DWORD type, const std::vector<BYTE>& data, DWORD& value);
+        
         /**
          * @brief 读取QWORD值
          * @param hKey 键句柄
@@ -268,10 +351,26 @@ namespace YG {
          */
         static ErrorCode BackupKey(HKEY hKeyParent, const String& subKey, const String& backupPath);
         
+        /**
+         * @brief 并行搜索注册表子树
+         *
+         * 调用线程与按需创建的辅助线程以工作窃取方式遍历子树，每个键只打开一次：
+         * 键名称、值名称、字符串值数据交给同一个匹配器，命中随找随报，不必等待遍历结束。
+         * 达到maxResults或回调返回false后其余线程尽快停止。
+         * @param hKeyRoot 根键句柄
+         * @param subKey 起始键路径，空字符串表示根键本身
+         * @param matcher 模式集
+         * @param options 搜索选项
+         * @param callback 命中回调
+         * @return ErrorCode 操作结果，起始键无法打开时返回RegistryError，取消时返回OperationCancelled
+         */
+        static ErrorCode SearchTree(HKEY hKeyRoot, const String& subKey, const RegistryTextMatcher& matcher,
+                                    const RegistrySearchOptions& options, const RegistrySearchCallback& callback);
+        
         /**
          * @brief 搜索注册表键
          * @param hKeyRoot 根键句柄
-         * @param searchPattern 搜索模式
+         * @param searchPattern 搜索模式（不区分大小写，支持*和?，不含通配符时按包含匹配）
          * @param foundKeys 输出找到的键路径
          * @param maxResults 最大结果数
          * @return ErrorCode 操作结果
@@ -280,10 +379,10 @@ namespace YG {
                                    StringVector& foundKeys, int maxResults = 1000);
         
         /**
-         * @brief 搜索注册表值
+         * @brief 搜索注册表值（值名称或字符串数据）
          * @param hKeyRoot 根键句柄
-         * @param searchPattern 搜索模式
-         * @param foundValues 输出找到的值路径
+         * @param searchPattern 搜索模式（同SearchKeys）
+         * @param foundValues 输出找到的值路径（键路径\\值名称）
          * @param maxResults 最大结果数
          * @return ErrorCode 操作结果
          */
@@ -357,38 +456,12 @@ namespace YG {
         
     private:
         /**
-         * @brief 递归搜索键
-         * @param hKey 当前键句柄
-         * @param currentPath 当前路径
-         * @param searchPattern 搜索模式
-         * @param foundKeys 找到的键列表
-         * @param maxResults 最大结果数
-         * @param currentCount 当前计数
-         */
-        static void RecursiveSearchKeys(HKEY hKey, const String& currentPath, 
-                                       const String& searchPattern, StringVector& foundKeys, 
-                                       int maxResults, int& currentCount);
-        
-        /**
-         * @brief 递归搜索值
-         * @param hKey 当前键句柄
-         * @param currentPath 当前路径
-         * @param searchPattern 搜索模式
-         * @param foundValues 找到的值列表
-         * @param maxResults 最大结果数
-         * @param currentCount 当前计数
-         */
-        static void RecursiveSearchValues(HKEY hKey, const String& currentPath, 
-                                         const String& searchPattern, StringVector& foundValues, 
-                                         int maxResults, int& currentCount);
-        
-        /**
-         * @brief 模式匹配
+         * @brief 模式匹配（不区分大小写，*匹配任意个字符，?匹配一个字符；不含通配符时按包含匹配）
          * @param text 文本
          * @param pattern 模式
          * @return bool 是否匹配
          */
-        static bool PatternMatch(const String& text, const String& pattern);
+        static bool PatternMatch(std::wstring_view text, std::wstring_view pattern);
     };
     
 } // namespace YG
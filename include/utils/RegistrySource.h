@@ -0,0 +1,261 @@
+/**
+ * @file RegistrySource.h
+ * @brief 可替换的注册表数据源（Win32 / 内存 .reg 夹具）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <memory>
+#include <shared_mutex>
+
+namespace YG {
+    
+    /**
+     * @brief 注册表数据源接口
+     *
+     * 所有注册表读写都经由此接口完成，语义与对应的Win32注册表API保持一致：
+     * 返回值为Win32错误码（ERROR_SUCCESS、ERROR_FILE_NOT_FOUND、ERROR_NO_MORE_ITEMS等），
+     * 句柄为不透明的HKEY，预定义根键（HKEY_LOCAL_MACHINE等）可直接作为父键使用。
+     */
+    class IRegistrySource {
+    public:
+        /**
+         * @brief 值枚举回调
+         * @param name 值名称
+         * @param type 值类型
+         * @param data 值数据（不读取数据时为空），只在回调期间有效
+         * @return bool 是否继续枚举
+         */
+        using ValueVisitor = std::function<bool(const String& name, DWORD type, const std::vector<BYTE>& data)>;
+        
+        virtual ~IRegistrySource() = default;
+        
+        /**
+         * @brief 打开子键（对应RegOpenKeyExW）
+         * @param hKeyParent 父键句柄
+         * @param subKey 子键路径，可包含多级"\\"
+         * @param samDesired 访问权限
+         * @param hKey 输出键句柄
+         * @return LONG Win32错误码
+         */
+        virtual LONG OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) = 0;
+        
+        /**
+         * @brief 创建或打开子键（对应RegCreateKeyExW）
+         * @param hKeyParent 父键句柄
+         * @param subKey 子键路径
+         * @param hKey 输出键句柄
+         * @param created 输出是否为新创建
+         * @return LONG Win32错误码
+         */
+        virtual LONG CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) = 0;
+        
+        /**
+         * @brief 关闭键句柄（对应RegCloseKey）
+         * @param hKey 键句柄
+         * @return LONG Win32错误码
+         */
+        virtual LONG CloseKey(HKEY hKey) = 0;
+        
+        /**
+         * @brief 按索引枚举子键名称（对应RegEnumKeyExW，名称不截断）
+         * @param hKey 键句柄
+         * @param index 子键索引
+         * @param name 输出子键名称
+         * @return LONG Win32错误码，枚举结束时返回ERROR_NO_MORE_ITEMS
+         */
+        virtual LONG EnumKey(HKEY hKey, DWORD index, String& name) = 0;
+        
+        /**
+         * @brief 按索引枚举值（对应RegEnumValueW，数据不截断）
+         * @param hKey 键句柄
+         * @param index 值索引
+         * @param name 输出值名称
+         * @param type 输出值类型，可为nullptr
+         * @param data 输出值数据，可为nullptr
+         * @return LONG Win32错误码，枚举结束时返回ERROR_NO_MORE_ITEMS
+         */
+        virtual LONG EnumValue(HKEY hKey, DWORD index, String& name,
+                               DWORD* type, std::vector<BYTE>* data) = 0;
+        
+        /**
+         * @brief 依次枚举键中的全部值，名称和数据缓冲区在整个枚举中复用
+         *
+         * 默认实现逐个调用EnumValue；枚举一个键的全部值时应优先使用本函数。
+         * @param hKey 键句柄
+         * @param withData 是否读取值数据
+         * @param visitor 回调，返回false时停止枚举
+         * @return LONG Win32错误码，枚举完或回调停止时返回ERROR_SUCCESS
+         */
+        virtual LONG EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor);
+        
+        /**
+         * @brief 按名称查询值（对应RegQueryValueExW，数据不截断）
+         * @param hKey 键句柄
+         * @param valueName 值名称，空字符串表示默认值
+         * @param type 输出值类型，可为nullptr
+         * @param data 输出值数据，可为nullptr
+         * @return LONG Win32错误码
+         */
+        virtual LONG QueryValue(HKEY hKey, const String& valueName,
+                                DWORD* type, std::vector<BYTE>* data) = 0;
+        
+        /**
+         * @brief 写入值（对应RegSetValueExW）
+         * @param hKey 键句柄
+         * @param valueName 值名称
+         * @param type 值类型
+         * @param data 值数据
+         * @param dataSize 数据字节数
+         * @return LONG Win32错误码
+         */
+        virtual LONG SetValue(HKEY hKey, const String& valueName, DWORD type,
+                              const BYTE* data, DWORD dataSize) = 0;
+        
+        /**
+         * @brief 查询键信息（对应RegQueryInfoKeyW）
+         * @param hKey 键句柄
+         * @param subKeyCount 输出子键数量，可为nullptr
+         * @param valueCount 输出值数量，可为nullptr
+         * @param lastWriteTime 输出最后写入时间，可为nullptr
+         * @return LONG Win32错误码
+         */
+        virtual LONG QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                                  FILETIME* lastWriteTime) = 0;
+        
+        /**
+         * @brief 删除没有子键的键（对应RegDeleteKeyW）
+         * @param hKeyParent 父键句柄
+         * @param subKey 子键路径
+         * @return LONG Win32错误码
+         */
+        virtual LONG DeleteKey(HKEY hKeyParent, const String& subKey) = 0;
+        
+        /**
+         * @brief 删除值（对应RegDeleteValueW）
+         * @param hKey 键句柄
+         * @param valueName 值名称
+         * @return LONG Win32错误码
+         */
+        virtual LONG DeleteValue(HKEY hKey, const String& valueName) = 0;
+    };
+    
+    /**
+     * @brief 直接调用Win32注册表API的数据源（默认数据源）
+     */
+    class Win32RegistrySource : public IRegistrySource {
+    public:
+        LONG OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) override;
+        LONG CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) override;
+        LONG CloseKey(HKEY hKey) override;
+        LONG EnumKey(HKEY hKey, DWORD index, String& name) override;
+        LONG EnumValue(HKEY hKey, DWORD index, String& name,
+                       DWORD* type, std::vector<BYTE>* data) override;
+        LONG EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor) override;
+        LONG QueryValue(HKEY hKey, const String& valueName,
+                        DWORD* type, std::vector<BYTE>* data) override;
+        LONG SetValue(HKEY hKey, const String& valueName, DWORD type,
+                      const BYTE* data, DWORD dataSize) override;
+        LONG QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                          FILETIME* lastWriteTime) override;
+        LONG DeleteKey(HKEY hKeyParent, const String& subKey) override;
+        LONG DeleteValue(HKEY hKey, const String& valueName) override;
+    };
+    
+    /**
+     * @brief 内存注册表树数据源
+     *
+     * 用于在没有真实注册表的环境下驱动扫描流程（回归测试、性能分析）。
+     * 可从regedit导出的.reg文本加载，也可通过CreateKey/SetValue构造合成数据。
+     * 子键与值按插入顺序枚举，名称查找不区分大小写，所有操作线程安全。
+     */
+    class MemoryRegistrySource : public IRegistrySource {
+    public:
+        /**
+         * @brief 构造函数，创建空的预定义根键
+         */
+        MemoryRegistrySource();
+        
+        /**
+         * @brief 析构函数
+         */
+        ~MemoryRegistrySource() override;
+        
+        /**
+         * @brief 加载.reg文本（"Windows Registry Editor Version 5.00"或"REGEDIT4"格式）
+         * @param regText .reg文件内容
+         * @return ErrorCode 操作结果，格式错误时返回InvalidParameter
+         */
+        ErrorCode LoadRegText(const String& regText);
+        
+        /**
+         * @brief 从磁盘加载.reg文件（支持UTF-16LE与UTF-8编码）
+         * @param filePath 文件路径
+         * @return ErrorCode 操作结果
+         */
+        ErrorCode LoadRegFile(const String& filePath);
+        
+        /**
+         * @brief 清空所有数据
+         */
+        void Clear();
+        
+        /**
+         * @brief 设置后续写入使用的最后写入时间（便于构造确定性夹具）
+         * @param lastWriteTime 最后写入时间
+         */
+        void SetDefaultWriteTime(const FILETIME& lastWriteTime);
+        
+        LONG OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) override;
+        LONG CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) override;
+        LONG CloseKey(HKEY hKey) override;
+        LONG EnumKey(HKEY hKey, DWORD index, String& name) override;
+        LONG EnumValue(HKEY hKey, DWORD index, String& name,
+                       DWORD* type, std::vector<BYTE>* data) override;
+        LONG QueryValue(HKEY hKey, const String& valueName,
+                        DWORD* type, std::vector<BYTE>* data) override;
+        LONG SetValue(HKEY hKey, const String& valueName, DWORD type,
+                      const BYTE* data, DWORD dataSize) override;
+        LONG QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                          FILETIME* lastWriteTime) override;
+        LONG DeleteKey(HKEY hKeyParent, const String& subKey) override;
+        LONG DeleteValue(HKEY hKey, const String& valueName) override;
+    
+    private:
+        struct MemoryKey;
+        struct MemoryHandle;
+        
+        /**
+         * @brief 将句柄解析为内存键节点（调用方需持有锁）
+         */
+        std::shared_ptr<MemoryKey> ResolveKey(HKEY hKey) const;
+        
+        /**
+         * @brief 沿路径查找子键，create为true时逐级创建（调用方需持有锁）
+         */
+        std::shared_ptr<MemoryKey> WalkPath(const std::shared_ptr<MemoryKey>& start,
+                                            const String& subKey, bool create, bool* created);
+        
+        /**
+         * @brief 递归删除路径指向的整棵子树（.reg中的[-KEY]语法）
+         */
+        void DeleteTree(const std::shared_ptr<MemoryKey>& parent, const String& subKey);
+        
+        /**
+         * @brief 解析.reg中的值赋值行
+         */
+        bool ParseValueLine(const std::shared_ptr<MemoryKey>& key, const String& line);
+        
+        std::vector<std::shared_ptr<MemoryKey>> m_roots;   ///< 预定义根键节点
+        FILETIME m_defaultWriteTime;                        ///< 写入时使用的时间戳
+        mutable std::shared_mutex m_mutex;                  ///< 树结构读写锁
+        
+        YG_DISABLE_COPY_AND_ASSIGN(MemoryRegistrySource);
+    };
+
+} // namespace YG
@@ -0,0 +1,131 @@
+/**
+ * @file RegistryWatcher.h
+ * @brief 注册表变更通知（Win32 RegNotifyChangeKeyValue / 手动触发）
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <atomic>
+
+namespace YG {
+    
+    /**
+     * @brief 需要监视的注册表键
+     */
+    struct RegistryWatchTarget {
+        HKEY rootKey;           ///< 根键
+        String path;            ///< 子键路径
+    };
+    
+    /**
+     * @brief 注册表变更通知器接口
+     *
+     * Start后，任一目标键（含其子树）发生写入时，在通知器内部线程上以目标序号调用回调。
+     * 同一次安装可能连续触发多次回调，调用方应保证处理是幂等的。
+     */
+    class IRegistryChangeNotifier {
+    public:
+        using ChangeCallback = std::function<void(size_t targetIndex)>;
+        
+        virtual ~IRegistryChangeNotifier() = default;
+        
+        /**
+         * @brief 开始监视
+         * @param targets 目标键列表
+         * @param callback 变更回调
+         * @return ErrorCode 操作结果，没有任何目标键可监视时返回失败
+         */
+        virtual ErrorCode Start(const std::vector<RegistryWatchTarget>& targets, const ChangeCallback& callback) = 0;
+        
+        /**
+         * @brief 停止监视，返回后不会再调用回调
+         */
+        virtual void Stop() = 0;
+        
+        /**
+         * @brief 是否正在监视
+         * @return bool 是否正在监视
+         */
+        virtual bool IsRunning() const = 0;
+        
+        /**
+         * @brief 运行期间是否每个目标键（或尚不存在的目标键的上级键）都在监视中
+         * @return bool 部分目标无法监视时返回false，调用方不应完全依赖通知
+         */
+        virtual bool IsWatchingAll() const = 0;
+    };
+    
+    /**
+     * @brief 基于RegNotifyChangeKeyValue的通知器
+     *
+     * 在独立线程中打开目标键并注册异步通知（通知与注册线程绑定），
+     * 每次事件触发后重新注册。目标键尚不存在时（例如还没有安装过32位程序）改为监视
+     * 最近的已存在上级键的子键增删，目标键出现后切换到目标键并回调一次；
+     * 因其他错误无法打开的目标键会被跳过。
+     */
+    class Win32RegistryChangeNotifier : public IRegistryChangeNotifier {
+    public:
+        Win32RegistryChangeNotifier();
+        ~Win32RegistryChangeNotifier() override;
+        
+        ErrorCode Start(const std::vector<RegistryWatchTarget>& targets, const ChangeCallback& callback) override;
+        void Stop() override;
+        bool IsRunning() const override;
+        bool IsWatchingAll() const override;
+    
+    private:
+        /**
+         * @brief 监视线程主循环
+         * @param readyCallback 注册完成后以成功注册的目标数量调用
+         */
+        void WatchLoop(const std::function<void(size_t)>& readyCallback);
+        
+        std::vector<RegistryWatchTarget> m_targets;    ///< 目标键
+        ChangeCallback m_callback;                      ///< 变更回调
+        std::unique_ptr<std::thread> m_thread;          ///< 监视线程
+        HANDLE m_stopEvent;                             ///< 停止事件
+        std::atomic<size_t> m_unwatchedCount;           ///< 无法监视的目标数量
+        mutable std::mutex m_mutex;                     ///< 启停锁
+        
+        YG_DISABLE_COPY_AND_ASSIGN(Win32RegistryChangeNotifier);
+    };
+    
+    /**
+     * @brief 手动触发的通知器
+     *
+     * 不访问系统注册表，由调用方通过Trigger模拟变更；
+     * 用于内存注册表数据源、回归测试或需要完全静默的场景。
+     */
+    class ManualRegistryChangeNotifier : public IRegistryChangeNotifier {
+    public:
+        ManualRegistryChangeNotifier() = default;
+        
+        ErrorCode Start(const std::vector<RegistryWatchTarget>& targets, const ChangeCallback& callback) override;
+        void Stop() override;
+        bool IsRunning() const override;
+        bool IsWatchingAll() const override { return true; }
+        
+        /**
+         * @brief 模拟目标键发生变更（在调用线程上同步执行回调）
+         * @param targetIndex 目标序号
+         */
+        void Trigger(size_t targetIndex);
+    
+    private:
+        size_t m_targetCount = 0;           ///< 目标数量
+        ChangeCallback m_callback;          ///< 变更回调
+        mutable std::mutex m_mutex;         ///< 状态锁
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ManualRegistryChangeNotifier);
+    };
+
+} // namespace YG
@@ -0,0 +1,91 @@
+/**
+ * @file ThreadPool.h
+ * @brief 固定大小的工作线程池
+ * @author YG Software
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#pragma once
+
+#include "core/Common.h"
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace YG {
+    
+    /**
+     * @brief 固定大小的工作线程池
+     *
+     * 任务按提交顺序出队，通过std::future返回结果或异常。
+     * 析构时会先执行完队列中剩余的任务，再等待所有工作线程退出。
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @brief 构造函数
+         * @param threadCount 工作线程数，0表示使用DefaultThreadCount()
+         */
+        explicit ThreadPool(size_t threadCount = 0);
+        
+        /**
+         * @brief 析构函数
+         */
+        ~ThreadPool();
+        
+        YG_DISABLE_COPY_AND_ASSIGN(ThreadPool);
+        
+        /**
+         * @brief 提交任务
+         * @param func 可调用对象
+         * @return std::future 任务结果
+         */
+        template<typename Func>
+        auto Submit(Func&& func) -> std::future<typename std::invoke_result<Func>::type> {
+            using ResultType = typename std::invoke_result<Func>::type;
+            
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Func>(func));
+            std::future<ResultType> future = task->get_future();
+            
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.emplace([task]() { (*task)(); });
+            }
+            m_condition.notify_one();
+            
+            return future;
+        }
+        
+        /**
+         * @brief 获取工作线程数
+         * @return size_t 线程数
+         */
+        size_t GetThreadCount() const { return m_workers.size(); }
+        
+        /**
+         * @brief 获取默认线程数（硬件并发数，至少为1）
+         * @return size_t 线程数
+         */
+        static size_t DefaultThreadCount();
+    
+    private:
+        /**
+         * @brief 工作线程主循环
+         */
+        void WorkerLoop();
+        
+        std::vector<std::thread> m_workers;             ///< 工作线程
+        std::queue<std::function<void()>> m_tasks;      ///< 待执行任务队列
+        std::mutex m_mutex;                             ///< 队列锁
+        std::condition_variable m_condition;            ///< 任务到达/停止通知
+        bool m_stopping;                                ///< 是否正在停止
+    };
+
+} // namespace YG
@@ -79,6 +79,7 @@
 #define ID_TOOLS_OPTIONS                40046
 #define ID_TOOLS_LOG_MANAGER            40047
 #define ID_TOOLS_SETTINGS               40048
+#define ID_TOOLS_UNDO_CLEANUP           40049
 
 // 对话框ID
 #define IDD_SETTINGS_GENERAL            200
@@ -11,10 +11,13 @@
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 #include "ui/MainWindow.h"
+#include "services/QuarantineStore.h"
+#include "utils/RegistryHelper.h"
 #include <windows.h>
 #include <commctrl.h>
 #include <objbase.h>
 #include <memory>
+#include <algorithm>
 
 // 链接必要的库（MSVC专用，GCC通过编译器参数链接）
 #ifdef _MSC_VER
@@ -80,6 +83,11 @@ ErrorCode InitializeApplication() {
         YG_LOG_WARNING(L"配置加载失败，使用默认配置");
     }
     
+    // 后台按保留天数清理隔离区
+    QuarantineRetention retention;
+    retention.maxAgeDays = static_cast<DWORD>(std::max(0, Config::GetInstance().GetInt(L"QuarantineRetentionDays", 7)));
+    QuarantineStore::GetShared().StartBackgroundPurge(retention);
+    
     // 设置错误处理器
     ErrorHandler::GetInstance().EnableAutoLogging(true);
     ErrorHandler::GetInstance().EnableErrorDialog(true);
@@ -103,6 +111,9 @@ void CleanupApplication() {
         OutputDebugStringW(L"配置保存失败\n");
     }
     
+    // 停止隔离区后台清理
+    QuarantineStore::GetShared().StopBackgroundPurge();
+    
     // 强制等待确保所有线程和操作完成
     Sleep(300);
     
@@ -281,7 +292,16 @@ int wmain(int argc, wchar_t* argv[]) {
                 wprintf(L"选项:\n");
                 wprintf(L"  --version, -v    显示版本信息\n");
                 wprintf(L"  --help, -h       显示此帮助信息\n");
+                wprintf(L"  --registry-fixture <file.reg>  从.reg文件加载内存注册表代替系统注册表\n");
                 return 0;
+            } else if (arg == L"--registry-fixture" && i + 1 < argc) {
+                // 使用.reg夹具驱动扫描流程，便于离线复现和性能分析
+                auto fixture = std::make_shared<MemoryRegistrySource>();
+                if (fixture->LoadRegFile(argv[++i]) != ErrorCode::Success) {
+                    fwprintf(stderr, L"无法加载注册表夹具: %s\n", argv[i]);
+                    return 1;
+                }
+                RegistryHelper::SetSource(fixture);
             }
         }
     }
@@ -8,6 +8,8 @@
 
 #include "core/Common.h"
 #include "core/Logger.h"
+#include "utils/RegistryHelper.h"
+#include "utils/DirectorySizeEngine.h"
 #include <windows.h>
 #include <vector>
 #include <string>
@@ -15,7 +17,6 @@
 namespace YG {
 
 // 前向声明
-DWORD64 EstimateDirectorySize(const String& directoryPath);
 DWORD64 EstimateExecutableSize(const String& uninstallString);
 String GetDateFromUninstallString(const String& uninstallString);
 String GetDateFromDirectory(const String& directoryPath);
@@ -46,6 +47,7 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
     };
     
     int totalFound = 0;
+    auto registry = RegistryHelper::GetSource();
     
     for (int pathIndex = 0; pathIndex < 4; pathIndex++) {
         YG_LOG_INFO(L"尝试打开注册表路径: " + String(registryPaths[pathIndex].description) + L" - " + String(registryPaths[pathIndex].path));
@@ -53,8 +55,8 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
         HKEY hUninstallKey;
         
         // 打开卸载注册表键
-        LONG result = RegOpenKeyExW(registryPaths[pathIndex].rootKey, registryPaths[pathIndex].path, 
-                                   0, KEY_READ, &hUninstallKey);
+        LONG result = registry->OpenKey(registryPaths[pathIndex].rootKey, registryPaths[pathIndex].path, 
+                                        KEY_READ, hUninstallKey);
         if (result != ERROR_SUCCESS) {
             YG_LOG_WARNING(L"无法打开注册表键，错误代码: " + std::to_wstring(result));
             continue; // 跳过无法打开的键
@@ -64,21 +66,17 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
         
         // 枚举所有子键
         DWORD index = 0;
-        wchar_t subKeyName[256];
-        DWORD subKeyNameSize;
+        String subKeyName;
         
         while (true) {
-            subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
-            
-            result = RegEnumKeyExW(hUninstallKey, index, subKeyName, &subKeyNameSize,
-                                  nullptr, nullptr, nullptr, nullptr);
+            result = registry->EnumKey(hUninstallKey, index, subKeyName);
             if (result != ERROR_SUCCESS) {
                 break; // 没有更多子键
             }
             
             // 打开子键
             HKEY hProgramKey;
-            result = RegOpenKeyExW(hUninstallKey, subKeyName, 0, KEY_READ, &hProgramKey);
+            result = registry->OpenKey(hUninstallKey, subKeyName, KEY_READ, hProgramKey);
             if (result != ERROR_SUCCESS) {
                 index++;
                 continue;
@@ -88,48 +86,37 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
             ProgramInfo program;
             
             // 读取显示名称
-            wchar_t displayName[512] = {0};
-            DWORD displayNameSize = sizeof(displayName);
-            DWORD dataType;
+            String displayName;
             
-            result = RegQueryValueExW(hProgramKey, L"DisplayName", nullptr, &dataType,
-                                     (LPBYTE)displayName, &displayNameSize);
-            if (result == ERROR_SUCCESS && wcslen(displayName) > 0) {
+            if (RegistryHelper::ReadString(hProgramKey, L"DisplayName", displayName) == ErrorCode::Success &&
+                !displayName.empty()) {
                 program.name = displayName;
                 
                 // 读取版本
-                wchar_t version[128] = {0};
-                DWORD versionSize = sizeof(version);
-                if (RegQueryValueExW(hProgramKey, L"DisplayVersion", nullptr, nullptr,
-                                    (LPBYTE)version, &versionSize) == ERROR_SUCCESS) {
+                String version;
+                if (RegistryHelper::ReadString(hProgramKey, L"DisplayVersion", version) == ErrorCode::Success) {
                     program.version = version;
                 }
                 
                 // 读取发布者
-                wchar_t publisher[256] = {0};
-                DWORD publisherSize = sizeof(publisher);
-                if (RegQueryValueExW(hProgramKey, L"Publisher", nullptr, nullptr,
-                                    (LPBYTE)publisher, &publisherSize) == ERROR_SUCCESS) {
+                String publisher;
+                if (RegistryHelper::ReadString(hProgramKey, L"Publisher", publisher) == ErrorCode::Success) {
                     program.publisher = publisher;
                 }
                 
                 // 读取安装日期 - 使用多种方法
-                wchar_t installDate[64] = {0};
-                DWORD installDateSize = sizeof(installDate);
+                String installDate;
                 bool dateFound = false;
                 
                 // 方法1: 尝试InstallDate字段 (字符串类型)
-                if (RegQueryValueExW(hProgramKey, L"InstallDate", nullptr, nullptr,
-                                    (LPBYTE)installDate, &installDateSize) == ERROR_SUCCESS && wcslen(installDate) > 0) {
+                if (RegistryHelper::ReadString(hProgramKey, L"InstallDate", installDate) == ErrorCode::Success && !installDate.empty()) {
                     program.installDate = installDate;
                     dateFound = true;
                 }
                 
                 // 方法2: 尝试InstallTime字段
                 if (!dateFound) {
-                    installDateSize = sizeof(installDate);
-                    if (RegQueryValueExW(hProgramKey, L"InstallTime", nullptr, nullptr,
-                                        (LPBYTE)installDate, &installDateSize) == ERROR_SUCCESS && wcslen(installDate) > 0) {
+                    if (RegistryHelper::ReadString(hProgramKey, L"InstallTime", installDate) == ErrorCode::Success && !installDate.empty()) {
                         program.installDate = installDate;
                         dateFound = true;
                     }
@@ -164,19 +151,17 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
                 
                 // 读取估算大小 - 使用多种方法
                 DWORD estimatedSize = 0;
-                DWORD sizeDataSize = sizeof(estimatedSize);
                 bool sizeFound = false;
                 
                 // 方法1: 从EstimatedSize字段读取
-                if (RegQueryValueExW(hProgramKey, L"EstimatedSize", nullptr, nullptr,
-                                    (LPBYTE)&estimatedSize, &sizeDataSize) == ERROR_SUCCESS && estimatedSize > 0) {
+                if (RegistryHelper::ReadDWord(hProgramKey, L"EstimatedSize", estimatedSize) == ErrorCode::Success && estimatedSize > 0) {
                     program.estimatedSize = (DWORD64)estimatedSize * 1024; // KB转换为字节
                     sizeFound = true;
                 }
                 
-                // 方法2: 如果没有大小信息，尝试从安装位置估算
+                // 方法2: 如果没有大小信息，统计安装目录的实际大小
                 if (!sizeFound && !program.installLocation.empty()) {
-                    DWORD64 directorySize = EstimateDirectorySize(program.installLocation);
+                    DWORD64 directorySize = DirectorySizeEngine::GetShared().GetSize(program.installLocation);
                     if (directorySize > 0) {
                         program.estimatedSize = directorySize;
                         sizeFound = true;
@@ -193,28 +178,22 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
                 }
                 
                 // 读取卸载字符串
-                wchar_t uninstallString[512] = {0};
-                DWORD uninstallStringSize = sizeof(uninstallString);
-                if (RegQueryValueExW(hProgramKey, L"UninstallString", nullptr, nullptr,
-                                    (LPBYTE)uninstallString, &uninstallStringSize) == ERROR_SUCCESS) {
+                String uninstallString;
+                if (RegistryHelper::ReadString(hProgramKey, L"UninstallString", uninstallString) == ErrorCode::Success) {
                     program.uninstallString = uninstallString;
                 }
                 
                 // 读取安装位置
-                wchar_t installLocation[512] = {0};
-                DWORD installLocationSize = sizeof(installLocation);
-                if (RegQueryValueExW(hProgramKey, L"InstallLocation", nullptr, nullptr,
-                                    (LPBYTE)installLocation, &installLocationSize) == ERROR_SUCCESS) {
+                String installLocation;
+                if (RegistryHelper::ReadString(hProgramKey, L"InstallLocation", installLocation) == ErrorCode::Success) {
                     program.installLocation = installLocation;
                 }
                 
                 // 跳过系统组件（可选）
                 DWORD systemComponent = 0;
-                DWORD systemComponentSize = sizeof(systemComponent);
-                if (RegQueryValueExW(hProgramKey, L"SystemComponent", nullptr, nullptr,
-                                    (LPBYTE)&systemComponent, &systemComponentSize) == ERROR_SUCCESS) {
+                if (RegistryHelper::ReadDWord(hProgramKey, L"SystemComponent", systemComponent) == ErrorCode::Success) {
                     if (systemComponent == 1) {
-                        RegCloseKey(hProgramKey);
+                        registry->CloseKey(hProgramKey);
                         index++;
                         continue; // 跳过系统组件
                     }
@@ -222,37 +201,25 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
                 
                 // 跳过没有卸载字符串的程序
                 if (program.uninstallString.empty()) {
-                    RegCloseKey(hProgramKey);
+                    registry->CloseKey(hProgramKey);
                     index++;
                     continue;
                 }
                 
                 // 构建完整的注册表键路径
-                String rootKeyName;
-                if (registryPaths[pathIndex].rootKey == HKEY_LOCAL_MACHINE) {
-                    rootKeyName = L"HKEY_LOCAL_MACHINE";
-                } else if (registryPaths[pathIndex].rootKey == HKEY_CURRENT_USER) {
-                    rootKeyName = L"HKEY_CURRENT_USER";
-                } else if (registryPaths[pathIndex].rootKey == HKEY_CLASSES_ROOT) {
-                    rootKeyName = L"HKEY_CLASSES_ROOT";
-                } else if (registryPaths[pathIndex].rootKey == HKEY_USERS) {
-                    rootKeyName = L"HKEY_USERS";
-                } else {
-                    rootKeyName = L"HKEY_LOCAL_MACHINE";
-                }
-                
-                program.registryKey = rootKeyName + L"\\" + String(registryPaths[pathIndex].path) + L"\\" + String(subKeyName);
+                program.registryKey = RegistryHelper::FormatRegistryPath(registryPaths[pathIndex].rootKey,
+                    String(registryPaths[pathIndex].path) + L"\\" + subKeyName);
                 
                 // 添加到列表
                 programs.push_back(program);
                 totalFound++;
             }
             
-            RegCloseKey(hProgramKey);
+            registry->CloseKey(hProgramKey);
             index++;
         }
         
-        RegCloseKey(hUninstallKey);
+        registry->CloseKey(hUninstallKey);
     }
     
     YG_LOG_INFO(L"直接API扫描完成，总共找到: " + std::to_wstring(totalFound) + L" 个程序");
@@ -301,57 +268,6 @@ int GetInstalledProgramsDirect(std::vector<ProgramInfo>& programs) {
     return totalFound;
 }
 
-/**
- * @brief 估算目录大小（快速版本）
- * @param directoryPath 目录路径
- * @return DWORD64 估算的目录大小（字节）
- */
-DWORD64 EstimateDirectorySize(const String& directoryPath) {
-    if (directoryPath.empty()) {
-        return 0;
-    }
-    
-    DWORD64 totalSize = 0;
-    WIN32_FIND_DATAW findData;
-    String searchPath = directoryPath + L"\\*";
-    
-    HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
-    if (hFind == INVALID_HANDLE_VALUE) {
-        return 0;
-    }
-    
-    int fileCount = 0;
-    const int maxFiles = 1000; // 限制扫描的文件数量，避免性能问题
-    
-    do {
-        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-            // 是文件，累加大小
-            LARGE_INTEGER fileSize;
-            fileSize.LowPart = findData.nFileSizeLow;
-            fileSize.HighPart = findData.nFileSizeHigh;
-            totalSize += fileSize.QuadPart;
-            fileCount++;
-            
-            // 如果文件太多，停止扫描并估算
-            if (fileCount >= maxFiles) {
-                // 基于已扫描的文件数量估算总大小
-                DWORD64 averageFileSize = totalSize / fileCount;
-                totalSize = averageFileSize * (fileCount * 10); // 假设还有10倍的文件
-                break;
-            }
-        }
-    } while (FindNextFileW(hFind, &findData));
-    
-    FindClose(hFind);
-    
-    // 限制最大估算大小为2GB，避免不合理的估算
-    if (totalSize > 2LL * 1024 * 1024 * 1024) {
-        totalSize = 2LL * 1024 * 1024 * 1024;
-    }
-    
-    return totalSize;
-}
-
 /**
  * @brief 从卸载字符串估算程序大小
  * @param uninstallString 卸载字符串
@@ -463,11 +379,10 @@ String GetDateFromRegistryKey(HKEY hKey) {
     }
     
     // 获取注册表键的最后修改时间
-    FILETIME lastWriteTime;
-    if (RegQueryInfoKeyW(hKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 
-                       nullptr, nullptr, nullptr, nullptr, &lastWriteTime) == ERROR_SUCCESS) {
+    RegistryKeyInfo keyInfo;
+    if (RegistryHelper::GetKeyInfo(hKey, keyInfo) == ErrorCode::Success) {
         SYSTEMTIME st;
-        if (FileTimeToSystemTime(&lastWriteTime, &st)) {
+        if (FileTimeToSystemTime(&keyInfo.lastWriteTime, &st)) {
             wchar_t dateStr[16];
             swprintf(dateStr, sizeof(dateStr)/sizeof(wchar_t), L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
             return String(dateStr);
@@ -0,0 +1,142 @@
+/**
+ * @file FuzzyMatcher.cpp
+ * @brief 子序列模糊匹配与评分实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/FuzzyMatcher.h"
+#include <algorithm>
+#include <cwctype>
+
+namespace YG {
+    
+    namespace {
+        
+        // 评分参数
+        const int s_scoreMatch = 16;                // 每个匹配字符
+        const int s_penaltyGapStart = -3;           // 间隔的第一个字符
+        const int s_penaltyGapExtension = -1;       // 间隔的后续字符
+        const int s_bonusWordStart = 8;             // 匹配在单词开头
+        const int s_bonusTransition = 7;            // 匹配在大小写、字母数字转换处
+        const int s_bonusConsecutive = 4;           // 与上一个匹配字符相邻
+        const int s_firstCharMultiplier = 2;        // 关键词首字符的位置加分倍数
+        
+        // 不可达状态；加上有限次的分数后仍远小于任何可达分数
+        const int s_unreachable = INT_MIN / 2;
+        
+        const int s_classBonus[] = { 0, s_bonusTransition, s_bonusWordStart };
+        
+        bool IsWordCharacter(wchar_t ch) {
+            return std::iswalnum(ch) != 0;
+        }
+    
+    } // namespace
+    
+    FuzzyMatcher::FuzzyMatcher(const String& pattern) : m_charMask(0) {
+        for (wchar_t ch : pattern) {
+            if (std::iswspace(ch) || m_pattern.size() >= MaxPatternLength) {
+                continue;
+            }
+            m_pattern.push_back(static_cast<wchar_t>(std::towlower(ch)));
+        }
+        m_charMask = MakeCharMask(m_pattern);
+    }
+    
+    std::uint64_t FuzzyMatcher::MakeCharMask(std::wstring_view foldedText) {
+        std::uint64_t mask = 0;
+        for (wchar_t ch : foldedText) {
+            unsigned bit;
+            if (ch >= L'a' && ch <= L'z') {
+                bit = static_cast<unsigned>(ch - L'a');
+            } else if (ch >= L'0' && ch <= L'9') {
+                bit = 26 + static_cast<unsigned>(ch - L'0');
+            } else {
+                bit = 36 + static_cast<unsigned>(ch) % 28;
+            }
+            mask |= std::uint64_t(1) << bit;
+        }
+        return mask;
+    }
+    
+    void FuzzyMatcher::ClassifyCharacters(const wchar_t* text, size_t length, std::uint8_t* charClasses) {
+        for (size_t i = 0; i < length; ++i) {
+            wchar_t ch = text[i];
+            if (!IsWordCharacter(ch)) {
+                charClasses[i] = FuzzyCharPlain;
+                continue;
+            }
+            if (i == 0 || !IsWordCharacter(text[i - 1])) {
+                charClasses[i] = FuzzyCharWordStart;
+                continue;
+            }
+            
+            wchar_t previous = text[i - 1];
+            bool camelCase = std::iswlower(previous) && std::iswupper(ch);
+            bool digitBoundary = (std::iswdigit(previous) != 0) != (std::iswdigit(ch) != 0);
+            charClasses[i] = (camelCase || digitBoundary) ? FuzzyCharTransition : FuzzyCharPlain;
+        }
+    }
+    
+    int FuzzyMatcher::Score(std::wstring_view foldedText, const std::uint8_t* charClasses) const {
+        const size_t patternLength = m_pattern.size();
+        if (patternLength == 0) {
+            return 0;
+        }
+        const size_t textLength = (std::min)(foldedText.size(), MaxTextLength);
+        
+        // 先按顺序扫描一遍确认是子序列，同时得到最早的起点
+        size_t begin = textLength;
+        size_t matched = 0;
+        for (size_t j = 0; j < textLength && matched < patternLength; ++j) {
+            if (foldedText[j] == m_pattern[matched]) {
+                if (matched == 0) {
+                    begin = j;
+                }
+                ++matched;
+            }
+        }
+        if (matched < patternLength) {
+            return NoMatch;
+        }
+        
+        // previousRow[j]/currentRow[j]：关键词第i-1/i个字符匹配在文本第j个字符时的最高分
+        int previousRow[MaxTextLength];
+        int currentRow[MaxTextLength];
+        
+        for (size_t j = begin; j < textLength; ++j) {
+            currentRow[j] = foldedText[j] == m_pattern[0]
+                ? s_scoreMatch + s_classBonus[charClasses[j]] * s_firstCharMultiplier
+                : s_unreachable;
+        }
+        
+        for (size_t i = 1; i < patternLength; ++i) {
+            std::copy(currentRow + begin, currentRow + textLength, previousRow + begin);
+            
+            const wchar_t patternChar = m_pattern[i];
+            int gapBest = s_unreachable;    // 上一字符匹配在j-2及之前、经过间隔到达j的最高分
+            for (size_t j = begin; j < textLength; ++j) {
+                int diagonal = j > begin ? previousRow[j - 1] : s_unreachable;
+                
+                int score = s_unreachable;
+                if (foldedText[j] == patternChar) {
+                    int bonus = s_classBonus[charClasses[j]];
+                    int consecutive = diagonal + s_scoreMatch + (std::max)(bonus, s_bonusConsecutive);
+                    int afterGap = gapBest + s_scoreMatch + bonus;
+                    score = (std::max)(consecutive, afterGap);
+                }
+                currentRow[j] = (std::max)(score, s_unreachable);
+                
+                gapBest = (std::max)(gapBest + s_penaltyGapExtension, diagonal + s_penaltyGapStart);
+            }
+        }
+        
+        int best = s_unreachable;
+        for (size_t j = begin; j < textLength; ++j) {
+            best = (std::max)(best, currentRow[j]);
+        }
+        return best > s_unreachable / 2 ? best : NoMatch;
+    }
+
+} // namespace YG
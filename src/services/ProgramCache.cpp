@@ -7,6 +7,7 @@
  */
 
 #include "services/ProgramCache.h"
+#include "services/ProgramSnapshot.h"
 #include "core/Logger.h"
 #include <algorithm>
 #include <sstream>
@@ -16,12 +17,16 @@ namespace YG {
     
     ProgramCache::ProgramCache(int maxCacheAge, size_t maxCacheSize)
         : m_maxCacheAge(maxCacheAge), m_maxCacheSize(maxCacheSize),
+          m_watching(false), m_changeGeneration(0),
           m_cacheHits(0), m_cacheMisses(0), m_cacheUpdates(0) {
         YG_LOG_INFO(L"程序缓存管理器初始化，最大缓存时间: " + std::to_wstring(maxCacheAge) + 
                    L"秒，最大缓存大小: " + std::to_wstring(maxCacheSize));
     }
     
     ProgramCache::~ProgramCache() {
+        // 先停止通知线程，避免回调访问已销毁的成员
+        StopWatching();
+        
         std::lock_guard<std::mutex> lock(m_mutex);
         YG_LOG_INFO(L"程序缓存管理器销毁，统计信息: 命中" + std::to_wstring(m_cacheHits) + 
                    L"次，未命中" + std::to_wstring(m_cacheMisses) + L"次");
@@ -70,28 +75,81 @@ namespace YG {
     
     ErrorContext ProgramCache::UpdateCache(bool includeSystemComponents, 
                                          const std::vector<ProgramInfo>& programs,
-                                         DWORD scanDuration) {
-        std::lock_guard<std::mutex> lock(m_mutex);
+                                         DWORD scanDuration,
+                                         std::uint64_t changeGeneration) {
+        String snapshotPath;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
         
-        // 检查缓存大小限制
-        if (m_cache.size() >= m_maxCacheSize) {
-            CleanupOldestCache();
+            // 检查缓存大小限制
+            if (m_cache.size() >= m_maxCacheSize) {
+                CleanupOldestCache();
+            }
+            
+            String key = GenerateCacheKey(includeSystemComponents);
+            
+            CacheItem item;
+            item.programs = programs;
+            item.lastUpdate = std::chrono::system_clock::now();
+            item.includeSystemComponents = includeSystemComponents;
+            item.programCount = programs.size();
+            item.scanDuration = scanDuration;
+            
+            // 扫描期间收到过变更通知，结果可能已过时
+            item.dirty = (changeGeneration != UINT64_MAX && changeGeneration != m_changeGeneration);
+            
+            m_cache[key] = std::move(item);
+            m_cacheUpdates++;
+            snapshotPath = m_snapshotPath;
+            
+            YG_LOG_INFO(L"缓存已更新，键: " + key + L"，程序数量: " + std::to_wstring(programs.size()) + 
+                       L"，扫描耗时: " + std::to_wstring(scanDuration) + L"毫秒");
         }
         
-        String key = GenerateCacheKey(includeSystemComponents);
-        
-        CacheItem item;
-        item.programs = programs;
-        item.lastUpdate = std::chrono::system_clock::now();
-        item.includeSystemComponents = includeSystemComponents;
-        item.programCount = programs.size();
-        item.scanDuration = scanDuration;
+        // 持久化到磁盘快照（在锁外写文件），写入失败不影响内存缓存
+        if (!snapshotPath.empty()) {
+            ErrorContext saveResult = ProgramSnapshot::Save(snapshotPath, programs, includeSystemComponents, scanDuration);
+            if (saveResult.code != DetailedErrorCode::Success) {
+                YG_LOG_WARNING(L"写入程序快照失败: " + saveResult.message);
+            }
+        }
         
-        m_cache[key] = std::move(item);
-        m_cacheUpdates++;
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+    
+    ErrorContext ProgramCache::PatchCachedPrograms(bool includeSystemComponents,
+                                                   const std::function<bool(ProgramInfo&)>& patch) {
+        String snapshotPath;
+        std::vector<ProgramInfo> snapshotPrograms;
+        DWORD scanDuration = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            
+            auto it = m_cache.find(GenerateCacheKey(includeSystemComponents));
+            if (it == m_cache.end()) {
+                return YG_DETAILED_ERROR(DetailedErrorCode::DataNotFound, L"缓存中未找到对应数据");
+            }
+            
+            size_t patchedCount = 0;
+            for (auto& program : it->second.programs) {
+                if (patch(program)) {
+                    patchedCount++;
+                }
+            }
+            
+            if (patchedCount == 0 || m_snapshotPath.empty()) {
+                return ErrorContext(DetailedErrorCode::Success);
+            }
+            
+            snapshotPath = m_snapshotPath;
+            snapshotPrograms = it->second.programs;
+            scanDuration = it->second.scanDuration;
+        }
         
-        YG_LOG_INFO(L"缓存已更新，键: " + key + L"，程序数量: " + std::to_wstring(programs.size()) + 
-                   L"，扫描耗时: " + std::to_wstring(scanDuration) + L"毫秒");
+        ErrorContext saveResult = ProgramSnapshot::Save(snapshotPath, snapshotPrograms, includeSystemComponents, scanDuration);
+        if (saveResult.code != DetailedErrorCode::Success) {
+            YG_LOG_WARNING(L"写入程序快照失败: " + saveResult.message);
+        }
         
         return ErrorContext(DetailedErrorCode::Success);
     }
@@ -134,6 +192,8 @@ namespace YG {
         stats << L"  缓存命中: " << m_cacheHits << L"次\n";
         stats << L"  缓存未命中: " << m_cacheMisses << L"次\n";
         stats << L"  缓存更新: " << m_cacheUpdates << L"次\n";
+        stats << L"  失效策略: " << (!m_watching ? L"按时间过期" :
+                                     m_notifier->IsWatchingAll() ? L"注册表变更通知" : L"注册表变更通知 + 按时间过期") << L"\n";
         
         if (m_cacheHits + m_cacheMisses > 0) {
             double hitRate = (double)m_cacheHits / (m_cacheHits + m_cacheMisses) * 100.0;
@@ -180,6 +240,11 @@ namespace YG {
             return true; // 无缓存，需要刷新
         }
         
+        // 监视变更时只有收到通知才需要刷新
+        if (m_watching) {
+            return it->second.dirty;
+        }
+        
         // 检查是否接近过期（剩余时间少于总时间的20%）
         auto age = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now() - it->second.lastUpdate).count();
@@ -193,6 +258,124 @@ namespace YG {
         // 实际实现需要与ProgramDetector协调
     }
     
+    ErrorContext ProgramCache::StartWatching(const std::vector<CacheWatchTarget>& targets,
+                                             std::shared_ptr<IRegistryChangeNotifier> notifier) {
+        StopWatching();
+        
+        if (!notifier) {
+            notifier = std::make_shared<Win32RegistryChangeNotifier>();
+        }
+        
+        std::vector<RegistryWatchTarget> watchTargets;
+        watchTargets.reserve(targets.size());
+        for (const auto& target : targets) {
+            watchTargets.push_back({ target.rootKey, target.path });
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_watchTargets = targets;
+        }
+        
+        ErrorCode result = notifier->Start(watchTargets, [this](size_t targetIndex) {
+            OnRegistryChanged(targetIndex);
+        });
+        if (result != ErrorCode::Success) {
+            YG_LOG_WARNING(L"注册表变更监视启动失败，缓存继续按时间过期");
+            return YG_DETAILED_ERROR(DetailedErrorCode::RegistryConnectionFailed, L"无法监视注册表变更");
+        }
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_notifier = notifier;
+        m_watching = true;
+        
+        YG_LOG_INFO(L"缓存已切换为变更通知失效模式");
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+    
+    void ProgramCache::StopWatching() {
+        std::shared_ptr<IRegistryChangeNotifier> notifier;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            notifier.swap(m_notifier);
+            m_watching = false;
+        }
+        
+        // 在锁外停止，回调中会获取m_mutex
+        if (notifier) {
+            notifier->Stop();
+        }
+    }
+    
+    bool ProgramCache::IsWatching() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_watching;
+    }
+    
+    std::uint64_t ProgramCache::GetChangeGeneration() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_changeGeneration;
+    }
+    
+    void ProgramCache::OnRegistryChanged(size_t targetIndex) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        m_changeGeneration++;
+        
+        bool systemComponentsOnly = targetIndex < m_watchTargets.size() && m_watchTargets[targetIndex].systemComponentsOnly;
+        
+        size_t markedCount = 0;
+        for (auto& pair : m_cache) {
+            if (systemComponentsOnly && !pair.second.includeSystemComponents) {
+                continue;
+            }
+            if (!pair.second.dirty) {
+                pair.second.dirty = true;
+                markedCount++;
+            }
+        }
+        
+        if (markedCount > 0) {
+            YG_LOG_INFO(L"检测到注册表变更: " +
+                       (targetIndex < m_watchTargets.size() ? m_watchTargets[targetIndex].path : String()) +
+                       L"，标记失效的缓存项: " + std::to_wstring(markedCount));
+        }
+    }
+    
+    void ProgramCache::SetSnapshotPath(const String& filePath) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_snapshotPath = filePath;
+        YG_LOG_INFO(L"程序快照路径: " + (filePath.empty() ? String(L"<禁用>") : filePath));
+    }
+    
+    ErrorContext ProgramCache::LoadSnapshot(bool includeSystemComponents, std::vector<ProgramInfo>& programs) const {
+        String snapshotPath;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            snapshotPath = m_snapshotPath;
+        }
+        
+        if (snapshotPath.empty()) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::DataNotFound, L"未设置快照路径");
+        }
+        
+        ProgramSnapshotData data;
+        ErrorContext result = ProgramSnapshot::Load(snapshotPath, data);
+        if (result.code != DetailedErrorCode::Success) {
+            YG_LOG_INFO(L"程序快照不可用，将执行完整扫描: " + result.message);
+            return result;
+        }
+        
+        if (data.includeSystemComponents != includeSystemComponents) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::DataNotFound, L"快照的系统组件选项与当前设置不一致");
+        }
+        
+        programs.swap(data.programs);
+        
+        YG_LOG_INFO(L"已从快照加载程序列表，程序数量: " + std::to_wstring(programs.size()));
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+    
     String ProgramCache::GenerateCacheKey(bool includeSystemComponents) const {
         return includeSystemComponents ? L"with_system" : L"without_system";
     }
@@ -215,6 +398,15 @@ namespace YG {
     }
     
     bool ProgramCache::IsCacheExpired(const CacheItem& item) const {
+        if (item.dirty) {
+            return true;
+        }
+        
+        // 监视变更时缓存在注册表静默期间始终有效；有目标键无法监视时仍按时间过期
+        if (m_watching && m_notifier->IsWatchingAll()) {
+            return false;
+        }
+        
         auto age = std::chrono::duration_cast<std::chrono::seconds>(
             std::chrono::system_clock::now() - item.lastUpdate).count();
         return age > m_maxCacheAge;
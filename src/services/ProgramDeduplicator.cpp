@@ -0,0 +1,130 @@
+/**
+ * @file ProgramDeduplicator.cpp
+ * @brief 基于规范化标识的程序列表去重实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramDeduplicator.h"
+#include "utils/StringUtils.h"
+#include "core/Logger.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace YG {
+    
+    namespace {
+        
+        // 常见的架构标识，按顺序依次截断
+        const wchar_t* const s_architectureSuffixes[] = {
+            L" (x64)", L" (x86)", L" (64-bit)", L" (32-bit)",
+            L" x64", L" x86", L" 64-bit", L" 32-bit"
+        };
+        
+        // 组合键的字段分隔符，不会出现在程序名称、发布者和版本中
+        const wchar_t s_keySeparator = L'\x1F';
+        
+    } // namespace
+    
+    String ProgramDeduplicator::StripArchitectureSuffixes(const String& foldedName) {
+        String baseName = foldedName;
+        for (const wchar_t* suffix : s_architectureSuffixes) {
+            size_t pos = baseName.find(suffix);
+            if (pos != String::npos) {
+                baseName.erase(pos);
+            }
+        }
+        return baseName;
+    }
+    
+    String ProgramDeduplicator::CanonicalizePath(const String& path) {
+        String canonical = StringUtils::ToLower(StringUtils::Trim(path));
+        
+        if (canonical.size() >= 2 && canonical.front() == L'"' && canonical.back() == L'"') {
+            canonical = canonical.substr(1, canonical.size() - 2);
+        }
+        std::replace(canonical.begin(), canonical.end(), L'/', L'\\');
+        
+        // "c:\\"这样的根目录保留末尾分隔符
+        while (canonical.size() > 3 && canonical.back() == L'\\') {
+            canonical.pop_back();
+        }
+        return canonical;
+    }
+    
+    ProgramIdentity ProgramDeduplicator::MakeIdentity(const ProgramInfo& program) {
+        ProgramIdentity identity;
+        identity.foldedName = StringUtils::ToLower(!program.displayName.empty() ? program.displayName : program.name);
+        identity.baseName = StripArchitectureSuffixes(identity.foldedName);
+        identity.publisher = program.publisher;
+        identity.version = program.version;
+        if (!program.installLocation.empty()) {
+            identity.installPath = CanonicalizePath(program.installLocation);
+        }
+        return identity;
+    }
+    
+    std::vector<size_t> ProgramDeduplicator::FindUniqueIndices(const std::vector<ProgramInfo>& programs,
+                                                              DeduplicationStats* stats) {
+        DeduplicationStats localStats;
+        localStats.inputCount = programs.size();
+        
+        std::unordered_set<String> nameKeys;
+        std::unordered_set<String> pathKeys;
+        nameKeys.reserve(programs.size());
+        pathKeys.reserve(programs.size());
+        
+        std::vector<size_t> keptIndices;
+        keptIndices.reserve(programs.size());
+        
+        for (size_t i = 0; i < programs.size(); i++) {
+            ProgramIdentity identity = MakeIdentity(programs[i]);
+            
+            String nameKey;
+            nameKey.reserve(identity.baseName.size() + identity.publisher.size() + identity.version.size() + 2);
+            nameKey += identity.baseName;
+            nameKey += s_keySeparator;
+            nameKey += identity.publisher;
+            nameKey += s_keySeparator;
+            nameKey += identity.version;
+            
+            // 只与已保留的程序比较：重复项的键不加入哈希表
+            if (nameKeys.find(nameKey) != nameKeys.end()) {
+                localStats.nameDuplicates++;
+                YG_LOG_DEBUG(L"发现重复程序: " + programs[i].displayName + L" (版本: " + programs[i].version + L")");
+                continue;
+            }
+            if (!identity.installPath.empty() && pathKeys.find(identity.installPath) != pathKeys.end()) {
+                localStats.pathDuplicates++;
+                YG_LOG_DEBUG(L"发现安装路径重复的程序: " + programs[i].displayName + L" (" + programs[i].installLocation + L")");
+                continue;
+            }
+            
+            nameKeys.insert(std::move(nameKey));
+            if (!identity.installPath.empty()) {
+                pathKeys.insert(std::move(identity.installPath));
+            }
+            keptIndices.push_back(i);
+        }
+        
+        localStats.keptCount = keptIndices.size();
+        if (stats) {
+            *stats = localStats;
+        }
+        return keptIndices;
+    }
+    
+    std::vector<ProgramInfo> ProgramDeduplicator::RemoveDuplicates(const std::vector<ProgramInfo>& programs,
+                                                                  DeduplicationStats* stats) {
+        std::vector<size_t> keptIndices = FindUniqueIndices(programs, stats);
+        
+        std::vector<ProgramInfo> uniquePrograms;
+        uniquePrograms.reserve(keptIndices.size());
+        for (size_t index : keptIndices) {
+            uniquePrograms.push_back(programs[index]);
+        }
+        return uniquePrograms;
+    }
+
+} // namespace YG
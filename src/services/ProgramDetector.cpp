@@ -7,7 +7,10 @@
  */
 
 #include "services/ProgramDetector.h"
+#include "services/ProgramSnapshot.h"
 #include "utils/RegistryHelper.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
 #include <windows.h>
 #include <shlobj.h>
 #include <vector>
@@ -16,19 +19,216 @@
 #include <future>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <iterator>
 
 namespace YG {
     
+    namespace {
+        
+        // 卸载信息所在的注册表路径，扫描与变更监视共用
+        const RegistryPath s_uninstallRoots[] = {
+            { HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"64位程序" },
+            { HKEY_LOCAL_MACHINE, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"32位程序" },
+            { HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"当前用户64位程序" },
+            { HKEY_CURRENT_USER, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"当前用户32位程序" }
+        };
+        
+        // Windows Store应用包所在路径（仅在包含系统组件时扫描）
+        const wchar_t* const s_storeAppsPath = L"SOFTWARE\\Classes\\Local Settings\\Software\\Microsoft\\Windows\\CurrentVersion\\AppModel\\Repository\\Packages";
+        
+        // 流式扫描默认每批程序数量
+        const size_t s_defaultScanBatchSize = 32;
+        
+        // 扫描线程的进度区间：注册表扫描占10%~80%，其余为Windows Store应用
+        const int s_registryProgressBegin = 10;
+        const int s_registryProgressEnd = 80;
+        
+        /**
+         * @brief 卸载注册表项中识别的值
+         */
+        enum class UninstallValue {
+            Unknown,
+            DisplayName,
+            DisplayVersion,
+            Version,
+            VersionMajor,
+            VersionMinor,
+            Publisher,
+            Manufacturer,
+            Contact,
+            InstallLocation,
+            UninstallString,
+            InstallDate,
+            InstallTime,
+            HelpLink,
+            DisplayIcon,
+            EstimatedSize,
+            SystemComponent
+        };
+        
+        constexpr wchar_t FoldAscii(wchar_t ch) {
+            return (ch >= L'A' && ch <= L'Z') ? static_cast<wchar_t>(ch - L'A' + L'a') : ch;
+        }
+        
+        /**
+         * @brief 不区分大小写的FNV-1a，编译期用于生成switch分支，运行期用于值名称
+         */
+        constexpr std::uint32_t HashValueName(const wchar_t* name) {
+            std::uint32_t hash = 2166136261u;
+            for (; *name != L'\0'; ++name) {
+                hash = (hash ^ static_cast<std::uint32_t>(FoldAscii(*name))) * 16777619u;
+            }
+            return hash;
+        }
+        
+        bool EqualsNoCase(const String& name, const wchar_t* expected) {
+            size_t i = 0;
+            for (; i < name.size() && expected[i] != L'\0'; ++i) {
+                if (FoldAscii(name[i]) != FoldAscii(expected[i])) {
+                    return false;
+                }
+            }
+            return i == name.size() && expected[i] == L'\0';
+        }
+        
+        /**
+         * @brief 按名称分派值。各分支的哈希在编译期计算，
+         * 重复的case标签会导致编译失败，从而保证对已知名称集合无冲突；
+         * 命中后再比较一次名称，排除未知名称的偶然碰撞。
+         */
+        UninstallValue ClassifyValueName(const String& name) {
+#define YG_UNINSTALL_VALUE(literal, kind) \
+            case HashValueName(literal): return EqualsNoCase(name, literal) ? UninstallValue::kind : UninstallValue::Unknown
+            
+            switch (HashValueName(name.c_str())) {
+                YG_UNINSTALL_VALUE(L"DisplayName", DisplayName);
+                YG_UNINSTALL_VALUE(L"DisplayVersion", DisplayVersion);
+                YG_UNINSTALL_VALUE(L"Version", Version);
+                YG_UNINSTALL_VALUE(L"VersionMajor", VersionMajor);
+                YG_UNINSTALL_VALUE(L"VersionMinor", VersionMinor);
+                YG_UNINSTALL_VALUE(L"Publisher", Publisher);
+                YG_UNINSTALL_VALUE(L"Manufacturer", Manufacturer);
+                YG_UNINSTALL_VALUE(L"Contact", Contact);
+                YG_UNINSTALL_VALUE(L"InstallLocation", InstallLocation);
+                YG_UNINSTALL_VALUE(L"UninstallString", UninstallString);
+                YG_UNINSTALL_VALUE(L"InstallDate", InstallDate);
+                YG_UNINSTALL_VALUE(L"InstallTime", InstallTime);
+                YG_UNINSTALL_VALUE(L"HelpLink", HelpLink);
+                YG_UNINSTALL_VALUE(L"DisplayIcon", DisplayIcon);
+                YG_UNINSTALL_VALUE(L"EstimatedSize", EstimatedSize);
+                YG_UNINSTALL_VALUE(L"SystemComponent", SystemComponent);
+                default: return UninstallValue::Unknown;
+            }
+
+#undef YG_UNINSTALL_VALUE
+        }
+        
+        /**
+         * @brief 一次枚举得到的卸载注册表值
+         */
+        struct UninstallValues {
+            String displayName;
+            String displayVersion;
+            String version;
+            String publisher;
+            String manufacturer;
+            String contact;
+            String installLocation;
+            String uninstallString;
+            String installDate;
+            String installTime;
+            String helpLink;
+            String displayIcon;
+            DWORD versionMajor = 0;
+            DWORD versionMinor = 0;
+            DWORD estimatedSize = 0;
+            DWORD systemComponent = 0;
+            bool hasVersionMajor = false;
+            bool hasDisplayName = false;
+        };
+        
+        /**
+         * @brief 枚举键下的全部值并分派到对应字段
+         * @return size_t 枚举到的值数量
+         */
+        size_t ReadUninstallValues(IRegistrySource& registry, HKEY hKey, UninstallValues& values) {
+            size_t count = 0;
+            registry.EnumValues(hKey, true, [&values, &count](const String& name, DWORD type, const std::vector<BYTE>& data) {
+                count++;
+                
+                String* text = nullptr;
+                DWORD* number = nullptr;
+                
+                switch (ClassifyValueName(name)) {
+                    case UninstallValue::DisplayName:
+                        values.hasDisplayName = RegistryHelper::DecodeString(type, data, values.displayName);
+                        return true;
+                    case UninstallValue::VersionMajor:
+                        values.hasVersionMajor = RegistryHelper::DecodeDWord(type, data, values.versionMajor);
+                        return true;
+                    case UninstallValue::DisplayVersion:  text = &values.displayVersion; break;
+                    case UninstallValue::Version:         text = &values.version; break;
+                    case UninstallValue::Publisher:       text = &values.publisher; break;
+                    case UninstallValue::Manufacturer:    text = &values.manufacturer; break;
+                    case UninstallValue::Contact:         text = &values.contact; break;
+                    case UninstallValue::InstallLocation: text = &values.installLocation; break;
+                    case UninstallValue::UninstallString: text = &values.uninstallString; break;
+                    case UninstallValue::InstallDate:     text = &values.installDate; break;
+                    case UninstallValue::InstallTime:     text = &values.installTime; break;
+                    case UninstallValue::HelpLink:        text = &values.helpLink; break;
+                    case UninstallValue::DisplayIcon:     text = &values.displayIcon; break;
+                    case UninstallValue::VersionMinor:    number = &values.versionMinor; break;
+                    case UninstallValue::EstimatedSize:   number = &values.estimatedSize; break;
+                    case UninstallValue::SystemComponent: number = &values.systemComponent; break;
+                    default: return true;
+                }
+                
+                if (text) {
+                    RegistryHelper::DecodeString(type, data, *text);
+                } else if (number) {
+                    RegistryHelper::DecodeDWord(type, data, *number);
+                }
+                return true;
+            });
+            
+            return count;
+        }
+        
+    } // namespace
+    
     ProgramDetector::ProgramDetector() 
-        : m_scanning(false), m_stopRequested(false), 
-          m_includeSystemComponents(false), m_deepScanEnabled(false),
+        : m_scanning(false), m_stopRequested(false), m_reportCancellation(false),
+          m_batchSize(s_defaultScanBatchSize), m_scanTotal(0),
+          m_includeSystemComponents(false), m_incrementalScan(false), m_deepScanEnabled(false),
           m_scanTimeout(30000), m_totalFound(0), m_lastScanTime(0) {
         
         // 初始化程序缓存
         m_cache = YG::MakeUnique<ProgramCache>(300, 5); // 5分钟缓存，最多5个缓存项
+        m_cache->SetSnapshotPath(ProgramSnapshot::GetDefaultPath());
+        
+        // 监视卸载注册表变更，缓存在注册表无变化时一直有效
+        std::vector<CacheWatchTarget> watchTargets;
+        for (const auto& root : s_uninstallRoots) {
+            watchTargets.push_back({ root.rootKey, root.path, false });
+        }
+        watchTargets.push_back({ HKEY_CURRENT_USER, s_storeAppsPath, true });
+        
+        // 非系统注册表数据源（如.reg夹具）不会被外部修改，使用手动通知器保持静默
+        std::shared_ptr<IRegistryChangeNotifier> notifier;
+        if (!std::dynamic_pointer_cast<Win32RegistrySource>(RegistryHelper::GetSource())) {
+            notifier = std::make_shared<ManualRegistryChangeNotifier>();
+        }
+        m_cache->StartWatching(watchTargets, notifier);
+        
+        m_enricher = YG::MakeUnique<ProgramEnricher>();
+        
+        m_programTable = ProgramTable::Empty();
     }
     
     ProgramDetector::~ProgramDetector() {
+        // 先等待补全线程退出，其完成回调会访问增量扫描记录和缓存
+        m_enricher.reset();
         StopScan();
     }
     
@@ -39,10 +239,18 @@ namespace YG {
             return ErrorCode::OperationInProgress;
         }
         
+        // 回收上一次已结束的扫描线程
+        if (m_scanThread && m_scanThread->joinable()) {
+            m_scanThread->join();
+        }
+        
         m_includeSystemComponents = includeSystemComponents;
+        m_incrementalScan = false;
         m_progressCallback = progressCallback;
         m_completedCallback = completedCallback;
+        m_batchCallback = nullptr;
         m_stopRequested = false;
+        m_reportCancellation = false;
         
         // 启动扫描线程
         m_scanThread = YG::MakeUnique<std::thread>(&ProgramDetector::ScanWorkerThread, this);
@@ -50,6 +258,174 @@ namespace YG {
         return ErrorCode::Success;
     }
     
+    ErrorCode ProgramDetector::StartStreamingScan(bool includeSystemComponents, size_t batchSize,
+                                                  const ScanBatchCallback& batchCallback,
+                                                  const ScanCompletedCallback& completedCallback) {
+        if (m_scanning.load()) {
+            return ErrorCode::OperationInProgress;
+        }
+        
+        if (m_scanThread && m_scanThread->joinable()) {
+            m_scanThread->join();
+        }
+        
+        m_includeSystemComponents = includeSystemComponents;
+        m_incrementalScan = false;
+        m_progressCallback = nullptr;
+        m_completedCallback = completedCallback;
+        m_batchCallback = batchCallback;
+        m_batchSize = batchSize > 0 ? batchSize : s_defaultScanBatchSize;
+        m_stopRequested = false;
+        m_reportCancellation = false;
+        m_scanning = true;
+        
+        m_scanThread = YG::MakeUnique<std::thread>(&ProgramDetector::ScanWorkerThread, this);
+        
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode ProgramDetector::StartRevalidation(bool includeSystemComponents,
+                                                 const ScanCompletedCallback& completedCallback,
+                                                 const ScanProgressCallback& progressCallback) {
+        if (m_scanning.load()) {
+            return ErrorCode::OperationInProgress;
+        }
+        
+        if (m_scanThread && m_scanThread->joinable()) {
+            m_scanThread->join();
+        }
+        
+        m_includeSystemComponents = includeSystemComponents;
+        m_incrementalScan = true;
+        m_progressCallback = progressCallback;
+        m_completedCallback = completedCallback;
+        m_batchCallback = nullptr;
+        m_stopRequested = false;
+        m_reportCancellation = false;
+        m_scanning = true;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_lastScanDelta = ProgramScanDelta();
+        }
+        
+        m_scanThread = YG::MakeUnique<std::thread>(&ProgramDetector::ScanWorkerThread, this);
+        
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode ProgramDetector::LoadSnapshot(bool includeSystemComponents, std::vector<ProgramInfo>& programs) {
+        if (!m_cache) {
+            return ErrorCode::DataNotFound;
+        }
+        
+        std::vector<ProgramInfo> snapshotPrograms;
+        if (m_cache->LoadSnapshot(includeSystemComponents, snapshotPrograms).code != DetailedErrorCode::Success) {
+            return ErrorCode::DataNotFound;
+        }
+        
+        // 用快照中的时间戳初始化增量记录，后台校验时未变化的子键无需重新读取
+        std::unordered_map<String, RegistryEntryState> index;
+        for (const auto& program : snapshotPrograms) {
+            if (program.registryKey.empty() || program.registryWriteTime == 0) {
+                continue;
+            }
+            
+            RegistryEntryState state;
+            state.lastWriteTime = program.registryWriteTime;
+            state.valid = true;
+            state.systemComponent = IsSystemComponent(program);
+            state.visible = true;
+            state.info = program;
+            index[StringUtils::ToLower(program.registryKey)] = std::move(state);
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_registryIndex.swap(index);
+        }
+        
+        m_includeSystemComponents = includeSystemComponents;
+        PublishPrograms(snapshotPrograms);
+        
+        programs.swap(snapshotPrograms);
+        return ErrorCode::Success;
+    }
+    
+    std::vector<ProgramInfo> ProgramDetector::GetPrograms() const {
+        return GetProgramTable()->ToVector();
+    }
+    
+    ProgramScanDelta ProgramDetector::GetLastScanDelta() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastScanDelta;
+    }
+    
+    ProgramTablePtr ProgramDetector::GetProgramTable() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_programTable;
+    }
+    
+    void ProgramDetector::PublishPrograms(const std::vector<ProgramInfo>& programs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_programTable = ProgramTable::Build(programs, m_programTable);
+        m_totalFound = static_cast<int>(programs.size());
+    }
+    
+    size_t ProgramDetector::StartEnrichment(const std::vector<ProgramInfo>& programs,
+                                            const ProgramEnricher::UpdateCallback& updateCallback) {
+        bool includeSystemComponents = m_includeSystemComponents;
+        return m_enricher->Submit(programs, updateCallback,
+            [this, includeSystemComponents](const std::vector<ProgramEnrichmentUpdate>& updates) {
+                OnEnrichmentCompleted(updates, includeSystemComponents);
+            });
+    }
+    
+    void ProgramDetector::CancelEnrichment() {
+        m_enricher->Cancel();
+    }
+    
+    void ProgramDetector::OnEnrichmentCompleted(const std::vector<ProgramEnrichmentUpdate>& updates,
+                                                bool includeSystemComponents) {
+        std::unordered_map<String, const ProgramEnrichmentUpdate*> byKey;
+        for (const auto& update : updates) {
+            if (update.fields != EnrichedNone) {
+                byKey[StringUtils::ToLower(update.programKey)] = &update;
+            }
+        }
+        
+        if (byKey.empty()) {
+            return;
+        }
+        
+        // 只写回注册表键未再变化的条目，下次增量扫描沿用补全后的信息
+        auto patch = [&byKey](ProgramInfo& program) {
+            auto it = byKey.find(StringUtils::ToLower(program.registryKey));
+            if (it == byKey.end() || it->second->registryWriteTime != program.registryWriteTime) {
+                return false;
+            }
+            it->second->ApplyTo(program);
+            return true;
+        };
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (auto& entry : m_registryIndex) {
+                patch(entry.second.info);
+            }
+            
+            ProgramTablePtr patched = m_programTable->WithEnrichment(updates);
+            if (patched) {
+                m_programTable = patched;
+            }
+        }
+        
+        if (m_cache) {
+            m_cache->PatchCachedPrograms(includeSystemComponents, patch);
+        }
+        
+        YG_LOG_INFO(L"程序信息补全完成，补全数量: " + std::to_wstring(byKey.size()));
+    }
+    
     ErrorCode ProgramDetector::ScanSync(bool includeSystemComponents, std::vector<ProgramInfo>& programs) {
         if (m_scanning.load()) {
             return ErrorCode::OperationInProgress;
@@ -60,47 +436,116 @@ namespace YG {
             YG_LOG_INFO(L"从缓存获取程序列表");
             auto cacheResult = m_cache->GetCachedPrograms(includeSystemComponents, programs);
             if (cacheResult.code == DetailedErrorCode::Success) {
-                m_programs = programs;
-                m_totalFound = static_cast<int>(programs.size());
+                PublishPrograms(programs);
                 return ErrorCode::Success;
             }
         }
         
-        // 缓存无效，执行实际扫描
+        // 缓存无效，执行实际扫描（同步扫描不使用上一次异步扫描的回调）
         m_includeSystemComponents = includeSystemComponents;
-        m_programs.clear();
+        m_progressCallback = nullptr;
+        m_batchCallback = nullptr;
         
         DWORD startTime = GetTickCount();
+        std::uint64_t changeGeneration = m_cache ? m_cache->GetChangeGeneration() : UINT64_MAX;
         
         // 扫描注册表卸载信息
-        ErrorCode result = ScanRegistryUninstall(m_programs, includeSystemComponents);
+        std::vector<ProgramInfo> scanned;
+        ErrorCode result = ScanRegistryUninstall(scanned, includeSystemComponents);
         if (result != ErrorCode::Success) {
             return result;
         }
         
         // 扫描Windows Store应用
         if (includeSystemComponents) {
-            ScanWindowsStoreApps(m_programs);
+            ScanWindowsStoreApps(scanned);
+        }
+        
+        m_lastScanTime = GetTickCount() - startTime;
+        PublishPrograms(scanned);
+        
+        // 更新缓存
+        if (m_cache) {
+            m_cache->UpdateCache(includeSystemComponents, scanned, m_lastScanTime, changeGeneration);
+        }
+        
+        programs.swap(scanned);
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode ProgramDetector::RescanIncremental(bool includeSystemComponents, std::vector<ProgramInfo>& programs,
+                                                 ProgramScanDelta& delta) {
+        // 与后台扫描线程互斥
+        bool expected = false;
+        if (!m_scanning.compare_exchange_strong(expected, true)) {
+            return ErrorCode::OperationInProgress;
+        }
+        
+        if (m_scanThread && m_scanThread->joinable()) {
+            m_scanThread->join();
+        }
+        
+        m_includeSystemComponents = includeSystemComponents;
+        m_progressCallback = nullptr;
+        m_batchCallback = nullptr;
+        m_stopRequested = false;
+        delta = ProgramScanDelta();
+        
+        DWORD startTime = GetTickCount();
+        std::uint64_t changeGeneration = m_cache ? m_cache->GetChangeGeneration() : UINT64_MAX;
+        
+        // 只重新读取新增或时间戳变化的子键
+        std::vector<ProgramInfo> scanned;
+        ErrorCode result = ScanRegistryUninstall(scanned, includeSystemComponents, &delta);
+        if (result != ErrorCode::Success) {
+            m_scanning = false;
+            return result;
+        }
+        
+        // Windows Store应用不参与增量比较，每次完整读取
+        if (includeSystemComponents) {
+            ScanWindowsStoreApps(scanned);
         }
         
         m_lastScanTime = GetTickCount() - startTime;
-        m_totalFound = static_cast<int>(m_programs.size());
+        PublishPrograms(scanned);
+        
+        YG_LOG_INFO(L"增量扫描完成，新增 " + std::to_wstring(delta.added.size()) +
+                   L"，变化 " + std::to_wstring(delta.changed.size()) +
+                   L"，移除 " + std::to_wstring(delta.removed.size()) +
+                   L"，耗时 " + std::to_wstring(m_lastScanTime) + L"ms");
         
         // 更新缓存
         if (m_cache) {
-            m_cache->UpdateCache(includeSystemComponents, m_programs, m_lastScanTime);
+            m_cache->UpdateCache(includeSystemComponents, scanned, m_lastScanTime, changeGeneration);
         }
         
-        programs = m_programs;
+        programs.swap(scanned);
+        m_scanning = false;
         return ErrorCode::Success;
     }
     
+    void ProgramDetector::CancelScan() {
+        if (!m_scanning.load()) {
+            return;
+        }
+        
+        YG_LOG_INFO(L"请求取消程序扫描");
+        {
+            std::lock_guard<std::mutex> lock(m_stopMutex);
+            m_reportCancellation = true;
+            m_stopRequested = true;
+        }
+        m_stopCondition.notify_all();
+    }
+    
     void ProgramDetector::StopScan() {
         YG_LOG_INFO(L"开始停止程序扫描...");
         
         // 设置停止标志并通知条件变量
         {
             std::lock_guard<std::mutex> lock(m_stopMutex);
+            m_reportCancellation = false;
             m_stopRequested = true;
         }
         m_stopCondition.notify_all();
@@ -193,74 +638,255 @@ namespace YG {
         lastScanTime = timeStr;
     }
     
-    ErrorCode ProgramDetector::ScanRegistryUninstall(std::vector<ProgramInfo>& programs, bool includeSystemComponents) {
-        YG_LOG_INFO(L"开始扫描注册表卸载信息");
+    ErrorCode ProgramDetector::ScanRegistryUninstall(std::vector<ProgramInfo>& programs, bool includeSystemComponents,
+                                                     ProgramScanDelta* delta) {
+        YG_LOG_INFO(L"开始扫描注册表卸载信息" + String(delta ? L"（增量）" : L""));
+        
+        // 所有需要扫描的注册表路径
+        const RegistryPath (&uninstallKeys)[4] = s_uninstallRoots;
+        const int keyCount = static_cast<int>(sizeof(uninstallKeys) / sizeof(uninstallKeys[0]));
+        
+        // 待扫描的子键（根键序号 + 子键名称）
+        struct ScanItem {
+            int keyIndex;
+            String subKeyName;
+        };
         
-        // 定义所有需要扫描的注册表路径
-        RegistryPath uninstallKeys[] = {
-            { HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"64位程序" },
-            { HKEY_LOCAL_MACHINE, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"32位程序" },
-            { HKEY_CURRENT_USER, L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"当前用户64位程序" },
-            { HKEY_CURRENT_USER, L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall", L"当前用户32位程序" }
+        // 单个子键的扫描结果
+        struct ScanResult {
+            String indexKey;                // m_registryIndex中的键
+            RegistryEntryState state;       // 新的扫描记录
+            bool reused;                    // 是否沿用了上次的记录
         };
         
-        for (int keyIndex = 0; keyIndex < 4; keyIndex++) {
+        auto registry = RegistryHelper::GetSource();
+        HKEY rootHandles[keyCount] = {};
+        DWORD subKeyCounts[keyCount] = {};
+        std::vector<ScanItem> items;
+        
+        auto closeRoots = [&]() {
+            for (int keyIndex = 0; keyIndex < keyCount; keyIndex++) {
+                if (rootHandles[keyIndex]) {
+                    registry->CloseKey(rootHandles[keyIndex]);
+                    rootHandles[keyIndex] = nullptr;
+                }
+            }
+        };
+        
+        // 第一阶段：先打开全部根键并取得子键计数，得到扫描总量后再枚举子键名称；
+        // 根键句柄保持打开供工作线程共享
+        size_t expectedTotal = 0;
+        for (int keyIndex = 0; keyIndex < keyCount; keyIndex++) {
             YG_LOG_INFO(L"尝试打开注册表键: " + String(uninstallKeys[keyIndex].description) + L" - " + String(uninstallKeys[keyIndex].path));
             
-            HKEY hKey;
-            LONG result = RegOpenKeyExW(uninstallKeys[keyIndex].rootKey, uninstallKeys[keyIndex].path, 0, KEY_READ, &hKey);
+            HKEY hKey = nullptr;
+            LONG result = registry->OpenKey(uninstallKeys[keyIndex].rootKey, uninstallKeys[keyIndex].path, KEY_READ, hKey);
             if (result != ERROR_SUCCESS) {
                 YG_LOG_WARNING(L"无法打开注册表键，错误代码: " + std::to_wstring(result));
                 continue;
             }
             
-            YG_LOG_INFO(L"成功打开注册表键");
+            rootHandles[keyIndex] = hKey;
+            if (registry->QueryInfoKey(hKey, &subKeyCounts[keyIndex], nullptr, nullptr) == ERROR_SUCCESS) {
+                expectedTotal += subKeyCounts[keyIndex];
+            }
+        }
+        
+        items.reserve(expectedTotal);
+        
+        for (int keyIndex = 0; keyIndex < keyCount; keyIndex++) {
+            HKEY hKey = rootHandles[keyIndex];
+            if (!hKey) {
+                continue;
+            }
             
             DWORD index = 0;
-            wchar_t subKeyName[256];
-            DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
-            int foundCount = 0;
+            String subKeyName;
+            while (registry->EnumKey(hKey, index++, subKeyName) == ERROR_SUCCESS) {
+                items.push_back({ keyIndex, subKeyName });
+            }
+            
+            YG_LOG_INFO(L"成功打开注册表键，子键数量: " + std::to_wstring(index - 1));
+        }
+        
+        // 计数与枚举之间子键可能增删，以实际枚举结果为准
+        if (items.size() != expectedTotal) {
+            YG_LOG_DEBUG(L"子键计数与枚举结果不一致: " + std::to_wstring(expectedTotal) + L" / " + std::to_wstring(items.size()));
+        }
+        m_scanTotal = items.size();
+        
+        if (m_stopRequested) {
+            closeRoots();
+            return ErrorCode::OperationCancelled;
+        }
+        
+        // 取出上次的扫描记录，工作线程只读访问；扫描取消时原样放回
+        std::unordered_map<String, RegistryEntryState> previousIndex;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            previousIndex.swap(m_registryIndex);
+        }
+        
+        // 第二阶段：按连续区间分片，交给线程池并行读取，每个分片产出独立的结果批次
+        const size_t threadCount = (std::min)(ThreadPool::DefaultThreadCount(), static_cast<size_t>(8));
+        const size_t shardSize = (std::max)(static_cast<size_t>(16), items.size() / (threadCount * 4) + 1);
+        const bool reuseUnchanged = (delta != nullptr);
+        
+        std::unordered_map<String, RegistryEntryState> newIndex;
+        newIndex.reserve(items.size());
+        size_t reusedCount = 0;
+        
+        std::vector<std::future<std::vector<ScanResult>>> shards;
+        {
+            ThreadPool pool(threadCount);
             
-            while (RegEnumKeyExW(hKey, index++, subKeyName, &subKeyNameSize, nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+            for (size_t begin = 0; begin < items.size(); begin += shardSize) {
+                size_t end = (std::min)(begin + shardSize, items.size());
+                
+                shards.push_back(pool.Submit([this, &registry, &items, &rootHandles, &uninstallKeys, &previousIndex,
+                                              begin, end, reuseUnchanged]() {
+                    std::vector<ScanResult> batch;
+                    
+                    // 分片开始前检查停止请求，已取消时直接返回空批次
+                    if (m_stopRequested) {
+                        return batch;
+                    }
+                    
+                    batch.reserve(end - begin);
+                    for (size_t i = begin; i < end; i++) {
+                        const ScanItem& item = items[i];
+                        const RegistryPath& registryPath = uninstallKeys[item.keyIndex];
+                        
+                        // 只读取子键的最后写入时间，用于判断是否需要重新读取全部值
+                        HKEY hSubKey = nullptr;
+                        if (registry->OpenKey(rootHandles[item.keyIndex], item.subKeyName, KEY_READ, hSubKey) != ERROR_SUCCESS) {
+                            continue;
+                        }
+                        
+                        FILETIME lastWrite = {};
+                        registry->QueryInfoKey(hSubKey, nullptr, nullptr, &lastWrite);
+                        registry->CloseKey(hSubKey);
+                        
+                        ScanResult scanResult;
+                        scanResult.indexKey = StringUtils::ToLower(RegistryHelper::FormatRegistryPath(registryPath.rootKey,
+                            String(registryPath.path) + L"\\" + item.subKeyName));
+                        scanResult.reused = false;
+                        
+                        DWORD64 writeTime = (static_cast<DWORD64>(lastWrite.dwHighDateTime) << 32) | lastWrite.dwLowDateTime;
+                        
+                        if (reuseUnchanged) {
+                            auto previous = previousIndex.find(scanResult.indexKey);
+                            if (previous != previousIndex.end() && previous->second.lastWriteTime == writeTime) {
+                                scanResult.state = previous->second;
+                                scanResult.reused = true;
+                                batch.push_back(std::move(scanResult));
+                                continue;
+                            }
+                        }
+                        
+                        scanResult.state.lastWriteTime = writeTime;
+                        ErrorCode result = GetProgramInfoFromRegistry(rootHandles[item.keyIndex], item.subKeyName,
+                                                                      scanResult.state.info, registryPath);
+                        if (result == ErrorCode::Success) {
+                            scanResult.state.valid = true;
+                            scanResult.state.info.registryWriteTime = writeTime;
+                            scanResult.state.systemComponent = IsSystemComponent(scanResult.state.info);
+                        } else {
+                            // 无效项也记录时间戳，避免每次刷新都重新读取
+                            YG_LOG_DEBUG(L"跳过无效程序项: " + item.subKeyName);
+                            scanResult.state.info = ProgramInfo();
+                        }
+                        
+                        batch.push_back(std::move(scanResult));
+                    }
+                    
+                    return batch;
+                }));
+            }
+            
+            // 第三阶段：按分片顺序合并，保证结果顺序与串行扫描一致；
+            // 每合并完一个分片即可分批回调，不必等待后面的分片
+            std::vector<ProgramInfo> pendingBatch;
+            for (size_t shardIndex = 0; shardIndex < shards.size(); shardIndex++) {
+                std::vector<ScanResult> batch = shards[shardIndex].get();
+                size_t completedItems = (std::min)((shardIndex + 1) * shardSize, items.size());
+                
                 if (m_stopRequested) {
-                    RegCloseKey(hKey);
-                    return ErrorCode::OperationCancelled;
+                    continue;
                 }
                 
-                ProgramInfo programInfo;
-                ErrorCode result = GetProgramInfoFromRegistry(hKey, subKeyName, programInfo, uninstallKeys[keyIndex]);
-                if (result == ErrorCode::Success) {
-                    foundCount++;
-                    YG_LOG_INFO(L"找到程序: " + programInfo.name);
-                    // 检查是否应该包含系统组件
-                    if (!includeSystemComponents && IsSystemComponent(programInfo)) {
-                        subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
-                        continue;
+                for (auto& scanResult : batch) {
+                    RegistryEntryState& state = scanResult.state;
+                    state.visible = state.valid && (includeSystemComponents || !state.systemComponent);
+                    
+                    if (delta) {
+                        auto previous = previousIndex.find(scanResult.indexKey);
+                        bool wasVisible = (previous != previousIndex.end() && previous->second.visible);
+                        
+                        if (state.visible && !wasVisible) {
+                            delta->added.push_back(state.info);
+                        } else if (state.visible && !scanResult.reused) {
+                            delta->changed.push_back(state.info);
+                        } else if (!state.visible && wasVisible) {
+                            delta->removed.push_back(previous->second.info);
+                        }
                     }
                     
-                    programs.push_back(programInfo);
+                    if (scanResult.reused) {
+                        reusedCount++;
+                    }
                     
-                    // 调试信息
-                    YG_LOG_INFO(L"找到程序: " + programInfo.name);
-                } else {
-                    // 调试信息
-                    YG_LOG_DEBUG(L"跳过无效程序项: " + String(subKeyName));
+                    if (state.visible) {
+                        if (!scanResult.reused) {
+                            YG_LOG_INFO(L"找到程序: " + state.info.name);
+                        }
+                        programs.push_back(state.info);
+                        if (m_batchCallback) {
+                            pendingBatch.push_back(state.info);
+                        }
+                    }
+                    
+                    newIndex[scanResult.indexKey] = std::move(state);
                 }
                 
-                subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+                EmitScanBatch(pendingBatch, completedItems, items.size(), shardIndex + 1 == shards.size());
                 
-                // 更新进度
+                // 更新进度（按已处理的子键数折算到注册表扫描所占的进度区间）
                 if (m_progressCallback) {
-                    int progress = (index * 100) / 200; // 估算进度
-                    UpdateProgress(progress, programInfo.name);
+                    int progress = s_registryProgressBegin + static_cast<int>(
+                        (completedItems * (s_registryProgressEnd - s_registryProgressBegin)) / items.size());
+                    UpdateProgress(progress, L"已扫描 " + std::to_wstring(completedItems) + L"/" +
+                                   std::to_wstring(items.size()) +
+                                   (programs.empty() ? String() : L"：" + programs.back().name));
                 }
             }
-            
-            YG_LOG_INFO(L"注册表键扫描完成，找到 " + std::to_wstring(foundCount) + L" 个程序");
-            RegCloseKey(hKey);
         }
         
-        YG_LOG_INFO(L"注册表扫描完成，总计找到 " + std::to_wstring(programs.size()) + L" 个程序");
+        closeRoots();
+        
+        if (m_stopRequested) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_registryIndex.swap(previousIndex);
+            return ErrorCode::OperationCancelled;
+        }
+        
+        // 上次可见、本次已不存在的子键计为移除
+        if (delta) {
+            for (const auto& previous : previousIndex) {
+                if (previous.second.visible && newIndex.find(previous.first) == newIndex.end()) {
+                    delta->removed.push_back(previous.second.info);
+                }
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_registryIndex.swap(newIndex);
+        }
+        
+        YG_LOG_INFO(L"注册表扫描完成，共 " + std::to_wstring(items.size()) + L" 个子键（沿用 " +
+                   std::to_wstring(reusedCount) + L" 个），" + std::to_wstring(shards.size()) +
+                   L" 个分片，总计找到 " + std::to_wstring(programs.size()) + L" 个程序");
         
         return ErrorCode::Success;
     }
@@ -269,25 +895,24 @@ namespace YG {
         YG_LOG_INFO(L"开始扫描Windows Store应用");
         
         // 扫描当前用户的UWP应用包
-        const wchar_t* uwpKeyPath = L"SOFTWARE\\Classes\\Local Settings\\Software\\Microsoft\\Windows\\CurrentVersion\\AppModel\\Repository\\Packages";
+        const wchar_t* uwpKeyPath = s_storeAppsPath;
         
+        auto registry = RegistryHelper::GetSource();
         HKEY hKey;
-        LONG result = RegOpenKeyExW(HKEY_CURRENT_USER, uwpKeyPath, 0, KEY_READ, &hKey);
+        LONG result = registry->OpenKey(HKEY_CURRENT_USER, uwpKeyPath, KEY_READ, hKey);
         if (result != ERROR_SUCCESS) {
             YG_LOG_WARNING(L"无法打开UWP应用注册表键，错误代码: " + std::to_wstring(result));
             return ErrorCode::RegistryError;
         }
         
         DWORD index = 0;
-        wchar_t subKeyName[256];
-        DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+        String subKeyName;
         int foundCount = 0;
         
-        while (RegEnumKeyExW(hKey, index++, subKeyName, &subKeyNameSize, 
-                           nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+        while (registry->EnumKey(hKey, index++, subKeyName) == ERROR_SUCCESS) {
             
             if (m_stopRequested) {
-                RegCloseKey(hKey);
+                registry->CloseKey(hKey);
                 return ErrorCode::OperationCancelled;
             }
             
@@ -299,7 +924,6 @@ namespace YG {
                 packageName.find(L"Windows.") == 0 ||
                 packageName.find(L"Microsoft.VCLibs") != String::npos ||
                 packageName.find(L"Microsoft.NET") != String::npos) {
-                subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
                 continue;
             }
             
@@ -321,11 +945,9 @@ namespace YG {
                 programs.push_back(uwpApp);
                 foundCount++;
             }
-            
-            subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
         }
         
-        RegCloseKey(hKey);
+        registry->CloseKey(hKey);
         
         YG_LOG_INFO(L"UWP应用扫描完成，找到 " + std::to_wstring(foundCount) + L" 个应用");
         return ErrorCode::Success;
@@ -338,127 +960,71 @@ namespace YG {
     }
     
     ErrorCode ProgramDetector::GetProgramInfoFromRegistry(HKEY hParentKey, const String& subKeyName, ProgramInfo& programInfo, const RegistryPath& registryPath) {
+        auto registry = RegistryHelper::GetSource();
         HKEY hSubKey;
-        LONG result = RegOpenKeyExW(hParentKey, subKeyName.c_str(), 0, KEY_READ, &hSubKey);
+        LONG result = registry->OpenKey(hParentKey, subKeyName, KEY_READ, hSubKey);
         if (result != ERROR_SUCCESS) {
             return ErrorCode::RegistryError;
         }
         
         // 构建完整的注册表键路径
-        String rootKeyName;
-        if (registryPath.rootKey == HKEY_LOCAL_MACHINE) {
-            rootKeyName = L"HKEY_LOCAL_MACHINE";
-        } else if (registryPath.rootKey == HKEY_CURRENT_USER) {
-            rootKeyName = L"HKEY_CURRENT_USER";
-        } else if (registryPath.rootKey == HKEY_CLASSES_ROOT) {
-            rootKeyName = L"HKEY_CLASSES_ROOT";
-        } else if (registryPath.rootKey == HKEY_USERS) {
-            rootKeyName = L"HKEY_USERS";
-        } else {
-            rootKeyName = L"HKEY_LOCAL_MACHINE";
-        }
+        programInfo.registryKey = RegistryHelper::FormatRegistryPath(registryPath.rootKey,
+            String(registryPath.path) + L"\\" + subKeyName);
         
-        programInfo.registryKey = rootKeyName + L"\\" + String(registryPath.path) + L"\\" + subKeyName;
+        // 一次枚举读出所有值，再按名称分派到各字段
+        UninstallValues values;
+        ReadUninstallValues(*registry, hSubKey, values);
         
         // 读取程序名称
-        wchar_t displayName[512] = {0};
-        DWORD displayNameSize = sizeof(displayName);
-        if (RegQueryValueExW(hSubKey, L"DisplayName", nullptr, nullptr, 
-                           (LPBYTE)displayName, &displayNameSize) == ERROR_SUCCESS) {
-            programInfo.name = displayName;
-            programInfo.displayName = displayName;  // 同时设置displayName字段
+        if (values.hasDisplayName) {
+            programInfo.name = values.displayName;
+            programInfo.displayName = values.displayName;  // 同时设置displayName字段
         } else {
             // 如果没有DisplayName，跳过此项
-            RegCloseKey(hSubKey);
+            registry->CloseKey(hSubKey);
             return ErrorCode::DataNotFound;
         }
         
+        // 路径类字段先于各项推断填充，后续的版本、发布者、日期和大小推断都依赖它们
+        programInfo.installLocation = values.installLocation;
+        programInfo.uninstallString = values.uninstallString;
+        programInfo.iconPath = values.displayIcon;
+        
         // 读取版本 - 多种方法尝试
-        wchar_t version[128] = {0};
-        DWORD versionSize = sizeof(version);
         bool versionFound = false;
         
         // 方法1: DisplayVersion字段
-        if (RegQueryValueExW(hSubKey, L"DisplayVersion", nullptr, nullptr, 
-                           (LPBYTE)version, &versionSize) == ERROR_SUCCESS && wcslen(version) > 0) {
-            programInfo.version = version;
+        if (!values.displayVersion.empty()) {
+            programInfo.version = values.displayVersion;
             versionFound = true;
         }
         
         // 方法2: Version字段
-        if (!versionFound) {
-            versionSize = sizeof(version);
-            if (RegQueryValueExW(hSubKey, L"Version", nullptr, nullptr, 
-                               (LPBYTE)version, &versionSize) == ERROR_SUCCESS && wcslen(version) > 0) {
-                programInfo.version = version;
-                versionFound = true;
-            }
+        if (!versionFound && !values.version.empty()) {
+            programInfo.version = values.version;
+            versionFound = true;
         }
         
         // 方法3: VersionMajor + VersionMinor
-        if (!versionFound) {
-            DWORD majorVersion = 0, minorVersion = 0;
-            DWORD dwSize = sizeof(DWORD);
-            
-            if (RegQueryValueExW(hSubKey, L"VersionMajor", nullptr, nullptr, 
-                               (LPBYTE)&majorVersion, &dwSize) == ERROR_SUCCESS) {
-                dwSize = sizeof(DWORD);
-                RegQueryValueExW(hSubKey, L"VersionMinor", nullptr, nullptr, 
-                               (LPBYTE)&minorVersion, &dwSize);
-                
-                if (majorVersion > 0) {
-                    wchar_t versionStr[32];
-                    swprintf(versionStr, sizeof(versionStr)/sizeof(wchar_t), L"%d.%d", majorVersion, minorVersion);
-                    programInfo.version = versionStr;
-                    versionFound = true;
-                }
-            }
+        if (!versionFound && values.hasVersionMajor && values.versionMajor > 0) {
+            wchar_t versionStr[32];
+            swprintf(versionStr, sizeof(versionStr)/sizeof(wchar_t), L"%lu.%lu",
+                     static_cast<unsigned long>(values.versionMajor), static_cast<unsigned long>(values.versionMinor));
+            programInfo.version = versionStr;
+            versionFound = true;
         }
         
-        // 方法4: 从可执行文件获取版本信息
-        if (!versionFound && !programInfo.uninstallString.empty()) {
-            String executablePath;
-            String parameters;
-            if (ParseUninstallString(programInfo.uninstallString, executablePath, parameters)) {
-                String fileVersion, fileDescription;
-                if (GetFileVersionInfo(executablePath, fileVersion, fileDescription)) {
-                    if (!fileVersion.empty()) {
-                        programInfo.version = fileVersion;
-                        versionFound = true;
-                    }
-                }
-            }
-        }
+        // 注册表中没有版本时由ProgramEnricher在后台读取卸载程序的文件版本，扫描本身不访问磁盘
         
         // 读取发布者 - 多种方法尝试
-        wchar_t publisher[256] = {0};
-        DWORD publisherSize = sizeof(publisher);
         bool publisherFound = false;
         
-        // 方法1: Publisher字段
-        if (RegQueryValueExW(hSubKey, L"Publisher", nullptr, nullptr, 
-                           (LPBYTE)publisher, &publisherSize) == ERROR_SUCCESS && wcslen(publisher) > 0) {
-            programInfo.publisher = publisher;
-            publisherFound = true;
-        }
-        
-        // 方法2: Manufacturer字段（某些程序使用此字段）
-        if (!publisherFound) {
-            publisherSize = sizeof(publisher);
-            if (RegQueryValueExW(hSubKey, L"Manufacturer", nullptr, nullptr, 
-                               (LPBYTE)publisher, &publisherSize) == ERROR_SUCCESS && wcslen(publisher) > 0) {
-                programInfo.publisher = publisher;
-                publisherFound = true;
-            }
-        }
-        
-        // 方法3: Contact字段
-        if (!publisherFound) {
-            publisherSize = sizeof(publisher);
-            if (RegQueryValueExW(hSubKey, L"Contact", nullptr, nullptr, 
-                               (LPBYTE)publisher, &publisherSize) == ERROR_SUCCESS && wcslen(publisher) > 0) {
-                programInfo.publisher = publisher;
+        // 方法1-3: Publisher、Manufacturer（某些程序使用此字段）、Contact字段
+        for (const String* publisher : { &values.publisher, &values.manufacturer, &values.contact }) {
+            if (!publisher->empty()) {
+                programInfo.publisher = *publisher;
                 publisherFound = true;
+                break;
             }
         }
         
@@ -480,52 +1046,27 @@ namespace YG {
             }
         }
         
-        // 读取安装路径
-        wchar_t installLocation[MAX_PATH] = {0};
-        DWORD installLocationSize = sizeof(installLocation);
-        if (RegQueryValueExW(hSubKey, L"InstallLocation", nullptr, nullptr, 
-                           (LPBYTE)installLocation, &installLocationSize) == ERROR_SUCCESS) {
-            programInfo.installLocation = installLocation;
-        }
-        
-        // 读取卸载字符串
-        wchar_t uninstallString[512] = {0};
-        DWORD uninstallStringSize = sizeof(uninstallString);
-        if (RegQueryValueExW(hSubKey, L"UninstallString", nullptr, nullptr, 
-                           (LPBYTE)uninstallString, &uninstallStringSize) == ERROR_SUCCESS) {
-            programInfo.uninstallString = uninstallString;
-        }
-        
         // 读取安装日期 - 尝试多种字段名和数据类型
         wchar_t installDate[64] = {0};
-        DWORD installDateSize = sizeof(installDate);
         bool dateFound = false;
         
         // 方法1: 尝试InstallDate字段 (字符串类型)
-        if (RegQueryValueExW(hSubKey, L"InstallDate", nullptr, nullptr, 
-                           (LPBYTE)installDate, &installDateSize) == ERROR_SUCCESS && wcslen(installDate) > 0) {
-            programInfo.installDate = installDate;
+        if (!values.installDate.empty()) {
+            programInfo.installDate = values.installDate;
             dateFound = true;
         }
         
         // 方法2: 尝试InstallTime字段
-        if (!dateFound) {
-            installDateSize = sizeof(installDate);
-            if (RegQueryValueExW(hSubKey, L"InstallTime", nullptr, nullptr, 
-                               (LPBYTE)installDate, &installDateSize) == ERROR_SUCCESS && wcslen(installDate) > 0) {
-                programInfo.installDate = installDate;
-                dateFound = true;
-            }
+        if (!dateFound && !values.installTime.empty()) {
+            programInfo.installDate = values.installTime;
+            dateFound = true;
         }
         
         // 方法3: 尝试HelpLink字段中的日期信息
         if (!dateFound) {
-            wchar_t helpLink[512] = {0};
-            DWORD helpLinkSize = sizeof(helpLink);
-            if (RegQueryValueExW(hSubKey, L"HelpLink", nullptr, nullptr, 
-                               (LPBYTE)helpLink, &helpLinkSize) == ERROR_SUCCESS) {
+            if (!values.helpLink.empty()) {
                 // 从HelpLink中提取日期信息（某些程序会在URL中包含版本和日期）
-                String helpStr = helpLink;
+                const String& helpStr = values.helpLink;
                 // 查找类似 2024, 2025 这样的年份
                 for (int year = 2020; year <= 2030; year++) {
                     String yearStr = std::to_wstring(year);
@@ -540,217 +1081,26 @@ namespace YG {
             }
         }
         
-        // 方法4: 从卸载字符串路径获取文件创建时间
-        if (!dateFound && !programInfo.uninstallString.empty()) {
-            // 提取卸载程序的路径
-            String uninstallPath = programInfo.uninstallString;
-            size_t exePos = uninstallPath.find(L".exe");
-            if (exePos != String::npos) {
-                uninstallPath = uninstallPath.substr(0, exePos + 4);
-                // 去掉引号
-                if (uninstallPath.front() == L'"') uninstallPath.erase(0, 1);
-                if (!uninstallPath.empty() && uninstallPath.back() == L'"') uninstallPath.pop_back();
-                
-                WIN32_FIND_DATAW findData;
-                HANDLE hFind = FindFirstFileW(uninstallPath.c_str(), &findData);
-                if (hFind != INVALID_HANDLE_VALUE) {
-                    SYSTEMTIME st;
-                    if (FileTimeToSystemTime(&findData.ftCreationTime, &st)) {
-                        swprintf(installDate, 64, L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
-                        programInfo.installDate = installDate;
-                        dateFound = true;
-                    }
-                    FindClose(hFind);
-                }
-            }
+        // 读取程序大小（EstimatedSize以KB为单位）
+        if (values.estimatedSize > 0) {
+            programInfo.estimatedSize = static_cast<DWORD64>(values.estimatedSize) * 1024; // KB转换为字节
         }
         
-        // 方法5: 从安装目录获取创建时间
-        if (!dateFound && !programInfo.installLocation.empty()) {
-            WIN32_FIND_DATAW findData;
-            HANDLE hFind = FindFirstFileW(programInfo.installLocation.c_str(), &findData);
-            if (hFind != INVALID_HANDLE_VALUE) {
-                SYSTEMTIME st;
-                if (FileTimeToSystemTime(&findData.ftCreationTime, &st)) {
-                    swprintf(installDate, 64, L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
-                    programInfo.installDate = installDate;
-                    dateFound = true;
-                }
-                FindClose(hFind);
-            }
-        }
-        
-        // 方法6: 从注册表键本身的修改时间获取
-        if (!dateFound) {
-            FILETIME lastWriteTime;
-            if (RegQueryInfoKeyW(hSubKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 
-                               nullptr, nullptr, nullptr, nullptr, &lastWriteTime) == ERROR_SUCCESS) {
-                SYSTEMTIME st;
-                if (FileTimeToSystemTime(&lastWriteTime, &st)) {
-                    swprintf(installDate, 64, L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
-                    programInfo.installDate = installDate;
-                    dateFound = true;
-                }
-            }
-        }
+        // 注册表中没有的大小和安装日期由ProgramEnricher在后台访问文件系统推断，扫描本身不访问磁盘
         
-        // 方法7: 从DisplayIcon路径获取文件创建时间
-        if (!dateFound && !programInfo.iconPath.empty()) {
-            String dateFromIcon = GetDateFromIconPath(programInfo.iconPath);
-            if (!dateFromIcon.empty()) {
-                programInfo.installDate = dateFromIcon;
-                dateFound = true;
-            }
-        }
-        
-        // 方法8: 基于程序版本和发布者的智能估算
-        if (!dateFound) {
-            String estimatedDate = EstimateInstallDateByName(programInfo);
-            if (!estimatedDate.empty()) {
-                programInfo.installDate = estimatedDate;
-                dateFound = true;
-            }
-        }
-        
-        // 读取程序大小 - 尝试多种方法获取
-        DWORD size = 0;
-        DWORD sizeDataSize = sizeof(size);
-        bool sizeFound = false;
-        
-        // 方法1: 从EstimatedSize字段读取
-        if (RegQueryValueExW(hSubKey, L"EstimatedSize", nullptr, nullptr, 
-                           (LPBYTE)&size, &sizeDataSize) == ERROR_SUCCESS && size > 0) {
-            programInfo.estimatedSize = static_cast<DWORD64>(size) * 1024; // KB转换为字节
-            sizeFound = true;
-        }
-        
-        // 方法2: 如果EstimatedSize不存在或为0，尝试计算安装目录大小
-        if (!sizeFound && !programInfo.installLocation.empty()) {
-            DWORD64 directorySize = CalculateDirectorySize(programInfo.installLocation);
-            if (directorySize > 0) {
-                programInfo.estimatedSize = directorySize;
-                sizeFound = true;
-            }
-        }
-        
-        // 方法3: 如果还是没有，尝试从卸载字符串中提取可执行文件大小
-        if (!sizeFound && !programInfo.uninstallString.empty()) {
-            DWORD64 executableSize = GetExecutableSize(programInfo.uninstallString);
-            if (executableSize > 0) {
-                programInfo.estimatedSize = executableSize;
-                sizeFound = true;
-            }
-        }
-        
-        // 方法4: 如果还是没有，尝试从DisplayIcon路径估算
-        if (!sizeFound && !programInfo.iconPath.empty()) {
-            DWORD64 iconSize = EstimateFromIconPath(programInfo.iconPath);
-            if (iconSize > 0) {
-                programInfo.estimatedSize = iconSize;
-                sizeFound = true;
-            }
-        }
-        
-        // 方法5: 最后的备用方案 - 基于程序名称和发布者的经验估算
-        if (!sizeFound) {
-            DWORD64 estimatedSize = EstimateProgramSizeByName(programInfo);
-            if (estimatedSize > 0) {
-                programInfo.estimatedSize = estimatedSize;
-                sizeFound = true;
-            }
-        }
-        
-        // 读取图标路径
-        wchar_t iconPath[MAX_PATH] = {0};
-        DWORD iconPathSize = sizeof(iconPath);
-        if (RegQueryValueExW(hSubKey, L"DisplayIcon", nullptr, nullptr, 
-                           (LPBYTE)iconPath, &iconPathSize) == ERROR_SUCCESS) {
-            programInfo.iconPath = iconPath;
-        }
-        
-        // 检查是否为系统组件（读取SystemComponent字段）
-        DWORD systemComponent = 0;
-        DWORD systemComponentSize = sizeof(systemComponent);
-        if (RegQueryValueExW(hSubKey, L"SystemComponent", nullptr, nullptr, 
-                           (LPBYTE)&systemComponent, &systemComponentSize) == ERROR_SUCCESS) {
-            programInfo.isSystemComponent = (systemComponent == 1);
-        } else {
-            programInfo.isSystemComponent = false;
-        }
+        // 检查是否为系统组件（SystemComponent字段）
+        programInfo.isSystemComponent = (values.systemComponent == 1);
         
         // 验证必要字段
         if (programInfo.name.empty() || programInfo.uninstallString.empty()) {
-            RegCloseKey(hSubKey);
+            registry->CloseKey(hSubKey);
             return ErrorCode::DataNotFound; // 缺少必要信息，跳过
         }
         
-        RegCloseKey(hSubKey);
+        registry->CloseKey(hSubKey);
         return ErrorCode::Success;
     }
     
-    bool ProgramDetector::ParseUninstallString(const String& uninstallString, String& executablePath, String& parameters) {
-        if (uninstallString.empty()) {
-            return false;
-        }
-        
-        // 简单的解析实现
-        size_t pos = uninstallString.find(L".exe");
-        if (pos != String::npos) {
-            executablePath = uninstallString.substr(0, pos + 4);
-            if (pos + 4 < uninstallString.length()) {
-                parameters = uninstallString.substr(pos + 4);
-            }
-            return true;
-        }
-        
-        executablePath = uninstallString;
-        return true;
-    }
-    
-    bool ProgramDetector::GetFileVersionInfo(const String& filePath, String& version, String& description) {
-        DWORD handle = 0;
-        DWORD size = ::GetFileVersionInfoSizeW(filePath.c_str(), &handle);
-        if (size == 0) {
-            return false;
-        }
-        
-        std::vector<BYTE> versionData(size);
-        if (!::GetFileVersionInfoW(filePath.c_str(), handle, size, versionData.data())) {
-            return false;
-        }
-        
-        // 获取版本信息
-        VS_FIXEDFILEINFO* fileInfo;
-        UINT fileInfoSize;
-        if (VerQueryValueW(versionData.data(), L"\\", (LPVOID*)&fileInfo, &fileInfoSize)) {
-            wchar_t versionStr[64];
-#ifdef _MSC_VER
-            swprintf_s(versionStr, L"%d.%d.%d.%d",
-                      HIWORD(fileInfo->dwFileVersionMS),
-                      LOWORD(fileInfo->dwFileVersionMS),
-                      HIWORD(fileInfo->dwFileVersionLS),
-                      LOWORD(fileInfo->dwFileVersionLS));
-#else
-            swprintf(versionStr, sizeof(versionStr)/sizeof(wchar_t), L"%d.%d.%d.%d",
-                    HIWORD(fileInfo->dwFileVersionMS),
-                    LOWORD(fileInfo->dwFileVersionMS),
-                    HIWORD(fileInfo->dwFileVersionLS),
-                    LOWORD(fileInfo->dwFileVersionLS));
-#endif
-            version = versionStr;
-        }
-        
-        // 获取文件描述
-        LPWSTR desc;
-        UINT descSize;
-        if (VerQueryValueW(versionData.data(), L"\\StringFileInfo\\040904b0\\FileDescription", 
-                          (LPVOID*)&desc, &descSize)) {
-            description = desc;
-        }
-        
-        return true;
-    }
-    
     bool ProgramDetector::IsSystemComponent(const ProgramInfo& programInfo) {
         // 1. 如果注册表中明确标记为系统组件
         if (programInfo.isSystemComponent) {
@@ -820,11 +1170,11 @@ namespace YG {
         YG_LOG_INFO(L"扫描工作线程开始");
         m_scanning = true;
         DWORD startTime = GetTickCount();
+        std::uint64_t changeGeneration = m_cache ? m_cache->GetChangeGeneration() : UINT64_MAX;
         ErrorCode result = ErrorCode::Success;
+        std::vector<ProgramInfo> programs;
         
         try {
-            m_programs.clear();
-            
             // 检查是否已被请求停止
             if (m_stopRequested.load()) {
                 YG_LOG_INFO(L"扫描线程启动时发现停止请求，立即退出");
@@ -832,16 +1182,33 @@ namespace YG {
                 goto cleanup;
             }
             
-            UpdateProgress(10, L"开始扫描注册表...");
+            UpdateProgress(s_registryProgressBegin, L"开始扫描注册表...");
+            
+            // 扫描注册表（后台校验时只重新读取发生变化的子键）
+            ProgramScanDelta delta;
+            result = ScanRegistryUninstall(programs, m_includeSystemComponents, m_incrementalScan ? &delta : nullptr);
             
-            // 扫描注册表
-            result = ScanRegistryUninstall(m_programs, m_includeSystemComponents);
+            if (result == ErrorCode::Success && m_incrementalScan) {
+                YG_LOG_INFO(L"后台校验完成，新增 " + std::to_wstring(delta.added.size()) +
+                           L"，变化 " + std::to_wstring(delta.changed.size()) +
+                           L"，移除 " + std::to_wstring(delta.removed.size()));
+                
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_lastScanDelta = std::move(delta);
+            }
             
             if (result == ErrorCode::Success && !m_stopRequested.load()) {
-                UpdateProgress(80, L"扫描Windows Store应用...");
+                UpdateProgress(s_registryProgressEnd, L"扫描Windows Store应用...");
                 
                 if (m_includeSystemComponents) {
-                    ScanWindowsStoreApps(m_programs);
+                    size_t registryCount = programs.size();
+                    ScanWindowsStoreApps(programs);
+                    
+                    // Windows Store应用作为最后一批回调
+                    if (m_batchCallback && !m_stopRequested.load()) {
+                        std::vector<ProgramInfo> storeBatch(programs.begin() + registryCount, programs.end());
+                        EmitScanBatch(storeBatch, m_scanTotal, m_scanTotal, true);
+                    }
                 }
                 
                 if (!m_stopRequested.load()) {
@@ -853,7 +1220,15 @@ namespace YG {
             }
             
             m_lastScanTime = GetTickCount() - startTime;
-            m_totalFound = static_cast<int>(m_programs.size());
+            
+            if (result == ErrorCode::Success) {
+                PublishPrograms(programs);
+            }
+            
+            // 更新缓存（同时写入磁盘快照）
+            if (result == ErrorCode::Success && m_cache) {
+                m_cache->UpdateCache(m_includeSystemComponents, programs, m_lastScanTime, changeGeneration);
+            }
             
         } catch (const std::exception& e) {
             YG_LOG_ERROR(L"扫描工作线程发生异常: " + StringToWString(e.what()));
@@ -864,17 +1239,16 @@ namespace YG {
         }
         
     cleanup:
-        // 清理和回调
-        try {
-            // 调用完成回调
-            if (m_completedCallback && !m_stopRequested.load()) {
-                m_completedCallback(m_programs, result);
+        // 被StopScan停止时不回调；被CancelScan取消时以OperationCancelled回调
+        ScanCompletedCallback completedCallback;
+        if (m_completedCallback && (!m_stopRequested.load() || m_reportCancellation.load())) {
+            completedCallback = m_completedCallback;
+            if (m_stopRequested.load()) {
+                result = ErrorCode::OperationCancelled;
             }
-        } catch (...) {
-            YG_LOG_ERROR(L"回调函数执行时发生异常");
         }
         
-        // 确保状态正确设置并通知等待的线程
+        // 先结束扫描状态再回调，收到回调投递的消息后即可开始新的扫描
         m_scanning = false;
         
         // 通知StopScan函数扫描已完成
@@ -883,6 +1257,14 @@ namespace YG {
         }
         m_stopCondition.notify_all();
         
+        try {
+            if (completedCallback) {
+                completedCallback(programs, result);
+            }
+        } catch (...) {
+            YG_LOG_ERROR(L"回调函数执行时发生异常");
+        }
+        
         YG_LOG_INFO(L"扫描工作线程结束");
     }
     
@@ -892,293 +1274,29 @@ namespace YG {
         }
     }
     
-    DWORD64 ProgramDetector::CalculateDirectorySize(const String& directoryPath) {
-        if (directoryPath.empty()) {
-            return 0;
-        }
-        
-        DWORD64 totalSize = 0;
-        WIN32_FIND_DATAW findData;
-        String searchPath = directoryPath + L"\\*";
-        
-        HANDLE hFind = FindFirstFileW(searchPath.c_str(), &findData);
-        if (hFind == INVALID_HANDLE_VALUE) {
-            return 0;
-        }
-        
-        int fileCount = 0;
-        const int maxFiles = 500; // 限制扫描的文件数量，避免性能问题
-        const int maxDirectories = 10; // 限制扫描的目录数量
-        int directoryCount = 0;
-        
-        do {
-            if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-                // 是文件，累加大小
-                LARGE_INTEGER fileSize;
-                fileSize.LowPart = findData.nFileSizeLow;
-                fileSize.HighPart = findData.nFileSizeHigh;
-                totalSize += fileSize.QuadPart;
-                fileCount++;
-                
-                // 如果文件太多，停止扫描并估算
-                if (fileCount >= maxFiles) {
-                    // 基于已扫描的文件数量估算总大小
-                    DWORD64 averageFileSize = totalSize / fileCount;
-                    totalSize = averageFileSize * (fileCount * 5); // 假设还有5倍的文件
-                    break;
-                }
-            } else if (wcscmp(findData.cFileName, L".") != 0 && wcscmp(findData.cFileName, L"..") != 0) {
-                // 是子目录，限制递归深度避免性能问题
-                if (directoryCount < maxDirectories) {
-                    String subDir = directoryPath + L"\\" + findData.cFileName;
-                    totalSize += CalculateDirectorySize(subDir);
-                    directoryCount++;
-                }
-            }
-            
-            // 如果总大小已经很大，停止计算
-            if (totalSize > 3LL * 1024 * 1024 * 1024) { // 3GB限制
-                break;
-            }
-        } while (FindNextFileW(hFind, &findData));
-        
-        FindClose(hFind);
-        
-        // 限制最大估算大小为3GB，避免不合理的估算
-        if (totalSize > 3LL * 1024 * 1024 * 1024) {
-            totalSize = 3LL * 1024 * 1024 * 1024;
-        }
-        
-        return totalSize;
-    }
-    
-    DWORD64 ProgramDetector::GetExecutableSize(const String& uninstallString) {
-        if (uninstallString.empty()) {
-            return 0;
-        }
-        
-        // 从卸载字符串中提取可执行文件路径
-        String executablePath;
-        String parameters;
-        if (!ParseUninstallString(uninstallString, executablePath, parameters)) {
-            return 0;
-        }
-        
-        // 获取可执行文件大小
-        WIN32_FIND_DATAW findData;
-        HANDLE hFind = FindFirstFileW(executablePath.c_str(), &findData);
-        if (hFind != INVALID_HANDLE_VALUE) {
-            LARGE_INTEGER fileSize;
-            fileSize.LowPart = findData.nFileSizeLow;
-            fileSize.HighPart = findData.nFileSizeHigh;
-            FindClose(hFind);
-            
-            // 对于可执行文件，估算整个程序大小为文件大小的10-50倍
-            return fileSize.QuadPart * 20; // 估算倍数
-        }
-        
-        return 0;
-    }
-    
-    /**
-     * @brief 从图标路径估算程序大小
-     * @param iconPath 图标路径
-     * @return DWORD64 估算的程序大小（字节）
-     */
-    DWORD64 ProgramDetector::EstimateFromIconPath(const String& iconPath) {
-        if (iconPath.empty()) {
-            return 0;
-        }
-        
-        // 从图标路径中提取可执行文件路径（去掉图标索引）
-        String executablePath = iconPath;
-        size_t commaPos = executablePath.find(L',');
-        if (commaPos != String::npos) {
-            executablePath = executablePath.substr(0, commaPos);
-        }
-        
-        // 去掉引号
-        if (executablePath.front() == L'"') executablePath.erase(0, 1);
-        if (!executablePath.empty() && executablePath.back() == L'"') executablePath.pop_back();
-        
-        // 获取可执行文件大小
-        WIN32_FIND_DATAW findData;
-        HANDLE hFind = FindFirstFileW(executablePath.c_str(), &findData);
-        if (hFind != INVALID_HANDLE_VALUE) {
-            LARGE_INTEGER fileSize;
-            fileSize.LowPart = findData.nFileSizeLow;
-            fileSize.HighPart = findData.nFileSizeHigh;
-            FindClose(hFind);
+    void ProgramDetector::EmitScanBatch(std::vector<ProgramInfo>& pending, size_t processedCount, size_t totalCount,
+                                        bool flush) {
+        if (!m_batchCallback || m_stopRequested.load()) {
+            pending.clear();
+            return;
+        }
+        
+        // 一个分片可能产出多批，按批大小切分后依次回调
+        size_t offset = 0;
+        while (pending.size() - offset >= m_batchSize || (flush && offset < pending.size())) {
+            size_t count = (std::min)(m_batchSize, pending.size() - offset);
+            std::vector<ProgramInfo> batch(std::make_move_iterator(pending.begin() + offset),
+                                           std::make_move_iterator(pending.begin() + offset + count));
+            offset += count;
             
-            // 对于可执行文件，估算整个程序大小为文件大小的20-40倍
-            return fileSize.QuadPart * 30; // 估算倍数
-        }
-        
-        return 0;
-    }
-    
-    /**
-     * @brief 基于程序名称和发布者估算程序大小
-     * @param programInfo 程序信息
-     * @return DWORD64 估算的程序大小（字节）
-     */
-    DWORD64 ProgramDetector::EstimateProgramSizeByName(const ProgramInfo& programInfo) {
-        String name = !programInfo.displayName.empty() ? programInfo.displayName : programInfo.name;
-        String publisher = programInfo.publisher;
-        
-        // 转换为小写进行比较
-        std::transform(name.begin(), name.end(), name.begin(), ::towlower);
-        std::transform(publisher.begin(), publisher.end(), publisher.begin(), ::towlower);
-        
-        // 基于程序名称的常见模式进行估算
-        if (name.find(L"microsoft") != String::npos) {
-            if (name.find(L"office") != String::npos) {
-                return 2LL * 1024 * 1024 * 1024; // 2GB - Office套件
-            } else if (name.find(L"visual studio") != String::npos) {
-                return 5LL * 1024 * 1024 * 1024; // 5GB - Visual Studio
-            } else if (name.find(L"sql server") != String::npos) {
-                return 3LL * 1024 * 1024 * 1024; // 3GB - SQL Server
-            } else if (name.find(L".net") != String::npos) {
-                return 500LL * 1024 * 1024; // 500MB - .NET Framework
-            } else {
-                return 1LL * 1024 * 1024 * 1024; // 1GB - 其他Microsoft程序
-            }
-        } else if (name.find(L"google") != String::npos) {
-            if (name.find(L"chrome") != String::npos) {
-                return 500LL * 1024 * 1024; // 500MB - Chrome浏览器
-            } else {
-                return 200LL * 1024 * 1024; // 200MB - 其他Google程序
-            }
-        } else if (name.find(L"adobe") != String::npos) {
-            if (name.find(L"photoshop") != String::npos) {
-                return 3LL * 1024 * 1024 * 1024; // 3GB - Photoshop
-            } else if (name.find(L"acrobat") != String::npos) {
-                return 1LL * 1024 * 1024 * 1024; // 1GB - Acrobat
-            } else {
-                return 2LL * 1024 * 1024 * 1024; // 2GB - 其他Adobe程序
-            }
-        } else if (name.find(L"游戏") != String::npos || name.find(L"game") != String::npos) {
-            return 5LL * 1024 * 1024 * 1024; // 5GB - 游戏
-        } else if (name.find(L"开发") != String::npos || name.find(L"development") != String::npos) {
-            return 2LL * 1024 * 1024 * 1024; // 2GB - 开发工具
-        } else if (name.find(L"安全") != String::npos || name.find(L"security") != String::npos || 
-                   name.find(L"杀毒") != String::npos || name.find(L"antivirus") != String::npos) {
-            return 1LL * 1024 * 1024 * 1024; // 1GB - 安全软件
-        } else {
-            // 默认估算：基于发布者
-            if (publisher.find(L"microsoft") != String::npos) {
-                return 500LL * 1024 * 1024; // 500MB - Microsoft程序
-            } else if (publisher.find(L"adobe") != String::npos) {
-                return 1LL * 1024 * 1024 * 1024; // 1GB - Adobe程序
-            } else if (publisher.find(L"google") != String::npos) {
-                return 300LL * 1024 * 1024; // 300MB - Google程序
-            } else {
-                return 200LL * 1024 * 1024; // 200MB - 其他程序
-            }
-        }
-    }
-    
-    /**
-     * @brief 从图标路径获取文件创建日期
-     * @param iconPath 图标路径
-     * @return String 日期字符串 (YYYYMMDD格式)
-     */
-    String ProgramDetector::GetDateFromIconPath(const String& iconPath) {
-        if (iconPath.empty()) {
-            return L"";
-        }
-        
-        // 从图标路径中提取可执行文件路径（去掉图标索引）
-        String executablePath = iconPath;
-        size_t commaPos = executablePath.find(L',');
-        if (commaPos != String::npos) {
-            executablePath = executablePath.substr(0, commaPos);
-        }
-        
-        // 去掉引号
-        if (executablePath.front() == L'"') executablePath.erase(0, 1);
-        if (!executablePath.empty() && executablePath.back() == L'"') executablePath.pop_back();
-        
-        // 获取可执行文件创建时间
-        WIN32_FIND_DATAW findData;
-        HANDLE hFind = FindFirstFileW(executablePath.c_str(), &findData);
-        if (hFind != INVALID_HANDLE_VALUE) {
-            SYSTEMTIME st;
-            if (FileTimeToSystemTime(&findData.ftCreationTime, &st)) {
-                wchar_t dateStr[16];
-                swprintf(dateStr, sizeof(dateStr)/sizeof(wchar_t), L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
-                FindClose(hFind);
-                return String(dateStr);
+            try {
+                m_batchCallback(batch, processedCount, totalCount);
+            } catch (...) {
+                YG_LOG_ERROR(L"分批结果回调执行时发生异常");
             }
-            FindClose(hFind);
         }
         
-        return L"";
-    }
-    
-    /**
-     * @brief 基于程序名称和发布者估算安装日期
-     * @param programInfo 程序信息
-     * @return String 估算的日期字符串 (YYYYMMDD格式)
-     */
-    String ProgramDetector::EstimateInstallDateByName(const ProgramInfo& programInfo) {
-        String name = !programInfo.displayName.empty() ? programInfo.displayName : programInfo.name;
-        String version = programInfo.version;
-        
-        // 转换为小写进行比较
-        std::transform(name.begin(), name.end(), name.begin(), ::towlower);
-        
-        // 基于程序名称的常见模式进行估算
-        if (name.find(L"microsoft") != String::npos) {
-            if (name.find(L"office") != String::npos) {
-                // Office通常是最近几年安装的
-                return L"20240101"; // 2024年1月1日
-            } else if (name.find(L"visual studio") != String::npos) {
-                // Visual Studio通常是开发工具，安装时间相对较新
-                return L"20240101"; // 2024年1月1日
-            } else if (name.find(L".net") != String::npos) {
-                // .NET Framework通常是系统组件，安装时间较早
-                return L"20220101"; // 2022年1月1日
-            } else {
-                return L"20230101"; // 2023年1月1日
-            }
-        } else if (name.find(L"google") != String::npos) {
-            if (name.find(L"chrome") != String::npos) {
-                // Chrome浏览器更新频繁，通常是最近安装的
-                return L"20240101"; // 2024年1月1日
-            } else {
-                return L"20230101"; // 2023年1月1日
-            }
-        } else if (name.find(L"adobe") != String::npos) {
-            // Adobe程序通常是专业软件，安装时间相对稳定
-            return L"20230101"; // 2023年1月1日
-        } else if (name.find(L"游戏") != String::npos || name.find(L"game") != String::npos) {
-            // 游戏程序通常是最近安装的
-            return L"20240101"; // 2024年1月1日
-        } else if (name.find(L"开发") != String::npos || name.find(L"development") != String::npos) {
-            // 开发工具通常是最近安装的
-            return L"20240101"; // 2024年1月1日
-        } else if (name.find(L"安全") != String::npos || name.find(L"security") != String::npos || 
-                   name.find(L"杀毒") != String::npos || name.find(L"antivirus") != String::npos) {
-            // 安全软件通常是系统基础软件，安装时间较早
-            return L"20220101"; // 2022年1月1日
-        } else {
-            // 默认估算：基于版本信息
-            if (!version.empty()) {
-                // 尝试从版本号中提取年份信息
-                if (version.find(L"2024") != String::npos) {
-                    return L"20240101";
-                } else if (version.find(L"2023") != String::npos) {
-                    return L"20230101";
-                } else if (version.find(L"2022") != String::npos) {
-                    return L"20220101";
-                } else if (version.find(L"2021") != String::npos) {
-                    return L"20210101";
-                }
-            }
-            // 默认估算为2023年
-            return L"20230101";
-        }
+        pending.erase(pending.begin(), pending.begin() + offset);
     }
     
     String ProgramDetector::ExtractPublisherFromPath(const String& path) {
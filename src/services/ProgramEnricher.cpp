@@ -0,0 +1,438 @@
+/**
+ * @file ProgramEnricher.cpp
+ * @brief 程序信息后台补全实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramEnricher.h"
+#include "core/Logger.h"
+#include "utils/DirectorySizeEngine.h"
+#include "utils/StringUtils.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_maxEnrichThreads = 4;
+        
+        String FormatFileDate(const FILETIME& fileTime) {
+            SYSTEMTIME st;
+            if (!FileTimeToSystemTime(&fileTime, &st)) {
+                return L"";
+            }
+            
+            wchar_t dateStr[16];
+            swprintf(dateStr, sizeof(dateStr)/sizeof(wchar_t), L"%04d%02d%02d", st.wYear, st.wMonth, st.wDay);
+            return String(dateStr);
+        }
+    
+    } // namespace
+    
+    /**
+     * @brief 一次Submit对应的批次
+     */
+    struct ProgramEnricher::Batch {
+        std::uint64_t generation;                           ///< 提交时的批次代数
+        std::vector<ProgramInfo> programs;                  ///< 待补全的程序
+        std::vector<ProgramEnrichmentUpdate> updates;       ///< 与programs一一对应的结果
+        std::atomic<size_t> remaining;                      ///< 未完成数量
+        UpdateCallback updateCallback;                      ///< 单个程序回调
+        CompletedCallback completedCallback;                ///< 整批完成回调
+        
+        Batch() : generation(0), remaining(0) {}
+    };
+    
+    void ProgramEnrichmentUpdate::ApplyTo(ProgramInfo& programInfo) const {
+        if (fields & EnrichedSize) {
+            programInfo.estimatedSize = estimatedSize;
+        }
+        if (fields & EnrichedInstallDate) {
+            programInfo.installDate = installDate;
+        }
+        if (fields & EnrichedVersion) {
+            programInfo.version = version;
+        }
+    }
+    
+    ProgramEnricher::ProgramEnricher(size_t threadCount) : m_generation(0) {
+        if (threadCount == 0) {
+            threadCount = (std::min)(ThreadPool::DefaultThreadCount(), s_maxEnrichThreads);
+        }
+        m_pool = YG::MakeUnique<ThreadPool>(threadCount);
+    }
+    
+    ProgramEnricher::~ProgramEnricher() {
+        Cancel();
+        
+        // 线程池析构时会把剩余任务执行完，被取消的任务会立即返回
+        m_pool.reset();
+    }
+    
+    bool ProgramEnricher::NeedsEnrichment(const ProgramInfo& programInfo) {
+        return !programInfo.registryKey.empty() &&
+               (programInfo.estimatedSize == 0 || programInfo.installDate.empty() ||
+                (programInfo.version.empty() && !programInfo.uninstallString.empty()));
+    }
+    
+    String ProgramEnricher::GetProgramKey(const ProgramInfo& programInfo) {
+        return programInfo.registryKey;
+    }
+    
+    size_t ProgramEnricher::Submit(const std::vector<ProgramInfo>& programs,
+                                   const UpdateCallback& updateCallback,
+                                   const CompletedCallback& completedCallback) {
+        auto batch = std::make_shared<Batch>();
+        for (const auto& program : programs) {
+            // 缺少的字段都已确认无法补全（安装目录为空或不存在、卸载程序没有版本资源）的程序不再排队
+            if (NeedsEnrichment(program) &&
+                ((program.estimatedSize == 0 && !IsKnownSizeMiss(program)) || program.installDate.empty() ||
+                 (program.version.empty() && !IsKnownVersionMiss(program)))) {
+                batch->programs.push_back(program);
+            }
+        }
+        
+        batch->updates.resize(batch->programs.size());
+        batch->remaining = batch->programs.size();
+        batch->updateCallback = updateCallback;
+        batch->completedCallback = completedCallback;
+        
+        {
+            std::lock_guard<std::mutex> lock(m_batchMutex);
+            batch->generation = ++m_generation;
+            m_currentBatch = batch->programs.empty() ? nullptr : batch;
+        }
+        
+        if (batch->programs.empty()) {
+            if (completedCallback) {
+                completedCallback(batch->updates);
+            }
+            return 0;
+        }
+        
+        for (size_t i = 0; i < batch->programs.size(); ++i) {
+            m_pool->Submit([this, batch, i]() { ProcessProgram(batch, i); });
+        }
+        
+        YG_LOG_INFO(L"已提交程序信息补全，数量: " + std::to_wstring(batch->programs.size()) +
+                   L"/" + std::to_wstring(programs.size()));
+        return batch->programs.size();
+    }
+    
+    void ProgramEnricher::Cancel() {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        ++m_generation;
+        m_currentBatch.reset();
+    }
+    
+    size_t ProgramEnricher::GetPendingCount() const {
+        std::lock_guard<std::mutex> lock(m_batchMutex);
+        return m_currentBatch ? m_currentBatch->remaining.load() : 0;
+    }
+    
+    void ProgramEnricher::ClearCache() {
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_pathCache.clear();
+            m_versionCache.clear();
+            m_sizeMisses.clear();
+        }
+        DirectorySizeEngine::GetShared().ClearCache();
+    }
+    
+    void ProgramEnricher::ProcessProgram(const std::shared_ptr<Batch>& batch, size_t index) {
+        if (batch->generation != m_generation.load()) {
+            return;
+        }
+        
+        const ProgramInfo& program = batch->programs[index];
+        ProgramEnrichmentUpdate& update = batch->updates[index];
+        update.programKey = GetProgramKey(program);
+        update.registryWriteTime = program.registryWriteTime;
+        
+        try {
+            if (program.estimatedSize == 0) {
+                update.estimatedSize = ResolveSize(program);
+                if (update.estimatedSize > 0) {
+                    update.fields |= EnrichedSize;
+                }
+            }
+            
+            if (program.installDate.empty()) {
+                update.installDate = ResolveInstallDate(program);
+                if (!update.installDate.empty()) {
+                    update.fields |= EnrichedInstallDate;
+                }
+            }
+            
+            if (program.version.empty()) {
+                update.version = ResolveVersion(program);
+                if (!update.version.empty()) {
+                    update.fields |= EnrichedVersion;
+                }
+            }
+        } catch (...) {
+            YG_LOG_ERROR(L"补全程序信息时发生异常: " + program.name);
+        }
+        
+        if (batch->generation != m_generation.load()) {
+            return;
+        }
+        
+        if (update.fields != EnrichedNone && batch->updateCallback) {
+            batch->updateCallback(update);
+        }
+        
+        // 最后一个完成的任务负责整批回调
+        if (--batch->remaining == 0 && batch->generation == m_generation.load()) {
+            if (batch->completedCallback) {
+                batch->completedCallback(batch->updates);
+            }
+        }
+    }
+    
+    DWORD64 ProgramEnricher::ResolveSize(const ProgramInfo& programInfo) {
+        // 只统计安装目录的实际大小；没有安装目录或目录为空时大小保持未知，不再按文件大小或名称估算
+        if (programInfo.installLocation.empty()) {
+            return 0;
+        }
+        
+        DWORD64 directorySize = DirectorySizeEngine::GetShared().GetSize(programInfo.installLocation);
+        if (directorySize == 0) {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            m_sizeMisses.insert(StringUtils::ToLower(programInfo.installLocation));
+        }
+        return directorySize;
+    }
+    
+    bool ProgramEnricher::IsKnownSizeMiss(const ProgramInfo& programInfo) {
+        if (programInfo.installLocation.empty()) {
+            return true;
+        }
+        
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_sizeMisses.count(StringUtils::ToLower(programInfo.installLocation)) > 0;
+    }
+    
+    String ProgramEnricher::ResolveInstallDate(const ProgramInfo& programInfo) {
+        // 方法1: 卸载程序的创建时间
+        if (!programInfo.uninstallString.empty()) {
+            PathFacts facts = GetPathFacts(ExtractExecutablePath(programInfo.uninstallString));
+            if (!facts.creationDate.empty()) {
+                return facts.creationDate;
+            }
+        }
+        
+        // 方法2: 安装目录的创建时间
+        if (!programInfo.installLocation.empty()) {
+            PathFacts facts = GetPathFacts(programInfo.installLocation);
+            if (!facts.creationDate.empty()) {
+                return facts.creationDate;
+            }
+        }
+        
+        // 方法3: 注册表键本身的最后写入时间（扫描时已读取）
+        if (programInfo.registryWriteTime != 0) {
+            FILETIME writeTime;
+            writeTime.dwLowDateTime = static_cast<DWORD>(programInfo.registryWriteTime & 0xFFFFFFFF);
+            writeTime.dwHighDateTime = static_cast<DWORD>(programInfo.registryWriteTime >> 32);
+            String date = FormatFileDate(writeTime);
+            if (!date.empty()) {
+                return date;
+            }
+        }
+        
+        // 方法4: 图标文件的创建时间
+        if (!programInfo.iconPath.empty()) {
+            PathFacts facts = GetPathFacts(ExtractExecutablePath(programInfo.iconPath));
+            if (!facts.creationDate.empty()) {
+                return facts.creationDate;
+            }
+        }
+        
+        // 方法5: 基于程序名称和版本的经验估算
+        return EstimateInstallDateByName(programInfo);
+    }
+    
+    String ProgramEnricher::ResolveVersion(const ProgramInfo& programInfo) {
+        // 只读取带目录的卸载程序："MsiExec.exe /X{...}"按搜索路径会读到系统msiexec的版本
+        String executablePath = ExtractExecutablePath(programInfo.uninstallString);
+        if (executablePath.find(L'\\') == String::npos) {
+            return L"";
+        }
+        
+        String cacheKey = StringUtils::ToLower(executablePath);
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            auto it = m_versionCache.find(cacheKey);
+            if (it != m_versionCache.end()) {
+                return it->second;
+            }
+        }
+        
+        String version = ReadFileVersion(executablePath);
+        
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_versionCache[cacheKey] = version;
+        return version;
+    }
+    
+    bool ProgramEnricher::IsKnownVersionMiss(const ProgramInfo& programInfo) {
+        String executablePath = ExtractExecutablePath(programInfo.uninstallString);
+        if (executablePath.find(L'\\') == String::npos) {
+            return true;
+        }
+        
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        auto it = m_versionCache.find(StringUtils::ToLower(executablePath));
+        return it != m_versionCache.end() && it->second.empty();
+    }
+    
+    String ProgramEnricher::ReadFileVersion(const String& filePath) {
+        DWORD handle = 0;
+        DWORD size = ::GetFileVersionInfoSizeW(filePath.c_str(), &handle);
+        if (size == 0) {
+            return L"";
+        }
+        
+        std::vector<BYTE> versionData(size);
+        if (!::GetFileVersionInfoW(filePath.c_str(), handle, size, versionData.data())) {
+            return L"";
+        }
+        
+        VS_FIXEDFILEINFO* fileInfo = nullptr;
+        UINT fileInfoSize = 0;
+        if (!VerQueryValueW(versionData.data(), L"\\", reinterpret_cast<LPVOID*>(&fileInfo), &fileInfoSize) ||
+            !fileInfo || fileInfoSize < sizeof(VS_FIXEDFILEINFO)) {
+            return L"";
+        }
+        
+        wchar_t versionStr[64];
+        swprintf(versionStr, sizeof(versionStr)/sizeof(wchar_t), L"%u.%u.%u.%u",
+                 static_cast<unsigned>(HIWORD(fileInfo->dwFileVersionMS)),
+                 static_cast<unsigned>(LOWORD(fileInfo->dwFileVersionMS)),
+                 static_cast<unsigned>(HIWORD(fileInfo->dwFileVersionLS)),
+                 static_cast<unsigned>(LOWORD(fileInfo->dwFileVersionLS)));
+        return String(versionStr);
+    }
+    
+    ProgramEnricher::PathFacts ProgramEnricher::GetPathFacts(const String& path) {
+        PathFacts facts;
+        if (path.empty()) {
+            return facts;
+        }
+        
+        String key = StringUtils::ToLower(path);
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            auto it = m_pathCache.find(key);
+            if (it != m_pathCache.end()) {
+                return it->second;
+            }
+        }
+        
+        // 在锁外访问文件系统，并发查询同一路径时最多重复一次
+        WIN32_FIND_DATAW findData;
+        HANDLE hFind = FindFirstFileW(path.c_str(), &findData);
+        if (hFind != INVALID_HANDLE_VALUE) {
+            facts.exists = true;
+            if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                LARGE_INTEGER fileSize;
+                fileSize.LowPart = findData.nFileSizeLow;
+                fileSize.HighPart = findData.nFileSizeHigh;
+                facts.fileSize = static_cast<DWORD64>(fileSize.QuadPart);
+            }
+            facts.creationDate = FormatFileDate(findData.ftCreationTime);
+            FindClose(hFind);
+        }
+        
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_pathCache[key] = facts;
+        return facts;
+    }
+    
+    String ProgramEnricher::ExtractExecutablePath(const String& command) {
+        String executablePath = command;
+        
+        // 卸载字符串截取到.exe为止，图标路径去掉",索引"
+        size_t exePos = StringUtils::ToLower(executablePath).find(L".exe");
+        if (exePos != String::npos) {
+            executablePath = executablePath.substr(0, exePos + 4);
+        } else {
+            size_t commaPos = executablePath.find(L',');
+            if (commaPos != String::npos) {
+                executablePath = executablePath.substr(0, commaPos);
+            }
+        }
+        
+        // 去掉引号
+        if (!executablePath.empty() && executablePath.front() == L'"') executablePath.erase(0, 1);
+        if (!executablePath.empty() && executablePath.back() == L'"') executablePath.pop_back();
+        
+        return executablePath;
+    }
+    
+    String ProgramEnricher::EstimateInstallDateByName(const ProgramInfo& programInfo) {
+        String name = !programInfo.displayName.empty() ? programInfo.displayName : programInfo.name;
+        String version = programInfo.version;
+        
+        // 转换为小写进行比较
+        std::transform(name.begin(), name.end(), name.begin(), ::towlower);
+        
+        // 基于程序名称的常见模式进行估算
+        if (name.find(L"microsoft") != String::npos) {
+            if (name.find(L"office") != String::npos) {
+                // Office通常是最近几年安装的
+                return L"20240101"; // 2024年1月1日
+            } else if (name.find(L"visual studio") != String::npos) {
+                // Visual Studio通常是开发工具，安装时间相对较新
+                return L"20240101"; // 2024年1月1日
+            } else if (name.find(L".net") != String::npos) {
+                // .NET Framework通常是系统组件，安装时间较早
+                return L"20220101"; // 2022年1月1日
+            } else {
+                return L"20230101"; // 2023年1月1日
+            }
+        } else if (name.find(L"google") != String::npos) {
+            if (name.find(L"chrome") != String::npos) {
+                // Chrome浏览器更新频繁，通常是最近安装的
+                return L"20240101"; // 2024年1月1日
+            } else {
+                return L"20230101"; // 2023年1月1日
+            }
+        } else if (name.find(L"adobe") != String::npos) {
+            // Adobe程序通常是专业软件，安装时间相对稳定
+            return L"20230101"; // 2023年1月1日
+        } else if (name.find(L"游戏") != String::npos || name.find(L"game") != String::npos) {
+            // 游戏程序通常是最近安装的
+            return L"20240101"; // 2024年1月1日
+        } else if (name.find(L"开发") != String::npos || name.find(L"development") != String::npos) {
+            // 开发工具通常是最近安装的
+            return L"20240101"; // 2024年1月1日
+        } else if (name.find(L"安全") != String::npos || name.find(L"security") != String::npos ||
+                   name.find(L"杀毒") != String::npos || name.find(L"antivirus") != String::npos) {
+            // 安全软件通常是系统基础软件，安装时间较早
+            return L"20220101"; // 2022年1月1日
+        } else {
+            // 默认估算：基于版本信息
+            if (!version.empty()) {
+                // 尝试从版本号中提取年份信息
+                if (version.find(L"2024") != String::npos) {
+                    return L"20240101";
+                } else if (version.find(L"2023") != String::npos) {
+                    return L"20230101";
+                } else if (version.find(L"2022") != String::npos) {
+                    return L"20220101";
+                } else if (version.find(L"2021") != String::npos) {
+                    return L"20210101";
+                }
+            }
+            // 默认估算为2023年
+            return L"20230101";
+        }
+    }
+
+} // namespace YG
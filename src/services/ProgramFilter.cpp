@@ -0,0 +1,239 @@
+/**
+ * @file ProgramFilter.cpp
+ * @brief 在程序表上执行结构化查询的实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramFilter.h"
+#include "services/ProgramSorter.h"
+#include <algorithm>
+#include <limits>
+
+namespace YG {
+    
+    namespace {
+        
+        // 起始区间不超过行数的该比例时直接排序行号，否则按位图顺序扫描
+        const size_t s_sortedSeedDivisor = 16;
+        
+    } // namespace
+    
+    ProgramFilter::ProgramFilter() : m_table(ProgramTable::Empty()) {
+    }
+    
+    ProgramFilter::~ProgramFilter() {
+    }
+    
+    void ProgramFilter::SetTable(const ProgramTablePtr& table, const ProgramSearchIndexPtr& index, bool textChanged) {
+        m_table = table ? table : ProgramTable::Empty();
+        m_index = index;
+        
+        m_columns[SizeColumn].valid = false;
+        m_columns[InstallDateColumn].valid = false;
+        if (textChanged) {
+            m_columns[VersionColumn].valid = false;
+        }
+    }
+    
+    const ProgramFilter::SortedColumn& ProgramFilter::GetColumn(NumericColumn column) {
+        SortedColumn& data = m_columns[column];
+        if (data.valid) {
+            return data;
+        }
+        
+        const ProgramTable& table = *m_table;
+        const std::uint32_t rowCount = m_index ? static_cast<std::uint32_t>(m_index->GetRowCount()) : 0;
+        data.values.assign(rowCount, 0);
+        data.sorted.resize(rowCount);
+        for (std::uint32_t row = 0; row < rowCount; ++row) {
+            ProgramId id = m_index->GetId(row);
+            std::uint64_t value = 0;
+            switch (column) {
+                case SizeColumn:
+                    value = table.GetEstimatedSize(id);
+                    break;
+                case InstallDateColumn:
+                    value = ProgramSorter::PackDate(table.GetInstallDate(id));
+                    break;
+                default:
+                    value = ProgramSorter::PackVersion(table.GetVersion(id));
+                    break;
+            }
+            data.values[row] = value;
+            data.sorted[row] = { value, row };
+        }
+        std::sort(data.sorted.begin(), data.sorted.end());
+        
+        data.valid = true;
+        return data;
+    }
+    
+    std::pair<size_t, size_t> ProgramFilter::FindRange(const SortedColumn& column, std::uint64_t low, std::uint64_t high) {
+        if (low > high) {
+            return { 0, 0 };
+        }
+        auto first = std::lower_bound(column.sorted.begin(), column.sorted.end(),
+                                      std::make_pair(low, static_cast<std::uint32_t>(0)));
+        auto last = std::upper_bound(first, column.sorted.end(),
+                                     std::make_pair(high, (std::numeric_limits<std::uint32_t>::max)()));
+        return { static_cast<size_t>(first - column.sorted.begin()), static_cast<size_t>(last - column.sorted.begin()) };
+    }
+    
+    ProgramFilter::NumericColumn ProgramFilter::ToNumericColumn(ProgramQueryField field) {
+        switch (field) {
+            case QueryFieldSize:
+                return SizeColumn;
+            case QueryFieldInstallDate:
+                return InstallDateColumn;
+            default:
+                return VersionColumn;
+        }
+    }
+    
+    unsigned ProgramFilter::ToSearchFields(ProgramQueryField field) {
+        switch (field) {
+            case QueryFieldName:
+                return SearchFieldTitle;
+            case QueryFieldPublisher:
+                return SearchFieldPublisher;
+            case QueryFieldVersion:
+                return SearchFieldVersion;
+            default:
+                return SearchFieldAll;
+        }
+    }
+    
+    bool ProgramFilter::Matches(const ProgramQueryClause& clause, std::uint32_t row) const {
+        switch (clause.op) {
+            case QueryOpRange:
+                {
+                    std::uint64_t value = m_columns[ToNumericColumn(clause.field)].values[row];
+                    return value >= clause.low && value <= clause.high;
+                }
+            case QueryOpEquals:
+                {
+                    unsigned fields = ToSearchFields(clause.field);
+                    return ((fields & SearchFieldTitle) && m_index->GetFoldedTitle(row) == clause.text) ||
+                           ((fields & SearchFieldPublisher) && m_index->GetFoldedPublisher(row) == clause.text) ||
+                           ((fields & SearchFieldVersion) && m_index->GetFoldedVersion(row) == clause.text);
+                }
+            default:
+                return m_index->RowMatches(row, clause.text, ToSearchFields(clause.field));
+        }
+    }
+    
+    ProgramFilterResult ProgramFilter::Execute(const ProgramQuery& query) {
+        ProgramFilterResult result;
+        if (!m_index) {
+            return result;
+        }
+        
+        const std::vector<ProgramQueryClause>& clauses = query.GetClauses();
+        const size_t rowCount = m_index->GetRowCount();
+        
+        // 估计各条件匹配的行数；数值列在此生成，逐行校验时直接读取
+        std::vector<ClausePlan> plans;
+        plans.reserve(clauses.size());
+        for (size_t i = 0; i < clauses.size(); ++i) {
+            const ProgramQueryClause& clause = clauses[i];
+            ClausePlan plan = { i, rowCount, 0, 1.0 };
+            if (clause.op == QueryOpRange) {
+                std::pair<size_t, size_t> range = FindRange(GetColumn(ToNumericColumn(clause.field)), clause.low, clause.high);
+                plan.estimate = range.second - range.first;
+                plan.cost = 1;
+            } else {
+                plan.estimate = m_index->EstimateMatches(clause.text);
+                plan.cost = clause.op == QueryOpEquals ? 2 : 3;
+            }
+            double rate = rowCount > 0 ? static_cast<double>(plan.estimate) / static_cast<double>(rowCount) : 0.0;
+            plan.passRate = clause.negated ? 1.0 - rate : rate;
+            plans.push_back(plan);
+        }
+        
+        // 匹配行数最少的肯定条件作为起始
+        int seed = -1;
+        for (size_t i = 0; i < plans.size(); ++i) {
+            if (!clauses[i].negated && (seed == -1 || plans[i].estimate < plans[seed].estimate)) {
+                seed = static_cast<int>(i);
+            }
+        }
+        
+        std::vector<std::uint32_t> candidates;
+        bool seedExact = false;     // 候选行是否已经满足起始条件
+        if (seed == -1) {
+            candidates.resize(rowCount);
+            for (std::uint32_t row = 0; row < rowCount; ++row) {
+                candidates[row] = row;
+            }
+        } else if (plans[seed].estimate == 0) {
+            result.seedClause = seed;
+            return result;
+        } else if (clauses[seed].op == QueryOpRange) {
+            const ProgramQueryClause& clause = clauses[seed];
+            const SortedColumn& column = m_columns[ToNumericColumn(clause.field)];
+            std::pair<size_t, size_t> range = FindRange(column, clause.low, clause.high);
+            const size_t count = range.second - range.first;
+            if (count * s_sortedSeedDivisor <= rowCount) {
+                candidates.reserve(count);
+                for (size_t i = range.first; i < range.second; ++i) {
+                    candidates.push_back(column.sorted[i].second);
+                }
+                std::sort(candidates.begin(), candidates.end());
+            } else {
+                std::vector<std::uint8_t> marked(rowCount, 0);
+                for (size_t i = range.first; i < range.second; ++i) {
+                    marked[column.sorted[i].second] = 1;
+                }
+                candidates.reserve(count);
+                for (std::uint32_t row = 0; row < rowCount; ++row) {
+                    if (marked[row]) {
+                        candidates.push_back(row);
+                    }
+                }
+            }
+            seedExact = true;
+        } else {
+            // 文本条件通过倒排表求候选；相等条件还需逐行比较
+            const ProgramQueryClause& clause = clauses[seed];
+            candidates = m_index->Search(clause.text, ToSearchFields(clause.field)).rows;
+            seedExact = clause.op == QueryOpContains;
+        }
+        result.seedClause = seed;
+        result.candidateCount = candidates.size();
+        
+        // 其余条件：代价低的先校验，同代价时通过率低的先校验
+        std::vector<ClausePlan> checks;
+        for (size_t i = 0; i < plans.size(); ++i) {
+            if (static_cast<int>(i) != seed || !seedExact) {
+                checks.push_back(plans[i]);
+            }
+        }
+        std::sort(checks.begin(), checks.end(), [](const ClausePlan& a, const ClausePlan& b) {
+            return a.cost != b.cost ? a.cost < b.cost : a.passRate < b.passRate;
+        });
+        
+        if (checks.empty()) {
+            result.rows.swap(candidates);
+            return result;
+        }
+        
+        result.rows.reserve(candidates.size());
+        for (std::uint32_t row : candidates) {
+            bool passed = true;
+            for (const ClausePlan& check : checks) {
+                const ProgramQueryClause& clause = clauses[check.clause];
+                if (Matches(clause, row) == clause.negated) {
+                    passed = false;
+                    break;
+                }
+            }
+            if (passed) {
+                result.rows.push_back(row);
+            }
+        }
+        return result;
+    }
+
+} // namespace YG
@@ -0,0 +1,826 @@
+/**
+ * @file ProgramIconService.cpp
+ * @brief 程序图标后台解析服务实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramIconService.h"
+#include "services/ProgramSnapshot.h"
+#include "core/Logger.h"
+#include "utils/StringUtils.h"
+#include <shellapi.h>
+#include <algorithm>
+#include <unordered_set>
+#include <cstring>
+#include <cwchar>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_maxIconThreads = 2;              // 提取图标主要耗在读取可执行文件，线程多了无益
+        const size_t s_maxCachedIcons = 4096;           // 磁盘缓存最多保留的图标数
+        const ULONGLONG s_saveIntervalMs = 10000;       // 空闲时写回磁盘缓存的最小间隔
+        const int s_maxIconSize = 256;
+        
+        const std::uint16_t CacheFlagFound = 0x1;
+        
+        // 磁盘缓存文件头（24字节），其后为变长记录：
+        //   uint32 键长度 + UTF-16键 + uint64 写入时间 + uint16 边长 + uint16 标志 + 边长*边长个uint32像素（仅找到图标时）
+        struct IconCacheHeader {
+            std::uint32_t magic;
+            std::uint16_t schemaVersion;
+            std::uint16_t headerSize;
+            std::uint32_t recordCount;
+            std::uint32_t reserved;
+            std::uint64_t checksum;             // 文件头之后全部字节的FNV-1a
+        };
+        static_assert(sizeof(IconCacheHeader) == 24, "IconCacheHeader layout changed");
+        
+        std::uint64_t Fnv1a(const BYTE* data, size_t size) {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= data[i];
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+        
+        template<typename T>
+        void AppendPod(std::vector<BYTE>& buffer, const T& value) {
+            const BYTE* bytes = reinterpret_cast<const BYTE*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+        
+        /**
+         * @brief 顺序读取缓冲区，越界后所有读取均失败
+         */
+        class BufferReader {
+        public:
+            BufferReader(const BYTE* data, size_t size) : m_data(data), m_size(size), m_offset(0) {}
+            
+            template<typename T>
+            bool Read(T& value) {
+                return ReadBytes(&value, sizeof(T));
+            }
+            
+            bool ReadBytes(void* target, size_t size) {
+                if (size > m_size - m_offset) {
+                    return false;
+                }
+                std::memcpy(target, m_data + m_offset, size);
+                m_offset += size;
+                return true;
+            }
+        
+        private:
+            const BYTE* m_data;
+            size_t m_size;
+            size_t m_offset;
+        };
+        
+        // 取得文件的最后写入时间，文件不存在或是目录时返回0
+        DWORD64 GetFileWriteTime(const String& path) {
+            WIN32_FILE_ATTRIBUTE_DATA attributes;
+            if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attributes) ||
+                (attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                return 0;
+            }
+            return (static_cast<DWORD64>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                   attributes.ftLastWriteTime.dwLowDateTime;
+        }
+        
+        String StripQuotes(const String& text) {
+            String result = StringUtils::Trim(text);
+            if (!result.empty() && result.front() == L'"') result.erase(0, 1);
+            if (!result.empty() && result.back() == L'"') result.pop_back();
+            return result;
+        }
+        
+        // 展开环境变量；不带目录的文件名（如"MsiExec.exe"）按系统搜索路径查找
+        String ResolveFilePath(const String& path) {
+            String resolved = path;
+            if (resolved.find(L'%') != String::npos) {
+                wchar_t expanded[MAX_PATH];
+                DWORD length = ExpandEnvironmentStringsW(resolved.c_str(), expanded, MAX_PATH);
+                if (length > 0 && length <= MAX_PATH) {
+                    resolved = expanded;
+                }
+            }
+            
+            if (!resolved.empty() && resolved.find_first_of(L"\\/") == String::npos) {
+                wchar_t found[MAX_PATH];
+                DWORD length = SearchPathW(nullptr, resolved.c_str(), nullptr, MAX_PATH, found, nullptr);
+                if (length > 0 && length < MAX_PATH) {
+                    resolved = found;
+                }
+            }
+            return resolved;
+        }
+        
+        // 来源键：小写路径 + 图标序号
+        String MakeSourceKey(const IconSource& source) {
+            return StringUtils::ToLower(source.path) + L"," + std::to_wstring(source.index);
+        }
+        
+        /**
+         * @brief 屏幕外32位位图（RAII）
+         */
+        class PixelCanvas {
+        public:
+            explicit PixelCanvas(int size) : m_dc(CreateCompatibleDC(nullptr)), m_bitmap(nullptr), m_oldBitmap(nullptr),
+                                             m_bits(nullptr), m_size(size) {
+                BITMAPINFO info = {};
+                info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+                info.bmiHeader.biWidth = size;
+                info.bmiHeader.biHeight = -size;            // 自上而下
+                info.bmiHeader.biPlanes = 1;
+                info.bmiHeader.biBitCount = 32;
+                info.bmiHeader.biCompression = BI_RGB;
+                
+                void* bits = nullptr;
+                m_bitmap = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+                m_bits = static_cast<std::uint32_t*>(bits);
+                if (m_dc && m_bitmap) {
+                    m_oldBitmap = SelectObject(m_dc, m_bitmap);
+                }
+            }
+            
+            ~PixelCanvas() {
+                if (m_oldBitmap) {
+                    SelectObject(m_dc, m_oldBitmap);
+                }
+                if (m_bitmap) {
+                    DeleteObject(m_bitmap);
+                }
+                if (m_dc) {
+                    DeleteDC(m_dc);
+                }
+            }
+            
+            bool IsValid() const { return m_oldBitmap != nullptr && m_bits != nullptr; }
+            
+            // 清空后以指定方式绘制图标，返回像素
+            const std::uint32_t* Draw(HICON icon, UINT flags, std::uint32_t background) {
+                std::fill(m_bits, m_bits + m_size * m_size, background);
+                DrawIconEx(m_dc, 0, 0, icon, m_size, m_size, 0, nullptr, flags);
+                GdiFlush();
+                return m_bits;
+            }
+        
+        private:
+            HDC m_dc;
+            HBITMAP m_bitmap;
+            HGDIOBJ m_oldBitmap;
+            std::uint32_t* m_bits;
+            int m_size;
+            
+            YG_DISABLE_COPY_AND_ASSIGN(PixelCanvas);
+        };
+        
+        // 将图标渲染为非预乘的BGRA像素
+        bool RenderIcon(HICON icon, int size, std::vector<std::uint32_t>& pixels) {
+            PixelCanvas canvas(size);
+            if (!canvas.IsValid()) {
+                return false;
+            }
+            
+            const size_t count = static_cast<size_t>(size) * size;
+            const std::uint32_t* drawn = canvas.Draw(icon, DI_NORMAL, 0);
+            pixels.assign(drawn, drawn + count);
+            
+            bool hasAlpha = std::any_of(pixels.begin(), pixels.end(), [](std::uint32_t pixel) { return (pixel >> 24) != 0; });
+            if (hasAlpha) {
+                // 带透明通道的图标经AlphaBlend绘制到全透明背景上，得到的是预乘结果
+                for (std::uint32_t& pixel : pixels) {
+                    std::uint32_t alpha = pixel >> 24;
+                    if (alpha == 0) {
+                        pixel = 0;
+                    } else if (alpha < 255) {
+                        std::uint32_t blue = (std::min)((pixel & 0xFF) * 255 / alpha, 255u);
+                        std::uint32_t green = (std::min)(((pixel >> 8) & 0xFF) * 255 / alpha, 255u);
+                        std::uint32_t red = (std::min)(((pixel >> 16) & 0xFF) * 255 / alpha, 255u);
+                        pixel = (alpha << 24) | (red << 16) | (green << 8) | blue;
+                    }
+                }
+                return true;
+            }
+            
+            // 没有透明通道的旧式图标：由掩码决定透明度（掩码为黑色处不透明）
+            const std::uint32_t* mask = canvas.Draw(icon, DI_MASK, 0x00FFFFFF);
+            for (size_t i = 0; i < count; ++i) {
+                pixels[i] = (mask[i] & 0x00FFFFFF) == 0 ? (pixels[i] | 0xFF000000) : 0;
+            }
+            return true;
+        }
+        
+        // 由像素创建图标，由调用方销毁
+        HICON CreateIconFromPixels(const std::vector<std::uint32_t>& pixels, int size) {
+            if (pixels.size() != static_cast<size_t>(size) * size) {
+                return nullptr;
+            }
+            
+            BITMAPINFO info = {};
+            info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+            info.bmiHeader.biWidth = size;
+            info.bmiHeader.biHeight = -size;
+            info.bmiHeader.biPlanes = 1;
+            info.bmiHeader.biBitCount = 32;
+            info.bmiHeader.biCompression = BI_RGB;
+            
+            void* bits = nullptr;
+            HBITMAP color = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+            if (!color) {
+                return nullptr;
+            }
+            std::memcpy(bits, pixels.data(), pixels.size() * sizeof(std::uint32_t));
+            
+            // 32位图标以透明通道为准，掩码全部置0即可
+            std::vector<BYTE> maskBits(static_cast<size_t>((size + 15) / 16 * 2) * size, 0);
+            HBITMAP mask = CreateBitmap(size, size, 1, 1, maskBits.data());
+            
+            HICON icon = nullptr;
+            if (mask) {
+                ICONINFO iconInfo = {};
+                iconInfo.fIcon = TRUE;
+                iconInfo.hbmColor = color;
+                iconInfo.hbmMask = mask;
+                icon = CreateIconIndirect(&iconInfo);
+                DeleteObject(mask);
+            }
+            DeleteObject(color);
+            return icon;
+        }
+        
+        // 从文件中提取图标并渲染为像素；文件中没有该图标时返回false
+        bool ExtractIconPixels(const IconSource& source, int size, std::vector<std::uint32_t>& pixels) {
+            HICON largeIcon = nullptr;
+            HICON smallIcon = nullptr;
+            bool wantLarge = size > GetSystemMetrics(SM_CXSMICON);
+            ExtractIconExW(source.path.c_str(), source.index, wantLarge ? &largeIcon : nullptr,
+                           wantLarge ? nullptr : &smallIcon, 1);
+            
+            HICON icon = wantLarge ? largeIcon : smallIcon;
+            if (!icon) {
+                return false;
+            }
+            
+            bool rendered = RenderIcon(icon, size, pixels);
+            DestroyIcon(icon);
+            return rendered;
+        }
+    
+    } // namespace
+    
+    ProgramIconService::ProgramIconService(const String& cachePath, const ReadyCallback& readyCallback, size_t threadCount)
+        : m_cachePath(cachePath), m_readyCallback(readyCallback), m_generation(0), m_imageList(nullptr),
+          m_defaultIndex(0), m_iconSize(16), m_cacheDirty(false), m_activeCount(0), m_lastSaveTick(0),
+          m_cacheLoaded(false) {
+        if (threadCount == 0) {
+            threadCount = (std::min)(ThreadPool::DefaultThreadCount(), s_maxIconThreads);
+        }
+        m_pool = YG::MakeUnique<ThreadPool>(threadCount);
+    }
+    
+    ProgramIconService::~ProgramIconService() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_generation;
+            m_imageList = nullptr;
+            m_queue.clear();
+        }
+        
+        // 线程池析构时执行完剩余任务，队列已清空，这些任务会立即返回
+        m_pool.reset();
+        
+        ErrorContext result = SaveCache();
+        if (result.code != DetailedErrorCode::Success) {
+            YG_LOG_WARNING(L"写回图标缓存失败: " + result.message);
+        }
+    }
+    
+    std::uint64_t ProgramIconService::Reset(HIMAGELIST imageList, int defaultIndex) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+        m_imageList = imageList;
+        m_defaultIndex = defaultIndex;
+        m_queue.clear();
+        m_sourceIndices.clear();
+        m_pending.clear();
+        
+        if (imageList) {
+            int width = 16;
+            int height = 16;
+            if (ImageList_GetIconSize(imageList, &width, &height) && width > 0) {
+                m_iconSize = (std::min)(width, s_maxIconSize);
+            }
+            
+            // 保留默认图标，其余图标随上一代一起丢弃
+            if (ImageList_GetImageCount(imageList) > defaultIndex + 1) {
+                ImageList_SetImageCount(imageList, defaultIndex + 1);
+            }
+        }
+        return m_generation;
+    }
+    
+    std::uint64_t ProgramIconService::GetGeneration() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_generation;
+    }
+    
+    void ProgramIconService::Request(ProgramId id, const ProgramInfo& program) {
+        Job job;
+        job.id = id;
+        job.program.displayName = program.displayName;
+        job.program.iconPath = program.iconPath;
+        job.program.uninstallString = program.uninstallString;
+        job.program.installLocation = program.installLocation;
+        job.nextSource = 0;
+        job.sourcesResolved = false;
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_imageList) {
+            return;
+        }
+        job.generation = m_generation;
+        
+        // 后请求的先处理：列表请求图标的总是当前正在绘制的行
+        m_queue.push_front(std::move(job));
+        ScheduleLocked();
+    }
+    
+    void ProgramIconService::Prioritize(const std::vector<ProgramId>& ids) {
+        if (ids.empty()) {
+            return;
+        }
+        std::unordered_set<ProgramId> visible(ids.begin(), ids.end());
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::stable_partition(m_queue.begin(), m_queue.end(), [&visible](const Job& job) {
+            return visible.count(job.id) != 0;
+        });
+    }
+    
+    void ProgramIconService::ScheduleLocked() {
+        m_pool->Submit([this]() { ProcessNext(); });
+    }
+    
+    void ProgramIconService::ProcessNext() {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.empty()) {
+                return;
+            }
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            ++m_activeCount;
+        }
+        
+        {
+            std::lock_guard<std::mutex> loadLock(m_loadMutex);
+            if (!m_cacheLoaded) {
+                LoadCache();
+                m_cacheLoaded = true;
+            }
+        }
+        
+        ProcessJob(std::move(job));
+        
+        // 队列处理完后择机写回磁盘缓存
+        bool save = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_activeCount;
+            ULONGLONG now = GetTickCount64();
+            if (m_queue.empty() && m_activeCount == 0 && m_cacheDirty && now - m_lastSaveTick >= s_saveIntervalMs) {
+                m_lastSaveTick = now;
+                save = true;
+            }
+        }
+        if (save) {
+            ErrorContext result = SaveCache();
+            if (result.code != DetailedErrorCode::Success) {
+                YG_LOG_WARNING(L"写回图标缓存失败: " + result.message);
+            }
+        }
+    }
+    
+    void ProgramIconService::ProcessJob(Job job) {
+        if (!job.sourcesResolved) {
+            job.sources = GetIconSources(job.program);
+            job.sourcesResolved = true;
+        }
+        
+        while (job.nextSource < job.sources.size()) {
+            const IconSource& source = job.sources[job.nextSource];
+            String sourceKey = MakeSourceKey(source);
+            
+            int knownIndex = -2;        // -2表示本代尚未解析过该来源
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (job.generation != m_generation) {
+                    return;
+                }
+                
+                auto known = m_sourceIndices.find(sourceKey);
+                if (known != m_sourceIndices.end()) {
+                    knownIndex = known->second;
+                } else {
+                    // 其他线程正在提取同一来源：等待其结果
+                    auto pending = m_pending.find(sourceKey);
+                    if (pending != m_pending.end()) {
+                        pending->second.waiters.push_back(std::move(job));
+                        return;
+                    }
+                    m_pending[sourceKey].generation = job.generation;
+                }
+            }
+            
+            if (knownIndex >= 0) {
+                Notify(job.generation, { job.id }, knownIndex);
+                return;
+            }
+            if (knownIndex == -1) {
+                ++job.nextSource;
+                continue;
+            }
+            
+            int imageIndex = ResolveSource(source, sourceKey, job.generation);
+            
+            std::vector<Job> waiters;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto pending = m_pending.find(sourceKey);
+                if (pending != m_pending.end() && pending->second.generation == job.generation) {
+                    waiters = std::move(pending->second.waiters);
+                    m_pending.erase(pending);
+                }
+                if (job.generation != m_generation) {
+                    return;
+                }
+                m_sourceIndices[sourceKey] = imageIndex;
+                
+                // 来源失败时，等待的请求各自继续尝试下一个来源
+                if (imageIndex < 0) {
+                    for (Job& waiter : waiters) {
+                        ++waiter.nextSource;
+                        m_queue.push_front(std::move(waiter));
+                        ScheduleLocked();
+                    }
+                    waiters.clear();
+                }
+            }
+            
+            if (imageIndex >= 0) {
+                std::vector<ProgramId> ids;
+                ids.reserve(waiters.size() + 1);
+                ids.push_back(job.id);
+                for (const Job& waiter : waiters) {
+                    ids.push_back(waiter.id);
+                }
+                Notify(job.generation, ids, imageIndex);
+                return;
+            }
+            ++job.nextSource;
+        }
+        
+        // 所有来源均失败，使用默认图标
+        int defaultIndex;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (job.generation != m_generation) {
+                return;
+            }
+            defaultIndex = m_defaultIndex;
+        }
+        Notify(job.generation, { job.id }, defaultIndex);
+    }
+    
+    int ProgramIconService::ResolveSource(const IconSource& source, const String& sourceKey, std::uint64_t generation) {
+        DWORD64 writeTime = GetFileWriteTime(source.path);
+        if (writeTime == 0) {
+            return -1;
+        }
+        
+        int size;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size = m_iconSize;
+        }
+        String cacheKey = sourceKey + L"@" + std::to_wstring(size);
+        
+        // 文件未变化时使用缓存的位图，否则重新提取
+        std::vector<std::uint32_t> pixels;
+        bool found = false;
+        bool cached = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_iconCache.find(cacheKey);
+            if (it != m_iconCache.end() && it->second.writeTime == writeTime && it->second.size == size) {
+                it->second.touched = true;
+                found = it->second.found;
+                pixels = it->second.pixels;
+                cached = true;
+            }
+        }
+        
+        if (!cached) {
+            found = ExtractIconPixels(source, size, pixels);
+            
+            std::lock_guard<std::mutex> lock(m_mutex);
+            CachedIcon& entry = m_iconCache[cacheKey];
+            entry.writeTime = writeTime;
+            entry.size = size;
+            entry.found = found;
+            entry.touched = true;
+            entry.pixels = found ? pixels : std::vector<std::uint32_t>();
+            m_cacheDirty = true;
+        }
+        
+        if (!found) {
+            return -1;
+        }
+        
+        HICON icon = CreateIconFromPixels(pixels, size);
+        if (!icon) {
+            return -1;
+        }
+        
+        // 图标列表只在持锁时修改，Reset截断列表与此处添加不会交错
+        int imageIndex = -1;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (generation == m_generation && m_imageList && size == m_iconSize) {
+                imageIndex = ImageList_AddIcon(m_imageList, icon);
+            }
+        }
+        DestroyIcon(icon);
+        return imageIndex;
+    }
+    
+    void ProgramIconService::Notify(std::uint64_t generation, const std::vector<ProgramId>& ids, int imageIndex) {
+        if (!m_readyCallback) {
+            return;
+        }
+        
+        ProgramIconUpdate update;
+        update.generation = generation;
+        update.icons.reserve(ids.size());
+        for (ProgramId id : ids) {
+            update.icons.emplace_back(id, imageIndex);
+        }
+        m_readyCallback(update);
+    }
+    
+    std::vector<IconSource> ProgramIconService::GetIconSources(const ProgramInfo& program) {
+        std::vector<IconSource> sources;
+        
+        // 1. 注册表中的DisplayIcon字段
+        IconSource source;
+        if (ParseIconLocation(program.iconPath, source)) {
+            sources.push_back(source);
+        }
+        
+        // 2. 卸载字符串中的可执行文件
+        if (!program.uninstallString.empty()) {
+            size_t exePos = StringUtils::ToLower(program.uninstallString).find(L".exe");
+            if (exePos != String::npos) {
+                String exePath = ResolveFilePath(StripQuotes(program.uninstallString.substr(0, exePos + 4)));
+                if (!exePath.empty()) {
+                    sources.emplace_back(exePath, 0);
+                }
+            }
+        }
+        
+        // 3. 根据程序名称猜测安装目录中的主执行文件
+        if (!program.installLocation.empty()) {
+            static const struct {
+                const wchar_t* keyword;
+                const wchar_t* executable;
+            } s_knownExecutables[] = {
+                { L"Chrome", L"chrome.exe" },
+                { L"Office", L"WINWORD.EXE" },
+                { L"Adobe", L"AcroRd32.exe" },
+                { L"VLC", L"vlc.exe" },
+                { L"7-Zip", L"7zFM.exe" },
+                { L"Code", L"Code.exe" },
+                { L"Notepad", L"notepad++.exe" },
+                { L"WinRAR", L"WinRAR.exe" }
+            };
+            
+            for (const auto& known : s_knownExecutables) {
+                if (program.displayName.find(known.keyword) != String::npos) {
+                    String directory = StripQuotes(program.installLocation);
+                    if (!directory.empty() && directory.back() != L'\\') {
+                        directory += L'\\';
+                    }
+                    sources.emplace_back(directory + known.executable, 0);
+                    break;
+                }
+            }
+        }
+        
+        return sources;
+    }
+    
+    bool ProgramIconService::ParseIconLocation(const String& location, IconSource& source) {
+        String text = StringUtils::Trim(location);
+        String path;
+        int index = 0;
+        
+        // 图标序号在最后一个逗号之后；带引号时只在引号之后查找
+        size_t searchFrom = 0;
+        if (!text.empty() && text.front() == L'"') {
+            size_t closing = text.find(L'"', 1);
+            searchFrom = closing != String::npos ? closing : text.size();
+        }
+        
+        size_t commaPos = text.rfind(L',');
+        if (commaPos != String::npos && commaPos >= searchFrom) {
+            String indexText = StringUtils::Trim(text.substr(commaPos + 1));
+            wchar_t* end = nullptr;
+            long value = std::wcstol(indexText.c_str(), &end, 10);
+            if (!indexText.empty() && end && *end == L'\0') {
+                index = static_cast<int>(value);
+                text = text.substr(0, commaPos);
+            }
+        }
+        
+        path = ResolveFilePath(StripQuotes(text));
+        if (path.empty()) {
+            return false;
+        }
+        
+        source.path = path;
+        source.index = index;
+        return true;
+    }
+    
+    String ProgramIconService::GetDefaultCachePath() {
+        String snapshotPath = ProgramSnapshot::GetDefaultPath();
+        size_t lastSlash = snapshotPath.find_last_of(L"\\/");
+        String directory = lastSlash != String::npos ? snapshotPath.substr(0, lastSlash) : GetApplicationPath();
+        return directory + L"\\icons.cache";
+    }
+    
+    void ProgramIconService::LoadCache() {
+        if (m_cachePath.empty()) {
+            return;
+        }
+        
+        HANDLE hFile = CreateFileW(m_cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        
+        std::vector<BYTE> buffer;
+        LARGE_INTEGER fileSize;
+        bool readOk = false;
+        if (GetFileSizeEx(hFile, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(IconCacheHeader)) &&
+            fileSize.QuadPart < 0x40000000) {
+            buffer.resize(static_cast<size_t>(fileSize.QuadPart));
+            DWORD bytesRead = 0;
+            readOk = ReadFile(hFile, buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, nullptr) &&
+                     bytesRead == buffer.size();
+        }
+        CloseHandle(hFile);
+        
+        IconCacheHeader header = {};
+        if (readOk) {
+            std::memcpy(&header, buffer.data(), sizeof(header));
+        }
+        if (!readOk || header.magic != CacheMagic || header.schemaVersion != CacheSchemaVersion ||
+            header.headerSize != sizeof(IconCacheHeader) ||
+            Fnv1a(buffer.data() + sizeof(header), buffer.size() - sizeof(header)) != header.checksum) {
+            YG_LOG_WARNING(L"图标缓存无效，将重新提取图标: " + m_cachePath);
+            return;
+        }
+        
+        std::unordered_map<String, CachedIcon> loaded;
+        BufferReader reader(buffer.data() + sizeof(header), buffer.size() - sizeof(header));
+        for (std::uint32_t i = 0; i < header.recordCount; ++i) {
+            std::uint32_t keyLength = 0;
+            if (!reader.Read(keyLength) || keyLength > 0x8000) {
+                break;
+            }
+            std::vector<std::uint16_t> units(keyLength);
+            std::uint16_t iconSize = 0;
+            std::uint16_t flags = 0;
+            CachedIcon entry;
+            if (!reader.ReadBytes(units.data(), units.size() * sizeof(std::uint16_t)) ||
+                !reader.Read(entry.writeTime) || !reader.Read(iconSize) || !reader.Read(flags) ||
+                iconSize == 0 || iconSize > s_maxIconSize) {
+                break;
+            }
+            
+            entry.size = iconSize;
+            entry.found = (flags & CacheFlagFound) != 0;
+            entry.touched = false;
+            if (entry.found) {
+                entry.pixels.resize(static_cast<size_t>(iconSize) * iconSize);
+                if (!reader.ReadBytes(entry.pixels.data(), entry.pixels.size() * sizeof(std::uint32_t))) {
+                    break;
+                }
+            }
+            loaded.emplace(String(units.begin(), units.end()), std::move(entry));
+        }
+        
+        // 读取期间已提取的图标比磁盘上的新，保留不覆盖
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& item : loaded) {
+            m_iconCache.emplace(item.first, std::move(item.second));
+        }
+        YG_LOG_INFO(L"图标缓存已读取: " + std::to_wstring(loaded.size()) + L"个图标");
+    }
+    
+    ErrorContext ProgramIconService::SaveCache() {
+        if (m_cachePath.empty()) {
+            return ErrorContext(DetailedErrorCode::Success);
+        }
+        
+        // 本次用到的图标优先，其余的按容量上限保留
+        std::vector<BYTE> buffer;
+        std::uint32_t recordCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_cacheDirty) {
+                return ErrorContext(DetailedErrorCode::Success);
+            }
+            
+            std::vector<const std::pair<const String, CachedIcon>*> entries;
+            entries.reserve(m_iconCache.size());
+            for (const auto& item : m_iconCache) {
+                entries.push_back(&item);
+            }
+            std::stable_partition(entries.begin(), entries.end(), [](const std::pair<const String, CachedIcon>* item) {
+                return item->second.touched;
+            });
+            if (entries.size() > s_maxCachedIcons) {
+                entries.resize(s_maxCachedIcons);
+            }
+            
+            buffer.resize(sizeof(IconCacheHeader));
+            for (const auto* item : entries) {
+                const CachedIcon& entry = item->second;
+                AppendPod(buffer, static_cast<std::uint32_t>(item->first.size()));
+                for (wchar_t ch : item->first) {
+                    AppendPod(buffer, static_cast<std::uint16_t>(ch));
+                }
+                AppendPod(buffer, static_cast<std::uint64_t>(entry.writeTime));
+                AppendPod(buffer, static_cast<std::uint16_t>(entry.size));
+                AppendPod(buffer, static_cast<std::uint16_t>(entry.found ? CacheFlagFound : 0));
+                if (entry.found) {
+                    const BYTE* bytes = reinterpret_cast<const BYTE*>(entry.pixels.data());
+                    buffer.insert(buffer.end(), bytes, bytes + entry.pixels.size() * sizeof(std::uint32_t));
+                }
+                ++recordCount;
+            }
+            m_cacheDirty = false;
+        }
+        
+        IconCacheHeader header = {};
+        header.magic = CacheMagic;
+        header.schemaVersion = CacheSchemaVersion;
+        header.headerSize = static_cast<std::uint16_t>(sizeof(IconCacheHeader));
+        header.recordCount = recordCount;
+        header.checksum = Fnv1a(buffer.data() + sizeof(IconCacheHeader), buffer.size() - sizeof(IconCacheHeader));
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        
+        // 确保目录存在
+        size_t lastSlash = m_cachePath.find_last_of(L"\\/");
+        if (lastSlash != String::npos) {
+            CreateDirectoryW(m_cachePath.substr(0, lastSlash).c_str(), nullptr);
+        }
+        
+        // 写入临时文件后替换，避免留下写了一半的缓存
+        String tempPath = m_cachePath + L".tmp";
+        HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr,
+                                   CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"无法创建图标缓存文件: " + tempPath);
+        }
+        
+        DWORD written = 0;
+        BOOL ok = WriteFile(hFile, buffer.data(), static_cast<DWORD>(buffer.size()), &written, nullptr);
+        CloseHandle(hFile);
+        
+        if (!ok || written != buffer.size()) {
+            DeleteFileW(tempPath.c_str());
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"写入图标缓存文件失败: " + tempPath);
+        }
+        
+        if (!MoveFileExW(tempPath.c_str(), m_cachePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"替换图标缓存文件失败: " + m_cachePath);
+        }
+        
+        YG_LOG_INFO(L"图标缓存已写入: " + std::to_wstring(recordCount) + L"个图标，大小: " +
+                   std::to_wstring(buffer.size()) + L"字节");
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+
+} // namespace YG
@@ -0,0 +1,360 @@
+/**
+ * @file ProgramQuery.cpp
+ * @brief 程序列表的结构化查询实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramQuery.h"
+#include "services/ProgramSearchIndex.h"
+#include "services/ProgramSorter.h"
+#include <cwctype>
+#include <limits>
+
+namespace YG {
+    
+    namespace {
+        
+        enum CompareOp {
+            CompareContains,        // ':'
+            CompareEquals,          // '='
+            CompareLess,            // '<'
+            CompareLessEqual,       // '<='
+            CompareGreater,         // '>'
+            CompareGreaterEqual     // '>='
+        };
+        
+        struct FieldName {
+            const wchar_t* name;
+            ProgramQueryField field;
+        };
+        
+        const FieldName s_fieldNames[] = {
+            { L"name", QueryFieldName },
+            { L"title", QueryFieldName },
+            { L"publisher", QueryFieldPublisher },
+            { L"pub", QueryFieldPublisher },
+            { L"version", QueryFieldVersion },
+            { L"ver", QueryFieldVersion },
+            { L"size", QueryFieldSize },
+            { L"installed", QueryFieldInstallDate },
+            { L"date", QueryFieldInstallDate }
+        };
+        
+        // 数值条件只匹配已知的值（0表示大小、日期或版本未知）
+        const std::uint64_t s_knownValueMin = 1;
+        const std::uint64_t s_valueMax = (std::numeric_limits<std::uint64_t>::max)();
+        
+        // 按空白切分，双引号内的空白不切分（引号保留，由取值时去掉）
+        std::vector<String> Tokenize(const String& text) {
+            std::vector<String> tokens;
+            String current;
+            bool quoted = false;
+            for (wchar_t ch : text) {
+                if (ch == L'"') {
+                    quoted = !quoted;
+                } else if (!quoted && std::iswspace(ch)) {
+                    if (!current.empty()) {
+                        tokens.push_back(current);
+                        current.clear();
+                    }
+                    continue;
+                }
+                current.push_back(ch);
+            }
+            if (!current.empty()) {
+                tokens.push_back(current);
+            }
+            return tokens;
+        }
+        
+        String Unquote(const String& value) {
+            String result;
+            result.reserve(value.size());
+            for (wchar_t ch : value) {
+                if (ch != L'"') {
+                    result.push_back(ch);
+                }
+            }
+            return result;
+        }
+        
+        // 拆分"字段 运算符 值"，字段名未知时返回false
+        bool SplitClause(const String& token, ProgramQueryField& field, CompareOp& op, String& value) {
+            size_t nameLength = 0;
+            while (nameLength < token.size() && std::iswalpha(token[nameLength])) {
+                ++nameLength;
+            }
+            if (nameLength == 0 || nameLength == token.size()) {
+                return false;
+            }
+            
+            String name = ProgramSearchIndex::Fold(token.substr(0, nameLength));
+            bool known = false;
+            for (const FieldName& entry : s_fieldNames) {
+                if (name == entry.name) {
+                    field = entry.field;
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) {
+                return false;
+            }
+            
+            size_t valueStart = nameLength + 1;
+            switch (token[nameLength]) {
+                case L':':
+                    op = CompareContains;
+                    break;
+                case L'=':
+                    op = CompareEquals;
+                    break;
+                case L'<':
+                case L'>':
+                    if (nameLength + 1 < token.size() && token[nameLength + 1] == L'=') {
+                        op = token[nameLength] == L'<' ? CompareLessEqual : CompareGreaterEqual;
+                        ++valueStart;
+                    } else {
+                        op = token[nameLength] == L'<' ? CompareLess : CompareGreater;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+            
+            value = Unquote(token.substr(valueStart));
+            return true;
+        }
+        
+        // 由值本身的区间[low, high]和比较方式得到匹配的区间
+        void ApplyCompare(CompareOp op, std::uint64_t low, std::uint64_t high, ProgramQueryClause& clause) {
+            clause.op = QueryOpRange;
+            switch (op) {
+                case CompareLess:
+                    clause.low = s_knownValueMin;
+                    clause.high = low > 0 ? low - 1 : 0;
+                    break;
+                case CompareLessEqual:
+                    clause.low = s_knownValueMin;
+                    clause.high = high;
+                    break;
+                case CompareGreater:
+                    if (high == s_valueMax) {
+                        // 空区间
+                        clause.low = s_valueMax;
+                        clause.high = 0;
+                    } else {
+                        clause.low = high + 1;
+                        clause.high = s_valueMax;
+                    }
+                    break;
+                case CompareGreaterEqual:
+                    clause.low = low;
+                    clause.high = s_valueMax;
+                    break;
+                default:
+                    clause.low = low;
+                    clause.high = high;
+                    break;
+            }
+            if (clause.low < s_knownValueMin) {
+                clause.low = s_knownValueMin;
+            }
+        }
+        
+        bool HasDigit(const String& text) {
+            for (wchar_t ch : text) {
+                if (std::iswdigit(ch)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    
+    } // namespace
+    
+    ProgramQuery::ProgramQuery() : m_structured(false) {
+    }
+    
+    ErrorContext ProgramQuery::Compile(const String& text, ProgramQuery& query) {
+        ProgramQuery compiled;
+        
+        for (const String& rawToken : Tokenize(text)) {
+            ProgramQueryClause clause;
+            String token = rawToken;
+            if (token.size() > 1 && token[0] == L'-') {
+                clause.negated = true;
+                token.erase(0, 1);
+            }
+            
+            ProgramQueryField field = QueryFieldText;
+            CompareOp op = CompareContains;
+            String value;
+            if (!SplitClause(token, field, op, value)) {
+                // 普通的词（包括未知的字段名）
+                value = Unquote(token);
+                if (value.empty()) {
+                    continue;
+                }
+                clause.field = QueryFieldText;
+                clause.op = QueryOpContains;
+                clause.text = ProgramSearchIndex::Fold(value);
+                compiled.m_structured = compiled.m_structured || clause.negated;
+                compiled.m_clauses.push_back(clause);
+                continue;
+            }
+            
+            compiled.m_structured = true;
+            if (value.empty()) {
+                // 值尚未输入
+                continue;
+            }
+            clause.field = field;
+            
+            switch (field) {
+                case QueryFieldSize:
+                    {
+                        std::uint64_t bytes = 0;
+                        if (!ParseSize(value, bytes)) {
+                            return ErrorContext(DetailedErrorCode::ParameterFormatInvalid, L"无法识别的大小: " + value);
+                        }
+                        ApplyCompare(op, bytes, bytes, clause);
+                    }
+                    break;
+                case QueryFieldInstallDate:
+                    {
+                        std::uint32_t low = 0;
+                        std::uint32_t high = 0;
+                        if (!ParseDateRange(value, low, high)) {
+                            return ErrorContext(DetailedErrorCode::ParameterFormatInvalid, L"无法识别的日期: " + value);
+                        }
+                        ApplyCompare(op, low, high, clause);
+                    }
+                    break;
+                case QueryFieldVersion:
+                    if (op != CompareContains && op != CompareEquals) {
+                        if (!HasDigit(value)) {
+                            return ErrorContext(DetailedErrorCode::ParameterFormatInvalid, L"无法识别的版本: " + value);
+                        }
+                        std::uint64_t packed = ProgramSorter::PackVersion(value);
+                        ApplyCompare(op, packed, packed, clause);
+                        break;
+                    }
+                    // 文本比较，与名称、发布者相同
+                    clause.op = op == CompareEquals ? QueryOpEquals : QueryOpContains;
+                    clause.text = ProgramSearchIndex::Fold(value);
+                    break;
+                default:
+                    if (op != CompareContains && op != CompareEquals) {
+                        return ErrorContext(DetailedErrorCode::ParameterFormatInvalid, L"该字段不支持大小比较: " + token);
+                    }
+                    clause.op = op == CompareEquals ? QueryOpEquals : QueryOpContains;
+                    clause.text = ProgramSearchIndex::Fold(value);
+                    break;
+            }
+            
+            compiled.m_clauses.push_back(clause);
+        }
+        
+        query = std::move(compiled);
+        return ErrorContext();
+    }
+    
+    bool ProgramQuery::ParseSize(const String& text, std::uint64_t& bytes) {
+        size_t pos = 0;
+        std::uint64_t whole = 0;
+        size_t digits = 0;
+        for (; pos < text.size() && std::iswdigit(text[pos]); ++pos, ++digits) {
+            if (whole > (s_valueMax - 9) / 10) {
+                return false;
+            }
+            whole = whole * 10 + static_cast<std::uint64_t>(text[pos] - L'0');
+        }
+        
+        // 小数部分最多保留3位
+        std::uint64_t fraction = 0;
+        std::uint64_t fractionScale = 1;
+        if (pos < text.size() && text[pos] == L'.') {
+            for (++pos; pos < text.size() && std::iswdigit(text[pos]); ++pos, ++digits) {
+                if (fractionScale < 1000) {
+                    fraction = fraction * 10 + static_cast<std::uint64_t>(text[pos] - L'0');
+                    fractionScale *= 10;
+                }
+            }
+        }
+        if (digits == 0) {
+            return false;
+        }
+        
+        String unit = ProgramSearchIndex::Fold(text.substr(pos));
+        std::uint64_t multiplier = 1;
+        if (unit.empty() || unit == L"b") {
+            multiplier = 1;
+        } else if (unit == L"k" || unit == L"kb") {
+            multiplier = 1ull << 10;
+        } else if (unit == L"m" || unit == L"mb") {
+            multiplier = 1ull << 20;
+        } else if (unit == L"g" || unit == L"gb") {
+            multiplier = 1ull << 30;
+        } else if (unit == L"t" || unit == L"tb") {
+            multiplier = 1ull << 40;
+        } else {
+            return false;
+        }
+        
+        if (whole > s_valueMax / multiplier) {
+            return false;
+        }
+        bytes = whole * multiplier + fraction * multiplier / fractionScale;
+        return true;
+    }
+    
+    bool ProgramQuery::ParseDateRange(const String& text, std::uint32_t& low, std::uint32_t& high) {
+        std::vector<std::uint32_t> parts;
+        std::vector<size_t> digitCounts;
+        size_t i = 0;
+        while (i < text.size()) {
+            if (!std::iswdigit(text[i])) {
+                if (text[i] != L'-' && text[i] != L'/' && text[i] != L'.') {
+                    return false;
+                }
+                ++i;
+                continue;
+            }
+            std::uint32_t value = 0;
+            size_t digits = 0;
+            for (; i < text.size() && std::iswdigit(text[i]); ++i, ++digits) {
+                if (digits < 8) {
+                    value = value * 10 + static_cast<std::uint32_t>(text[i] - L'0');
+                }
+            }
+            parts.push_back(value);
+            digitCounts.push_back(digits);
+        }
+        
+        // 完整日期与程序表使用同一解析方式
+        if ((parts.size() == 1 && digitCounts[0] == 8) || parts.size() == 3) {
+            low = high = ProgramSorter::PackDate(text);
+            return low != 0;
+        }
+        
+        if (parts.empty() || digitCounts[0] != 4 || parts[0] < 1000 || parts.size() > 2) {
+            return false;
+        }
+        std::uint32_t year = parts[0] * 10000;
+        if (parts.size() == 1) {
+            low = year + 101;
+            high = year + 1231;
+            return true;
+        }
+        if (parts[1] < 1 || parts[1] > 12) {
+            return false;
+        }
+        low = year + parts[1] * 100 + 1;
+        high = year + parts[1] * 100 + 31;
+        return true;
+    }
+
+} // namespace YG
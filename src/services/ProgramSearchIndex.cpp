@@ -0,0 +1,346 @@
+/**
+ * @file ProgramSearchIndex.cpp
+ * @brief 程序表搜索索引实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramSearchIndex.h"
+#include <algorithm>
+#include <unordered_map>
+#include <cwctype>
+
+namespace YG {
+    
+    namespace {
+        
+        // 候选行少于该数量时直接校验，不再继续求交集
+        const size_t s_directVerifyThreshold = 32;
+        
+        // 索引项的最大长度：每个位置建立1~3个字符的索引项
+        const size_t s_maxGramLength = 3;
+        
+        // 模糊搜索中只匹配到发布者时的扣分，名称匹配排在前面
+        const int s_publisherPenalty = 16;
+        
+        // 将sorted中不在[first, last)里的行去掉（两者都升序）
+        void IntersectRows(std::vector<std::uint32_t>& sorted, const std::uint32_t* first, const std::uint32_t* last) {
+            size_t kept = 0;
+            for (size_t i = 0; i < sorted.size() && first != last; ++i) {
+                first = std::lower_bound(first, last, sorted[i]);
+                if (first != last && *first == sorted[i]) {
+                    sorted[kept++] = sorted[i];
+                }
+            }
+            sorted.resize(kept);
+        }
+    
+    } // namespace
+    
+    ProgramSearchIndex::ProgramSearchIndex() {
+    }
+    
+    String ProgramSearchIndex::Fold(const String& text) {
+        String folded = text;
+        for (wchar_t& ch : folded) {
+            ch = static_cast<wchar_t>(std::towlower(ch));
+        }
+        return folded;
+    }
+    
+    std::uint64_t ProgramSearchIndex::MakeGram(const wchar_t* text, size_t length) {
+        // 每个字符取21位，可容纳全部Unicode码位；不足3个字符的索引项以0补齐，
+        // 字段中不含'\0'，不同长度的索引项不会冲突
+        const std::uint64_t mask = 0x1FFFFF;
+        std::uint64_t gram = 0;
+        for (size_t i = 0; i < s_maxGramLength; ++i) {
+            gram <<= 21;
+            if (i < length) {
+                gram |= static_cast<std::uint64_t>(text[i]) & mask;
+            }
+        }
+        return gram;
+    }
+    
+    ProgramSearchIndexPtr ProgramSearchIndex::Build(const ProgramTable& table) {
+        std::shared_ptr<ProgramSearchIndex> index(new ProgramSearchIndex());
+        index->m_ids = table.GetIds();
+        
+        const size_t rowCount = index->m_ids.size();
+        index->m_fieldOffsets.reserve(rowCount * ColumnCount + 1);
+        index->m_fuzzyMasks.reserve(rowCount);
+        
+        // 第一遍：索引项按首次出现分配编号，记录各行包含的编号（每行内不重复）
+        std::unordered_map<std::uint64_t, std::uint32_t> gramNumbers;
+        std::vector<std::uint64_t> gramsByNumber;
+        std::vector<std::uint32_t> lastRowByNumber;         // 编号最近一次出现的行号+1，用于行内去重
+        std::vector<std::uint32_t> rowGramNumbers;          // 各行的索引项编号依次存放
+        std::vector<size_t> rowGramEnds(rowCount);          // 各行在rowGramNumbers中的结束位置
+        
+        for (std::uint32_t row = 0; row < rowCount; ++row) {
+            ProgramId id = index->m_ids[row];
+            const wchar_t* fields[ColumnCount] = {
+                table.GetTitle(id), table.GetPublisher(id), table.GetVersion(id)
+            };
+            
+            for (const wchar_t* field : fields) {
+                size_t start = index->m_chars.size();
+                index->m_fieldOffsets.push_back(static_cast<std::uint32_t>(start));
+                for (const wchar_t* p = field; *p; ++p) {
+                    index->m_chars.push_back(static_cast<wchar_t>(std::towlower(*p)));
+                }
+                size_t length = index->m_chars.size() - start;
+                index->m_chars.push_back(L'\0');
+                
+                // 模糊匹配的位置类别按原文的大小写判断
+                index->m_charClasses.resize(index->m_chars.size(), FuzzyCharPlain);
+                FuzzyMatcher::ClassifyCharacters(field, length, &index->m_charClasses[start]);
+                
+                // 索引项不跨字段
+                for (size_t i = 0; i < length; ++i) {
+                    for (size_t gramLength = 1; gramLength <= s_maxGramLength && i + gramLength <= length; ++gramLength) {
+                        std::uint64_t gram = MakeGram(&index->m_chars[start + i], gramLength);
+                        auto inserted = gramNumbers.emplace(gram, static_cast<std::uint32_t>(gramsByNumber.size()));
+                        if (inserted.second) {
+                            gramsByNumber.push_back(gram);
+                            lastRowByNumber.push_back(0);
+                        }
+                        std::uint32_t number = inserted.first->second;
+                        if (lastRowByNumber[number] != row + 1) {
+                            lastRowByNumber[number] = row + 1;
+                            rowGramNumbers.push_back(number);
+                        }
+                    }
+                }
+            }
+            rowGramEnds[row] = rowGramNumbers.size();
+            index->m_fuzzyMasks.push_back(FuzzyMatcher::MakeCharMask(index->Field(row, TitleColumn)) |
+                                          FuzzyMatcher::MakeCharMask(index->Field(row, PublisherColumn)));
+        }
+        index->m_fieldOffsets.push_back(static_cast<std::uint32_t>(index->m_chars.size()));
+        index->m_chars.shrink_to_fit();
+        index->m_charClasses.shrink_to_fit();
+        
+        // 索引项按值排序，统计各倒排表长度后计算起始位置
+        std::vector<std::uint32_t> sortedNumbers(gramsByNumber.size());
+        for (std::uint32_t number = 0; number < sortedNumbers.size(); ++number) {
+            sortedNumbers[number] = number;
+        }
+        std::sort(sortedNumbers.begin(), sortedNumbers.end(),
+                  [&gramsByNumber](std::uint32_t a, std::uint32_t b) {
+                      return gramsByNumber[a] < gramsByNumber[b];
+                  });
+        
+        std::vector<std::uint32_t> postingCounts(gramsByNumber.size(), 0);
+        for (std::uint32_t number : rowGramNumbers) {
+            postingCounts[number]++;
+        }
+        
+        std::vector<std::uint32_t> writePositions(gramsByNumber.size());
+        index->m_gramKeys.reserve(sortedNumbers.size());
+        index->m_postingOffsets.reserve(sortedNumbers.size() + 1);
+        std::uint32_t offset = 0;
+        for (std::uint32_t number : sortedNumbers) {
+            index->m_gramKeys.push_back(gramsByNumber[number]);
+            index->m_postingOffsets.push_back(offset);
+            writePositions[number] = offset;
+            offset += postingCounts[number];
+        }
+        index->m_postingOffsets.push_back(offset);
+        
+        // 第二遍：按行号升序写入，每个倒排表内的行号自然有序
+        index->m_postings.resize(rowGramNumbers.size());
+        size_t position = 0;
+        for (std::uint32_t row = 0; row < rowCount; ++row) {
+            for (; position < rowGramEnds[row]; ++position) {
+                index->m_postings[writePositions[rowGramNumbers[position]]++] = row;
+            }
+        }
+        
+        return index;
+    }
+    
+    std::pair<const std::uint32_t*, const std::uint32_t*> ProgramSearchIndex::FindPostings(std::uint64_t gram) const {
+        auto it = std::lower_bound(m_gramKeys.begin(), m_gramKeys.end(), gram);
+        if (it == m_gramKeys.end() || *it != gram) {
+            return { nullptr, nullptr };
+        }
+        size_t keyIndex = static_cast<size_t>(it - m_gramKeys.begin());
+        const std::uint32_t* base = m_postings.data();
+        return { base + m_postingOffsets[keyIndex], base + m_postingOffsets[keyIndex + 1] };
+    }
+    
+    bool ProgramSearchIndex::RowMatches(std::uint32_t row, const String& foldedKeyword, unsigned fields) const {
+        if ((fields & SearchFieldTitle) && Field(row, TitleColumn).find(foldedKeyword) != std::wstring_view::npos) {
+            return true;
+        }
+        if ((fields & SearchFieldPublisher) && Field(row, PublisherColumn).find(foldedKeyword) != std::wstring_view::npos) {
+            return true;
+        }
+        if ((fields & SearchFieldVersion) && Field(row, VersionColumn).find(foldedKeyword) != std::wstring_view::npos) {
+            return true;
+        }
+        return false;
+    }
+    
+    size_t ProgramSearchIndex::EstimateMatches(const String& foldedKeyword) const {
+        const size_t keywordLength = foldedKeyword.size();
+        if (keywordLength == 0) {
+            return m_ids.size();
+        }
+        
+        size_t estimate = m_ids.size();
+        for (size_t i = 0; i == 0 || i + s_maxGramLength <= keywordLength; ++i) {
+            auto postings = FindPostings(MakeGram(&foldedKeyword[i], (std::min)(keywordLength, s_maxGramLength)));
+            estimate = (std::min)(estimate, static_cast<size_t>(postings.second - postings.first));
+            if (estimate == 0) {
+                break;
+            }
+        }
+        return estimate;
+    }
+    
+    ProgramSearchResult ProgramSearchIndex::Search(const String& keyword, unsigned fields,
+                                                   const ProgramSearchResult* previous) const {
+        ProgramSearchResult result;
+        result.foldedKeyword = Fold(keyword);
+        result.fields = fields;
+        
+        const std::uint32_t rowCount = static_cast<std::uint32_t>(m_ids.size());
+        if (result.foldedKeyword.empty()) {
+            result.rows.resize(rowCount);
+            for (std::uint32_t row = 0; row < rowCount; ++row) {
+                result.rows[row] = row;
+            }
+            return result;
+        }
+        
+        // 包含上一次关键词的新关键词，匹配结果一定是上一次结果的子集
+        const bool canNarrow = previous && !previous->foldedKeyword.empty() && previous->fields == fields &&
+                               result.foldedKeyword.find(previous->foldedKeyword) != String::npos;
+        const size_t keywordLength = result.foldedKeyword.size();
+        
+        // 不超过3个字符的关键词本身就是一个索引项；其余按三元组取倒排表
+        std::vector<std::pair<const std::uint32_t*, const std::uint32_t*>> lists;
+        for (size_t i = 0; i == 0 || i + s_maxGramLength <= keywordLength; ++i) {
+            auto postings = FindPostings(MakeGram(&result.foldedKeyword[i], (std::min)(keywordLength, s_maxGramLength)));
+            if (postings.first == postings.second) {
+                // 有索引项从未出现，不可能匹配
+                return result;
+            }
+            lists.push_back(postings);
+        }
+        
+        // 索引项不跨字段，短关键词在全部字段中搜索时倒排表就是结果
+        if (keywordLength <= s_maxGramLength && fields == SearchFieldAll) {
+            result.rows.assign(lists[0].first, lists[0].second);
+            return result;
+        }
+        
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::pair<const std::uint32_t*, const std::uint32_t*>& a,
+                     const std::pair<const std::uint32_t*, const std::uint32_t*>& b) {
+                      return (a.second - a.first) < (b.second - b.first);
+                  });
+        
+        // 从最短的集合开始，上一次的结果更短时以其为起点
+        std::vector<std::uint32_t> candidates;
+        size_t nextList = 0;
+        if (canNarrow && previous->rows.size() <= static_cast<size_t>(lists[0].second - lists[0].first)) {
+            candidates = previous->rows;
+            result.narrowed = true;
+        } else {
+            candidates.assign(lists[0].first, lists[0].second);
+            nextList = 1;
+        }
+        for (; nextList < lists.size() && candidates.size() > s_directVerifyThreshold; ++nextList) {
+            IntersectRows(candidates, lists[nextList].first, lists[nextList].second);
+        }
+        
+        result.candidateCount = candidates.size();
+        result.rows.reserve(candidates.size());
+        for (std::uint32_t row : candidates) {
+            if (RowMatches(row, result.foldedKeyword, fields)) {
+                result.rows.push_back(row);
+            }
+        }
+        
+        return result;
+    }
+    
+    FuzzySearchResult ProgramSearchIndex::FuzzySearch(const String& keyword, size_t maxResults) const {
+        FuzzySearchResult result;
+        FuzzyMatcher matcher(keyword);
+        if (matcher.IsEmpty() || maxResults == 0) {
+            return result;
+        }
+        
+        // 字符掩码预筛：连续数组上的无分支循环，可由编译器向量化
+        const size_t rowCount = m_ids.size();
+        const std::uint64_t patternMask = matcher.GetCharMask();
+        std::vector<std::uint8_t> passed(rowCount);
+        for (size_t row = 0; row < rowCount; ++row) {
+            passed[row] = static_cast<std::uint8_t>((m_fuzzyMasks[row] & patternMask) == patternMask);
+        }
+        
+        for (std::uint32_t row = 0; row < rowCount; ++row) {
+            if (!passed[row]) {
+                continue;
+            }
+            result.candidateCount++;
+            
+            size_t titleSlot = static_cast<size_t>(row) * ColumnCount + TitleColumn;
+            size_t publisherSlot = static_cast<size_t>(row) * ColumnCount + PublisherColumn;
+            int score = matcher.Score(Field(row, TitleColumn), &m_charClasses[m_fieldOffsets[titleSlot]]);
+            int publisherScore = matcher.Score(Field(row, PublisherColumn), &m_charClasses[m_fieldOffsets[publisherSlot]]);
+            if (publisherScore != FuzzyMatcher::NoMatch) {
+                score = (std::max)(score, publisherScore - s_publisherPenalty);
+            }
+            if (score != FuzzyMatcher::NoMatch) {
+                result.matches.push_back({ row, score });
+            }
+        }
+        result.totalMatches = result.matches.size();
+        
+        // 只对前maxResults个结果排序：评分高者在前，同分时名称短者在前，再按原顺序
+        auto better = [this](const FuzzySearchMatch& a, const FuzzySearchMatch& b) {
+            if (a.score != b.score) {
+                return a.score > b.score;
+            }
+            size_t lengthA = Field(a.row, TitleColumn).size();
+            size_t lengthB = Field(b.row, TitleColumn).size();
+            if (lengthA != lengthB) {
+                return lengthA < lengthB;
+            }
+            return a.row < b.row;
+        };
+        size_t keep = (std::min)(maxResults, result.matches.size());
+        std::partial_sort(result.matches.begin(), result.matches.begin() + keep, result.matches.end(), better);
+        result.matches.resize(keep);
+        
+        return result;
+    }
+    
+    std::vector<ProgramId> ProgramSearchIndex::ToIds(const std::vector<std::uint32_t>& rows) const {
+        std::vector<ProgramId> ids;
+        ids.reserve(rows.size());
+        for (std::uint32_t row : rows) {
+            ids.push_back(m_ids[row]);
+        }
+        return ids;
+    }
+    
+    size_t ProgramSearchIndex::GetMemoryUsage() const {
+        return sizeof(*this) +
+               m_ids.capacity() * sizeof(ProgramId) +
+               m_chars.capacity() * sizeof(wchar_t) +
+               m_charClasses.capacity() * sizeof(std::uint8_t) +
+               m_fuzzyMasks.capacity() * sizeof(std::uint64_t) +
+               m_fieldOffsets.capacity() * sizeof(std::uint32_t) +
+               m_gramKeys.capacity() * sizeof(std::uint64_t) +
+               m_postingOffsets.capacity() * sizeof(std::uint32_t) +
+               m_postings.capacity() * sizeof(std::uint32_t);
+    }
+
+} // namespace YG
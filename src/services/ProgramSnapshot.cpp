@@ -0,0 +1,375 @@
+/**
+ * @file ProgramSnapshot.cpp
+ * @brief 程序清单磁盘快照实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramSnapshot.h"
+#include "core/Logger.h"
+#include <windows.h>
+#include <shlobj.h>
+#include <unordered_map>
+#include <cstring>
+
+namespace YG {
+    
+    namespace {
+        
+        // 文件头（72字节）
+        struct SnapshotHeader {
+            std::uint32_t magic;
+            std::uint16_t schemaVersion;
+            std::uint16_t headerSize;
+            std::uint32_t flags;                // 位0：包含系统组件
+            std::uint32_t recordCount;
+            std::uint32_t recordSize;
+            std::uint32_t stringCount;
+            std::uint64_t stringTableOffset;
+            std::uint64_t stringTableSize;
+            std::uint64_t recordsOffset;
+            std::uint64_t createdTime;          // FILETIME
+            std::uint32_t scanDuration;
+            std::uint32_t reserved;
+            std::uint64_t checksum;             // 文件头之后全部字节的FNV-1a
+        };
+        static_assert(sizeof(SnapshotHeader) == 72, "SnapshotHeader layout changed");
+        
+        // ProgramInfo中的字符串字段，顺序即记录中的存放顺序
+        enum SnapshotField {
+            FieldName,
+            FieldDisplayName,
+            FieldVersion,
+            FieldPublisher,
+            FieldInstallDate,
+            FieldInstallLocation,
+            FieldUninstallString,
+            FieldIconPath,
+            FieldRegistryKey,
+            FieldCount
+        };
+        
+        // 定长程序记录（56字节）
+        struct SnapshotRecord {
+            std::uint32_t strings[FieldCount];  // 字符串表内的字节偏移
+            std::uint32_t flags;                // 位0：系统组件
+            std::uint64_t estimatedSize;
+            std::uint64_t registryWriteTime;
+        };
+        static_assert(sizeof(SnapshotRecord) == 56, "SnapshotRecord layout changed");
+        
+        const std::uint32_t HeaderFlagSystemComponents = 0x1;
+        const std::uint32_t RecordFlagSystemComponent = 0x1;
+        
+        template<typename Info>
+        auto FieldOf(Info& info, int field) -> decltype(&info.name) {
+            switch (field) {
+                case FieldName:             return &info.name;
+                case FieldDisplayName:      return &info.displayName;
+                case FieldVersion:          return &info.version;
+                case FieldPublisher:        return &info.publisher;
+                case FieldInstallDate:      return &info.installDate;
+                case FieldInstallLocation:  return &info.installLocation;
+                case FieldUninstallString:  return &info.uninstallString;
+                case FieldIconPath:         return &info.iconPath;
+                case FieldRegistryKey:      return &info.registryKey;
+                default:                    return nullptr;
+            }
+        }
+        
+        std::uint64_t Fnv1a(const BYTE* data, size_t size) {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= data[i];
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+        
+        template<typename T>
+        void AppendPod(std::vector<BYTE>& buffer, const T& value) {
+            const BYTE* bytes = reinterpret_cast<const BYTE*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+        
+        void AlignTo(std::vector<BYTE>& buffer, size_t alignment) {
+            while (buffer.size() % alignment != 0) {
+                buffer.push_back(0);
+            }
+        }
+        
+        /**
+         * @brief 字符串表构建器（相同字符串只存一份）
+         */
+        class StringTableBuilder {
+        public:
+            std::uint32_t Intern(const String& value) {
+                auto it = m_offsets.find(value);
+                if (it != m_offsets.end()) {
+                    return it->second;
+                }
+                
+                std::uint32_t offset = static_cast<std::uint32_t>(m_data.size());
+                AppendPod(m_data, static_cast<std::uint32_t>(value.size()));
+                for (wchar_t ch : value) {
+                    AppendPod(m_data, static_cast<std::uint16_t>(ch));
+                }
+                AlignTo(m_data, 4);
+                
+                m_offsets.emplace(value, offset);
+                return offset;
+            }
+            
+            const std::vector<BYTE>& Data() const { return m_data; }
+            size_t Count() const { return m_offsets.size(); }
+        
+        private:
+            std::vector<BYTE> m_data;
+            std::unordered_map<String, std::uint32_t> m_offsets;
+        };
+        
+        /**
+         * @brief 只读文件映射（RAII）
+         */
+        class MappedFile {
+        public:
+            MappedFile() : m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_view(nullptr), m_size(0) {}
+            
+            ~MappedFile() {
+                if (m_view) {
+                    UnmapViewOfFile(m_view);
+                }
+                if (m_mapping) {
+                    CloseHandle(m_mapping);
+                }
+                if (m_file != INVALID_HANDLE_VALUE) {
+                    CloseHandle(m_file);
+                }
+            }
+            
+            bool Open(const String& filePath) {
+                m_file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                     OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE) {
+                    return false;
+                }
+                
+                LARGE_INTEGER fileSize;
+                if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart <= 0) {
+                    return false;
+                }
+                m_size = static_cast<size_t>(fileSize.QuadPart);
+                
+                m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!m_mapping) {
+                    return false;
+                }
+                
+                m_view = static_cast<const BYTE*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                return m_view != nullptr;
+            }
+            
+            const BYTE* Data() const { return m_view; }
+            size_t Size() const { return m_size; }
+        
+        private:
+            HANDLE m_file;
+            HANDLE m_mapping;
+            const BYTE* m_view;
+            size_t m_size;
+            
+            YG_DISABLE_COPY_AND_ASSIGN(MappedFile);
+        };
+        
+        bool ReadTableString(const BYTE* table, std::uint64_t tableSize, std::uint32_t offset, String& value) {
+            if (offset % 4 != 0 || static_cast<std::uint64_t>(offset) + sizeof(std::uint32_t) > tableSize) {
+                return false;
+            }
+            
+            std::uint32_t length;
+            std::memcpy(&length, table + offset, sizeof(length));
+            
+            std::uint64_t begin = static_cast<std::uint64_t>(offset) + sizeof(std::uint32_t);
+            if (begin + static_cast<std::uint64_t>(length) * sizeof(std::uint16_t) > tableSize) {
+                return false;
+            }
+            
+            value.resize(length);
+            for (std::uint32_t i = 0; i < length; ++i) {
+                std::uint16_t unit;
+                std::memcpy(&unit, table + begin + i * sizeof(std::uint16_t), sizeof(unit));
+                value[i] = static_cast<wchar_t>(unit);
+            }
+            return true;
+        }
+    
+    } // namespace
+    
+    ErrorContext ProgramSnapshot::Save(const String& filePath, const std::vector<ProgramInfo>& programs,
+                                       bool includeSystemComponents, DWORD scanDuration) {
+        if (filePath.empty()) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::InvalidParameter, L"快照路径为空");
+        }
+        
+        // 先构建字符串表与记录
+        StringTableBuilder strings;
+        std::vector<SnapshotRecord> records;
+        records.reserve(programs.size());
+        
+        for (const auto& program : programs) {
+            SnapshotRecord record = {};
+            for (int field = 0; field < FieldCount; ++field) {
+                record.strings[field] = strings.Intern(*FieldOf(program, field));
+            }
+            record.flags = program.isSystemComponent ? RecordFlagSystemComponent : 0;
+            record.estimatedSize = program.estimatedSize;
+            record.registryWriteTime = program.registryWriteTime;
+            records.push_back(record);
+        }
+        
+        FILETIME now;
+        GetSystemTimeAsFileTime(&now);
+        
+        SnapshotHeader header = {};
+        header.magic = Magic;
+        header.schemaVersion = SchemaVersion;
+        header.headerSize = static_cast<std::uint16_t>(sizeof(SnapshotHeader));
+        header.flags = includeSystemComponents ? HeaderFlagSystemComponents : 0;
+        header.recordCount = static_cast<std::uint32_t>(records.size());
+        header.recordSize = static_cast<std::uint32_t>(sizeof(SnapshotRecord));
+        header.stringCount = static_cast<std::uint32_t>(strings.Count());
+        header.stringTableOffset = sizeof(SnapshotHeader);
+        header.stringTableSize = strings.Data().size();
+        header.createdTime = (static_cast<std::uint64_t>(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+        header.scanDuration = scanDuration;
+        
+        // 组装负载：字符串表 + 对齐填充 + 记录段
+        std::vector<BYTE> buffer;
+        buffer.reserve(sizeof(SnapshotHeader) + strings.Data().size() + records.size() * sizeof(SnapshotRecord) + 8);
+        AppendPod(buffer, header);
+        buffer.insert(buffer.end(), strings.Data().begin(), strings.Data().end());
+        AlignTo(buffer, 8);
+        
+        SnapshotHeader* bufferHeader = reinterpret_cast<SnapshotHeader*>(buffer.data());
+        bufferHeader->recordsOffset = buffer.size();
+        for (const auto& record : records) {
+            AppendPod(buffer, record);
+        }
+        
+        bufferHeader = reinterpret_cast<SnapshotHeader*>(buffer.data());
+        bufferHeader->checksum = Fnv1a(buffer.data() + sizeof(SnapshotHeader), buffer.size() - sizeof(SnapshotHeader));
+        
+        // 确保目录存在
+        size_t lastSlash = filePath.find_last_of(L"\\/");
+        if (lastSlash != String::npos) {
+            CreateDirectoryW(filePath.substr(0, lastSlash).c_str(), nullptr);
+        }
+        
+        // 写入临时文件后替换，避免读取到写了一半的快照
+        String tempPath = filePath + L".tmp";
+        HANDLE hFile = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr,
+                                   CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"无法创建快照文件: " + tempPath);
+        }
+        
+        DWORD written = 0;
+        BOOL ok = WriteFile(hFile, buffer.data(), static_cast<DWORD>(buffer.size()), &written, nullptr);
+        CloseHandle(hFile);
+        
+        if (!ok || written != buffer.size()) {
+            DeleteFileW(tempPath.c_str());
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"写入快照文件失败: " + tempPath);
+        }
+        
+        if (!MoveFileExW(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileWriteError, L"替换快照文件失败: " + filePath);
+        }
+        
+        YG_LOG_INFO(L"程序快照已写入: " + filePath + L"，程序数量: " + std::to_wstring(records.size()) +
+                   L"，字符串: " + std::to_wstring(strings.Count()) + L"，大小: " + std::to_wstring(buffer.size()) + L"字节");
+        
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+    
+    ErrorContext ProgramSnapshot::Load(const String& filePath, ProgramSnapshotData& data) {
+        MappedFile file;
+        if (!file.Open(filePath)) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileNotFound, L"无法映射快照文件: " + filePath);
+        }
+        
+        const BYTE* base = file.Data();
+        const size_t size = file.Size();
+        
+        if (size < sizeof(SnapshotHeader)) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileCorrupted, L"快照文件过短");
+        }
+        
+        SnapshotHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        
+        if (header.magic != Magic || header.headerSize != sizeof(SnapshotHeader)) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileCorrupted, L"快照文件头无效");
+        }
+        
+        if (header.schemaVersion != SchemaVersion) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::ConfigVersionMismatch,
+                                     L"快照结构版本不匹配: " + std::to_wstring(header.schemaVersion));
+        }
+        
+        // 各段范围必须落在文件内
+        if (header.recordSize != sizeof(SnapshotRecord) ||
+            header.stringTableOffset != sizeof(SnapshotHeader) ||
+            header.stringTableOffset + header.stringTableSize > size ||
+            header.recordsOffset < header.stringTableOffset + header.stringTableSize ||
+            header.recordsOffset % 8 != 0 ||
+            header.recordsOffset + static_cast<std::uint64_t>(header.recordCount) * sizeof(SnapshotRecord) != size) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileCorrupted, L"快照文件段长度无效");
+        }
+        
+        if (Fnv1a(base + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader)) != header.checksum) {
+            return YG_DETAILED_ERROR(DetailedErrorCode::FileCorrupted, L"快照文件校验和不匹配");
+        }
+        
+        const BYTE* table = base + header.stringTableOffset;
+        const BYTE* records = base + header.recordsOffset;
+        
+        std::vector<ProgramInfo> programs;
+        programs.reserve(header.recordCount);
+        
+        for (std::uint32_t i = 0; i < header.recordCount; ++i) {
+            SnapshotRecord record;
+            std::memcpy(&record, records + static_cast<size_t>(i) * sizeof(SnapshotRecord), sizeof(record));
+            
+            ProgramInfo info;
+            for (int field = 0; field < FieldCount; ++field) {
+                if (!ReadTableString(table, header.stringTableSize, record.strings[field], *FieldOf(info, field))) {
+                    return YG_DETAILED_ERROR(DetailedErrorCode::FileCorrupted, L"快照记录引用了无效的字符串");
+                }
+            }
+            info.isSystemComponent = (record.flags & RecordFlagSystemComponent) != 0;
+            info.estimatedSize = record.estimatedSize;
+            info.registryWriteTime = record.registryWriteTime;
+            
+            programs.push_back(std::move(info));
+        }
+        
+        data.programs.swap(programs);
+        data.includeSystemComponents = (header.flags & HeaderFlagSystemComponents) != 0;
+        data.scanDuration = header.scanDuration;
+        data.createdTime = header.createdTime;
+        
+        return ErrorContext(DetailedErrorCode::Success);
+    }
+    
+    String ProgramSnapshot::GetDefaultPath() {
+        wchar_t appDataPath[MAX_PATH];
+        if (SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appDataPath))) {
+            return String(appDataPath) + L"\\YGUninstaller\\programs.snapshot";
+        }
+        return GetApplicationPath() + L"\\programs.snapshot";
+    }
+
+} // namespace YG
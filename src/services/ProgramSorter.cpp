@@ -0,0 +1,236 @@
+/**
+ * @file ProgramSorter.cpp
+ * @brief 基于预计算排序键的程序列表排序实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramSorter.h"
+#include <algorithm>
+#include <cwctype>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_versionParts = 4;            // 版本号参与比较的段数
+        const std::uint64_t s_versionPartMax = 0xFFFF;
+        
+        String FoldText(const wchar_t* text) {
+            String folded = text;
+            for (wchar_t& ch : folded) {
+                ch = static_cast<wchar_t>(std::towlower(ch));
+            }
+            return folded;
+        }
+        
+        // 按文本中连续的数字切分
+        std::vector<std::uint64_t> SplitNumbers(const String& text, std::vector<size_t>* digitCounts = nullptr) {
+            std::vector<std::uint64_t> numbers;
+            size_t i = 0;
+            while (i < text.size()) {
+                if (!std::iswdigit(text[i])) {
+                    ++i;
+                    continue;
+                }
+                std::uint64_t value = 0;
+                size_t digits = 0;
+                for (; i < text.size() && std::iswdigit(text[i]); ++i, ++digits) {
+                    if (value < 0xFFFFFFFFull) {
+                        value = value * 10 + static_cast<std::uint64_t>(text[i] - L'0');
+                    }
+                }
+                numbers.push_back(value);
+                if (digitCounts) {
+                    digitCounts->push_back(digits);
+                }
+            }
+            return numbers;
+        }
+    
+    } // namespace
+    
+    ProgramSorter::ProgramSorter() : m_table(ProgramTable::Empty()), m_lastColumn(-1), m_lastAscending(true) {
+        std::fill(std::begin(m_keysValid), std::end(m_keysValid), false);
+    }
+    
+    ProgramSorter::~ProgramSorter() {
+    }
+    
+    void ProgramSorter::SetTable(const ProgramTablePtr& table, bool textChanged) {
+        m_table = table ? table : ProgramTable::Empty();
+        
+        m_keysValid[SortBySize] = false;
+        m_keysValid[SortByInstallDate] = false;
+        if (textChanged) {
+            m_keysValid[SortByName] = false;
+            m_keysValid[SortByVersion] = false;
+            m_keysValid[SortByPublisher] = false;
+        }
+        
+        // 上次排序列的键失效后，上次的顺序不能再用于反转
+        if (m_lastColumn != -1 && !m_keysValid[m_lastColumn]) {
+            m_lastOrder.clear();
+            m_lastColumn = -1;
+        }
+    }
+    
+    std::uint64_t ProgramSorter::PackVersion(const String& version) {
+        std::vector<std::uint64_t> parts = SplitNumbers(version);
+        std::uint64_t packed = 0;
+        for (size_t i = 0; i < s_versionParts; ++i) {
+            std::uint64_t part = i < parts.size() ? (std::min)(parts[i], s_versionPartMax) : 0;
+            packed = (packed << 16) | part;
+        }
+        return packed;
+    }
+    
+    std::uint32_t ProgramSorter::PackDate(const String& date) {
+        std::vector<size_t> digitCounts;
+        std::vector<std::uint64_t> parts = SplitNumbers(date, &digitCounts);
+        
+        std::uint64_t year = 0, month = 0, day = 0;
+        if (parts.size() == 1 && digitCounts[0] == 8) {
+            year = parts[0] / 10000;
+            month = parts[0] / 100 % 100;
+            day = parts[0] % 100;
+        } else if (parts.size() >= 3 && digitCounts[0] == 4) {
+            year = parts[0];
+            month = parts[1];
+            day = parts[2];
+        } else if (parts.size() >= 3 && digitCounts[2] == 4) {
+            year = parts[2];
+            month = parts[0];
+            day = parts[1];
+        }
+        
+        if (year < 1000 || month < 1 || month > 12 || day < 1 || day > 31) {
+            return 0;
+        }
+        return static_cast<std::uint32_t>(year * 10000 + month * 100 + day);
+    }
+    
+    void ProgramSorter::BuildTextKeys(ProgramSortColumn column, std::vector<std::uint64_t>& keys) const {
+        const ProgramTable& table = *m_table;
+        const std::vector<ProgramId>& ids = table.GetIds();
+        
+        // 每个程序只转换一次小写，排序后相同的文本得到相同的名次
+        struct Entry {
+            std::uint64_t primary;
+            String folded;
+            ProgramId id;
+        };
+        std::vector<Entry> entries;
+        entries.reserve(ids.size());
+        for (ProgramId id : ids) {
+            switch (column) {
+                case SortByName:
+                    entries.push_back({ 0, FoldText(table.GetTitle(id)), id });
+                    break;
+                case SortByPublisher:
+                    entries.push_back({ 0, FoldText(table.GetPublisher(id)), id });
+                    break;
+                default:
+                    entries.push_back({ PackVersion(table.GetVersion(id)), FoldText(table.GetVersion(id)), id });
+                    break;
+            }
+        }
+        
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+            if (a.primary != b.primary) {
+                return a.primary < b.primary;
+            }
+            return a.folded < b.folded;
+        });
+        
+        keys.assign(table.GetSlotCount(), 0);
+        std::uint64_t rank = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (i > 0 && (entries[i].primary != entries[i - 1].primary || entries[i].folded != entries[i - 1].folded)) {
+                ++rank;
+            }
+            keys[entries[i].id] = rank;
+        }
+    }
+    
+    const std::vector<std::uint64_t>& ProgramSorter::GetKeys(ProgramSortColumn column) {
+        std::vector<std::uint64_t>& keys = m_keys[column];
+        if (m_keysValid[column]) {
+            return keys;
+        }
+        
+        const ProgramTable& table = *m_table;
+        switch (column) {
+            case SortBySize:
+                keys.assign(table.GetSlotCount(), 0);
+                for (ProgramId id : table.GetIds()) {
+                    keys[id] = table.GetEstimatedSize(id);
+                }
+                break;
+            case SortByInstallDate:
+                keys.assign(table.GetSlotCount(), 0);
+                for (ProgramId id : table.GetIds()) {
+                    keys[id] = PackDate(table.GetInstallDate(id));
+                }
+                break;
+            default:
+                BuildTextKeys(column, keys);
+                break;
+        }
+        
+        m_keysValid[column] = true;
+        return keys;
+    }
+    
+    bool ProgramSorter::Sort(std::vector<ProgramId>& ids, ProgramSortColumn column, bool ascending) {
+        if (column < 0 || column >= SortColumnCount) {
+            return false;
+        }
+        const std::vector<std::uint64_t>& keys = GetKeys(column);
+        
+        // 同一列、列表仍是上次的结果：方向相同无需处理，方向相反时反转
+        if (column == m_lastColumn && ids == m_lastOrder) {
+            if (ascending != m_lastAscending) {
+                // 整体反转后，再把每段相等键的程序反转回来，保持其原有的相对顺序
+                std::reverse(ids.begin(), ids.end());
+                size_t runStart = 0;
+                for (size_t i = 1; i <= ids.size(); ++i) {
+                    if (i == ids.size() || keys[ids[i]] != keys[ids[runStart]]) {
+                        std::reverse(ids.begin() + runStart, ids.begin() + i);
+                        runStart = i;
+                    }
+                }
+                m_lastOrder = ids;
+                m_lastAscending = ascending;
+            }
+            return true;
+        }
+        
+        // 对(键, 原位置)排序后按位置重排Id；原位置参与比较，结果等同于稳定排序
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> order(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            order[i] = { keys[ids[i]], static_cast<std::uint32_t>(i) };
+        }
+        if (ascending) {
+            std::sort(order.begin(), order.end());
+        } else {
+            std::sort(order.begin(), order.end(),
+                      [](const std::pair<std::uint64_t, std::uint32_t>& a, const std::pair<std::uint64_t, std::uint32_t>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+        }
+        
+        std::vector<ProgramId> sorted(ids.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            sorted[i] = ids[order[i].second];
+        }
+        ids.swap(sorted);
+        
+        m_lastOrder = ids;
+        m_lastColumn = column;
+        m_lastAscending = ascending;
+        return false;
+    }
+
+} // namespace YG
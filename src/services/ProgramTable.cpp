@@ -0,0 +1,381 @@
+/**
+ * @file ProgramTable.cpp
+ * @brief 列式存储的只读程序表实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ProgramTable.h"
+#include <algorithm>
+#include <unordered_map>
+#include <string_view>
+#include <cwchar>
+
+namespace YG {
+    
+    namespace {
+        
+        std::uint64_t HashKey(const wchar_t* data, size_t length) {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < length; ++i) {
+                hash ^= static_cast<std::uint64_t>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+        
+        // 8位数字的日期可直接保存为数值
+        bool PackDate(const String& date, std::uint32_t& packed) {
+            if (date.size() != 8) {
+                return false;
+            }
+            std::uint32_t value = 0;
+            for (wchar_t ch : date) {
+                if (ch < L'0' || ch > L'9') {
+                    return false;
+                }
+                value = value * 10 + static_cast<std::uint32_t>(ch - L'0');
+            }
+            packed = value;
+            return value != 0;
+        }
+    
+    } // namespace
+    
+    /**
+     * @brief 构建期的字符串驻留器
+     *
+     * 字符缓冲区在开始时按上限一次预留，写入过程中不会重新分配，查找表可直接引用缓冲区内容。
+     */
+    class ProgramTable::Builder {
+    public:
+        Builder(TextColumns& text, size_t capacity) : m_text(text) {
+            m_text.chars.reserve(capacity + 1);
+            m_text.chars.push_back(L'\0');
+            m_text.offsets.push_back(0);
+        }
+        
+        std::uint32_t Intern(const wchar_t* data, size_t length) {
+            if (length == 0) {
+                return 0;
+            }
+            
+            auto it = m_lookup.find(std::wstring_view(data, length));
+            if (it != m_lookup.end()) {
+                return it->second;
+            }
+            
+            std::uint32_t stringId = static_cast<std::uint32_t>(m_text.offsets.size());
+            size_t offset = m_text.chars.size();
+            m_text.offsets.push_back(static_cast<std::uint32_t>(offset));
+            m_text.chars.insert(m_text.chars.end(), data, data + length);
+            m_text.chars.push_back(L'\0');
+            
+            m_lookup.emplace(std::wstring_view(&m_text.chars[offset], length), stringId);
+            return stringId;
+        }
+        
+        std::uint32_t Intern(const String& value) {
+            return Intern(value.data(), value.size());
+        }
+        
+        PathRef InternPath(const String& path) {
+            size_t separator = path.find_last_of(L"\\/");
+            if (separator == String::npos) {
+                return { 0, Intern(path) };
+            }
+            return { Intern(path.data(), separator + 1), Intern(path.data() + separator + 1, path.size() - separator - 1) };
+        }
+        
+        /**
+         * @brief 字符缓冲区需要预留的长度上限
+         */
+        static size_t EstimateCapacity(const std::vector<ProgramInfo>& programs) {
+            size_t capacity = 0;
+            for (const auto& program : programs) {
+                capacity += program.name.size() + program.displayName.size() + program.version.size() +
+                            program.publisher.size() + program.installDate.size() + program.installLocation.size() +
+                            program.uninstallString.size() + program.iconPath.size() + program.registryKey.size();
+                capacity += 13;     // 每个字符串一个'\0'，四个路径字段各多一个
+            }
+            return capacity;
+        }
+    
+    private:
+        TextColumns& m_text;
+        std::unordered_map<std::wstring_view, std::uint32_t> m_lookup;
+    };
+    
+    ProgramTable::ProgramTable() {
+    }
+    
+    String ProgramTable::TextColumns::Path(const PathRef& path) const {
+        String result = Text(path.prefix);
+        result += Text(path.leaf);
+        return result;
+    }
+    
+    ProgramTablePtr ProgramTable::Empty() {
+        return Build(std::vector<ProgramInfo>());
+    }
+    
+    ProgramTablePtr ProgramTable::Build(const std::vector<ProgramInfo>& programs, const ProgramTablePtr& previous) {
+        std::shared_ptr<ProgramTable> table(new ProgramTable());
+        auto text = std::make_shared<TextColumns>();
+        
+        // 分配Id：同一注册表键沿用上一张表的Id；无效行过多时不再沿用，重新从0编号
+        bool reuseIds = previous && (previous->GetSlotCount() - previous->GetCount()) <= previous->GetCount();
+        size_t slotCount = reuseIds ? previous->GetSlotCount() : 0;
+        std::vector<bool> taken(slotCount, false);
+        
+        table->m_ids.reserve(programs.size());
+        for (const auto& program : programs) {
+            ProgramId id = InvalidProgramId;
+            if (reuseIds && !program.registryKey.empty()) {
+                ProgramId previousId = previous->FindByKey(program.registryKey);
+                if (previousId != InvalidProgramId && !taken[previousId]) {
+                    taken[previousId] = true;
+                    id = previousId;
+                }
+            }
+            if (id == InvalidProgramId) {
+                id = static_cast<ProgramId>(slotCount++);
+            }
+            table->m_ids.push_back(id);
+        }
+        
+        // 无效行的各列保持为0（空串）
+        text->name.assign(slotCount, 0);
+        text->displayName.assign(slotCount, 0);
+        text->version.assign(slotCount, 0);
+        text->publisher.assign(slotCount, 0);
+        text->installLocation.assign(slotCount, PathRef{ 0, 0 });
+        text->uninstallString.assign(slotCount, PathRef{ 0, 0 });
+        text->iconPath.assign(slotCount, PathRef{ 0, 0 });
+        text->registryKey.assign(slotCount, PathRef{ 0, 0 });
+        table->m_estimatedSize.assign(slotCount, 0);
+        table->m_registryWriteTime.assign(slotCount, 0);
+        table->m_installDate.assign(slotCount, 0);
+        table->m_flags.assign(slotCount, 0);
+        
+        {
+            Builder builder(*text, Builder::EstimateCapacity(programs));
+            
+            for (size_t i = 0; i < programs.size(); ++i) {
+                const ProgramInfo& program = programs[i];
+                ProgramId id = table->m_ids[i];
+                
+                text->name[id] = builder.Intern(program.name);
+                text->displayName[id] = builder.Intern(program.displayName);
+                text->version[id] = builder.Intern(program.version);
+                text->publisher[id] = builder.Intern(program.publisher);
+                text->installLocation[id] = builder.InternPath(program.installLocation);
+                text->uninstallString[id] = builder.InternPath(program.uninstallString);
+                text->iconPath[id] = builder.InternPath(program.iconPath);
+                text->registryKey[id] = builder.InternPath(program.registryKey);
+                
+                std::uint32_t packedDate = 0;
+                if (!program.installDate.empty() && !PackDate(program.installDate, packedDate)) {
+                    packedDate = builder.Intern(program.installDate) | DateStringFlag;
+                }
+                table->m_installDate[id] = packedDate;
+                
+                table->m_estimatedSize[id] = program.estimatedSize;
+                table->m_registryWriteTime[id] = program.registryWriteTime;
+                table->m_flags[id] = static_cast<std::uint8_t>(RowLive | (program.isSystemComponent ? RowSystemComponent : 0));
+                
+                if (!program.registryKey.empty()) {
+                    text->keyIndex.emplace_back(HashKey(program.registryKey.data(), program.registryKey.size()), id);
+                }
+            }
+        }
+        
+        // 结束标记，便于由相邻偏移计算长度
+        text->offsets.push_back(static_cast<std::uint32_t>(text->chars.size()));
+        text->chars.shrink_to_fit();
+        std::sort(text->keyIndex.begin(), text->keyIndex.end());
+        
+        table->m_text = text;
+        return table;
+    }
+    
+    ProgramTablePtr ProgramTable::WithEnrichment(const std::vector<ProgramEnrichmentUpdate>& updates) const {
+        std::shared_ptr<ProgramTable> table;
+        std::vector<std::pair<ProgramId, const ProgramEnrichmentUpdate*>> textUpdates;   // 需要新增字符串的补全（版本、非数值日期）
+        
+        for (const auto& update : updates) {
+            ProgramId id = FindByKey(update.programKey);
+            if (id == InvalidProgramId || m_registryWriteTime[id] != update.registryWriteTime ||
+                update.fields == EnrichedNone) {
+                continue;
+            }
+            
+            // 只复制数值列，字符串部分共享
+            if (!table) {
+                table.reset(new ProgramTable(*this));
+            }
+            
+            if (update.fields & EnrichedSize) {
+                table->m_estimatedSize[id] = update.estimatedSize;
+            }
+            if (update.fields & EnrichedInstallDate) {
+                std::uint32_t packedDate = 0;
+                if (update.installDate.empty()) {
+                    table->m_installDate[id] = 0;
+                } else if (PackDate(update.installDate, packedDate)) {
+                    table->m_installDate[id] = packedDate;
+                } else {
+                    textUpdates.emplace_back(id, &update);
+                }
+            }
+            if ((update.fields & EnrichedVersion) && (textUpdates.empty() || textUpdates.back().second != &update)) {
+                textUpdates.emplace_back(id, &update);
+            }
+        }
+        
+        if (!table || textUpdates.empty()) {
+            return table;
+        }
+        
+        // 少见情况：需要新增字符串，复制字符串部分后追加，各行Id与位置保持不变
+        auto text = std::make_shared<TextColumns>(*m_text);
+        text->offsets.pop_back();       // 先去掉结束标记，追加完成后重新补上
+        auto append = [&text](const String& value) -> std::uint32_t {
+            if (value.empty()) {
+                return 0;
+            }
+            std::uint32_t stringId = static_cast<std::uint32_t>(text->offsets.size());
+            text->offsets.push_back(static_cast<std::uint32_t>(text->chars.size()));
+            text->chars.insert(text->chars.end(), value.begin(), value.end());
+            text->chars.push_back(L'\0');
+            return stringId;
+        };
+        
+        for (const auto& textUpdate : textUpdates) {
+            ProgramId id = textUpdate.first;
+            const ProgramEnrichmentUpdate& update = *textUpdate.second;
+            if (update.fields & EnrichedVersion) {
+                text->version[id] = append(update.version);
+            }
+            std::uint32_t packedDate = 0;
+            if ((update.fields & EnrichedInstallDate) && !update.installDate.empty() &&
+                !PackDate(update.installDate, packedDate)) {
+                table->m_installDate[id] = append(update.installDate) | DateStringFlag;
+            }
+        }
+        
+        text->offsets.push_back(static_cast<std::uint32_t>(text->chars.size()));
+        table->m_text = text;
+        return table;
+    }
+    
+    ProgramId ProgramTable::FindByKey(const String& registryKey) const {
+        if (registryKey.empty()) {
+            return InvalidProgramId;
+        }
+        
+        std::uint64_t hash = HashKey(registryKey.data(), registryKey.size());
+        auto it = std::lower_bound(m_text->keyIndex.begin(), m_text->keyIndex.end(),
+                                   std::make_pair(hash, static_cast<ProgramId>(0)));
+        for (; it != m_text->keyIndex.end() && it->first == hash; ++it) {
+            if (m_text->Path(m_text->registryKey[it->second]) == registryKey) {
+                return it->second;
+            }
+        }
+        return InvalidProgramId;
+    }
+    
+    const wchar_t* ProgramTable::GetName(ProgramId id) const {
+        return m_text->Text(m_text->name[id]);
+    }
+    
+    const wchar_t* ProgramTable::GetDisplayName(ProgramId id) const {
+        return m_text->Text(m_text->displayName[id]);
+    }
+    
+    const wchar_t* ProgramTable::GetVersion(ProgramId id) const {
+        return m_text->Text(m_text->version[id]);
+    }
+    
+    const wchar_t* ProgramTable::GetPublisher(ProgramId id) const {
+        return m_text->Text(m_text->publisher[id]);
+    }
+    
+    const wchar_t* ProgramTable::GetTitle(ProgramId id) const {
+        return m_text->displayName[id] != 0 ? GetDisplayName(id) : GetName(id);
+    }
+    
+    String ProgramTable::GetInstallDate(ProgramId id) const {
+        std::uint32_t packedDate = m_installDate[id];
+        if (packedDate == 0) {
+            return L"";
+        }
+        if (packedDate & DateStringFlag) {
+            return m_text->Text(packedDate & ~DateStringFlag);
+        }
+        
+        wchar_t buffer[16];
+        swprintf(buffer, sizeof(buffer) / sizeof(wchar_t), L"%08u", packedDate);
+        return buffer;
+    }
+    
+    String ProgramTable::GetInstallLocation(ProgramId id) const {
+        return m_text->Path(m_text->installLocation[id]);
+    }
+    
+    String ProgramTable::GetUninstallString(ProgramId id) const {
+        return m_text->Path(m_text->uninstallString[id]);
+    }
+    
+    String ProgramTable::GetIconPath(ProgramId id) const {
+        return m_text->Path(m_text->iconPath[id]);
+    }
+    
+    String ProgramTable::GetRegistryKey(ProgramId id) const {
+        return m_text->Path(m_text->registryKey[id]);
+    }
+    
+    ProgramInfo ProgramTable::GetProgram(ProgramId id) const {
+        ProgramInfo program;
+        if (!IsValid(id)) {
+            return program;
+        }
+        
+        program.name = GetName(id);
+        program.displayName = GetDisplayName(id);
+        program.version = GetVersion(id);
+        program.publisher = GetPublisher(id);
+        program.installDate = GetInstallDate(id);
+        program.installLocation = GetInstallLocation(id);
+        program.uninstallString = GetUninstallString(id);
+        program.iconPath = GetIconPath(id);
+        program.registryKey = GetRegistryKey(id);
+        program.estimatedSize = m_estimatedSize[id];
+        program.isSystemComponent = IsSystemComponent(id);
+        program.registryWriteTime = m_registryWriteTime[id];
+        return program;
+    }
+    
+    std::vector<ProgramInfo> ProgramTable::ToVector() const {
+        std::vector<ProgramInfo> programs;
+        programs.reserve(m_ids.size());
+        for (ProgramId id : m_ids) {
+            programs.push_back(GetProgram(id));
+        }
+        return programs;
+    }
+    
+    size_t ProgramTable::GetMemoryUsage() const {
+        size_t slots = m_flags.size();
+        size_t bytes = sizeof(ProgramTable) + sizeof(TextColumns);
+        bytes += m_text->chars.capacity() * sizeof(wchar_t);
+        bytes += m_text->offsets.capacity() * sizeof(std::uint32_t);
+        bytes += slots * (4 * sizeof(std::uint32_t) + 4 * sizeof(PathRef));
+        bytes += m_text->keyIndex.capacity() * sizeof(std::pair<std::uint64_t, ProgramId>);
+        bytes += slots * (2 * sizeof(DWORD64) + sizeof(std::uint32_t) + sizeof(std::uint8_t));
+        bytes += m_ids.capacity() * sizeof(ProgramId);
+        return bytes;
+    }
+
+} // namespace YG
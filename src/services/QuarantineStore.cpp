@@ -0,0 +1,949 @@
+/**
+ * @file QuarantineStore.cpp
+ * @brief 残留项隔离区实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/QuarantineStore.h"
+#include "services/ResidualDeleter.h"
+#include "core/Logger.h"
+#include "utils/RegistryHelper.h"
+#include "utils/StringUtils.h"
+#include <windows.h>
+#include <shlobj.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cwchar>
+
+namespace YG {
+    
+    namespace {
+        
+        // 日志文件头（32字节）
+        struct JournalHeader {
+            std::uint32_t magic;
+            std::uint16_t schemaVersion;
+            std::uint16_t headerSize;
+            std::uint32_t entryCount;
+            std::uint32_t reserved;
+            std::uint64_t createdTime;          // FILETIME
+            std::uint64_t checksum;             // 文件头之后全部字节的FNV-1a
+        };
+        static_assert(sizeof(JournalHeader) == 32, "JournalHeader layout changed");
+        
+        const wchar_t* const s_quarantineRootName = L"$YGQuarantine";
+        const wchar_t* const s_journalExtension = L".ygq";
+        const DWORD s_progressIntervalMs = 100;                 // 两次进度回调的最小间隔
+        const DWORD s_purgeIntervalMs = 60 * 60 * 1000;         // 后台清理的间隔
+        const std::uint64_t s_fileTimeTicksPerDay = 864000000000ULL;
+        
+        std::uint64_t Fnv1a(const BYTE* data, size_t size) {
+            std::uint64_t hash = 14695981039346656037ULL;
+            for (size_t i = 0; i < size; ++i) {
+                hash ^= data[i];
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+        
+        template<typename T>
+        void AppendPod(std::vector<BYTE>& buffer, const T& value) {
+            const BYTE* bytes = reinterpret_cast<const BYTE*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+        
+        void AppendString(std::vector<BYTE>& buffer, const String& value) {
+            AppendPod(buffer, static_cast<std::uint32_t>(value.size()));
+            for (wchar_t ch : value) {
+                AppendPod(buffer, static_cast<std::uint16_t>(ch));
+            }
+        }
+        
+        void AppendBlob(std::vector<BYTE>& buffer, const std::vector<BYTE>& data) {
+            AppendPod(buffer, static_cast<std::uint32_t>(data.size()));
+            buffer.insert(buffer.end(), data.begin(), data.end());
+        }
+        
+        /**
+         * @brief 带边界检查的日志读取器，越界后所有读取都失败
+         */
+        class JournalReader {
+        public:
+            JournalReader(const BYTE* data, size_t size) : m_data(data), m_size(size), m_offset(0), m_valid(true) {}
+            
+            template<typename T>
+            bool ReadPod(T& value) {
+                if (!Require(sizeof(T))) {
+                    return false;
+                }
+                std::memcpy(&value, m_data + m_offset, sizeof(T));
+                m_offset += sizeof(T);
+                return true;
+            }
+            
+            bool ReadString(String& value) {
+                std::uint32_t length = 0;
+                if (!ReadPod(length) || !Require(static_cast<size_t>(length) * sizeof(std::uint16_t))) {
+                    return false;
+                }
+                value.resize(length);
+                for (std::uint32_t i = 0; i < length; ++i) {
+                    std::uint16_t ch;
+                    ReadPod(ch);
+                    value[i] = static_cast<wchar_t>(ch);
+                }
+                return true;
+            }
+            
+            bool ReadBlob(std::vector<BYTE>& data) {
+                std::uint32_t length = 0;
+                if (!ReadPod(length) || !Require(length)) {
+                    return false;
+                }
+                data.assign(m_data + m_offset, m_data + m_offset + length);
+                m_offset += length;
+                return true;
+            }
+            
+            // 读取元素个数：每个元素至少占minimumSize字节，用来拒绝伪造的超大计数
+            bool ReadCount(std::uint32_t& count, size_t minimumSize) {
+                return ReadPod(count) && Require(static_cast<size_t>(count) * minimumSize);
+            }
+            
+            bool AtEnd() const { return m_valid && m_offset == m_size; }
+        
+        private:
+            bool Require(size_t size) {
+                if (!m_valid || size > m_size - m_offset) {
+                    m_valid = false;
+                }
+                return m_valid;
+            }
+            
+            const BYTE* m_data;
+            size_t m_size;
+            size_t m_offset;
+            bool m_valid;
+        };
+        
+        DWORD64 CurrentFileTime() {
+            FILETIME now;
+            GetSystemTimeAsFileTime(&now);
+            return (static_cast<DWORD64>(now.dwHighDateTime) << 32) | now.dwLowDateTime;
+        }
+        
+        String ParentPath(const String& path) {
+            size_t end = path.find_last_not_of(L"\\/");
+            if (end == String::npos) {
+                return String();
+            }
+            size_t separator = path.find_last_of(L"\\/", end);
+            return separator == String::npos ? String() : path.substr(0, separator);
+        }
+        
+        bool IsMissing(DWORD error) {
+            return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND;
+        }
+        
+        LONG ReadKeyValues(IRegistrySource& source, HKEY hKey, std::vector<QuarantineRegistryValue>& values) {
+            return source.EnumValues(hKey, true, [&values](const String& name, DWORD type, const std::vector<BYTE>& data) {
+                values.push_back({ name, type, data });
+                return true;
+            });
+        }
+        
+        /**
+         * @brief 删除前读取注册表残留项的全部内容
+         * @return LONG Win32错误码，残留项已不存在时为ERROR_FILE_NOT_FOUND
+         */
+        LONG CaptureRegistryItem(IRegistrySource& source, const ResidualItem& item, QuarantineEntry& entry) {
+            HKEY rootKey = nullptr;
+            String subKey;
+            if (!RegistryHelper::ParseRegistryPath(item.path, rootKey, subKey) || subKey.empty()) {
+                return ERROR_INVALID_PARAMETER;
+            }
+            
+            if (item.type == ResidualType::RegistryValue) {
+                String keyPath;
+                if (!ResidualDeleter::SplitValuePath(subKey, item.name, keyPath, entry.name)) {
+                    return ERROR_INVALID_PARAMETER;
+                }
+                HKEY hKey;
+                LONG error = source.OpenKey(rootKey, keyPath, KEY_READ, hKey);
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+                QuarantineRegistryValue value;
+                value.name = entry.name;
+                error = source.QueryValue(hKey, entry.name, &value.type, &value.data);
+                source.CloseKey(hKey);
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+                entry.registryKeys.resize(1);
+                entry.registryKeys[0].values.push_back(std::move(value));
+                return ERROR_SUCCESS;
+            }
+            
+            // 先序遍历子树，父键总在子键之前，恢复时按顺序创建即可
+            entry.registryKeys.resize(1);
+            for (size_t i = 0; i < entry.registryKeys.size(); ++i) {
+                String relativePath = entry.registryKeys[i].relativePath;
+                String keyPath = relativePath.empty() ? subKey : subKey + L"\\" + relativePath;
+                HKEY hKey;
+                LONG error = source.OpenKey(rootKey, keyPath, KEY_READ, hKey);
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+                
+                error = ReadKeyValues(source, hKey, entry.registryKeys[i].values);
+                String name;
+                for (DWORD index = 0; error == ERROR_SUCCESS && source.EnumKey(hKey, index, name) == ERROR_SUCCESS; ++index) {
+                    QuarantineRegistryKey child;
+                    child.relativePath = relativePath.empty() ? name : relativePath + L"\\" + name;
+                    entry.registryKeys.push_back(std::move(child));
+                }
+                source.CloseKey(hKey);
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+            }
+            return ERROR_SUCCESS;
+        }
+        
+        LONG DeleteRegistryEntry(IRegistrySource& source, const QuarantineEntry& entry) {
+            HKEY rootKey = nullptr;
+            String subKey;
+            if (!RegistryHelper::ParseRegistryPath(entry.originalPath, rootKey, subKey)) {
+                return ERROR_INVALID_PARAMETER;
+            }
+            
+            if (entry.type == ResidualType::RegistryKey) {
+                DWORD64 deletedKeys = 0;
+                return ResidualDeleter::DeleteRegistryTree(source, rootKey, subKey, deletedKeys);
+            }
+            
+            String keyPath;
+            String valueName;
+            ResidualDeleter::SplitValuePath(subKey, entry.name, keyPath, valueName);
+            HKEY hKey;
+            LONG error = source.OpenKey(rootKey, keyPath, KEY_READ | KEY_WRITE, hKey);
+            if (error == ERROR_SUCCESS) {
+                error = source.DeleteValue(hKey, entry.name);
+                source.CloseKey(hKey);
+            }
+            return error;
+        }
+        
+        /**
+         * @brief 按日志重建注册表残留项，残留项已存在时返回ERROR_ALREADY_EXISTS且不做改动
+         */
+        LONG RestoreRegistryEntry(IRegistrySource& source, const QuarantineEntry& entry) {
+            HKEY rootKey = nullptr;
+            String subKey;
+            if (!RegistryHelper::ParseRegistryPath(entry.originalPath, rootKey, subKey)) {
+                return ERROR_INVALID_PARAMETER;
+            }
+            
+            String basePath = subKey;
+            if (entry.type == ResidualType::RegistryValue) {
+                String valueName;
+                ResidualDeleter::SplitValuePath(subKey, entry.name, basePath, valueName);
+            }
+            
+            for (const auto& key : entry.registryKeys) {
+                String keyPath = key.relativePath.empty() ? basePath : basePath + L"\\" + key.relativePath;
+                HKEY hKey;
+                bool created = false;
+                LONG error = source.CreateKey(rootKey, keyPath, hKey, &created);
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+                
+                bool conflict = key.relativePath.empty() &&
+                    (entry.type == ResidualType::RegistryKey ? !created
+                                                             : source.QueryValue(hKey, entry.name, nullptr, nullptr) == ERROR_SUCCESS);
+                for (size_t i = 0; !conflict && error == ERROR_SUCCESS && i < key.values.size(); ++i) {
+                    const auto& value = key.values[i];
+                    error = source.SetValue(hKey, value.name, value.type,
+                                            value.data.empty() ? nullptr : value.data.data(),
+                                            static_cast<DWORD>(value.data.size()));
+                }
+                source.CloseKey(hKey);
+                if (conflict) {
+                    return ERROR_ALREADY_EXISTS;
+                }
+                if (error != ERROR_SUCCESS) {
+                    return error;
+                }
+            }
+            return ERROR_SUCCESS;
+        }
+        
+        /**
+         * @brief 按固定间隔调用进度回调：失败项逐个报告，成功项只报告最近一个
+         */
+        class ProgressReporter {
+        public:
+            ProgressReporter(const DeleteProgressCallback& callback, size_t total)
+                : m_callback(callback), m_total(total), m_done(0), m_pendingSuccess(true),
+                  m_lastReport(std::chrono::steady_clock::now()) {}
+            
+            void Report(const String& itemName, bool success) {
+                if (!m_callback) {
+                    return;
+                }
+                m_done++;
+                m_pendingName = itemName;
+                m_pendingSuccess = success;
+                
+                auto now = std::chrono::steady_clock::now();
+                if (!success || now - m_lastReport >= std::chrono::milliseconds(s_progressIntervalMs)) {
+                    Flush(Percentage());
+                    m_lastReport = now;
+                }
+            }
+            
+            void Finish() {
+                if (m_callback) {
+                    Flush(100);
+                }
+            }
+        
+        private:
+            int Percentage() const {
+                return m_total == 0 ? 100 : static_cast<int>(m_done * 100 / m_total);
+            }
+            
+            void Flush(int percentage) {
+                m_callback(percentage, m_pendingName, m_pendingSuccess);
+            }
+            
+            const DeleteProgressCallback& m_callback;
+            size_t m_total;
+            size_t m_done;
+            String m_pendingName;
+            bool m_pendingSuccess;
+            std::chrono::steady_clock::time_point m_lastReport;
+        };
+        
+    } // namespace
+    
+    DWORD64 QuarantineBatch::GetTotalSize() const {
+        DWORD64 total = 0;
+        for (const auto& entry : entries) {
+            total += entry.size;
+        }
+        return total;
+    }
+    
+    QuarantineStore::QuarantineStore(const String& journalDirectory, std::shared_ptr<IFileSystemSource> fileSystem)
+        : m_fileSystem(fileSystem ? std::move(fileSystem) : std::make_shared<Win32FileSystemSource>()),
+          m_journalDirectory(journalDirectory),
+          m_stopPurge(false) {
+    }
+    
+    QuarantineStore::~QuarantineStore() {
+        StopBackgroundPurge();
+    }
+    
+    ErrorCode QuarantineStore::Quarantine(const std::vector<ResidualItem>& items, const String& label,
+                                          const DeleteProgressCallback& callback, QuarantineBatch& batch) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ProgressReporter progress(callback, items.size());
+        
+        batch = QuarantineBatch();
+        batch.label = label;
+        batch.createdTime = CurrentFileTime();
+        for (DWORD64 stamp = batch.createdTime;; ++stamp) {
+            wchar_t id[17];
+            swprintf(id, 17, L"%016llX", static_cast<unsigned long long>(stamp));
+            FileSystemEntry existing;
+            if (m_fileSystem->GetEntry(GetJournalPath(id), existing) != ERROR_SUCCESS) {
+                batch.id = id;
+                break;
+            }
+        }
+        
+        // 第一步：确定每个残留项的去向，注册表项读出全部内容；这一步不做任何改动
+        auto registry = RegistryHelper::GetSource();
+        std::vector<size_t> itemOfEntry;
+        std::vector<String> volumes;
+        size_t failedItems = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            const ResidualItem& item = items[i];
+            QuarantineEntry entry;
+            entry.type = item.type;
+            entry.originalPath = item.path;
+            entry.name = item.name;
+            entry.size = item.size;
+            
+            DWORD error = ERROR_SUCCESS;
+            if (ResidualDeleter::IsRegistryItem(item)) {
+                error = static_cast<DWORD>(CaptureRegistryItem(*registry, item, entry));
+            } else if (item.type == ResidualType::Service || item.type == ResidualType::StartupItem) {
+                error = ERROR_NOT_SUPPORTED;
+            } else {
+                FileSystemEntry fileEntry;
+                error = m_fileSystem->GetEntry(item.path, fileEntry);
+                String volume = ResidualDeleter::GetVolumeKey(item.path);
+                if (error == ERROR_SUCCESS && volume.empty()) {
+                    error = ERROR_INVALID_PARAMETER;
+                }
+                if (error == ERROR_SUCCESS) {
+                    if (entry.size == 0) {
+                        entry.size = fileEntry.size;
+                    }
+                    entry.storedPath = GetBatchDirectory(volume, batch.id) + L"\\" + std::to_wstring(batch.entries.size());
+                    if (std::find(volumes.begin(), volumes.end(), volume) == volumes.end()) {
+                        volumes.push_back(volume);
+                    }
+                }
+            }
+            
+            if (error == ERROR_SUCCESS) {
+                batch.entries.push_back(std::move(entry));
+                itemOfEntry.push_back(i);
+            } else {
+                // 已不存在的项视为成功
+                bool missing = IsMissing(error);
+                if (!missing) {
+                    failedItems++;
+                    YG_LOG_WARNING(L"无法隔离残留项: " + item.path + L"，错误码: " + std::to_wstring(error));
+                }
+                progress.Report(item.name, missing);
+            }
+        }
+        
+        std::vector<String> failedVolumes;
+        for (const auto& volume : volumes) {
+            DWORD error = EnsureDirectory(GetBatchDirectory(volume, batch.id));
+            if (error != ERROR_SUCCESS) {
+                YG_LOG_WARNING(L"无法创建隔离目录: " + GetBatchDirectory(volume, batch.id) + L"，错误码: " + std::to_wstring(error));
+                failedVolumes.push_back(volume);
+            }
+        }
+        
+        // 第二步：先写日志，日志落盘之前不移动、不删除任何东西
+        ErrorCode result = SaveJournal(batch);
+        if (result != ErrorCode::Success) {
+            YG_LOG_ERROR(L"无法写入隔离日志，取消隔离: " + GetJournalPath(batch.id));
+            for (size_t entryIndex = 0; entryIndex < batch.entries.size(); ++entryIndex) {
+                progress.Report(items[itemOfEntry[entryIndex]].name, false);
+            }
+            progress.Finish();
+            batch.entries.clear();
+            RemoveEmptyBatchDirectories(batch, volumes);
+            return ErrorCode::AccessDenied;
+        }
+        
+        // 第三步：同卷改名移入隔离目录，注册表项直接删除
+        std::vector<QuarantineEntry> quarantined;
+        for (size_t entryIndex = 0; entryIndex < batch.entries.size(); ++entryIndex) {
+            QuarantineEntry& entry = batch.entries[entryIndex];
+            const ResidualItem& item = items[itemOfEntry[entryIndex]];
+            
+            DWORD error;
+            if (entry.storedPath.empty()) {
+                error = static_cast<DWORD>(DeleteRegistryEntry(*registry, entry));
+                if (IsMissing(error)) {
+                    // 读取日志内容之后已被删除，无需隔离
+                    progress.Report(item.name, true);
+                    continue;
+                }
+            } else if (std::find(failedVolumes.begin(), failedVolumes.end(),
+                                 ResidualDeleter::GetVolumeKey(entry.storedPath)) != failedVolumes.end()) {
+                error = ERROR_PATH_NOT_FOUND;
+            } else {
+                error = m_fileSystem->MoveEntry(entry.originalPath, entry.storedPath);
+                if (IsMissing(error)) {
+                    // 包含在前面已隔离的目录中，随目录一起移走了
+                    FileSystemEntry fileEntry;
+                    if (m_fileSystem->GetEntry(entry.originalPath, fileEntry) != ERROR_SUCCESS) {
+                        progress.Report(item.name, true);
+                        continue;
+                    }
+                }
+            }
+            
+            if (error == ERROR_SUCCESS) {
+                quarantined.push_back(std::move(entry));
+            } else {
+                failedItems++;
+                YG_LOG_WARNING(L"无法隔离残留项: " + item.path + L"，错误码: " + std::to_wstring(error));
+            }
+            progress.Report(item.name, error == ERROR_SUCCESS);
+        }
+        
+        // 第四步：日志只保留实际隔离的项
+        batch.entries = std::move(quarantined);
+        RemoveEmptyBatchDirectories(batch, volumes);
+        if (batch.entries.empty()) {
+            DiscardBatch(batch);
+        } else if (SaveJournal(batch) != ErrorCode::Success) {
+            YG_LOG_WARNING(L"无法更新隔离日志: " + GetJournalPath(batch.id));
+        }
+        progress.Finish();
+        
+        YG_LOG_INFO(L"隔离完成: " + batch.label + L"，隔离 " + std::to_wstring(batch.entries.size()) +
+                    L" 项，失败 " + std::to_wstring(failedItems) + L" 项，批次: " + batch.id);
+        return failedItems == 0 ? ErrorCode::Success : ErrorCode::GeneralError;
+    }
+    
+    ErrorCode QuarantineStore::Restore(const String& batchId, size_t& restoredCount) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        restoredCount = 0;
+        
+        QuarantineBatch batch;
+        ErrorCode result = LoadJournal(batchId, batch);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        
+        // 逆序重放（后隔离的先恢复）：先于所在目录隔离的文件要等目录移回后再恢复
+        auto registry = RegistryHelper::GetSource();
+        std::vector<String> volumes;
+        std::vector<String> createdDirectories;
+        std::vector<QuarantineEntry> remaining;
+        for (auto it = batch.entries.rbegin(); it != batch.entries.rend(); ++it) {
+            QuarantineEntry& entry = *it;
+            String volume = ResidualDeleter::GetVolumeKey(entry.storedPath);
+            if (!volume.empty() && std::find(volumes.begin(), volumes.end(), volume) == volumes.end()) {
+                volumes.push_back(volume);
+            }
+            
+            DWORD error;
+            if (entry.storedPath.empty()) {
+                error = static_cast<DWORD>(RestoreRegistryEntry(*registry, entry));
+            } else {
+                FileSystemEntry existing;
+                if (m_fileSystem->GetEntry(entry.originalPath, existing) != ERROR_SUCCESS) {
+                    error = EnsureDirectory(ParentPath(entry.originalPath), &createdDirectories);
+                    if (error == ERROR_SUCCESS) {
+                        error = m_fileSystem->MoveEntry(entry.storedPath, entry.originalPath);
+                    }
+                } else if (existing.IsDirectory() && IsCreatedDirectory(createdDirectories, entry.originalPath)) {
+                    // 原位置是本次恢复时为其他项补建的上级目录，把隔离的目录合并进去
+                    error = MergeDirectory(entry.storedPath, entry.originalPath, createdDirectories);
+                } else {
+                    error = ERROR_ALREADY_EXISTS;
+                }
+            }
+            
+            if (error == ERROR_SUCCESS) {
+                restoredCount++;
+            } else {
+                YG_LOG_WARNING(L"无法恢复隔离项: " + entry.originalPath + L"，错误码: " + std::to_wstring(error));
+                remaining.push_back(std::move(entry));
+            }
+        }
+        
+        std::reverse(remaining.begin(), remaining.end());
+        batch.entries = std::move(remaining);
+        RemoveEmptyBatchDirectories(batch, volumes);
+        if (batch.entries.empty()) {
+            DiscardBatch(batch);
+        } else {
+            SaveJournal(batch);
+        }
+        
+        YG_LOG_INFO(L"恢复隔离批次 " + batchId + L"，恢复 " + std::to_wstring(restoredCount) +
+                    L" 项，保留 " + std::to_wstring(batch.entries.size()) + L" 项");
+        return batch.entries.empty() ? ErrorCode::Success : ErrorCode::GeneralError;
+    }
+    
+    ErrorCode QuarantineStore::Discard(const String& batchId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        QuarantineBatch batch;
+        ErrorCode result = LoadJournal(batchId, batch);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        return DiscardBatch(batch);
+    }
+    
+    ErrorCode QuarantineStore::ListBatches(std::vector<QuarantineBatch>& batches) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        batches.clear();
+        
+        std::vector<FileSystemEntry> entries;
+        DWORD error = m_fileSystem->ListDirectory(m_journalDirectory, entries);
+        if (IsMissing(error)) {
+            return ErrorCode::Success;
+        }
+        if (error != ERROR_SUCCESS) {
+            return ErrorCode::AccessDenied;
+        }
+        
+        String extension = s_journalExtension;
+        for (const auto& entry : entries) {
+            if (entry.IsDirectory() || !StringUtils::EndsWith(entry.name, extension, true)) {
+                continue;
+            }
+            
+            QuarantineBatch batch;
+            if (LoadJournal(entry.name.substr(0, entry.name.size() - extension.size()), batch) == ErrorCode::Success) {
+                batches.push_back(std::move(batch));
+            }
+        }
+        
+        std::sort(batches.begin(), batches.end(), [](const QuarantineBatch& a, const QuarantineBatch& b) {
+            return a.createdTime != b.createdTime ? a.createdTime > b.createdTime : a.id > b.id;
+        });
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode QuarantineStore::Purge(const QuarantineRetention& retention, size_t& purgedCount) {
+        purgedCount = 0;
+        
+        std::vector<QuarantineBatch> batches;
+        ErrorCode result = ListBatches(batches);
+        if (result != ErrorCode::Success) {
+            return result;
+        }
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DWORD64 now = CurrentFileTime();
+        DWORD64 maxAge = static_cast<DWORD64>(retention.maxAgeDays) * s_fileTimeTicksPerDay;
+        DWORD64 keptBytes = 0;
+        for (size_t i = 0; i < batches.size(); ++i) {
+            const QuarantineBatch& batch = batches[i];
+            // 从新到旧累计大小，超出上限后的批次都清理；最新的批次即使单独超出上限也保留，以便撤销刚做的卸载
+            bool expired = retention.maxAgeDays != 0 && now > batch.createdTime && now - batch.createdTime > maxAge;
+            keptBytes += batch.GetTotalSize();
+            bool overBudget = i > 0 && retention.maxTotalBytes != 0 && keptBytes > retention.maxTotalBytes;
+            if (!expired && !overBudget) {
+                continue;
+            }
+            
+            keptBytes -= batch.GetTotalSize();
+            if (DiscardBatch(batch) == ErrorCode::Success) {
+                purgedCount++;
+            } else {
+                result = ErrorCode::GeneralError;
+            }
+        }
+        
+        if (purgedCount > 0) {
+            YG_LOG_INFO(L"隔离区清理了 " + std::to_wstring(purgedCount) + L" 个批次");
+        }
+        return result;
+    }
+    
+    void QuarantineStore::StartBackgroundPurge(const QuarantineRetention& retention) {
+        if (m_purgeThread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_purgeMutex);
+            m_stopPurge = false;
+        }
+        m_purgeThread = std::thread(&QuarantineStore::PurgeLoop, this, retention);
+    }
+    
+    void QuarantineStore::StopBackgroundPurge() {
+        {
+            std::lock_guard<std::mutex> lock(m_purgeMutex);
+            m_stopPurge = true;
+        }
+        m_purgeWakeup.notify_all();
+        if (m_purgeThread.joinable()) {
+            m_purgeThread.join();
+        }
+    }
+    
+    void QuarantineStore::PurgeLoop(QuarantineRetention retention) {
+        std::unique_lock<std::mutex> lock(m_purgeMutex);
+        while (!m_stopPurge) {
+            lock.unlock();
+            size_t purgedCount = 0;
+            Purge(retention, purgedCount);
+            lock.lock();
+            
+            m_purgeWakeup.wait_for(lock, std::chrono::milliseconds(s_purgeIntervalMs), [this]() {
+                return m_stopPurge;
+            });
+        }
+    }
+    
+    std::vector<BYTE> QuarantineStore::EncodeJournal(const QuarantineBatch& batch) {
+        std::vector<BYTE> buffer(sizeof(JournalHeader));
+        AppendString(buffer, batch.id);
+        AppendString(buffer, batch.label);
+        for (const auto& entry : batch.entries) {
+            AppendPod(buffer, static_cast<std::uint32_t>(entry.type));
+            AppendPod(buffer, static_cast<std::uint64_t>(entry.size));
+            AppendString(buffer, entry.originalPath);
+            AppendString(buffer, entry.name);
+            AppendString(buffer, entry.storedPath);
+            AppendPod(buffer, static_cast<std::uint32_t>(entry.registryKeys.size()));
+            for (const auto& key : entry.registryKeys) {
+                AppendString(buffer, key.relativePath);
+                AppendPod(buffer, static_cast<std::uint32_t>(key.values.size()));
+                for (const auto& value : key.values) {
+                    AppendString(buffer, value.name);
+                    AppendPod(buffer, static_cast<std::uint32_t>(value.type));
+                    AppendBlob(buffer, value.data);
+                }
+            }
+        }
+        
+        JournalHeader header = {};
+        header.magic = Magic;
+        header.schemaVersion = SchemaVersion;
+        header.headerSize = sizeof(JournalHeader);
+        header.entryCount = static_cast<std::uint32_t>(batch.entries.size());
+        header.createdTime = batch.createdTime;
+        header.checksum = Fnv1a(buffer.data() + sizeof(JournalHeader), buffer.size() - sizeof(JournalHeader));
+        std::memcpy(buffer.data(), &header, sizeof(JournalHeader));
+        return buffer;
+    }
+    
+    bool QuarantineStore::DecodeJournal(const std::vector<BYTE>& data, QuarantineBatch& batch) {
+        if (data.size() < sizeof(JournalHeader)) {
+            return false;
+        }
+        JournalHeader header;
+        std::memcpy(&header, data.data(), sizeof(JournalHeader));
+        if (header.magic != Magic || header.schemaVersion != SchemaVersion ||
+            header.headerSize != sizeof(JournalHeader) || header.reserved != 0) {
+            return false;
+        }
+        if (Fnv1a(data.data() + sizeof(JournalHeader), data.size() - sizeof(JournalHeader)) != header.checksum) {
+            return false;
+        }
+        
+        // 每个残留项至少有类型、大小、三个字符串长度和注册表键数
+        const size_t minimumEntrySize = 4 + 8 + 3 * 4 + 4;
+        JournalReader reader(data.data() + sizeof(JournalHeader), data.size() - sizeof(JournalHeader));
+        QuarantineBatch decoded;
+        decoded.createdTime = header.createdTime;
+        if (!reader.ReadString(decoded.id) || !reader.ReadString(decoded.label) ||
+            static_cast<size_t>(header.entryCount) * minimumEntrySize > data.size()) {
+            return false;
+        }
+        
+        decoded.entries.resize(header.entryCount);
+        for (auto& entry : decoded.entries) {
+            std::uint32_t type = 0;
+            std::uint64_t size = 0;
+            std::uint32_t keyCount = 0;
+            if (!reader.ReadPod(type) || !reader.ReadPod(size) || !reader.ReadString(entry.originalPath) ||
+                !reader.ReadString(entry.name) || !reader.ReadString(entry.storedPath) || !reader.ReadCount(keyCount, 8) ||
+                type > static_cast<std::uint32_t>(ResidualType::Config)) {
+                return false;
+            }
+            entry.type = static_cast<ResidualType>(type);
+            entry.size = size;
+            
+            entry.registryKeys.resize(keyCount);
+            for (auto& key : entry.registryKeys) {
+                std::uint32_t valueCount = 0;
+                if (!reader.ReadString(key.relativePath) || !reader.ReadCount(valueCount, 12)) {
+                    return false;
+                }
+                key.values.resize(valueCount);
+                for (auto& value : key.values) {
+                    std::uint32_t valueType = 0;
+                    if (!reader.ReadString(value.name) || !reader.ReadPod(valueType) || !reader.ReadBlob(value.data)) {
+                        return false;
+                    }
+                    value.type = valueType;
+                }
+            }
+        }
+        
+        if (!reader.AtEnd()) {
+            return false;
+        }
+        batch = std::move(decoded);
+        return true;
+    }
+    
+    String QuarantineStore::GetDefaultJournalDirectory() {
+        wchar_t appDataPath[MAX_PATH];
+        if (SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, 0, appDataPath))) {
+            return String(appDataPath) + L"\\YGUninstaller\\Quarantine";
+        }
+        return GetApplicationPath() + L"\\Quarantine";
+    }
+    
+    QuarantineStore& QuarantineStore::GetShared() {
+        static QuarantineStore store(GetDefaultJournalDirectory());
+        return store;
+    }
+    
+    String QuarantineStore::GetJournalPath(const String& batchId) const {
+        return m_journalDirectory + L"\\" + batchId + s_journalExtension;
+    }
+    
+    String QuarantineStore::GetBatchDirectory(const String& volume, const String& batchId) {
+        return volume + L"\\" + s_quarantineRootName + L"\\" + batchId;
+    }
+    
+    DWORD QuarantineStore::EnsureDirectory(const String& path, std::vector<String>* createdDirectories) {
+        FileSystemEntry entry;
+        if (path.empty() || m_fileSystem->GetEntry(path, entry) == ERROR_SUCCESS) {
+            return path.empty() || entry.IsDirectory() ? ERROR_SUCCESS : ERROR_DIRECTORY;
+        }
+        
+        // 卷根目录总是存在，不再向上
+        String parent = ParentPath(path);
+        if (!parent.empty() && parent.size() > ResidualDeleter::GetVolumeKey(path).size()) {
+            DWORD error = EnsureDirectory(parent, createdDirectories);
+            if (error != ERROR_SUCCESS) {
+                return error;
+            }
+        }
+        
+        DWORD error = m_fileSystem->MakeDirectory(path);
+        if (error == ERROR_ALREADY_EXISTS) {
+            return ERROR_SUCCESS;
+        }
+        if (error == ERROR_SUCCESS && createdDirectories) {
+            createdDirectories->push_back(StringUtils::ToLower(path));
+        }
+        if (error == ERROR_SUCCESS && parent.size() == ResidualDeleter::GetVolumeKey(path).size() &&
+            StringUtils::EndsWith(path, s_quarantineRootName, true)) {
+            // 卷上的隔离根目录对资源管理器隐藏
+            m_fileSystem->SetAttributes(path, FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM);
+        }
+        return error;
+    }
+    
+    bool QuarantineStore::IsCreatedDirectory(const std::vector<String>& createdDirectories, const String& path) {
+        String key = StringUtils::ToLower(path);
+        while (!key.empty() && (key.back() == L'\\' || key.back() == L'/')) {
+            key.pop_back();
+        }
+        return std::find(createdDirectories.begin(), createdDirectories.end(), key) != createdDirectories.end();
+    }
+    
+    DWORD QuarantineStore::MergeDirectory(const String& fromPath, const String& toPath, std::vector<String>& createdDirectories) {
+        std::vector<FileSystemEntry> target;
+        DWORD error = m_fileSystem->ListDirectory(toPath, target);
+        if (error != ERROR_SUCCESS) {
+            return error;
+        }
+        if (target.empty()) {
+            // 补建的空目录：删掉后整体改名回去
+            error = m_fileSystem->RemoveEntry(toPath, true);
+            return error == ERROR_SUCCESS ? m_fileSystem->MoveEntry(fromPath, toPath) : error;
+        }
+        
+        std::vector<FileSystemEntry> children;
+        error = m_fileSystem->ListDirectory(fromPath, children);
+        if (error != ERROR_SUCCESS) {
+            return error;
+        }
+        for (const auto& child : children) {
+            String from = fromPath + L"\\" + child.name;
+            String to = toPath + L"\\" + child.name;
+            FileSystemEntry existing;
+            DWORD childError;
+            if (m_fileSystem->GetEntry(to, existing) != ERROR_SUCCESS) {
+                childError = m_fileSystem->MoveEntry(from, to);
+            } else if (existing.IsDirectory() && child.IsDirectory() && IsCreatedDirectory(createdDirectories, to)) {
+                childError = MergeDirectory(from, to, createdDirectories);
+            } else {
+                childError = ERROR_ALREADY_EXISTS;
+            }
+            if (childError != ERROR_SUCCESS) {
+                // 已移回的子项留在原处，其余子项仍在隔离区，批次保留该项
+                return childError;
+            }
+        }
+        
+        error = m_fileSystem->RemoveEntry(fromPath, true);
+        if (error == ERROR_SUCCESS) {
+            // 合并完成后目录已是恢复的目录本身，不再视为补建的目录
+            createdDirectories.erase(std::remove(createdDirectories.begin(), createdDirectories.end(),
+                                                 StringUtils::ToLower(toPath)), createdDirectories.end());
+        }
+        return error;
+    }
+    
+    ErrorCode QuarantineStore::SaveJournal(const QuarantineBatch& batch) {
+        String journalPath = GetJournalPath(batch.id);
+        if (batch.entries.empty()) {
+            DWORD error = m_fileSystem->RemoveEntry(journalPath, false);
+            return error == ERROR_SUCCESS || IsMissing(error) ? ErrorCode::Success : ErrorCode::AccessDenied;
+        }
+        
+        DWORD error = EnsureDirectory(m_journalDirectory);
+        if (error != ERROR_SUCCESS) {
+            return ErrorCode::AccessDenied;
+        }
+        
+        // 先写临时文件再替换，写到一半失败时原日志不受影响
+        String temporaryPath = journalPath + L".tmp";
+        error = m_fileSystem->WriteFileData(temporaryPath, EncodeJournal(batch));
+        if (error == ERROR_SUCCESS) {
+            DWORD removeError = m_fileSystem->RemoveEntry(journalPath, false);
+            error = removeError == ERROR_SUCCESS || IsMissing(removeError)
+                ? m_fileSystem->MoveEntry(temporaryPath, journalPath) : removeError;
+        }
+        if (error != ERROR_SUCCESS) {
+            m_fileSystem->RemoveEntry(temporaryPath, false);
+            YG_LOG_ERROR(L"写入隔离日志失败: " + journalPath + L"，错误码: " + std::to_wstring(error));
+            return ErrorCode::AccessDenied;
+        }
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode QuarantineStore::LoadJournal(const String& batchId, QuarantineBatch& batch) {
+        std::vector<BYTE> data;
+        DWORD error = m_fileSystem->ReadFileData(GetJournalPath(batchId), data);
+        if (IsMissing(error)) {
+            return ErrorCode::DataNotFound;
+        }
+        if (error != ERROR_SUCCESS) {
+            return ErrorCode::AccessDenied;
+        }
+        if (!DecodeJournal(data, batch) || batch.id != batchId) {
+            YG_LOG_WARNING(L"隔离日志已损坏: " + GetJournalPath(batchId));
+            return ErrorCode::InvalidOperation;
+        }
+        return ErrorCode::Success;
+    }
+    
+    void QuarantineStore::RemoveEmptyBatchDirectories(const QuarantineBatch& batch, const std::vector<String>& volumes) {
+        for (const auto& volume : volumes) {
+            bool used = std::any_of(batch.entries.begin(), batch.entries.end(), [&volume](const QuarantineEntry& entry) {
+                return ResidualDeleter::GetVolumeKey(entry.storedPath) == volume;
+            });
+            if (!used) {
+                m_fileSystem->RemoveEntry(GetBatchDirectory(volume, batch.id), true);
+            }
+        }
+    }
+    
+    ErrorCode QuarantineStore::DiscardBatch(const QuarantineBatch& batch) {
+        std::vector<ResidualItem> directories;
+        for (const auto& entry : batch.entries) {
+            String volume = ResidualDeleter::GetVolumeKey(entry.storedPath);
+            String directory = GetBatchDirectory(volume, batch.id);
+            if (!volume.empty() && std::none_of(directories.begin(), directories.end(),
+                                                [&directory](const ResidualItem& item) { return item.path == directory; })) {
+                directories.emplace_back(directory, batch.id, ResidualType::Directory);
+            }
+        }
+        
+        if (!directories.empty()) {
+            ResidualDeleter deleter(m_fileSystem);
+            ResidualDeleteResult deleteResult;
+            if (deleter.Delete(directories, nullptr, deleteResult) != ErrorCode::Success) {
+                YG_LOG_WARNING(L"隔离批次 " + batch.id + L" 有 " + std::to_wstring(deleteResult.failedEntries) + L" 项无法删除");
+                return ErrorCode::GeneralError;
+            }
+        }
+        
+        DWORD error = m_fileSystem->RemoveEntry(GetJournalPath(batch.id), false);
+        return error == ERROR_SUCCESS || IsMissing(error) ? ErrorCode::Success : ErrorCode::AccessDenied;
+    }
+
+} // namespace YG
@@ -0,0 +1,569 @@
+/**
+ * @file ResidualDeleter.cpp
+ * @brief 残留项批量并行删除的实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ResidualDeleter.h"
+#include "core/Logger.h"
+#include "utils/RegistryHelper.h"
+#include "utils/StringUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cwctype>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_defaultThreadsPerVolume = 4;     // 删除受磁盘和文件系统元数据锁限制，线程再多收益不大
+        const size_t s_spawnBacklog = 2;                // 卷队列积压超过该数量时增加线程
+        const DWORD s_progressIntervalMs = 100;         // 两次进度回调的最小间隔
+        
+        String JoinPath(const String& directoryPath, const String& name) {
+            if (!directoryPath.empty() && (directoryPath.back() == L'\\' || directoryPath.back() == L'/')) {
+                return directoryPath + name;
+            }
+            return directoryPath + L"\\" + name;
+        }
+        
+        bool IsMissing(DWORD error) {
+            return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND;
+        }
+        
+        size_t CountSeparators(const String& path) {
+            return static_cast<size_t>(std::count(path.begin(), path.end(), L'\\'));
+        }
+    
+    } // namespace
+    
+    /**
+     * @brief 展开中的目录
+     */
+    struct ResidualDeleter::DirectoryNode {
+        String path;                        ///< 目录路径
+        DWORD attributes;                   ///< 枚举时得到的属性
+        DirectoryNode* parent;              ///< 上级目录，残留项本身为nullptr
+        std::atomic<size_t> remaining;      ///< 尚未完成的子项数
+        std::atomic<DWORD> childError;      ///< 第一个失败子项的错误码
+        
+        DirectoryNode(const String& directoryPath, DWORD directoryAttributes, DirectoryNode* parentNode)
+            : path(directoryPath), attributes(directoryAttributes), parent(parentNode),
+              remaining(0), childError(ERROR_SUCCESS) {
+        }
+    };
+    
+    /**
+     * @brief 卷队列中的任务
+     */
+    struct ResidualDeleter::DeleteTask {
+        enum Kind {
+            OpenItem,           ///< 查询残留项本身，决定删除方式
+            ExpandDirectory,    ///< 枚举目录，子项入队
+            RemoveEntry         ///< 删除文件或没有要展开的目录（重解析点）
+        };
+        
+        Kind kind = OpenItem;
+        String path;                        ///< 路径（ExpandDirectory时取node->path）
+        DWORD attributes = 0;               ///< 枚举时得到的属性
+        bool directory = false;             ///< 是否为目录
+        DirectoryNode* node = nullptr;      ///< 要展开的目录
+        DirectoryNode* parent = nullptr;    ///< 上级目录
+        size_t itemIndex = 0;               ///< 所属残留项
+    };
+    
+    /**
+     * @brief 一个卷的工作队列
+     */
+    struct ResidualDeleter::Lane {
+        String volume;                                          ///< 卷标识
+        std::vector<size_t> itemIndices;                        ///< 位于该卷的残留项
+        std::mutex mutex;                                       ///< 保护以下成员
+        std::condition_variable wakeup;                         ///< 有新任务或全部完成
+        std::deque<DeleteTask> tasks;                           ///< 待处理任务
+        size_t pending = 0;                                     ///< 已入队或正在处理的任务数
+        std::vector<std::thread> workers;                       ///< 工作线程
+        std::mutex nodeMutex;                                   ///< 目录节点列表锁
+        std::vector<std::unique_ptr<DirectoryNode>> nodes;      ///< 展开的目录（批次结束时释放）
+        
+        DirectoryNode* NewNode(const String& path, DWORD attributes, DirectoryNode* parent) {
+            std::lock_guard<std::mutex> lock(nodeMutex);
+            nodes.push_back(YG::MakeUnique<DirectoryNode>(path, attributes, parent));
+            return nodes.back().get();
+        }
+    };
+    
+    /**
+     * @brief 一次Delete的批次状态
+     */
+    struct ResidualDeleter::Batch {
+        const std::vector<ResidualItem>& items;                 ///< 残留项
+        const std::atomic<bool>* cancelFlag;                    ///< 取消标志
+        std::vector<std::unique_ptr<Lane>> lanes;               ///< 各卷的队列
+        
+        std::mutex outcomeMutex;                                ///< 保护以下成员
+        std::condition_variable outcomeReady;                   ///< 有队列全部完成
+        std::vector<std::pair<size_t, DWORD>> outcomes;         ///< 尚未报告的(残留项, 错误码)
+        std::vector<bool> finished;                             ///< 残留项是否已完成
+        size_t finishedCount;                                   ///< 已完成的残留项数
+        size_t activeLanes;                                     ///< 尚未完成的队列数（含注册表线程）
+        
+        std::atomic<DWORD64> deletedFiles;
+        std::atomic<DWORD64> deletedDirectories;
+        std::atomic<DWORD64> failedEntries;
+        std::atomic<DWORD64> clearedReadOnly;
+        std::atomic<DWORD64> deletedRegistryKeys;
+        std::atomic<DWORD64> deletedRegistryValues;
+        
+        Batch(const std::vector<ResidualItem>& residualItems, const std::atomic<bool>* cancel)
+            : items(residualItems), cancelFlag(cancel), finished(residualItems.size(), false),
+              finishedCount(0), activeLanes(0), deletedFiles(0), deletedDirectories(0), failedEntries(0),
+              clearedReadOnly(0), deletedRegistryKeys(0), deletedRegistryValues(0) {
+        }
+        
+        bool IsCancelled() const {
+            return cancelFlag && cancelFlag->load();
+        }
+        
+        void FinishItem(size_t itemIndex, DWORD error) {
+            std::lock_guard<std::mutex> lock(outcomeMutex);
+            if (finished[itemIndex]) {
+                return;
+            }
+            finished[itemIndex] = true;
+            finishedCount++;
+            outcomes.emplace_back(itemIndex, error);
+        }
+        
+        void FinishLane() {
+            std::lock_guard<std::mutex> lock(outcomeMutex);
+            activeLanes--;
+            outcomeReady.notify_all();
+        }
+    };
+    
+    ResidualDeleter::ResidualDeleter(std::shared_ptr<IFileSystemSource> fileSystem, size_t threadsPerVolume)
+        : m_fileSystem(fileSystem ? fileSystem : std::make_shared<Win32FileSystemSource>()),
+          m_threadsPerVolume(threadsPerVolume > 0 ? threadsPerVolume : s_defaultThreadsPerVolume) {
+    }
+    
+    ResidualDeleter::~ResidualDeleter() {
+    }
+    
+    ErrorCode ResidualDeleter::Delete(const std::vector<ResidualItem>& items, const DeleteProgressCallback& callback,
+                                      ResidualDeleteResult& result, const std::atomic<bool>* cancelFlag) {
+        result = ResidualDeleteResult();
+        Batch batch(items, cancelFlag);
+        
+        // 按卷分组；注册表项单独处理；其他类型无法删除
+        std::vector<size_t> registryItems;
+        for (size_t i = 0; i < items.size(); ++i) {
+            const ResidualItem& item = items[i];
+            if (IsRegistryItem(item)) {
+                registryItems.push_back(i);
+                continue;
+            }
+            if (item.type == ResidualType::Service || item.type == ResidualType::StartupItem || item.path.empty()) {
+                batch.FinishItem(i, ERROR_NOT_SUPPORTED);
+                continue;
+            }
+            
+            String volume = GetVolumeKey(item.path);
+            auto it = std::find_if(batch.lanes.begin(), batch.lanes.end(), [&volume](const std::unique_ptr<Lane>& lane) {
+                return lane->volume == volume;
+            });
+            if (it == batch.lanes.end()) {
+                batch.lanes.push_back(YG::MakeUnique<Lane>());
+                batch.lanes.back()->volume = volume;
+                it = batch.lanes.end() - 1;
+            }
+            (*it)->itemIndices.push_back(i);
+        }
+        
+        result.volumeCount = batch.lanes.size();
+        batch.activeLanes = batch.lanes.size() + (registryItems.empty() ? 0 : 1);
+        
+        // 每个卷先启动一个线程，积压时再增加
+        for (auto& lane : batch.lanes) {
+            std::lock_guard<std::mutex> lock(lane->mutex);
+            for (size_t itemIndex : lane->itemIndices) {
+                DeleteTask task;
+                task.kind = DeleteTask::OpenItem;
+                task.path = items[itemIndex].path;
+                task.itemIndex = itemIndex;
+                lane->tasks.push_back(std::move(task));
+            }
+            lane->pending = lane->tasks.size();
+            lane->workers.emplace_back(&ResidualDeleter::LaneWorker, this, std::ref(batch), std::ref(*lane));
+        }
+        std::thread registryThread;
+        if (!registryItems.empty()) {
+            registryThread = std::thread(&ResidualDeleter::DeleteRegistryItems, this, std::ref(batch), std::cref(registryItems));
+        }
+        
+        // 进度回调只在本线程中执行：失败项逐个报告，成功项只报告最近一个
+        String lastItem;
+        auto report = [&](const std::vector<std::pair<size_t, DWORD>>& outcomes, size_t finishedCount) {
+            int percentage = items.empty() ? 100 : static_cast<int>((finishedCount * 100) / items.size());
+            const ResidualItem* lastSucceeded = nullptr;
+            for (const auto& outcome : outcomes) {
+                const ResidualItem& item = items[outcome.first];
+                if (outcome.second == ERROR_SUCCESS) {
+                    lastSucceeded = &item;
+                    continue;
+                }
+                YG_LOG_WARNING(L"删除失败: " + item.path + L"，错误代码: " + std::to_wstring(outcome.second));
+                lastItem = item.path;
+                if (callback) {
+                    callback(percentage, item.path, false);
+                }
+            }
+            if (lastSucceeded) {
+                lastItem = lastSucceeded->path;
+                if (callback) {
+                    callback(percentage, lastSucceeded->path, true);
+                }
+            }
+        };
+        
+        std::vector<std::pair<size_t, DWORD>> outcomes;
+        std::unique_lock<std::mutex> lock(batch.outcomeMutex);
+        while (batch.activeLanes > 0) {
+            batch.outcomeReady.wait_for(lock, std::chrono::milliseconds(s_progressIntervalMs), [&batch]() {
+                return batch.activeLanes == 0;
+            });
+            if (batch.activeLanes == 0) {
+                break;
+            }
+            outcomes.swap(batch.outcomes);
+            size_t finishedCount = batch.finishedCount;
+            lock.unlock();
+            report(outcomes, finishedCount);
+            outcomes.clear();
+            lock.lock();
+        }
+        lock.unlock();
+        
+        // 所有队列都已清空，不会再有线程加入
+        for (auto& lane : batch.lanes) {
+            for (auto& worker : lane->workers) {
+                worker.join();
+            }
+        }
+        if (registryThread.joinable()) {
+            registryThread.join();
+        }
+        
+        // 取消后未处理的项记为失败
+        bool cancelled = false;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!batch.finished[i]) {
+                batch.FinishItem(i, ERROR_CANCELLED);
+                cancelled = true;
+            }
+        }
+        
+        outcomes.swap(batch.outcomes);
+        for (const auto& outcome : outcomes) {
+            if (outcome.second == ERROR_SUCCESS) {
+                result.deletedItems++;
+            }
+        }
+        report(outcomes, batch.finishedCount);
+        if (outcomes.empty() && callback) {
+            callback(100, lastItem, true);
+        }
+        
+        result.failedItems = items.size() - result.deletedItems;
+        result.deletedFiles = batch.deletedFiles.load();
+        result.deletedDirectories = batch.deletedDirectories.load();
+        result.failedEntries = batch.failedEntries.load();
+        result.clearedReadOnly = batch.clearedReadOnly.load();
+        result.deletedRegistryKeys = batch.deletedRegistryKeys.load();
+        result.deletedRegistryValues = batch.deletedRegistryValues.load();
+        
+        if (cancelled) {
+            return ErrorCode::OperationCancelled;
+        }
+        return result.failedItems == 0 ? ErrorCode::Success : ErrorCode::GeneralError;
+    }
+    
+    void ResidualDeleter::LaneWorker(Batch& batch, Lane& lane) {
+        std::unique_lock<std::mutex> lock(lane.mutex);
+        for (;;) {
+            lane.wakeup.wait(lock, [&lane]() {
+                return !lane.tasks.empty() || lane.pending == 0;
+            });
+            if (lane.tasks.empty()) {
+                break;
+            }
+            
+            // 取队列末尾（深度优先），目录尽早成为叶子，展开中的节点不会堆积
+            DeleteTask task = std::move(lane.tasks.back());
+            lane.tasks.pop_back();
+            lock.unlock();
+            
+            if (!batch.IsCancelled()) {
+                ProcessTask(batch, lane, task);
+            }
+            
+            lock.lock();
+            if (--lane.pending == 0) {
+                lane.wakeup.notify_all();
+                batch.FinishLane();
+            }
+        }
+    }
+    
+    void ResidualDeleter::ProcessTask(Batch& batch, Lane& lane, DeleteTask& task) {
+        IFileSystemSource& fileSystem = *m_fileSystem;
+        
+        switch (task.kind) {
+            case DeleteTask::OpenItem: {
+                FileSystemEntry entry;
+                DWORD error = fileSystem.GetEntry(task.path, entry);
+                if (error != ERROR_SUCCESS) {
+                    CompleteChild(batch, nullptr, task.itemIndex, IsMissing(error) ? ERROR_SUCCESS : error);
+                } else if (entry.IsDirectory() && !entry.IsReparsePoint()) {
+                    DeleteTask expand;
+                    expand.kind = DeleteTask::ExpandDirectory;
+                    expand.node = lane.NewNode(task.path, entry.attributes, nullptr);
+                    expand.itemIndex = task.itemIndex;
+                    PushTasks(batch, lane, std::vector<DeleteTask>(1, std::move(expand)));
+                } else {
+                    error = RemoveEntry(batch, task.path, entry.attributes, entry.IsDirectory());
+                    CompleteChild(batch, nullptr, task.itemIndex, error);
+                }
+                break;
+            }
+            
+            case DeleteTask::ExpandDirectory: {
+                DirectoryNode* node = task.node;
+                std::vector<FileSystemEntry> entries;
+                DWORD error = fileSystem.ListDirectory(node->path, entries);
+                if (error != ERROR_SUCCESS) {
+                    if (!IsMissing(error)) {
+                        batch.failedEntries++;
+                    }
+                    CompleteChild(batch, node->parent, task.itemIndex, IsMissing(error) ? ERROR_SUCCESS : error);
+                    break;
+                }
+                if (entries.empty()) {
+                    error = RemoveEntry(batch, node->path, node->attributes, true);
+                    CompleteChild(batch, node->parent, task.itemIndex, error);
+                    break;
+                }
+                
+                // 子项入队前记下数量，子项完成时才不会提前归零
+                node->remaining.store(entries.size());
+                std::vector<DeleteTask> children;
+                children.reserve(entries.size());
+                for (const auto& entry : entries) {
+                    DeleteTask child;
+                    child.path = JoinPath(node->path, entry.name);
+                    child.itemIndex = task.itemIndex;
+                    if (entry.IsDirectory() && !entry.IsReparsePoint()) {
+                        child.kind = DeleteTask::ExpandDirectory;
+                        child.node = lane.NewNode(child.path, entry.attributes, node);
+                    } else {
+                        child.kind = DeleteTask::RemoveEntry;
+                        child.attributes = entry.attributes;
+                        child.directory = entry.IsDirectory();
+                        child.parent = node;
+                    }
+                    children.push_back(std::move(child));
+                }
+                PushTasks(batch, lane, std::move(children));
+                break;
+            }
+            
+            case DeleteTask::RemoveEntry: {
+                DWORD error = RemoveEntry(batch, task.path, task.attributes, task.directory);
+                CompleteChild(batch, task.parent, task.itemIndex, error);
+                break;
+            }
+        }
+    }
+    
+    void ResidualDeleter::PushTasks(Batch& batch, Lane& lane, std::vector<DeleteTask> tasks) {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.pending += tasks.size();
+        for (auto& task : tasks) {
+            lane.tasks.push_back(std::move(task));
+        }
+        
+        // 本线程的任务尚未完成，pending不会在此期间归零，新线程可以安全加入
+        if (lane.tasks.size() > s_spawnBacklog && lane.workers.size() < m_threadsPerVolume) {
+            lane.workers.emplace_back(&ResidualDeleter::LaneWorker, this, std::ref(batch), std::ref(lane));
+        }
+        lane.wakeup.notify_all();
+    }
+    
+    DWORD ResidualDeleter::RemoveEntry(Batch& batch, const String& path, DWORD attributes, bool directory) {
+        // 只读属性取自枚举结果，删除前一并清除
+        if ((attributes & FILE_ATTRIBUTE_READONLY) &&
+            m_fileSystem->SetAttributes(path, attributes & ~FILE_ATTRIBUTE_READONLY) == ERROR_SUCCESS) {
+            batch.clearedReadOnly++;
+        }
+        
+        DWORD error = m_fileSystem->RemoveEntry(path, directory);
+        if (error == ERROR_SUCCESS) {
+            (directory ? batch.deletedDirectories : batch.deletedFiles)++;
+        } else if (IsMissing(error)) {
+            error = ERROR_SUCCESS;
+        } else {
+            batch.failedEntries++;
+        }
+        return error;
+    }
+    
+    void ResidualDeleter::CompleteChild(Batch& batch, DirectoryNode* parent, size_t itemIndex, DWORD error) {
+        // 沿上级目录逐层完成：子项全部成功的目录在最后完成的子项所在线程中删除
+        while (parent) {
+            if (error != ERROR_SUCCESS) {
+                DWORD expected = ERROR_SUCCESS;
+                parent->childError.compare_exchange_strong(expected, error);
+            }
+            if (--parent->remaining != 0) {
+                return;
+            }
+            
+            error = parent->childError.load();
+            if (error == ERROR_SUCCESS) {
+                error = RemoveEntry(batch, parent->path, parent->attributes, true);
+            }
+            parent = parent->parent;
+        }
+        batch.FinishItem(itemIndex, error);
+    }
+    
+    void ResidualDeleter::DeleteRegistryItems(Batch& batch, const std::vector<size_t>& itemIndices) {
+        // 先删值，再按路径从深到浅删键：同时选中的父键和子键不会互相干扰
+        std::vector<size_t> order = itemIndices;
+        std::stable_sort(order.begin(), order.end(), [&batch](size_t a, size_t b) {
+            const ResidualItem& first = batch.items[a];
+            const ResidualItem& second = batch.items[b];
+            bool firstIsValue = first.type == ResidualType::RegistryValue;
+            bool secondIsValue = second.type == ResidualType::RegistryValue;
+            if (firstIsValue != secondIsValue) {
+                return firstIsValue;
+            }
+            return CountSeparators(first.path) > CountSeparators(second.path);
+        });
+        
+        auto source = RegistryHelper::GetSource();
+        for (size_t itemIndex : order) {
+            if (batch.IsCancelled()) {
+                break;
+            }
+            
+            const ResidualItem& item = batch.items[itemIndex];
+            HKEY rootKey = nullptr;
+            String subKey;
+            String keyPath;
+            String valueName;
+            LONG error = ERROR_INVALID_PARAMETER;
+            if (RegistryHelper::ParseRegistryPath(item.path, rootKey, subKey) && !subKey.empty()) {
+                if (item.type == ResidualType::RegistryKey) {
+                    DWORD64 deletedKeys = 0;
+                    error = DeleteRegistryTree(*source, rootKey, subKey, deletedKeys);
+                    batch.deletedRegistryKeys += deletedKeys;
+                } else if (SplitValuePath(subKey, item.name, keyPath, valueName)) {
+                    HKEY hKey;
+                    error = source->OpenKey(rootKey, keyPath, KEY_READ | KEY_WRITE, hKey);
+                    if (error == ERROR_SUCCESS) {
+                        error = source->DeleteValue(hKey, valueName);
+                        source->CloseKey(hKey);
+                        if (error == ERROR_SUCCESS) {
+                            batch.deletedRegistryValues++;
+                        }
+                    }
+                }
+            }
+            
+            batch.FinishItem(itemIndex, IsMissing(static_cast<DWORD>(error)) ? ERROR_SUCCESS : static_cast<DWORD>(error));
+        }
+        
+        batch.FinishLane();
+    }
+    
+    // 先序收集子树中的全部键，再逆序删除
+    LONG ResidualDeleter::DeleteRegistryTree(IRegistrySource& source, HKEY rootKey, const String& subKey, DWORD64& deletedKeys) {
+        std::vector<String> keys(1, subKey);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            HKEY hKey;
+            LONG error = source.OpenKey(rootKey, keys[i], KEY_READ, hKey);
+            if (error != ERROR_SUCCESS) {
+                if (i == 0) {
+                    return error;
+                }
+                continue;
+            }
+            
+            String name;
+            for (DWORD index = 0; source.EnumKey(hKey, index, name) == ERROR_SUCCESS; ++index) {
+                keys.push_back(keys[i] + L"\\" + name);
+            }
+            source.CloseKey(hKey);
+        }
+        
+        LONG result = ERROR_SUCCESS;
+        DWORD64 deletedBefore = deletedKeys;
+        for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+            LONG error = source.DeleteKey(rootKey, *it);
+            if (error == ERROR_SUCCESS) {
+                deletedKeys++;
+            } else if (!IsMissing(static_cast<DWORD>(error))) {
+                result = error;
+            } else if (it + 1 == keys.rend() && deletedKeys == deletedBefore && result == ERROR_SUCCESS) {
+                // 整棵子树在枚举之后已被删除
+                result = error;
+            }
+        }
+        return result;
+    }
+    
+    bool ResidualDeleter::SplitValuePath(const String& subKey, const String& name, String& keyPath, String& valueName) {
+        if (!subKey.empty() && subKey.back() == L'\\') {
+            keyPath = subKey.substr(0, subKey.size() - 1);
+            valueName.clear();
+            return !keyPath.empty();
+        }
+        if (name.empty() || subKey.size() <= name.size() || !StringUtils::EndsWith(subKey, L"\\" + name, true)) {
+            return false;
+        }
+        keyPath = subKey.substr(0, subKey.size() - name.size() - 1);
+        valueName = subKey.substr(keyPath.size() + 1);
+        return true;
+    }
+    
+    String ResidualDeleter::GetVolumeKey(const String& path) {
+        String normalized = path;
+        std::replace(normalized.begin(), normalized.end(), L'/', L'\\');
+        if (StringUtils::StartsWith(normalized, L"\\\\?\\UNC\\", true)) {
+            normalized = L"\\\\" + normalized.substr(8);
+        } else if (StringUtils::StartsWith(normalized, L"\\\\?\\")) {
+            normalized = normalized.substr(4);
+        }
+        
+        if (normalized.size() >= 2 && normalized[1] == L':' && std::iswalpha(normalized[0])) {
+            return StringUtils::ToUpper(normalized.substr(0, 2));
+        }
+        if (StringUtils::StartsWith(normalized, L"\\\\")) {
+            size_t serverEnd = normalized.find(L'\\', 2);
+            if (serverEnd == String::npos) {
+                return StringUtils::ToUpper(normalized);
+            }
+            size_t shareEnd = normalized.find(L'\\', serverEnd + 1);
+            return StringUtils::ToUpper(normalized.substr(0, shareEnd));
+        }
+        return String();
+    }
+
+} // namespace YG
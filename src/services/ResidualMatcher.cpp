@@ -0,0 +1,301 @@
+/**
+ * @file ResidualMatcher.cpp
+ * @brief 残留名称多模式匹配的实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "services/ResidualMatcher.h"
+#include <algorithm>
+#include <cwctype>
+#include <limits>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_charClassTableSize = 0x10000;
+        
+        // 各程序通用的文件名、目录名，作为模式会命中大量无关的项
+        const wchar_t* const s_genericNames[] = {
+            L"setup", L"update", L"updater", L"install", L"installer", L"uninstall", L"uninstaller",
+            L"msiexec", L"rundll32", L"bin", L"program files", L"program files (x86)",
+            L"common files", L"programdata", L"appdata", L"windows", L"system32",
+            L"app", L"apps", L"application", L"client", L"current", L"latest", L"launcher",
+            L"x64", L"x86", L"win32", L"win64", L"amd64", L"tools", L"games", L"data",
+            L"common", L"shared", L"runtime", L"plugins"
+        };
+        
+        // 版本号目录："1.2.3"、"v2.0"、"10"
+        bool IsVersionName(const String& folded) {
+            size_t start = !folded.empty() && folded[0] == L'v' ? 1 : 0;
+            if (start == folded.size() || !std::iswdigit(folded[start])) {
+                return false;
+            }
+            for (size_t i = start; i < folded.size(); ++i) {
+                if (!std::iswdigit(folded[i]) && folded[i] != L'.') {
+                    return false;
+                }
+            }
+            return true;
+        }
+        
+        String FoldPattern(const String& text) {
+            String folded = text;
+            for (wchar_t& ch : folded) {
+                ch = static_cast<wchar_t>(std::towlower(ch));
+            }
+            return folded;
+        }
+        
+        bool IsGenericName(const String& folded) {
+            // unins000、uninst等卸载程序名
+            if (folded.compare(0, 5, L"unins") == 0) {
+                return true;
+            }
+            for (const wchar_t* name : s_genericNames) {
+                if (folded == name) {
+                    return true;
+                }
+            }
+            return IsVersionName(folded);
+        }
+        
+        String Trim(const String& text, const wchar_t* characters) {
+            size_t first = text.find_first_not_of(characters);
+            if (first == String::npos) {
+                return String();
+            }
+            size_t last = text.find_last_not_of(characters);
+            return text.substr(first, last - first + 1);
+        }
+    
+    } // namespace
+    
+    ResidualMatcher::ResidualMatcher() : m_classCount(1) {
+    }
+    
+    bool ResidualMatcher::AddPattern(const String& text, ResidualPatternKind kind, std::uint32_t owner) {
+        String trimmed = Trim(text, L" \t\"");
+        if (trimmed.size() < MinPatternLength) {
+            return false;
+        }
+        
+        String folded = FoldPattern(trimmed);
+        if (IsGenericName(folded)) {
+            return false;
+        }
+        
+        // 同一程序的重复模式只保留先加入（更可信）的一个
+        for (size_t i = 0; i < m_patterns.size(); ++i) {
+            if (m_patterns[i].owner == owner && m_foldedPatterns[i] == folded) {
+                return false;
+            }
+        }
+        
+        m_patterns.push_back({ trimmed, kind, owner });
+        m_foldedPatterns.push_back(folded);
+        return true;
+    }
+    
+    void ResidualMatcher::AddProgram(const ProgramInfo& programInfo, std::uint32_t owner) {
+        String name = programInfo.displayName.empty() ? programInfo.name : programInfo.displayName;
+        AddPattern(name, PatternDisplayName, owner);
+        AddPattern(programInfo.name, PatternDisplayName, owner);
+        
+        String compactName = name;
+        compactName.erase(std::remove(compactName.begin(), compactName.end(), L' '), compactName.end());
+        AddPattern(compactName, PatternCompactName, owner);
+        
+        if (!programInfo.installLocation.empty()) {
+            AddPattern(GetFolderLeaf(programInfo.installLocation), PatternInstallFolder, owner);
+        }
+        AddPattern(GetUninstallerStem(programInfo.uninstallString), PatternUninstallerStem, owner);
+        AddPattern(programInfo.publisher, PatternPublisher, owner);
+    }
+    
+    void ResidualMatcher::Build() {
+        // 模式中出现的每个小写字符一类；类表按小写展开，匹配时不再转换大小写
+        std::vector<std::uint16_t> foldedClasses(s_charClassTableSize, 0);
+        m_classCount = 1;
+        for (const String& pattern : m_foldedPatterns) {
+            for (wchar_t ch : pattern) {
+                std::uint16_t& charClass = foldedClasses[static_cast<std::uint16_t>(ch)];
+                if (charClass == 0) {
+                    charClass = static_cast<std::uint16_t>(m_classCount++);
+                }
+            }
+        }
+        m_charClasses.assign(s_charClassTableSize, 0);
+        for (size_t ch = 0; ch < s_charClassTableSize; ++ch) {
+            wchar_t folded = static_cast<wchar_t>(std::towlower(static_cast<wint_t>(ch)));
+            m_charClasses[ch] = foldedClasses[static_cast<std::uint16_t>(folded)];
+        }
+        
+        // 字典树
+        const std::uint32_t none = (std::numeric_limits<std::uint32_t>::max)();
+        m_transitions.assign(m_classCount, none);
+        std::vector<std::vector<std::uint32_t>> outputs(1);
+        for (std::uint32_t i = 0; i < m_foldedPatterns.size(); ++i) {
+            std::uint32_t state = 0;
+            for (wchar_t ch : m_foldedPatterns[i]) {
+                size_t slot = state * m_classCount + foldedClasses[static_cast<std::uint16_t>(ch)];
+                if (m_transitions[slot] == none) {
+                    m_transitions[slot] = static_cast<std::uint32_t>(outputs.size());
+                    m_transitions.resize(m_transitions.size() + m_classCount, none);
+                    outputs.emplace_back();
+                }
+                state = m_transitions[slot];
+            }
+            outputs[state].push_back(i);
+        }
+        
+        // 按层次计算失败转移并填入转移表；后缀状态层次更浅，其输出已经完整
+        std::vector<std::uint32_t> failures(outputs.size(), 0);
+        std::vector<std::uint32_t> queue;
+        queue.reserve(outputs.size());
+        for (std::uint32_t charClass = 0; charClass < m_classCount; ++charClass) {
+            std::uint32_t& next = m_transitions[charClass];
+            if (next == none) {
+                next = 0;
+            } else {
+                queue.push_back(next);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            const std::uint32_t state = queue[head];
+            const std::uint32_t failure = failures[state];
+            outputs[state].insert(outputs[state].end(), outputs[failure].begin(), outputs[failure].end());
+            
+            for (std::uint32_t charClass = 0; charClass < m_classCount; ++charClass) {
+                const size_t slot = state * m_classCount + charClass;
+                const std::uint32_t fallback = m_transitions[failure * m_classCount + charClass];
+                if (m_transitions[slot] == none) {
+                    m_transitions[slot] = fallback;
+                } else {
+                    failures[m_transitions[slot]] = fallback;
+                    queue.push_back(m_transitions[slot]);
+                }
+            }
+        }
+        
+        // 每个状态的输出按可信度排序后展开，FindBest只需看第一个
+        m_outputStarts.assign(1, 0);
+        m_outputs.clear();
+        for (auto& stateOutputs : outputs) {
+            std::sort(stateOutputs.begin(), stateOutputs.end(), [this](std::uint32_t a, std::uint32_t b) {
+                return IsBetter(a, b);
+            });
+            m_outputs.insert(m_outputs.end(), stateOutputs.begin(), stateOutputs.end());
+            m_outputStarts.push_back(static_cast<std::uint32_t>(m_outputs.size()));
+        }
+    }
+    
+    bool ResidualMatcher::IsBetter(std::uint32_t a, std::uint32_t b) const {
+        const ResidualPattern& first = m_patterns[a];
+        const ResidualPattern& second = m_patterns[b];
+        if (IsStrong(first.kind) != IsStrong(second.kind)) {
+            return IsStrong(first.kind);
+        }
+        if (first.text.size() != second.text.size()) {
+            return first.text.size() > second.text.size();
+        }
+        if (first.kind != second.kind) {
+            return first.kind < second.kind;
+        }
+        return a < b;
+    }
+    
+    bool ResidualMatcher::FindBest(std::wstring_view text, ResidualMatch& match) const {
+        if (m_outputStarts.empty()) {
+            return false;
+        }
+        
+        bool found = false;
+        std::uint32_t best = 0;
+        std::uint32_t state = 0;
+        for (wchar_t ch : text) {
+            state = m_transitions[state * m_classCount + m_charClasses[static_cast<std::uint16_t>(ch)]];
+            const std::uint32_t first = m_outputStarts[state];
+            if (first != m_outputStarts[state + 1] && (!found || IsBetter(m_outputs[first], best))) {
+                best = m_outputs[first];
+                found = true;
+            }
+        }
+        
+        if (found) {
+            match.pattern = best;
+            match.kind = m_patterns[best].kind;
+            match.owner = m_patterns[best].owner;
+        }
+        return found;
+    }
+    
+    bool ResidualMatcher::FindAll(std::wstring_view text, std::vector<ResidualMatch>& matches) const {
+        matches.clear();
+        if (m_outputStarts.empty()) {
+            return false;
+        }
+        
+        std::uint32_t state = 0;
+        for (wchar_t ch : text) {
+            state = m_transitions[state * m_classCount + m_charClasses[static_cast<std::uint16_t>(ch)]];
+            for (std::uint32_t i = m_outputStarts[state]; i < m_outputStarts[state + 1]; ++i) {
+                const std::uint32_t pattern = m_outputs[i];
+                
+                // 每个程序只保留最可信的匹配；候选名称很短，匹配数很少，线性查找即可
+                auto it = std::find_if(matches.begin(), matches.end(), [&](const ResidualMatch& match) {
+                    return match.owner == m_patterns[pattern].owner;
+                });
+                if (it == matches.end()) {
+                    matches.push_back({ pattern, m_patterns[pattern].kind, m_patterns[pattern].owner });
+                } else if (IsBetter(pattern, it->pattern)) {
+                    it->pattern = pattern;
+                    it->kind = m_patterns[pattern].kind;
+                }
+            }
+        }
+        
+        std::sort(matches.begin(), matches.end(), [](const ResidualMatch& a, const ResidualMatch& b) {
+            return a.owner < b.owner;
+        });
+        return !matches.empty();
+    }
+    
+    const wchar_t* ResidualMatcher::GetKindName(ResidualPatternKind kind) {
+        switch (kind) {
+            case PatternDisplayName:
+                return L"程序名称";
+            case PatternCompactName:
+                return L"程序名称（去空格）";
+            case PatternInstallFolder:
+                return L"安装目录";
+            case PatternUninstallerStem:
+                return L"卸载程序";
+            case PatternPublisher:
+                return L"发布者";
+            default:
+                return L"未知";
+        }
+    }
+    
+    String ResidualMatcher::GetUninstallerStem(const String& uninstallString) {
+        String folded = FoldPattern(uninstallString);
+        size_t end = folded.find(L".exe");
+        if (end == String::npos || end == 0) {
+            return String();
+        }
+        
+        size_t separator = folded.find_last_of(L"\\/\"", end - 1);
+        size_t start = separator == String::npos ? 0 : separator + 1;
+        return Trim(uninstallString.substr(start, end - start), L" \t");
+    }
+    
+    String ResidualMatcher::GetFolderLeaf(const String& path) {
+        String trimmed = Trim(path, L" \t\"\\/");
+        size_t separator = trimmed.find_last_of(L"\\/");
+        return separator == String::npos ? trimmed : trimmed.substr(separator + 1);
+    }
+
+} // namespace YG
@@ -7,20 +7,62 @@
  */
 
 #include "services/ResidualScanner.h"
+#include "services/ResidualDeleter.h"
+#include "services/QuarantineStore.h"
 #include "core/Logger.h"
 #include "core/ErrorHandler.h"
 #include "utils/StringUtils.h"
 #include "utils/RegistryHelper.h"
 #include <shlobj.h>
 #include <algorithm>
+#include <cwchar>
 #include <regex>
+#include <future>
+#include <unordered_set>
 
 namespace YG {
     
+    namespace {
+        
+        // 扫描单元以磁盘和注册表I/O为主，线程数不必超过单元数
+        const size_t s_maxScanThreads = 4;
+        
+        // 注册表子树的搜索深度（扫描位置的子键为1）：默认到"厂商\产品"一级，深度扫描时更深
+        const int s_registryDepth = 2;
+        const int s_deepRegistryDepth = 6;
+        
+        // 每个注册表位置最多报告的命中数
+        const size_t s_maxRegistryHits = 500;
+        
+        // 多个程序共用的注册表位置，值数据中出现安装路径不代表该值属于被卸载的程序
+        const wchar_t* const s_sharedRegistryPrefixes[] = {
+            L"Software\\Microsoft",
+            L"Software\\Classes",
+            L"Software\\WOW6432Node\\Microsoft",
+            L"Software\\WOW6432Node\\Classes"
+        };
+        
+        bool IsSharedRegistryLocation(HKEY rootKey, const String& keyPath) {
+            if (rootKey == HKEY_CLASSES_ROOT) {
+                return true;
+            }
+            for (const wchar_t* prefix : s_sharedRegistryPrefixes) {
+                size_t length = std::wcslen(prefix);
+                if (StringUtils::StartsWith(keyPath, prefix, true) &&
+                    (keyPath.size() == length || keyPath[length] == L'\\')) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        
+    } // namespace
+    
     ResidualScanner::ResidualScanner() 
         : m_isScanning(false), m_shouldStop(false),
           m_scanFiles(true), m_scanRegistry(true), m_scanShortcuts(true),
           m_scanServices(false), m_deepScan(false) {
+        m_pool = YG::MakeUnique<ThreadPool>((std::min)(ThreadPool::DefaultThreadCount(), s_maxScanThreads));
         YG_LOG_INFO(L"残留扫描器已创建");
     }
     
@@ -30,11 +72,24 @@ namespace YG {
     }
     
     ErrorCode ResidualScanner::StartScan(const ProgramInfo& programInfo, ScanProgressCallback progressCallback) {
+        return StartBatchScan(std::vector<ProgramInfo>(1, programInfo), progressCallback);
+    }
+    
+    ErrorCode ResidualScanner::StartBatchScan(const std::vector<ProgramInfo>& programs, ScanProgressCallback progressCallback) {
+        if (programs.empty()) {
+            return ErrorCode::InvalidParameter;
+        }
+        
         if (m_isScanning.load()) {
             YG_LOG_WARNING(L"扫描已在进行中");
             return ErrorCode::InvalidOperation;
         }
         
+        // 上一次扫描已自行结束时，回收其线程
+        if (m_scanThread && m_scanThread->joinable()) {
+            m_scanThread->join();
+        }
+        
         m_progressCallback = progressCallback;
         m_shouldStop.store(false);
         m_isScanning.store(true);
@@ -44,28 +99,33 @@ namespace YG {
             std::lock_guard<std::mutex> lock(m_resultsMutex);
             m_scanResults.clear();
         }
+        m_scanPrograms = programs;
         
-        YG_LOG_INFO(L"开始扫描程序残留: " + programInfo.name);
+        if (programs.size() == 1) {
+            YG_LOG_INFO(L"开始扫描程序残留: " + programs[0].name);
+        } else {
+            YG_LOG_INFO(L"开始批量扫描程序残留，程序数: " + std::to_wstring(programs.size()));
+        }
         
         // 启动扫描线程
-        m_scanThread = YG::MakeUnique<std::thread>(&ResidualScanner::ScanWorkerThread, this, programInfo);
+        m_scanThread = YG::MakeUnique<std::thread>(&ResidualScanner::ScanWorkerThread, this, programs);
         
         return ErrorCode::Success;
     }
     
     void ResidualScanner::StopScan() {
-        if (!m_isScanning.load()) {
-            return;
-        }
-        
+        bool wasScanning = m_isScanning.load();
         m_shouldStop.store(true);
         
+        // 扫描已自行结束时线程仍需回收
         if (m_scanThread && m_scanThread->joinable()) {
             m_scanThread->join();
         }
         
         m_isScanning.store(false);
-        YG_LOG_INFO(L"残留扫描已停止");
+        if (wasScanning) {
+            YG_LOG_INFO(L"残留扫描已停止");
+        }
     }
     
     bool ResidualScanner::IsScanning() const {
@@ -77,6 +137,27 @@ namespace YG {
         return m_scanResults;
     }
     
+    std::vector<ResidualGroup> ResidualScanner::GetProgramScanResults(size_t programIndex) const {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        std::vector<ResidualGroup> results;
+        for (const auto& group : m_scanResults) {
+            ResidualGroup programGroup(group.groupName, group.groupDescription, group.groupType);
+            for (const auto& item : group.items) {
+                if (item.programIndex == programIndex) {
+                    programGroup.items.push_back(item);
+                    programGroup.totalSize += item.size;
+                    if (item.isSelected) {
+                        programGroup.selectedCount++;
+                    }
+                }
+            }
+            if (!programGroup.items.empty()) {
+                results.push_back(std::move(programGroup));
+            }
+        }
+        return results;
+    }
+    
     void ResidualScanner::SetScanOptions(bool scanFiles, bool scanRegistry, bool scanShortcuts, 
                                         bool scanServices, bool deepScan) {
         m_scanFiles = scanFiles;
@@ -88,46 +169,32 @@ namespace YG {
         YG_LOG_INFO(L"扫描选项已更新");
     }
     
-    void ResidualScanner::ScanWorkerThread(const ProgramInfo& programInfo) {
+    void ResidualScanner::ScanWorkerThread(const std::vector<ProgramInfo>& programs) {
         YG_LOG_INFO(L"扫描工作线程开始");
         
         try {
-            std::vector<ResidualGroup> results;
-            int totalSteps = 0;
-            int currentStep = 0;
-            
-            // 计算总步骤数
-            if (m_scanFiles) totalSteps += 3;      // 文件系统扫描（AppData, ProgramData, Temp）
-            if (m_scanRegistry) totalSteps += 2;   // 注册表扫描（HKLM, HKCU）
-            if (m_scanShortcuts) totalSteps += 2;  // 快捷方式扫描（桌面, 开始菜单）
-            if (m_scanServices) totalSteps += 1;   // 服务扫描
-            
-            // 文件系统扫描
-            if (m_scanFiles && !m_shouldStop.load()) {
-                UpdateProgress((currentStep * 100) / totalSteps, L"扫描用户数据目录...", 0);
-                ScanFileSystemResiduals(programInfo, results);
-                currentStep += 3;
+            // 各阶段拆分为互不依赖的扫描单元，在线程池中并发执行；
+            // 全部程序共用一个匹配器，每个位置只遍历一次
+            ResidualMatcherPtr matcher = BuildMatcher(programs);
+            std::vector<ScanUnit> units;
+            if (m_scanFiles) {
+                AddFileSystemScanUnits(matcher, units);
             }
-            
-            // 注册表扫描
-            if (m_scanRegistry && !m_shouldStop.load()) {
-                UpdateProgress((currentStep * 100) / totalSteps, L"扫描注册表残留...", 0);
-                ScanRegistryResiduals(programInfo, results);
-                currentStep += 2;
+            if (m_scanRegistry) {
+                AddRegistryScanUnits(matcher, units);
             }
-            
-            // 快捷方式扫描
-            if (m_scanShortcuts && !m_shouldStop.load()) {
-                UpdateProgress((currentStep * 100) / totalSteps, L"扫描快捷方式残留...", 0);
-                ScanShortcutResiduals(programInfo, results);
-                currentStep += 2;
+            if (m_scanShortcuts) {
+                AddShortcutScanUnits(matcher, units);
             }
+            // 服务项既不能删除也不能隔离，m_scanServices不增加扫描单元
+            
+            UpdateProgress(0, L"开始扫描残留...", 0);
+            std::vector<ResidualGroup> results = RunScanUnits(units);
             
-            // 服务扫描
-            if (m_scanServices && !m_shouldStop.load()) {
-                UpdateProgress((currentStep * 100) / totalSteps, L"扫描系统服务...", 0);
-                ScanServiceResiduals(programInfo, results);
-                currentStep += 1;
+            // 计算总的残留项数量
+            int totalFound = 0;
+            for (const auto& group : results) {
+                totalFound += static_cast<int>(group.items.size());
             }
             
             // 保存结果
@@ -136,15 +203,10 @@ namespace YG {
                 m_scanResults = std::move(results);
             }
             
-            // 计算总的残留项数量
-            int totalFound = 0;
-            for (const auto& group : m_scanResults) {
-                totalFound += static_cast<int>(group.items.size());
-            }
-            
             UpdateProgress(100, L"扫描完成", totalFound);
             
         } catch (const std::exception& e) {
+            (void)e;
             YG_LOG_ERROR(L"扫描过程中发生异常");
             UpdateProgress(100, L"扫描出错", 0);
         }
@@ -153,85 +215,124 @@ namespace YG {
         YG_LOG_INFO(L"扫描工作线程结束");
     }
     
-    void ResidualScanner::ScanFileSystemResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results) {
-        YG_LOG_INFO(L"开始扫描文件系统残留");
-        
-        // 生成搜索模式
-        std::vector<String> searchPatterns = GenerateSearchPatterns(programInfo);
+    std::vector<ResidualGroup> ResidualScanner::RunScanUnits(const std::vector<ScanUnit>& units) {
+        const size_t totalUnits = units.size();
+        std::vector<std::vector<ResidualItem>> unitResults(totalUnits);
+        std::atomic<size_t> completedUnits(0);
+        std::atomic<int> foundCount(0);
+        
+        std::vector<std::future<void>> futures;
+        futures.reserve(totalUnits);
+        for (size_t i = 0; i < totalUnits; ++i) {
+            futures.push_back(m_pool->Submit([this, &units, &unitResults, &completedUnits, &foundCount, totalUnits, i]() {
+                if (!m_shouldStop.load()) {
+                    try {
+                        units[i].run(unitResults[i]);
+                    } catch (const std::exception& e) {
+                        (void)e;
+                        YG_LOG_ERROR(L"扫描单元发生异常: " + units[i].description);
+                    }
+                }
         
-        // 创建文件系统残留分组
-        ResidualGroup filesGroup(L"文件和文件夹", L"程序相关的文件和目录", ResidualType::File);
-        ResidualGroup cacheGroup(L"缓存文件", L"程序缓存和临时文件", ResidualType::Cache);
-        ResidualGroup configGroup(L"配置文件", L"程序配置和设置文件", ResidualType::Config);
+                // 进度按完成的单元计算，100%留到合并完成后报告
+                int found = foundCount.fetch_add(static_cast<int>(unitResults[i].size())) +
+                            static_cast<int>(unitResults[i].size());
+                size_t completed = completedUnits.fetch_add(1) + 1;
+                UpdateProgress(static_cast<int>(completed * 99 / totalUnits), L"已完成: " + units[i].description, found);
+            }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
         
-        // 扫描用户数据目录
-        if (!m_shouldStop.load()) {
-            UpdateProgress(10, L"扫描用户数据目录...", 0);
-            
-            wchar_t appDataPath[MAX_PATH];
-            if (SHGetFolderPathW(nullptr, CSIDL_APPDATA, nullptr, SHGFP_TYPE_CURRENT, appDataPath) == S_OK) {
-                ScanDirectoryForResiduals(appDataPath, programInfo.name, searchPatterns, filesGroup.items);
-            }
-            
-            wchar_t localAppDataPath[MAX_PATH];
-            if (SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA, nullptr, SHGFP_TYPE_CURRENT, localAppDataPath) == S_OK) {
-                ScanDirectoryForResiduals(localAppDataPath, programInfo.name, searchPatterns, cacheGroup.items);
+        // 按单元顺序合并，结果顺序与并发完成的先后无关；扫描位置互相包含（如深度扫描时Software与Run），同一路径只保留先出现的一项
+        std::vector<ResidualGroup> groups = {
+            ResidualGroup(L"文件和文件夹", L"程序相关的文件和目录", ResidualType::File),
+            ResidualGroup(L"缓存文件", L"程序缓存和临时文件", ResidualType::Cache),
+            ResidualGroup(L"配置文件", L"程序配置和设置文件", ResidualType::Config),
+            ResidualGroup(L"注册表项", L"程序相关的注册表键和值", ResidualType::RegistryKey),
+            ResidualGroup(L"快捷方式", L"桌面和开始菜单中的快捷方式", ResidualType::Shortcut),
+            ResidualGroup(L"系统服务", L"程序注册的Windows服务", ResidualType::Service)
+        };
+        std::unordered_set<String> seenPaths;
+        for (size_t i = 0; i < totalUnits; ++i) {
+            std::vector<ResidualItem>& items = groups[units[i].group].items;
+            for (auto& item : unitResults[i]) {
+                if (seenPaths.insert(StringUtils::ToLower(item.path)).second) {
+                    items.push_back(std::move(item));
+                }
             }
         }
-        
-        // 扫描公共数据目录
-        if (!m_shouldStop.load()) {
-            UpdateProgress(20, L"扫描公共数据目录...", 0);
             
-            wchar_t programDataPath[MAX_PATH];
-            if (SHGetFolderPathW(nullptr, CSIDL_COMMON_APPDATA, nullptr, SHGFP_TYPE_CURRENT, programDataPath) == S_OK) {
-                ScanDirectoryForResiduals(programDataPath, programInfo.name, searchPatterns, configGroup.items);
+        // 添加非空的分组到结果
+        std::vector<ResidualGroup> results;
+        for (auto& group : groups) {
+            if (group.items.empty()) {
+                continue;
             }
+            for (const auto& item : group.items) {
+                group.totalSize += item.size;
+                if (item.isSelected) {
+                    group.selectedCount++;
+                }
+            }
+            results.push_back(std::move(group));
         }
-        
-        // 扫描临时目录
-        if (!m_shouldStop.load()) {
-            UpdateProgress(30, L"扫描临时目录...", 0);
             
-            wchar_t tempPath[MAX_PATH];
-            if (::GetTempPathW(MAX_PATH, tempPath) > 0) {
-                ScanDirectoryForResiduals(tempPath, programInfo.name, searchPatterns, cacheGroup.items);
-            }
+        YG_LOG_INFO(L"残留扫描单元全部完成，单元数: " + std::to_wstring(totalUnits));
+        return results;
+    }
+    
+    ResidualMatcherPtr ResidualScanner::BuildMatcher(const std::vector<ProgramInfo>& programs) {
+        auto matcher = std::make_shared<ResidualMatcher>();
+        for (size_t i = 0; i < programs.size(); ++i) {
+            matcher->AddProgram(programs[i], static_cast<std::uint32_t>(i));
         }
+        matcher->Build();
+        YG_LOG_INFO(L"残留匹配模式数: " + std::to_wstring(matcher->GetPatterns().size()));
+        return matcher;
+    }
         
-        // 添加非空的分组到结果
-        if (!filesGroup.items.empty()) {
-            filesGroup.selectedCount = static_cast<int>(filesGroup.items.size());
-            for (const auto& item : filesGroup.items) {
-                filesGroup.totalSize += item.size;
-            }
-            results.push_back(std::move(filesGroup));
-        }
+    void ResidualScanner::AddFileSystemScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units) {
+        struct FileRoot {
+            int csidl;
+            const wchar_t* description;
+            ResultGroup group;
+        };
+        const FileRoot roots[] = {
+            { CSIDL_APPDATA, L"用户数据目录", FilesGroup },
+            { CSIDL_LOCAL_APPDATA, L"本地数据目录", CacheGroup },
+            { CSIDL_COMMON_APPDATA, L"公共数据目录", ConfigGroup }
+        };
         
-        if (!cacheGroup.items.empty()) {
-            cacheGroup.selectedCount = static_cast<int>(cacheGroup.items.size());
-            for (const auto& item : cacheGroup.items) {
-                cacheGroup.totalSize += item.size;
+        std::vector<std::pair<String, const FileRoot*>> directories;
+        for (const auto& root : roots) {
+            wchar_t path[MAX_PATH];
+            if (SHGetFolderPathW(nullptr, root.csidl, nullptr, SHGFP_TYPE_CURRENT, path) == S_OK) {
+                directories.emplace_back(path, &root);
             }
-            results.push_back(std::move(cacheGroup));
         }
         
-        if (!configGroup.items.empty()) {
-            configGroup.selectedCount = static_cast<int>(configGroup.items.size());
-            for (const auto& item : configGroup.items) {
-                configGroup.totalSize += item.size;
-            }
-            results.push_back(std::move(configGroup));
+        for (const auto& directory : directories) {
+            String path = directory.first;
+            units.push_back({ String(directory.second->description) + L": " + path, directory.second->group,
+                [this, path, matcher](std::vector<ResidualItem>& items) {
+                    ScanDirectoryForResiduals(path, *matcher, items);
+                } });
         }
         
-        YG_LOG_INFO(L"文件系统扫描完成");
+        // 临时目录
+        wchar_t tempPath[MAX_PATH];
+        if (::GetTempPathW(MAX_PATH, tempPath) > 0) {
+            String path = tempPath;
+            units.push_back({ L"临时目录: " + path, CacheGroup,
+                [this, path, matcher](std::vector<ResidualItem>& items) {
+                    ScanDirectoryForResiduals(path, *matcher, items);
+                } });
+        }
     }
     
-    void ResidualScanner::ScanRegistryResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results) {
-        YG_LOG_INFO(L"开始扫描注册表残留");
-        
-        ResidualGroup registryGroup(L"注册表项", L"程序相关的注册表键和值", ResidualType::RegistryKey);
-        
+    void ResidualScanner::AddRegistryScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units) {
         // 扫描常见的注册表位置
         std::vector<std::pair<HKEY, String>> registryPaths = {
             {HKEY_CURRENT_USER, L"Software"},
@@ -242,66 +343,39 @@ namespace YG {
         };
         
         for (const auto& regPath : registryPaths) {
-            if (m_shouldStop.load()) break;
-            
-            UpdateProgress(50, L"扫描注册表: " + regPath.second, 0);
-            ScanRegistryKey(regPath.first, regPath.second, programInfo.name, registryGroup.items);
+            HKEY rootKey = regPath.first;
+            String keyPath = regPath.second;
+            units.push_back({ L"注册表: " + keyPath, RegistryGroup,
+                [this, rootKey, keyPath, matcher](std::vector<ResidualItem>& items) {
+                    ScanRegistryKey(rootKey, keyPath, *matcher, items);
+                } });
         }
-        
-        if (!registryGroup.items.empty()) {
-            registryGroup.selectedCount = static_cast<int>(registryGroup.items.size());
-            results.push_back(std::move(registryGroup));
-        }
-        
-        YG_LOG_INFO(L"注册表扫描完成");
     }
     
-    void ResidualScanner::ScanShortcutResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results) {
-        YG_LOG_INFO(L"开始扫描快捷方式残留");
-        
-        ResidualGroup shortcutGroup(L"快捷方式", L"桌面和开始菜单中的快捷方式", ResidualType::Shortcut);
-        
-        // 扫描桌面
-        if (!m_shouldStop.load()) {
-            UpdateProgress(70, L"扫描桌面快捷方式...", 0);
-            
-            wchar_t desktopPath[MAX_PATH];
-            if (SHGetFolderPathW(nullptr, CSIDL_DESKTOP, nullptr, SHGFP_TYPE_CURRENT, desktopPath) == S_OK) {
-                std::vector<String> shortcutPatterns = {L"*" + programInfo.name + L"*.lnk"};
-                ScanDirectoryForResiduals(desktopPath, programInfo.name, shortcutPatterns, shortcutGroup.items);
-            }
-        }
+    void ResidualScanner::AddShortcutScanUnits(const ResidualMatcherPtr& matcher, std::vector<ScanUnit>& units) {
+        struct ShortcutRoot {
+            int csidl;
+            const wchar_t* description;
+        };
+        const ShortcutRoot roots[] = {
+            { CSIDL_DESKTOP, L"桌面快捷方式" },
+            { CSIDL_PROGRAMS, L"开始菜单" }
+        };
         
-        // 扫描开始菜单
-        if (!m_shouldStop.load()) {
-            UpdateProgress(80, L"扫描开始菜单...", 0);
-            
-            wchar_t startMenuPath[MAX_PATH];
-            if (SHGetFolderPathW(nullptr, CSIDL_PROGRAMS, nullptr, SHGFP_TYPE_CURRENT, startMenuPath) == S_OK) {
-                std::vector<String> shortcutPatterns = {L"*" + programInfo.name + L"*.lnk"};
-                ScanDirectoryForResiduals(startMenuPath, programInfo.name, shortcutPatterns, shortcutGroup.items);
+        for (const auto& root : roots) {
+            wchar_t path[MAX_PATH];
+            if (SHGetFolderPathW(nullptr, root.csidl, nullptr, SHGFP_TYPE_CURRENT, path) != S_OK) {
+                continue;
             }
+            String directory = path;
+            units.push_back({ String(root.description) + L": " + directory, ShortcutGroup,
+                [this, directory, matcher](std::vector<ResidualItem>& items) {
+                    ScanDirectoryForResiduals(directory, *matcher, items);
+                } });
         }
-        
-        if (!shortcutGroup.items.empty()) {
-            shortcutGroup.selectedCount = static_cast<int>(shortcutGroup.items.size());
-            results.push_back(std::move(shortcutGroup));
-        }
-        
-        YG_LOG_INFO(L"快捷方式扫描完成");
     }
     
-    void ResidualScanner::ScanServiceResiduals(const ProgramInfo& programInfo, std::vector<ResidualGroup>& results) {
-        YG_LOG_INFO(L"开始扫描服务残留");
-        
-        // TODO: 实现服务扫描逻辑
-        // 这里可以扫描与程序相关的Windows服务
-        
-        YG_LOG_INFO(L"服务扫描完成");
-    }
-    
-    void ResidualScanner::ScanDirectoryForResiduals(const String& directory, const String& programName,
-                                                   const std::vector<String>& searchPatterns,
+    void ResidualScanner::ScanDirectoryForResiduals(const String& directory, const ResidualMatcher& matcher,
                                                    std::vector<ResidualItem>& results) {
         if (m_shouldStop.load()) return;
         
@@ -316,30 +390,23 @@ namespace YG {
         do {
             if (m_shouldStop.load()) break;
             
-            String fileName = findData.cFileName;
-            String fullPath = directory + L"\\" + fileName;
+            std::wstring_view fileName = findData.cFileName;
             
             // 跳过 . 和 ..
             if (fileName == L"." || fileName == L"..") {
                 continue;
             }
             
-            // 检查是否匹配搜索模式
-            bool matches = false;
-            String lowerFileName = fileName;
-            String lowerProgramName = programName;
-            std::transform(lowerFileName.begin(), lowerFileName.end(), lowerFileName.begin(), ::towlower);
-            std::transform(lowerProgramName.begin(), lowerProgramName.end(), lowerProgramName.begin(), ::towlower);
-            
-            // 简单的名称匹配
-            if (lowerFileName.find(lowerProgramName) != String::npos) {
-                matches = true;
-            }
+            // 检查是否匹配搜索模式，未命中的项不生成路径
+            ResidualMatch match;
+            bool matches = matcher.FindBest(fileName, match);
+            String fullPath;
             
             if (matches) {
+                fullPath = directory + L"\\" + findData.cFileName;
                 ResidualItem item;
                 item.path = fullPath;
-                item.name = fileName;
+                item.name = findData.cFileName;
                 item.type = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? 
                            ResidualType::Directory : ResidualType::File;
                 
@@ -352,7 +419,7 @@ namespace YG {
                 }
                 
                 // 评估风险级别
-                item.riskLevel = EvaluateRiskLevel(item);
+                ApplyMatch(matcher, match, item);
                 
                 // 格式化最后修改时间
                 SYSTEMTIME sysTime;
@@ -369,7 +436,7 @@ namespace YG {
             
             // 如果是目录且启用深度扫描，递归扫描
             if (matches && (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) && m_deepScan) {
-                ScanDirectoryForResiduals(fullPath, programName, searchPatterns, results);
+                ScanDirectoryForResiduals(fullPath, matcher, results);
             }
             
         } while (FindNextFileW(hFind, &findData) && !m_shouldStop.load());
@@ -377,75 +444,94 @@ namespace YG {
         FindClose(hFind);
     }
     
-    void ResidualScanner::ScanRegistryKey(HKEY rootKey, const String& keyPath, const String& programName,
+    void ResidualScanner::ScanRegistryKey(HKEY rootKey, const String& keyPath, const ResidualMatcher& matcher,
                                         std::vector<ResidualItem>& results) {
         if (m_shouldStop.load()) return;
         
-        HKEY hKey;
-        if (RegOpenKeyExW(rootKey, keyPath.c_str(), 0, KEY_READ, &hKey) != ERROR_SUCCESS) {
-            return;
-        }
-        
-        // 枚举子键
-        DWORD index = 0;
-        wchar_t subKeyName[256];
-        DWORD subKeyNameSize;
-        
-        while (!m_shouldStop.load()) {
-            subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
-            
-            if (RegEnumKeyExW(hKey, index, subKeyName, &subKeyNameSize,
-                             nullptr, nullptr, nullptr, nullptr) != ERROR_SUCCESS) {
-                break;
+        // 子树中的键名称、值名称和字符串数据（多为安装路径）都参与匹配；命中的键整体作为一项，不再进入
+        RegistrySearchOptions options;
+        options.targets = RegistrySearchAll;
+        options.maxDepth = m_deepScan ? s_deepRegistryDepth : s_registryDepth;
+        options.maxResults = s_maxRegistryHits;
+        options.skipMatchedSubtrees = true;
+        options.cancelFlag = &m_shouldStop;
+        
+        auto textMatcher = [&matcher](std::wstring_view text, std::uint32_t& pattern) {
+            ResidualMatch match;
+            if (!matcher.FindBest(text, match)) {
+                return false;
             }
+            pattern = match.pattern;
+            return true;
+        };
+        
+        RegistryHelper::SearchTree(rootKey, keyPath, textMatcher, options,
+            [&](const RegistrySearchHit& hit) {
+                const ResidualPattern& pattern = matcher.GetPatterns()[hit.pattern];
             
-            // 检查是否与程序名称相关
-            String lowerSubKeyName = subKeyName;
-            String lowerProgramName = programName;
-            std::transform(lowerSubKeyName.begin(), lowerSubKeyName.end(), lowerSubKeyName.begin(), ::towlower);
-            std::transform(lowerProgramName.begin(), lowerProgramName.end(), lowerProgramName.begin(), ::towlower);
-            
-            if (lowerSubKeyName.find(lowerProgramName) != String::npos) {
+                // 发布者名称在值名称和值数据中随处可见，值不接受只命中发布者的匹配
+                if (hit.target != RegistrySearchKeyName && pattern.kind == PatternPublisher) {
+                    return true;
+                }
+                
+                ResidualMatch match;
+                match.pattern = hit.pattern;
+                match.kind = pattern.kind;
+                match.owner = pattern.owner;
+                
                 ResidualItem item;
-                item.path = keyPath + L"\\" + subKeyName;
-                item.name = subKeyName;
-                item.type = ResidualType::RegistryKey;
-                item.riskLevel = EvaluateRiskLevel(item);
+                String keyFullPath = RegistryHelper::FormatRegistryPath(rootKey, hit.keyPath);
+                if (hit.target == RegistrySearchKeyName) {
+                    item.path = keyFullPath;
+                    item.name = hit.keyPath.substr(hit.keyPath.find_last_of(L'\\') + 1);
+                    item.type = ResidualType::RegistryKey;
+                } else {
+                    // 值的路径为"键路径\\值名称"，默认值的路径以"\\"结尾
+                    item.path = keyFullPath + L"\\" + hit.valueName;
+                    item.name = hit.valueName.empty() ? String(L"(默认)") : hit.valueName;
+                    item.type = ResidualType::RegistryValue;
+                }
                 item.size = 0; // 注册表项没有大小概念
+                ApplyMatch(matcher, match, item);
+                
+                // 共用位置中的值只是引用了安装路径（文件关联、MUI缓存等），交由用户确认
+                if (hit.target == RegistrySearchValueData && IsSharedRegistryLocation(rootKey, hit.keyPath)) {
+                    item.isSelected = false;
+                    item.riskLevel = std::max(item.riskLevel, RiskLevel::Medium);
+                }
                 
                 results.push_back(item);
-            }
-            
-            index++;
+                return true;
+            });
+    }
+    
+    void ResidualScanner::ApplyMatch(const ResidualMatcher& matcher, const ResidualMatch& match, ResidualItem& item) {
+        const ResidualPattern& pattern = matcher.GetPatterns()[match.pattern];
+        
+        // 批量扫描时按命中的模式归属到对应的程序
+        item.programIndex = match.owner;
+        if (m_scanPrograms.size() > 1 && match.owner < m_scanPrograms.size()) {
+            const ProgramInfo& owner = m_scanPrograms[match.owner];
+            item.category = owner.displayName.empty() ? owner.name : owner.displayName;
         }
+        item.description = String(L"匹配") + ResidualMatcher::GetKindName(match.kind) + L": " + pattern.text;
+        item.riskLevel = EvaluateRiskLevel(item, match);
         
-        RegCloseKey(hKey);
+        // 弱匹配交由用户确认
+        item.isSelected = ResidualMatcher::IsStrong(match.kind);
     }
     
-    std::vector<String> ResidualScanner::GenerateSearchPatterns(const ProgramInfo& programInfo) {
-        std::vector<String> patterns;
-        
-        // 基于程序名称生成模式
-        String programName = programInfo.displayName.empty() ? programInfo.name : programInfo.displayName;
-        
-        patterns.push_back(programName);
-        
-        // 如果程序名称包含空格，也搜索去掉空格的版本
-        String nameWithoutSpaces = programName;
-        nameWithoutSpaces.erase(std::remove(nameWithoutSpaces.begin(), nameWithoutSpaces.end(), L' '), nameWithoutSpaces.end());
-        if (nameWithoutSpaces != programName) {
-            patterns.push_back(nameWithoutSpaces);
-        }
+    RiskLevel ResidualScanner::EvaluateRiskLevel(const ResidualItem& item, const ResidualMatch& match) {
+        RiskLevel pathRisk = EvaluatePathRisk(item);
         
-        // 基于发布者生成模式
-        if (!programInfo.publisher.empty()) {
-            patterns.push_back(programInfo.publisher);
+        // 弱匹配的项可能属于同一发布者的其他程序，或只是名称中含有常见的目录名
+        if (!ResidualMatcher::IsStrong(match.kind) && pathRisk < RiskLevel::Medium) {
+            return RiskLevel::Medium;
         }
-        
-        return patterns;
+        return pathRisk;
     }
     
-    RiskLevel ResidualScanner::EvaluateRiskLevel(const ResidualItem& item) {
+    RiskLevel ResidualScanner::EvaluatePathRisk(const ResidualItem& item) {
         String lowerPath = item.path;
         std::transform(lowerPath.begin(), lowerPath.end(), lowerPath.begin(), ::towlower);
         
@@ -473,6 +559,7 @@ namespace YG {
     }
     
     void ResidualScanner::UpdateProgress(int percentage, const String& currentPath, int foundCount) {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
         if (m_progressCallback) {
             m_progressCallback(percentage, currentPath, foundCount);
         }
@@ -482,46 +569,30 @@ namespace YG {
                                                   DeleteProgressCallback deleteCallback) {
         YG_LOG_INFO(L"开始删除残留项，数量: " + std::to_wstring(items.size()));
         
-        int totalItems = static_cast<int>(items.size());
-        int deletedItems = 0;
+        ResidualDeleter deleter;
+        ResidualDeleteResult result;
+        ErrorCode errorCode = deleter.Delete(items, deleteCallback, result);
+        
+        YG_LOG_INFO(L"残留项删除完成，成功: " + std::to_wstring(result.deletedItems) +
+                    L"，失败: " + std::to_wstring(result.failedItems) +
+                    L"，文件: " + std::to_wstring(result.deletedFiles) +
+                    L"，目录: " + std::to_wstring(result.deletedDirectories) +
+                    L"，注册表键: " + std::to_wstring(result.deletedRegistryKeys) +
+                    L"，注册表值: " + std::to_wstring(result.deletedRegistryValues));
+        return errorCode;
+    }
+    
+    ErrorCode ResidualScanner::QuarantineResidualItems(const std::vector<ResidualItem>& items, const String& label,
+                                                      DeleteProgressCallback deleteCallback) {
+        YG_LOG_INFO(L"开始隔离残留项，数量: " + std::to_wstring(items.size()));
         
-        for (const auto& item : items) {
-            if (deleteCallback) {
-                deleteCallback((deletedItems * 100) / totalItems, item.path, false);
-            }
-            
-            bool success = false;
-            
-            try {
-                if (item.type == ResidualType::File) {
-                    success = (DeleteFileW(item.path.c_str()) != 0);
-                } else if (item.type == ResidualType::Directory) {
-                    success = (RemoveDirectoryW(item.path.c_str()) != 0);
-                } else if (item.type == ResidualType::RegistryKey) {
-                    // TODO: 实现注册表删除
-                    success = true; // 暂时标记为成功
-                }
-                
-                if (success) {
-                    YG_LOG_INFO(L"成功删除: " + item.path);
-                } else {
-                    YG_LOG_WARNING(L"删除失败: " + item.path);
-                }
-                
-            } catch (...) {
-                YG_LOG_ERROR(L"删除异常: " + item.path);
-                success = false;
-            }
-            
-            deletedItems++;
-            
-            if (deleteCallback) {
-                deleteCallback((deletedItems * 100) / totalItems, item.path, success);
-            }
-        }
+        QuarantineBatch batch;
+        ErrorCode errorCode = QuarantineStore::GetShared().Quarantine(items, label, deleteCallback, batch);
         
-        YG_LOG_INFO(L"残留项删除完成");
-        return ErrorCode::Success;
+        YG_LOG_INFO(L"残留项隔离完成，隔离: " + std::to_wstring(batch.entries.size()) +
+                    L"，大小: " + StringUtils::FormatFileSize(batch.GetTotalSize()) +
+                    L"，批次: " + batch.id);
+        return errorCode;
     }
-    
+
 } // namespace YG
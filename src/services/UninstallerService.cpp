@@ -8,7 +8,9 @@
 
 #include "services/UninstallerService.h"
 #include "services/ResidualScanner.h"
+#include "services/QuarantineStore.h"
 #include "core/Logger.h"
+#include "utils/RegistryHelper.h"
 #include <windows.h>
 #include <shellapi.h>
 #include <shlobj.h>
@@ -16,6 +18,21 @@
 
 namespace YG {
     
+    namespace {
+        
+        ResidualItem MakeInstallLocationItem(const ProgramInfo& program) {
+            // 去掉末尾的分隔符，改名时路径指向目录本身
+            String path = program.installLocation;
+            while (path.size() > 3 && (path.back() == L'\\' || path.back() == L'/')) {
+                path.pop_back();
+            }
+            ResidualItem item(path, program.name, ResidualType::Directory, RiskLevel::Medium);
+            item.size = program.estimatedSize;
+            return item;
+        }
+    
+    } // namespace
+    
     UninstallerService::UninstallerService() {
         YG_LOG_INFO(L"卸载服务已创建");
     }
@@ -185,24 +202,12 @@ namespace YG {
         
         YG_LOG_WARNING(L"标准卸载失败，开始强制清理");
         
-        // 强制删除安装目录
+        // 安装目录移入隔离区
+        std::vector<ResidualItem> items;
         if (!program.installLocation.empty()) {
-            YG_LOG_INFO(L"删除安装目录: " + program.installLocation);
-            
-            SHFILEOPSTRUCTW fileOp = {};
-            fileOp.wFunc = FO_DELETE;
-            fileOp.fFlags = FOF_ALLOWUNDO | FOF_NOCONFIRMATION | FOF_SILENT;
-            
-            std::wstring pathToDelete = program.installLocation + L"\0";
-            fileOp.pFrom = pathToDelete.c_str();
-            
-            int result = SHFileOperationW(&fileOp);
-            if (result == 0) {
-                YG_LOG_INFO(L"安装目录删除成功");
-            } else {
-                YG_LOG_WARNING(L"安装目录删除失败，错误代码: " + std::to_wstring(result));
-            }
+            items.push_back(MakeInstallLocationItem(program));
         }
+        QuarantineLeftovers(program, items);
         
         YG_LOG_INFO(L"强制卸载完成");
         return ErrorCode::Success;
@@ -211,25 +216,32 @@ namespace YG {
     ErrorCode UninstallerService::ExecuteDeepUninstall(const ProgramInfo& program) {
         YG_LOG_INFO(L"执行深度卸载: " + program.name);
         
-        // 深度卸载 = 强制卸载 + 注册表清理
-        ErrorCode result = ExecuteForceUninstall(program);
-        
-        if (result == ErrorCode::Success) {
-            YG_LOG_INFO(L"开始深度清理...");
-            
-            // 清理注册表项
-            CleanupRegistryEntries(program);
-            
-            // 清理快捷方式
-            CleanupShortcuts(program);
-            
-            YG_LOG_INFO(L"深度卸载完成");
+        // 深度卸载 = 强制卸载 + 注册表清理，全部残留作为一个批次隔离，撤销时一起恢复
+        std::vector<ResidualItem> items;
+        if (ExecuteStandardUninstall(program) == ErrorCode::Success) {
+            YG_LOG_INFO(L"标准卸载成功");
+        } else {
+            YG_LOG_WARNING(L"标准卸载失败，开始强制清理");
+            if (!program.installLocation.empty()) {
+                items.push_back(MakeInstallLocationItem(program));
+            }
         }
         
-        return result;
+        YG_LOG_INFO(L"开始深度清理...");
+        
+        // 清理注册表项
+        CollectRegistryEntries(program, items);
+        
+        // 清理快捷方式
+        CollectShortcuts(program, items);
+        
+        QuarantineLeftovers(program, items);
+        
+        YG_LOG_INFO(L"深度卸载完成");
+        return ErrorCode::Success;
     }
     
-    ErrorCode UninstallerService::CleanupRegistryEntries(const ProgramInfo& program) {
+    void UninstallerService::CollectRegistryEntries(const ProgramInfo& program, std::vector<ResidualItem>& items) {
         YG_LOG_INFO(L"清理注册表项: " + program.name);
         
         // 清理卸载注册表项
@@ -238,96 +250,98 @@ namespace YG {
             L"SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall"
         };
         
+        auto registry = RegistryHelper::GetSource();
+        
         for (const auto& keyPath : uninstallKeys) {
             HKEY hKey;
-            if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, keyPath, 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+            if (registry->OpenKey(HKEY_LOCAL_MACHINE, keyPath, KEY_READ, hKey) == ERROR_SUCCESS) {
                 
                 DWORD index = 0;
-                wchar_t subKeyName[256];
-                DWORD subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
+                String subKeyName;
                 
-                while (RegEnumKeyExW(hKey, index++, subKeyName, &subKeyNameSize, 
-                                   nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+                while (registry->EnumKey(hKey, index++, subKeyName) == ERROR_SUCCESS) {
                     
                     HKEY hSubKey;
-                    if (RegOpenKeyExW(hKey, subKeyName, 0, KEY_READ, &hSubKey) == ERROR_SUCCESS) {
+                    if (registry->OpenKey(hKey, subKeyName, KEY_READ, hSubKey) == ERROR_SUCCESS) {
                         
-                        wchar_t displayName[512] = {0};
-                        DWORD displayNameSize = sizeof(displayName);
-                        if (RegQueryValueExW(hSubKey, L"DisplayName", nullptr, nullptr, 
-                                           (LPBYTE)displayName, &displayNameSize) == ERROR_SUCCESS) {
+                        String displayName;
+                        bool matched = RegistryHelper::ReadString(hSubKey, L"DisplayName", displayName) == ErrorCode::Success &&
+                                       displayName == program.name;
+                        registry->CloseKey(hSubKey);
                             
-                            if (wcscmp(displayName, program.name.c_str()) == 0) {
-                                RegCloseKey(hSubKey);
-                                
-                                // 删除注册表项
-                                if (RegDeleteKeyW(hKey, subKeyName) == ERROR_SUCCESS) {
-                                    YG_LOG_INFO(L"删除注册表项成功: " + String(subKeyName));
-                                } else {
-                                    YG_LOG_WARNING(L"删除注册表项失败: " + String(subKeyName));
-                                }
-                                break;
-                            }
+                        if (matched) {
+                            // 枚举结束后再删除，删除前由隔离区记录键的内容
+                            String fullPath = RegistryHelper::FormatRegistryPath(HKEY_LOCAL_MACHINE, String(keyPath) + L"\\" + subKeyName);
+                            items.emplace_back(fullPath, subKeyName, ResidualType::RegistryKey);
+                            break;
                         }
-                        
-                        RegCloseKey(hSubKey);
                     }
-                    
-                    subKeyNameSize = sizeof(subKeyName) / sizeof(wchar_t);
                 }
                 
-                RegCloseKey(hKey);
+                registry->CloseKey(hKey);
             }
         }
-        
-        return ErrorCode::Success;
     }
     
-    ErrorCode UninstallerService::CleanupShortcuts(const ProgramInfo& program) {
+    void UninstallerService::CollectShortcuts(const ProgramInfo& program, std::vector<ResidualItem>& items) {
         YG_LOG_INFO(L"清理快捷方式: " + program.name);
         
-        // 清理开始菜单快捷方式
-        wchar_t startMenuPath[MAX_PATH];
-        if (SHGetFolderPathW(nullptr, CSIDL_COMMON_STARTMENU, nullptr, SHGFP_TYPE_CURRENT, startMenuPath) == S_OK) {
-            String searchPath = String(startMenuPath) + L"\\Programs";
+        // 开始菜单和桌面中名称包含程序名的快捷方式
+        const int folders[] = { CSIDL_COMMON_STARTMENU, CSIDL_DESKTOP };
+        for (int folder : folders) {
+            wchar_t folderPath[MAX_PATH];
+            if (SHGetFolderPathW(nullptr, folder, nullptr, SHGFP_TYPE_CURRENT, folderPath) != S_OK) {
+                continue;
+            }
             
+            String searchPath = folder == CSIDL_COMMON_STARTMENU ? String(folderPath) + L"\\Programs" : String(folderPath);
             WIN32_FIND_DATAW findData;
             String pattern = searchPath + L"\\*" + program.name + L"*";
             HANDLE hFind = FindFirstFileW(pattern.c_str(), &findData);
             
             if (hFind != INVALID_HANDLE_VALUE) {
                 do {
-                    String shortcutPath = searchPath + L"\\" + findData.cFileName;
-                    if (DeleteFileW(shortcutPath.c_str())) {
-                        YG_LOG_INFO(L"删除开始菜单快捷方式: " + shortcutPath);
+                    if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+                        items.emplace_back(searchPath + L"\\" + findData.cFileName, findData.cFileName, ResidualType::Shortcut);
                     }
                 } while (FindNextFileW(hFind, &findData));
                 
                 FindClose(hFind);
             }
         }
+    }
         
-        // 清理桌面快捷方式
-        wchar_t desktopPath[MAX_PATH];
-        if (SHGetFolderPathW(nullptr, CSIDL_DESKTOP, nullptr, SHGFP_TYPE_CURRENT, desktopPath) == S_OK) {
+    ErrorCode UninstallerService::QuarantineLeftovers(const ProgramInfo& program, const std::vector<ResidualItem>& items) {
+        if (items.empty()) {
+            return ErrorCode::Success;
+        }
             
-            WIN32_FIND_DATAW findData;
-            String pattern = String(desktopPath) + L"\\*" + program.name + L"*";
-            HANDLE hFind = FindFirstFileW(pattern.c_str(), &findData);
+        QuarantineBatch batch;
+        ErrorCode result = QuarantineStore::GetShared().Quarantine(items, program.name, nullptr, batch);
+        YG_LOG_INFO(L"已移入隔离区 " + std::to_wstring(batch.entries.size()) + L" 项，批次: " + batch.id);
+        if (result == ErrorCode::Success) {
+            return result;
+        }
             
-            if (hFind != INVALID_HANDLE_VALUE) {
-                do {
-                    String shortcutPath = String(desktopPath) + L"\\" + findData.cFileName;
-                    if (DeleteFileW(shortcutPath.c_str())) {
-                        YG_LOG_INFO(L"删除桌面快捷方式: " + shortcutPath);
-                    }
-                } while (FindNextFileW(hFind, &findData));
+        // 安装目录无法隔离（例如跨卷挂载或隔离日志无法写入）时退回到移入回收站
+        if (!program.installLocation.empty() && PathExists(program.installLocation)) {
+            YG_LOG_WARNING(L"安装目录无法移入隔离区，改为移入回收站: " + program.installLocation);
                 
-                FindClose(hFind);
+            SHFILEOPSTRUCTW fileOp = {};
+            fileOp.wFunc = FO_DELETE;
+            fileOp.fFlags = FOF_ALLOWUNDO | FOF_NOCONFIRMATION | FOF_SILENT;
+            
+            std::wstring pathToDelete = program.installLocation + L"\0";
+            fileOp.pFrom = pathToDelete.c_str();
+            
+            int fileOpResult = SHFileOperationW(&fileOp);
+            if (fileOpResult == 0) {
+                YG_LOG_INFO(L"安装目录删除成功");
+            } else {
+                YG_LOG_WARNING(L"安装目录删除失败，错误代码: " + std::to_wstring(fileOpResult));
             }
         }
-        
-        return ErrorCode::Success;
+        return result;
     }
     
     // PathExists 函数已经在 Common.cpp 中定义
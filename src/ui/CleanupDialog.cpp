@@ -117,7 +117,7 @@ namespace YG {
     }
     
     void CleanupDialog::SetResidualData(const std::vector<ResidualGroup>& groups) {
-        m_residualGroups = groups;
+        m_model.Reset(groups);
         
         // 如果对话框已创建，更新显示
         if (m_hDialog && IsWindow(m_hDialog)) {
@@ -163,7 +163,7 @@ namespace YG {
             WS_EX_CLIENTEDGE,
             WC_LISTVIEWW,
             nullptr,
-            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL,
+            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL | LVS_OWNERDATA,
             MARGIN, MARGIN + 20,
             DIALOG_WIDTH - 2 * MARGIN, 110, // 主要显示区域
             m_hDialog,
@@ -176,6 +176,9 @@ namespace YG {
             // 设置ListView扩展样式，与日志管理窗口一致
             ListView_SetExtendedListViewStyle(m_hListView, LVS_EX_FULLROWSELECT | LVS_EX_GRIDLINES | LVS_EX_CHECKBOXES);
             
+            // 虚拟列表的勾选状态由LVN_GETDISPINFO提供
+            ListView_SetCallbackMask(m_hListView, LVIS_STATEIMAGEMASK);
+            
             // 添加列
             LVCOLUMNW lvc = {0};
             lvc.mask = LVCF_TEXT | LVCF_WIDTH | LVCF_SUBITEM;
@@ -239,7 +242,7 @@ namespace YG {
             WS_EX_CLIENTEDGE,
             WC_LISTVIEWW,
             nullptr,
-            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL,
+            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SHOWSELALWAYS | LVS_SINGLESEL | LVS_OWNERDATA,
             MARGIN + 260, MARGIN + 30,
             DIALOG_WIDTH - MARGIN - 270, DIALOG_HEIGHT - 150,
             m_hDialog,
@@ -252,6 +255,7 @@ namespace YG {
             // 设置扩展样式
             ListView_SetExtendedListViewStyle(m_hListView, 
                 LVS_EX_FULLROWSELECT | LVS_EX_CHECKBOXES | LVS_EX_GRIDLINES);
+            ListView_SetCallbackMask(m_hListView, LVIS_STATEIMAGEMASK);
             
             // 添加列
             LVCOLUMNW col = {};
@@ -339,8 +343,9 @@ namespace YG {
         TreeView_DeleteAllItems(m_hTreeView);
         
         // 添加分组节点
-        for (size_t i = 0; i < m_residualGroups.size(); i++) {
-            const auto& group = m_residualGroups[i];
+        const std::vector<ResidualGroup>& groups = m_model.GetGroups();
+        for (size_t i = 0; i < groups.size(); i++) {
+            const auto& group = groups[i];
             
             String nodeText = group.groupName + L" (" + std::to_wstring(group.items.size()) + L"项)";
             
@@ -358,72 +363,56 @@ namespace YG {
     }
     
     void CleanupDialog::PopulateListView(int groupIndex) {
+        (void)groupIndex;  // 始终显示全部分组
         if (!m_hListView) return;
         
-        // 清空列表
-        ListView_DeleteAllItems(m_hListView);
+        // 虚拟列表只设置行数，行号即模型中的行号，不再受列表项参数位数的限制
+        ListView_SetItemCountEx(m_hListView, static_cast<int>(m_model.GetRowCount()), 0);
+        InvalidateRect(m_hListView, nullptr, FALSE);
         
-        // 显示所有残留项，类似日志管理窗口的风格
-        int itemIndex = 0;
-        for (size_t groupIdx = 0; groupIdx < m_residualGroups.size(); groupIdx++) {
-            const auto& group = m_residualGroups[groupIdx];
+        YG_LOG_INFO(L"列表控件数据填充完成，总计: " + std::to_wstring(m_model.GetRowCount()) + L" 项");
+    }
             
-            for (size_t i = 0; i < group.items.size(); i++) {
-                const auto& item = group.items[i];
-                
-                LVITEMW lvItem = {};
-                lvItem.mask = LVIF_TEXT | LVIF_PARAM;
-                lvItem.iItem = itemIndex;
-                lvItem.iSubItem = 0;
-                
-                // 类型列 - 显示分组名称
-                String typeText = GetResidualTypeText(item.type);
-                lvItem.pszText = const_cast<wchar_t*>(typeText.c_str());
-                lvItem.lParam = static_cast<LPARAM>((groupIdx << 16) | i); // 编码组和项索引
-                
-                int insertedIndex = ListView_InsertItem(m_hListView, &lvItem);
+    void CleanupDialog::OnGetDispInfo(NMLVDISPINFOW* dispInfo) {
+        LVITEMW& lvItem = dispInfo->item;
+        if (lvItem.iItem < 0 || static_cast<size_t>(lvItem.iItem) >= m_model.GetRowCount()) {
+            return;
+        }
                 
-                if (insertedIndex >= 0) {
-                    // 设置选中状态
-                    ListView_SetCheckState(m_hListView, insertedIndex, item.isSelected);
-                    
-                    // 路径列
-                    ListView_SetItemText(m_hListView, insertedIndex, 1, const_cast<wchar_t*>(item.path.c_str()));
-                    
-                    // 大小列
-                    String sizeText = item.size > 0 ? StringUtils::FormatFileSize(item.size) : L"-";
-                    ListView_SetItemText(m_hListView, insertedIndex, 2, const_cast<wchar_t*>(sizeText.c_str()));
-                }
+        const ResidualItem& item = m_model.GetItem(static_cast<size_t>(lvItem.iItem));
                 
-                itemIndex++;
+        if ((lvItem.mask & LVIF_TEXT) && lvItem.pszText && lvItem.cchTextMax > 0) {
+            switch (lvItem.iSubItem) {
+                case 0: // 类型列
+                    lstrcpynW(lvItem.pszText, GetResidualTypeText(item.type).c_str(), lvItem.cchTextMax);
+                    break;
+                case 1: // 路径列
+                    lstrcpynW(lvItem.pszText, item.path.c_str(), lvItem.cchTextMax);
+                    break;
+                case 2: // 大小列
+                    lstrcpynW(lvItem.pszText, item.size > 0 ? StringUtils::FormatFileSize(item.size).c_str() : L"-",
+                              lvItem.cchTextMax);
+                    break;
+                default:
+                    lvItem.pszText[0] = L'\0';
+                    break;
             }
         }
         
-        YG_LOG_INFO(L"列表控件数据填充完成，总计: " + std::to_wstring(itemIndex) + L" 项");
+        // 复选框状态图像：1为未勾选，2为勾选
+        if (lvItem.mask & LVIF_STATE) {
+            bool selected = m_model.IsSelected(static_cast<size_t>(lvItem.iItem));
+            lvItem.state = (lvItem.state & ~LVIS_STATEIMAGEMASK) | INDEXTOSTATEIMAGEMASK(selected ? 2 : 1);
+            lvItem.stateMask |= LVIS_STATEIMAGEMASK;
+        }
     }
     
     void CleanupDialog::UpdateSelectionStats() {
-        int totalItems = 0;
-        int selectedItems = 0;
-        DWORD64 totalSize = 0;
-        DWORD64 selectedSize = 0;
-        
-        for (const auto& group : m_residualGroups) {
-            totalItems += static_cast<int>(group.items.size());
-            for (const auto& item : group.items) {
-                totalSize += item.size;
-                if (item.isSelected) {
-                    selectedItems++;
-                    selectedSize += item.size;
-                }
-            }
-        }
-        
-        String statusText = L"总计 " + std::to_wstring(totalItems) + L" 项，已选中 " + 
-                          std::to_wstring(selectedItems) + L" 项";
+        String statusText = L"总计 " + std::to_wstring(m_model.GetRowCount()) + L" 项，已选中 " + 
+                          std::to_wstring(m_model.GetSelectedCount()) + L" 项";
         
-        if (selectedSize > 0) {
-            statusText += L"，将释放 " + StringUtils::FormatFileSize(selectedSize) + L" 空间";
+        if (m_model.GetSelectedSize() > 0) {
+            statusText += L"，将释放 " + StringUtils::FormatFileSize(m_model.GetSelectedSize()) + L" 空间";
         }
         
         if (m_hStatusLabel) {
@@ -432,22 +421,11 @@ namespace YG {
     }
     
     void CleanupDialog::SelectAll() {
-        for (auto& group : m_residualGroups) {
-            for (auto& item : group.items) {
-                item.isSelected = true;
-            }
-        }
+        m_model.SetAllSelected(true);
         
-        // 更新当前显示的列表
-        HTREEITEM selectedItem = TreeView_GetSelection(m_hTreeView);
-        if (selectedItem) {
-            TVITEMW tvItem = {};
-            tvItem.mask = TVIF_PARAM;
-            tvItem.hItem = selectedItem;
-            TreeView_GetItem(m_hTreeView, &tvItem);
-            
-            int groupIndex = static_cast<int>(tvItem.lParam);
-            PopulateListView(groupIndex);
+        // 勾选状态在重绘时从模型读取
+        if (m_hListView) {
+            InvalidateRect(m_hListView, nullptr, FALSE);
         }
         
         UpdateSelectionStats();
@@ -455,22 +433,10 @@ namespace YG {
     }
     
     void CleanupDialog::SelectNone() {
-        for (auto& group : m_residualGroups) {
-            for (auto& item : group.items) {
-                item.isSelected = false;
-            }
-        }
+        m_model.SetAllSelected(false);
         
-        // 更新当前显示的列表
-        HTREEITEM selectedItem = TreeView_GetSelection(m_hTreeView);
-        if (selectedItem) {
-            TVITEMW tvItem = {};
-            tvItem.mask = TVIF_PARAM;
-            tvItem.hItem = selectedItem;
-            TreeView_GetItem(m_hTreeView, &tvItem);
-            
-            int groupIndex = static_cast<int>(tvItem.lParam);
-            PopulateListView(groupIndex);
+        if (m_hListView) {
+            InvalidateRect(m_hListView, nullptr, FALSE);
         }
         
         UpdateSelectionStats();
@@ -479,14 +445,7 @@ namespace YG {
     
     void CleanupDialog::DeleteSelected() {
         // 收集选中的项
-        std::vector<ResidualItem> selectedItems;
-        for (const auto& group : m_residualGroups) {
-            for (const auto& item : group.items) {
-                if (item.isSelected) {
-                    selectedItems.push_back(item);
-                }
-            }
-        }
+        std::vector<ResidualItem> selectedItems = m_model.GetSelectedItems();
         
         if (selectedItems.empty()) {
             MessageBox(m_hDialog, L"请先选择要删除的项目。", L"提示", MB_OK | MB_ICONINFORMATION);
@@ -495,7 +454,7 @@ namespace YG {
         
         // 确认删除
         String confirmMsg = L"确定要删除选中的 " + std::to_wstring(selectedItems.size()) + L" 个残留项吗？\n\n";
-        confirmMsg += L"此操作无法撤销！";
+        confirmMsg += L"残留项将移入隔离区，可通过 工具 → 撤销上次清理 恢复。";
         
         if (MessageBox(m_hDialog, confirmMsg.c_str(), L"确认删除", MB_YESNO | MB_ICONQUESTION) == IDYES) {
             PerformDelete(selectedItems);
@@ -504,12 +463,7 @@ namespace YG {
     
     void CleanupDialog::DeleteAll() {
         // 收集所有项
-        std::vector<ResidualItem> allItems;
-        for (const auto& group : m_residualGroups) {
-            for (const auto& item : group.items) {
-                allItems.push_back(item);
-            }
-        }
+        std::vector<ResidualItem> allItems = m_model.GetAllItems();
         
         if (allItems.empty()) {
             MessageBox(m_hDialog, L"没有可删除的项目。", L"提示", MB_OK | MB_ICONINFORMATION);
@@ -518,7 +472,7 @@ namespace YG {
         
         // 确认删除
         String confirmMsg = L"确定要删除全部 " + std::to_wstring(allItems.size()) + L" 个残留项吗？\n\n";
-        confirmMsg += L"此操作无法撤销！";
+        confirmMsg += L"残留项将移入隔离区，可通过 工具 → 撤销上次清理 恢复。";
         
         if (MessageBox(m_hDialog, confirmMsg.c_str(), L"确认删除全部", MB_YESNO | MB_ICONWARNING) == IDYES) {
             PerformDelete(allItems);
@@ -540,9 +494,11 @@ namespace YG {
         
         YG_LOG_INFO(L"开始删除操作，项目数: " + std::to_wstring(items.size()));
         
-        // 使用扫描器执行删除
+        // 移入隔离区（同卷改名，不逐个删除文件），进度回调在本线程中执行
+        ErrorCode deleteResult = ErrorCode::Success;
         if (m_scanner) {
-            m_scanner->DeleteResidualItems(items, 
+            String label = m_programInfo.displayName.empty() ? m_programInfo.name : m_programInfo.displayName;
+            deleteResult = m_scanner->QuarantineResidualItems(items, label,
                 [this](int percentage, const String& currentItem, bool success) {
                     OnDeleteProgress(percentage, currentItem, success);
                 });
@@ -561,7 +517,11 @@ namespace YG {
         // 隐藏进度条
         ShowWindow(m_hProgressBar, SW_HIDE);
         
-        MessageBox(m_hDialog, L"清理操作完成！", L"完成", MB_OK | MB_ICONINFORMATION);
+        if (deleteResult == ErrorCode::Success) {
+            MessageBox(m_hDialog, L"清理操作完成！", L"完成", MB_OK | MB_ICONINFORMATION);
+        } else {
+            MessageBox(m_hDialog, L"清理操作完成，部分残留项未能移入隔离区，详情请查看日志。", L"完成", MB_OK | MB_ICONWARNING);
+        }
         
         YG_LOG_INFO(L"删除操作完成");
     }
@@ -572,7 +532,7 @@ namespace YG {
         }
         
         if (m_hStatusLabel) {
-            String statusText = L"正在删除: " + currentItem;
+            String statusText = L"正在清理: " + currentItem;
             if (!success) {
                 statusText += L" (失败)";
             }
@@ -703,13 +663,22 @@ namespace YG {
                             OnTreeSelectionChanged(pNMTV->itemNew.hItem);
                         }
                     } else if (pNMHDR->hwndFrom == m_hListView) {
-                        // 处理列表控件通知
-                        if (pNMHDR->code == LVN_ITEMCHANGED) {
-                            LPNMLISTVIEW pNMLV = (LPNMLISTVIEW)lParam;
-                            if (pNMLV->uChanged & LVIF_STATE) {
-                                // 选择状态变化
-                                bool isSelected = ListView_GetCheckState(m_hListView, pNMLV->iItem) != 0;
-                                OnListItemSelectionChanged(pNMLV->iItem, isSelected);
+                        // 处理列表控件通知；虚拟列表不会自行切换复选框，点击复选框或按空格时由模型切换
+                        if (pNMHDR->code == LVN_GETDISPINFOW) {
+                            OnGetDispInfo(reinterpret_cast<NMLVDISPINFOW*>(lParam));
+                        } else if (pNMHDR->code == NM_CLICK) {
+                            LPNMITEMACTIVATE pNMIA = (LPNMITEMACTIVATE)lParam;
+                            LVHITTESTINFO hitTest = {};
+                            hitTest.pt = pNMIA->ptAction;
+                            int row = ListView_HitTest(m_hListView, &hitTest);
+                            if (row >= 0 && (hitTest.flags & LVHT_ONITEMSTATEICON)) {
+                                OnListItemSelectionChanged(row, !m_model.IsSelected(static_cast<size_t>(row)));
+                            }
+                        } else if (pNMHDR->code == LVN_KEYDOWN) {
+                            LPNMLVKEYDOWN pNMKD = (LPNMLVKEYDOWN)lParam;
+                            int row = ListView_GetNextItem(m_hListView, -1, LVNI_FOCUSED);
+                            if (pNMKD->wVKey == VK_SPACE && row >= 0) {
+                                OnListItemSelectionChanged(row, !m_model.IsSelected(static_cast<size_t>(row)));
                             }
                         }
                     }
@@ -733,20 +702,13 @@ namespace YG {
     }
     
     void CleanupDialog::OnListItemSelectionChanged(int itemIndex, bool selected) {
-        // 更新对应的残留项选择状态
-        HTREEITEM selectedTreeItem = TreeView_GetSelection(m_hTreeView);
-        if (!selectedTreeItem) return;
-        
-        TVITEMW tvItem = {};
-        tvItem.mask = TVIF_PARAM;
-        tvItem.hItem = selectedTreeItem;
-        TreeView_GetItem(m_hTreeView, &tvItem);
+        if (itemIndex < 0 || static_cast<size_t>(itemIndex) >= m_model.GetRowCount()) {
+            return;
+        }
         
-        int groupIndex = static_cast<int>(tvItem.lParam);
-        if (groupIndex >= 0 && groupIndex < static_cast<int>(m_residualGroups.size()) &&
-            itemIndex >= 0 && itemIndex < static_cast<int>(m_residualGroups[groupIndex].items.size())) {
-            
-            m_residualGroups[groupIndex].items[itemIndex].isSelected = selected;
+        // 只更新该行和合计值，不再遍历全部残留项
+        if (m_model.SetSelected(static_cast<size_t>(itemIndex), selected)) {
+            ListView_RedrawItems(m_hListView, itemIndex, itemIndex);
             UpdateSelectionStats();
         }
     }
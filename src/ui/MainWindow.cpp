@@ -13,6 +13,7 @@
 #include "ui/ResourceManager.h"
 #include "ui/CleanupDialog.h"
 #include "services/ResidualScanner.h"
+#include "services/QuarantineStore.h"
 #include "utils/UIUtils.h"
 #include "utils/StringUtils.h"
 #include "utils/RegistryHelper.h"
@@ -20,6 +21,7 @@
 #include "core/ErrorHandler.h"
 #include "core/Config.h"
 #include "services/DirectProgramScanner.h"
+#include "services/ProgramDeduplicator.h"
 #include "../resources/resource.h"  // 包含资源定义
 #include <cstdio>  // 为swprintf_s提供支持
 #include <commctrl.h>  // ListView控件支持
@@ -70,13 +72,20 @@ namespace YG {
                               m_hToolbar(nullptr), m_hStatusBar(nullptr), m_hListView(nullptr),
                               m_hSearchEdit(nullptr), m_hProgressBar(nullptr), m_hLeftPanel(nullptr),
                               m_hRightPanel(nullptr), m_hDetailsEdit(nullptr), m_hBottomSearchEdit(nullptr), m_hImageList(nullptr),
-                              m_includeSystemComponents(false), m_showWindowsUpdates(false),
-                              m_isScanning(false), m_isUninstalling(false), m_isListViewMode(false),
-                              m_scrollBarsHidden(false), m_originalListViewProc(nullptr), m_sortColumn(0), m_sortAscending(true) {
+                              m_includeSystemComponents(false), m_showWindowsUpdates(false), m_fuzzySearch(false),
+                              m_isScanning(false), m_scanGeneration(0), m_rescanPending(false),
+                              m_hasScannedList(false), m_listedSystemComponents(false), m_isUninstalling(false), m_isBatchUninstalling(false),
+                              m_isListViewMode(false),
+                              m_scrollBarsHidden(false), m_originalListViewProc(nullptr), m_sortColumn(-1), m_sortAscending(true) {
         
         // 创建资源管理器（最先创建）
         m_resourceManager = YG::MakeUnique<ResourceManager>();
         
+        m_programTable = ProgramTable::Empty();
+        m_searchIndex = ProgramSearchIndex::Build(*m_programTable);
+        m_programSorter = YG::MakeUnique<ProgramSorter>();
+        m_programFilter = YG::MakeUnique<ProgramFilter>();
+        
         // 初始化日志管理器
         m_logManager = YG::MakeUnique<MainWindowLogs>(this);
         
@@ -303,53 +312,107 @@ namespace YG {
         
         YG_LOG_INFO(L"开始刷新程序列表，包含系统组件: " + String(includeSystemComponents ? L"是" : L"否"));
         
-        SetStatusText(L"正在扫描已安装的程序...");
+        if (!m_programDetector) {
+            m_programDetector = YG::MakeUnique<ProgramDetector>();
+        }
         
-        // 显示进度条
-        UpdateProgress(0, true);
+        // 新的刷新取代进行中的扫描：只请求取消，不在界面线程中等待；旧扫描退出时投递的完成消息
+        // 再开始新的扫描（取消后其增量记录会恢复）
+        if (m_programDetector->IsScanning()) {
+            YG_LOG_INFO(L"取消进行中的程序扫描，结束后重新扫描");
+            m_rescanPending = true;
+            m_programDetector->CancelScan();
+            SetStatusText(L"正在扫描已安装的程序...");
+            return;
+        }
         
-        // 在编辑框中显示扫描状态
-        if (m_hListView) {
-            SetWindowTextW(m_hListView, L"正在扫描64位 Windows 系统上的已安装程序...\r\n\r\n请耐心等待，这可能需要几秒钟时间。");
+        m_rescanPending = false;
+        
+        std::uint64_t generation = ++m_scanGeneration;
+        std::shared_ptr<ProgressCoalescer> progress = std::make_shared<ProgressCoalescer>(
+            m_hWnd, WM_USER + 105, static_cast<WPARAM>(generation), SCAN_PROGRESS_INTERVAL_MS);
+            
+        // 增量扫描在后台线程中进行：只重新读取新增或发生变化的注册表项，首次调用时为完整扫描。
+        // 扫描期间当前列表保持可用，完成后在界面线程中整体替换
+        HWND hMainWnd = m_hWnd;
+        ErrorCode result = m_programDetector->StartRevalidation(includeSystemComponents,
+            [hMainWnd, generation](const std::vector<ProgramInfo>&, ErrorCode scanResult) {
+                PostMessage(hMainWnd, WM_USER + 102, static_cast<WPARAM>(scanResult), static_cast<LPARAM>(generation));
+            },
+            [progress](int percentage, const String& currentItem) {
+                progress->Report(percentage, currentItem);
+            });
+            
+        if (result != ErrorCode::Success) {
+            // 被取消的扫描未能在限定时间内退出时，暂时无法开始新的扫描
+            YG_LOG_ERROR(L"无法开始程序扫描，错误代码: " + std::to_wstring(static_cast<int>(result)));
+            m_isScanning = false;
+            m_scanProgress.reset();
+            UpdateProgress(0, false);
+            SetStatusText(L"上一次扫描尚未结束，请稍后再刷新");
+            return;
+        }
+            
+        m_isScanning = true;
+        m_scanProgress = progress;
+        SetStatusText(L"正在扫描已安装的程序...");
+        UpdateProgress(0, true);
+    }
+    
+    void MainWindow::OnProgramScanCompleted(ErrorCode result, std::uint64_t generation) {
+        if (generation != m_scanGeneration) {
+            YG_LOG_DEBUG(L"丢弃过期的程序扫描结果，代数: " + std::to_wstring(generation));
+            return;
         }
         
-        // 使用ProgramDetector进行扫描
-        if (!m_programDetector) {
-            m_programDetector = YG::MakeUnique<ProgramDetector>();
+        m_isScanning = false;
+        m_scanProgress.reset();
+        
+        // 扫描期间又请求了刷新：丢弃本次结果，按最新的选项重新扫描；
+        // 丢弃的结果已计入增量记录，下次扫描的差异不再包含它，因此下次总是重新填充
+        if (m_rescanPending) {
+            if (result == ErrorCode::Success) {
+                m_hasScannedList = false;
+            }
+            RefreshProgramList(m_includeSystemComponents);
+            return;
         }
         
-        std::vector<ProgramInfo> programs;
-        ErrorCode result = m_programDetector->ScanSync(includeSystemComponents, programs);
+        UpdateProgress(0, false);
         
-        if (result == ErrorCode::Success) {
-            YG_LOG_INFO(L"扫描完成，找到 " + std::to_wstring(programs.size()) + L" 个程序");
-            
-            // 更新进度到100%
-            UpdateProgress(100, true);
-            
-            // 短暂显示完成状态，然后隐藏进度条
-            Sleep(500);
-            UpdateProgress(0, false);
+        if (result == ErrorCode::Success && m_programDetector) {
+            // 注册表没有变化时保留当前列表（及其选择、滚动位置和补全结果）；
+            // Windows Store应用每次完整读取、不在差异中，包含系统组件时总是重新填充
+            if (m_hasScannedList && m_listedSystemComponents == m_includeSystemComponents &&
+                !m_includeSystemComponents && m_programDetector->GetLastScanDelta().IsEmpty()) {
+                YG_LOG_INFO(L"扫描完成，程序列表没有变化");
+                UpdateStatusBarForSelection();
+                return;
+            }
             
+            std::vector<ProgramInfo> programs = m_programDetector->GetPrograms();
+            YG_LOG_INFO(L"扫描完成，程序数量: " + std::to_wstring(programs.size()));
             PopulateProgramList(programs);
+            m_hasScannedList = true;
+            m_listedSystemComponents = m_includeSystemComponents;
+            
+            // 替换程序表后重新应用当前的搜索条件
+            if (!m_currentSearchKeyword.empty()) {
+                SearchPrograms(m_currentSearchKeyword);
+            }
             
             // 扫描完成后，确保隐藏水平滚动条
             m_scrollBarsHidden = false;  // 重置状态，允许重新隐藏滚动条
             ForceHideScrollBars();
-        } else {
+        } else if (result != ErrorCode::OperationCancelled) {
             YG_LOG_ERROR(L"程序扫描失败，错误代码: " + std::to_wstring(static_cast<int>(result)));
             
-            // 隐藏进度条
-            UpdateProgress(0, false);
-            
-            // 显示扫描失败信息
-            if (m_hListView) {
+            // 已有列表时保留原列表，否则显示扫描失败信息
+            if (m_hListView && m_displayIds.empty()) {
                 SetWindowTextW(m_hListView, L"程序扫描失败！\r\n\r\n可能的原因：\r\n• 缺少管理员权限\r\n• 注册表访问被限制\r\n• 系统安全软件阻止\r\n\r\n请尝试以管理员身份运行程序，或检查系统安全设置。");
             }
             SetStatusText(L"程序扫描失败 - 请检查权限和系统设置");
         }
-        
-        YG_LOG_INFO(L"程序列表刷新完成");
     }
     
     void MainWindow::SearchPrograms(const String& keyword) {
@@ -358,50 +421,76 @@ namespace YG {
         m_currentSearchKeyword = isBlank ? L"" : keyword;
         YG_LOG_INFO(L"搜索程序: " + (isBlank ? String(L"<空>") : keyword));
         
+        // 带字段或取反的输入（如"publisher:microsoft size>500MB"）按结构化查询过滤
+        ProgramQuery query;
+        ErrorContext queryResult;
+        if (!isBlank) {
+            queryResult = ProgramQuery::Compile(keyword, query);
+        }
+        bool structured = !isBlank && (queryResult.code != DetailedErrorCode::Success || query.IsStructured());
+        
+        if (structured && queryResult.code != DetailedErrorCode::Success) {
+            // 保留当前列表，等待输入完整
+            SetStatusText(L"查询条件无法识别: " + queryResult.message);
+            return;
+        }
+        
         if (isBlank) {
             // 空搜索，显示所有程序
-            m_filteredPrograms = m_programs;
-        } else {
-            // 执行搜索过滤
-            m_filteredPrograms.clear();
-            String lowerKeyword = keyword;
-            std::transform(lowerKeyword.begin(), lowerKeyword.end(), lowerKeyword.begin(), ::towlower);
-            
-            for (const auto& program : m_programs) {
-                // 获取程序名称
-                String programName = !program.displayName.empty() ? program.displayName : program.name;
-                String lowerName = programName;
-                std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::towlower);
-                
-                // 获取发布者名称
-                String lowerPublisher = program.publisher;
-                std::transform(lowerPublisher.begin(), lowerPublisher.end(), lowerPublisher.begin(), ::towlower);
-                
-                // 检查是否匹配
-                if (lowerName.find(lowerKeyword) != String::npos ||
-                    lowerPublisher.find(lowerKeyword) != String::npos ||
-                    program.version.find(keyword) != String::npos) {
-                    m_filteredPrograms.push_back(program);
-                }
+            m_displayIds = m_programTable->GetIds();
+            m_searchResult = ProgramSearchResult();
+        } else if (structured) {
+            // 查询编译一次，由过滤器按代价安排各条件的求值顺序
+            ProgramFilterResult result = m_programFilter->Execute(query);
+            m_displayIds = m_searchIndex->ToIds(result.rows);
+            YG_LOG_DEBUG(L"查询 " + std::to_wstring(query.GetClauses().size()) + L" 个条件，校验候选 " +
+                        std::to_wstring(result.candidateCount) + L" 行，匹配 " + std::to_wstring(result.rows.size()) + L" 个");
+            m_searchResult = ProgramSearchResult();
+        } else if (m_fuzzySearch) {
+            // 模糊搜索：按评分从高到低显示，只对评分最高的一部分排序
+            FuzzySearchResult result = m_searchIndex->FuzzySearch(keyword, FUZZY_RESULT_LIMIT);
+            m_displayIds.clear();
+            m_displayIds.reserve(result.matches.size());
+            for (const FuzzySearchMatch& match : result.matches) {
+                m_displayIds.push_back(m_searchIndex->GetId(match.row));
             }
+            YG_LOG_DEBUG(L"模糊搜索评分 " + std::to_wstring(result.candidateCount) + L" 行，匹配 " +
+                        std::to_wstring(result.totalMatches) + L" 个");
+            m_searchResult = ProgramSearchResult();
+        } else {
+            // 通过搜索索引过滤；继续输入时在上一次的结果中缩小
+            ProgramSearchResult result = m_searchIndex->Search(keyword, SearchFieldAll, &m_searchResult);
+            m_displayIds = m_searchIndex->ToIds(result.rows);
+            YG_LOG_DEBUG(L"搜索校验候选 " + std::to_wstring(result.candidateCount) + L" 行" +
+                        (result.narrowed ? L"（在上次结果中缩小）" : L""));
+            m_searchResult = std::move(result);
+        }
+        
+        // 过滤结果按表中顺序给出，按当前排序列重排；模糊搜索保持评分顺序
+        bool ranked = !isBlank && !structured && m_fuzzySearch;
+        if (!ranked && m_sortColumn != -1) {
+            m_programSorter->Sort(m_displayIds, static_cast<ProgramSortColumn>(m_sortColumn), m_sortAscending);
         }
         
         // 更新显示
-        PopulateProgramList(m_filteredPrograms);
+        ShowProgramRows();
         
         // 更新状态栏 - 搜索结果特殊处理
         if (!isBlank) {
             // 搜索模式下的状态栏显示
             String statusText;
-            if (m_filteredPrograms.empty()) {
+            if (m_displayIds.empty()) {
                 statusText = L"搜索结果: 未找到匹配的程序";
             } else {
                 DWORD64 totalSize = 0;
-                for (const auto& program : m_filteredPrograms) {
-                    totalSize += program.estimatedSize;
+                for (ProgramId id : m_displayIds) {
+                    totalSize += m_programTable->GetEstimatedSize(id);
                 }
                 
-                statusText = L"搜索结果: 找到 " + std::to_wstring(m_filteredPrograms.size()) + L" 个程序";
+                statusText = L"搜索结果: 找到 " + std::to_wstring(m_displayIds.size()) + L" 个程序";
+                if (m_fuzzySearch && !structured) {
+                    statusText += L"（模糊搜索，按匹配度排序）";
+                }
                 if (totalSize > 0) {
                     statusText += L", 占用空间: " + FormatFileSize(totalSize);
                 }
@@ -412,7 +501,7 @@ namespace YG {
             UpdateStatusBarForSelection();
         }
         
-        YG_LOG_INFO(L"搜索完成，找到 " + std::to_wstring(m_filteredPrograms.size()) + L" 个匹配程序");
+        YG_LOG_INFO(L"搜索完成，找到 " + std::to_wstring(m_displayIds.size()) + L" 个匹配程序");
     }
     
     void MainWindow::UninstallSelectedProgram(UninstallMode mode) {
@@ -497,8 +586,7 @@ namespace YG {
         if (selectedCount == 0) {
             // 没有选中程序，显示总体统计信息
             // 使用当前显示的程序列表（可能是搜索结果或全部程序）
-            const auto& displayPrograms = m_filteredPrograms.empty() ? m_programs : m_filteredPrograms;
-            int totalCount = static_cast<int>(displayPrograms.size());
+            int totalCount = static_cast<int>(m_displayIds.size());
             
             if (totalCount == 0) {
                 // 如果还没有程序数据，显示0个程序
@@ -509,8 +597,8 @@ namespace YG {
             DWORD64 totalSize = 0;
             
             // 计算总占用空间
-            for (const auto& program : displayPrograms) {
-                totalSize += program.estimatedSize; // estimatedSize已经是字节单位
+            for (ProgramId id : m_displayIds) {
+                totalSize += m_programTable->GetEstimatedSize(id); // estimatedSize已经是字节单位
             }
             
             String statusText = L"共计 " + std::to_wstring(totalCount) + L" 个程序";
@@ -669,6 +757,9 @@ namespace YG {
                         // 清理图标列表
                         if (m_hImageList) {
                             YG_LOG_INFO(L"WM_CLOSE: 清理图标列表");
+                            if (m_iconService) {
+                                m_iconService->Reset(nullptr, GetDefaultProgramIcon());
+                            }
                             ImageList_Destroy(m_hImageList);
                             m_hImageList = nullptr;
                         }
@@ -709,6 +800,32 @@ namespace YG {
                             // 立即更新状态栏显示初始状态
                             UpdateStatusBarForSelection();
                             
+                            // 优先显示上次的程序快照，再在后台校验
+                            if (!m_programDetector) {
+                                m_programDetector = YG::MakeUnique<ProgramDetector>();
+                            }
+                            
+                            std::vector<ProgramInfo> snapshotPrograms;
+                            if (m_programDetector->LoadSnapshot(m_includeSystemComponents, snapshotPrograms) == ErrorCode::Success &&
+                                !snapshotPrograms.empty()) {
+                                YG_LOG_INFO(L"已从快照显示程序列表，开始后台校验");
+                                PopulateProgramList(snapshotPrograms);
+                                m_hasScannedList = true;
+                                m_listedSystemComponents = m_includeSystemComponents;
+                                SetStatusText(L"已显示上次的程序列表，正在后台校验...");
+                                
+                                HWND hMainWnd = m_hWnd;
+                                std::uint64_t generation = ++m_scanGeneration;
+                                if (m_programDetector->StartRevalidation(m_includeSystemComponents,
+                                        [hMainWnd, generation](const std::vector<ProgramInfo>&, ErrorCode result) {
+                                            PostMessage(hMainWnd, WM_USER + 102, static_cast<WPARAM>(result),
+                                                        static_cast<LPARAM>(generation));
+                                        }) == ErrorCode::Success) {
+                                    m_isScanning = true;
+                                }
+                                return DefWindowProc(hWnd, uMsg, wParam, lParam);
+                            }
+                            
                             // 第一次启动时自动扫描程序列表
                             SetStatusText(L"正在扫描已安装的程序...");
                             
@@ -724,10 +841,7 @@ namespace YG {
                                                            L"• 可按程序名称进行搜索");
                             }
                             
-                            // 延迟一下再开始扫描，让用户看到提示信息
-                            Sleep(500);
-                            
-                            // 开始自动扫描程序列表
+                            // 开始自动扫描程序列表（后台进行，提示信息保持到扫描完成）
                             RefreshProgramList(m_includeSystemComponents);
                             
                         } else {
@@ -793,6 +907,41 @@ namespace YG {
                     HandleResidualScanProgress(percentage, foundCount);
                     return 0;
                 }
+            case WM_USER + 102:
+                {
+                    // 处理后台扫描（刷新或快照校验）完成消息
+                    OnProgramScanCompleted(static_cast<ErrorCode>(wParam), static_cast<std::uint64_t>(lParam));
+                    return 0;
+                }
+            case WM_USER + 103:
+                {
+                    // 处理合并后的程序信息补全结果
+                    std::vector<ProgramEnrichmentUpdate> updates;
+                    if (m_enrichmentInbox && m_enrichmentInbox->Take(updates)) {
+                        ApplyProgramEnrichment(updates);
+                    }
+                    return 0;
+                }
+            case WM_USER + 104:
+                {
+                    // 处理后台解析完成的程序图标
+                    std::unique_ptr<ProgramIconUpdate> update(reinterpret_cast<ProgramIconUpdate*>(lParam));
+                    if (update) {
+                        ApplyProgramIcons(*update);
+                    }
+                    return 0;
+                }
+            case WM_USER + 105:
+                {
+                    // 处理合并后的扫描进度，过期扫描的进度直接丢弃
+                    int percentage = 0;
+                    String currentItem;
+                    if (m_scanProgress && static_cast<std::uint64_t>(wParam) == m_scanGeneration &&
+                        m_scanProgress->Take(percentage, currentItem)) {
+                        UpdateProgress(percentage, true);
+                    }
+                    return 0;
+                }
             default:
                 return DefWindowProc(hWnd, uMsg, wParam, lParam);
         }
@@ -849,6 +998,9 @@ namespace YG {
         // 清理图标列表
         if (m_hImageList) {
             YG_LOG_INFO(L"OnDestroy: 清理图标列表");
+            if (m_iconService) {
+                m_iconService->Reset(nullptr, GetDefaultProgramIcon());
+            }
             ImageList_Destroy(m_hImageList);
             m_hImageList = nullptr;
         }
@@ -994,6 +1146,9 @@ namespace YG {
 
                     // 清理图标列表
                     if (m_hImageList) {
+                        if (m_iconService) {
+                            m_iconService->Reset(nullptr, GetDefaultProgramIcon());
+                        }
                         ImageList_Destroy(m_hImageList);
                         m_hImageList = nullptr;
                     }
@@ -1300,6 +1455,25 @@ namespace YG {
                     SetStatusText(m_showWindowsUpdates ? L"显示Windows更新" : L"隐藏Windows更新");
                 }
                 break;
+            case ID_VIEW_FUZZY_SEARCH:
+                {
+                    HMENU hMenu = GetMenu(m_hWnd);
+                    HMENU hViewMenu = GetSubMenu(hMenu, 2);
+                    UINT state = GetMenuState(hViewMenu, ID_VIEW_FUZZY_SEARCH, MF_BYCOMMAND);
+                    bool isChecked = (state & MF_CHECKED) != 0;
+                    
+                    CheckMenuItem(hViewMenu, ID_VIEW_FUZZY_SEARCH, MF_BYCOMMAND | (isChecked ? MF_UNCHECKED : MF_CHECKED));
+                    m_fuzzySearch = !isChecked;
+                    
+                    // 用当前关键词按新的方式重新搜索
+                    m_searchResult = ProgramSearchResult();
+                    if (!m_currentSearchKeyword.empty()) {
+                        SearchPrograms(m_currentSearchKeyword);
+                    } else {
+                        SetStatusText(m_fuzzySearch ? L"已切换到模糊搜索" : L"已切换到普通搜索");
+                    }
+                }
+                break;
                 
             // 帮助菜单
             case ID_HELP_HELP:
@@ -1326,6 +1500,9 @@ namespace YG {
                     m_logManager->ShowLogManagerDialog();
                 }
                 break;
+            case ID_TOOLS_UNDO_CLEANUP:
+                UndoLastCleanup();
+                break;
                 
                 
                 
@@ -1369,6 +1546,7 @@ namespace YG {
                     }
 
                     // 清理图标列表
+                    if (m_iconService) { m_iconService->Reset(nullptr, GetDefaultProgramIcon()); }
                     if (m_hImageList) { ImageList_Destroy(m_hImageList); m_hImageList = nullptr; }
 
                     Logger::GetInstance().Flush();
@@ -1388,6 +1566,35 @@ namespace YG {
     LRESULT MainWindow::OnNotify(LPNMHDR pNMHDR) {
         if (!pNMHDR) return 0;
         
+        // 虚拟列表每绘制一个单元格都会请求一次数据，在记录日志之前处理
+        if (pNMHDR->idFrom == 2001 && m_isListViewMode) {
+            switch (pNMHDR->code) {
+                case LVN_GETDISPINFOW:
+                    OnGetDispInfo(reinterpret_cast<NMLVDISPINFOW*>(pNMHDR));
+                    return 0;
+                case LVN_ODCACHEHINT:
+                {
+                    // 可见范围变化时，先解析这些行的图标
+                    const NMLVCACHEHINT* cacheHint = reinterpret_cast<NMLVCACHEHINT*>(pNMHDR);
+                    if (m_iconService) {
+                        std::vector<ProgramId> visibleIds;
+                        for (int row = cacheHint->iFrom; row <= cacheHint->iTo; ++row) {
+                            ProgramId id = GetProgramIdAtRow(row);
+                            if (id != InvalidProgramId) {
+                                visibleIds.push_back(id);
+                            }
+                        }
+                        m_iconService->Prioritize(visibleIds);
+                    }
+                    return 0;
+                }
+                case LVN_ODFINDITEMW:
+                    return FindProgramRow(reinterpret_cast<NMLVFINDITEMW*>(pNMHDR));
+                default:
+                    break;
+            }
+        }
+        
         YG_LOG_INFO(L"OnNotify: 检查ListView句柄匹配 - 消息句柄:" + std::to_wstring(reinterpret_cast<uintptr_t>(pNMHDR->hwndFrom)) + 
                    L", ListView句柄:" + std::to_wstring(reinterpret_cast<uintptr_t>(m_hListView)));
         
@@ -1573,7 +1780,7 @@ namespace YG {
             0,  // 移除WS_EX_CLIENTEDGE边框样式
             WC_LISTVIEWW,
             L"",
-            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | WS_VSCROLL,
+            WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | LVS_OWNERDATA | WS_VSCROLL,
             20, menuBarHeight + searchBarHeight,  // 左边距20px
             totalWidth - 20, availableHeight,  // 宽度 = 总宽度 - 左边距20px，右边距为0
             m_hWnd,
@@ -1769,6 +1976,10 @@ namespace YG {
             // 显示选项
             AppendMenuW(hViewMenu, MF_STRING, ID_VIEW_SHOW_SYSTEM, L"显示系统组件(&C)");
             AppendMenuW(hViewMenu, MF_STRING, ID_VIEW_SHOW_UPDATES, L"显示Windows更新(&W)");
+            AppendMenuW(hViewMenu, MF_SEPARATOR, 0, nullptr);
+            
+            // 搜索方式
+            AppendMenuW(hViewMenu, MF_STRING, ID_VIEW_FUZZY_SEARCH, L"模糊搜索(&Z)");
             
             AppendMenuW(m_hMenu, MF_POPUP, (UINT_PTR)hViewMenu, L"查看(&V)");
         }
@@ -1779,6 +1990,7 @@ namespace YG {
             AppendMenuW(hToolsMenu, MF_STRING, ID_TOOLS_SETTINGS, L"设置(&S)");
             AppendMenuW(hToolsMenu, MF_SEPARATOR, 0, nullptr);
             AppendMenuW(hToolsMenu, MF_STRING, ID_TOOLS_LOG_MANAGER, L"日志管理(&L)");
+            AppendMenuW(hToolsMenu, MF_STRING, ID_TOOLS_UNDO_CLEANUP, L"撤销上次清理(&U)");
             AppendMenuW(m_hMenu, MF_POPUP, (UINT_PTR)hToolsMenu, L"工具(&T)");
         }
         
@@ -2210,59 +2422,72 @@ namespace YG {
             return;
         }
         
-        // 先进行去重处理
-        std::vector<ProgramInfo> uniquePrograms = RemoveDuplicatePrograms(programs);
+        // 调用方在填充扫描结果后重新标记
+        m_hasScannedList = false;
+        
+        // 先进行去重处理，再生成程序表；同一程序沿用上一张表的Id
+        DeduplicationStats dedupeStats;
+        std::vector<ProgramInfo> uniquePrograms = ProgramDeduplicator::RemoveDuplicates(programs, &dedupeStats);
+        YG_LOG_INFO(L"去重完成，去重后程序数量: " + std::to_wstring(dedupeStats.keptCount) +
+                   L", 移除重复项: " + std::to_wstring(dedupeStats.inputCount - dedupeStats.keptCount));
+        m_programTable = ProgramTable::Build(uniquePrograms, m_programTable);
+        m_displayIds = m_programTable->GetIds();
+        m_searchIndex = ProgramSearchIndex::Build(*m_programTable);
+        m_searchResult = ProgramSearchResult();
+        m_programSorter->SetTable(m_programTable, true);
+        m_programFilter->SetTable(m_programTable, m_searchIndex, true);
+        if (m_sortColumn != -1) {
+            m_programSorter->Sort(m_displayIds, static_cast<ProgramSortColumn>(m_sortColumn), m_sortAscending);
+        }
+        ResetProgramIcons();
+        
+        YG_LOG_INFO(L"程序表已生成，占用约 " + std::to_wstring(m_programTable->GetMemoryUsage() / 1024) + L" KB，搜索索引约 " +
+                   std::to_wstring(m_searchIndex->GetMemoryUsage() / 1024) + L" KB");
+        
+        ShowProgramRows();
+        
+        // 注册表中缺失的大小、安装日期和版本在后台补全；结果先在合并器中积累，
+        // 界面线程每处理一条消息整批应用一次
+        if (m_isListViewMode && m_programDetector && !uniquePrograms.empty()) {
+            if (!m_enrichmentInbox) {
+                m_enrichmentInbox = std::make_shared<BatchCoalescer<ProgramEnrichmentUpdate>>(m_hWnd, WM_USER + 103);
+            }
+            std::shared_ptr<BatchCoalescer<ProgramEnrichmentUpdate>> inbox = m_enrichmentInbox;
+            m_programDetector->StartEnrichment(uniquePrograms, [inbox](const ProgramEnrichmentUpdate& update) {
+                inbox->Add(update);
+            });
+        }
+    }
+    
+    void MainWindow::ShowProgramRows() {
+        if (!m_hListView) {
+            return;
+        }
+        
+        const ProgramTable& table = *m_programTable;
         
         // 根据控件类型选择显示方式
         if (m_isListViewMode) {
             // ListView表格模式
             YG_LOG_INFO(L"使用ListView表格模式显示程序列表");
             
-            // 清除现有数据
-            ListView_DeleteAllItems(m_hListView);
+            // 虚拟列表只保存行数，文本和图标在LVN_GETDISPINFO中按需从程序表读取；
+            // 排序、搜索和刷新只替换m_displayIds并重设行数
+            ListView_SetItemState(m_hListView, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
             
-            if (uniquePrograms.empty()) {
-                SetStatusText(L"未找到已安装的程序");
-                return;
+            m_rowById.assign(table.GetSlotCount(), -1);
+            for (size_t i = 0; i < m_displayIds.size(); i++) {
+                m_rowById[m_displayIds[i]] = static_cast<int>(i);
+            }
+            if (m_iconIndexById.size() < table.GetSlotCount()) {
+                m_iconIndexById.resize(table.GetSlotCount(), -1);
             }
             
-            // 保存去重后的程序列表
-            m_programs = uniquePrograms;
+            ListView_SetItemCountEx(m_hListView, static_cast<int>(m_displayIds.size()), 0);
             
-            // 添加程序数据到ListView
-            for (size_t i = 0; i < uniquePrograms.size(); i++) {
-                const auto& program = uniquePrograms[i];
-                
-                LVITEMW item = {0};
-                item.mask = LVIF_TEXT | LVIF_PARAM | LVIF_IMAGE;
-                item.iItem = static_cast<int>(i);
-                item.iSubItem = 0;
-                // 优先使用displayName，如果为空则使用name
-                String programName = !program.displayName.empty() ? program.displayName : program.name;
-                item.pszText = const_cast<LPWSTR>(programName.c_str());
-                item.lParam = static_cast<LPARAM>(i); // 存储程序索引
-                
-                // 提取程序图标
-                item.iImage = ExtractProgramIcon(program);
-                
-                int index = ListView_InsertItem(m_hListView, &item);
-                
-                if (index != -1) {
-                    // 设置子项（版本、发布者、大小、安装日期）
-                    ListView_SetItemText(m_hListView, index, 1, const_cast<LPWSTR>(program.version.c_str()));
-                    ListView_SetItemText(m_hListView, index, 2, const_cast<LPWSTR>(program.publisher.c_str()));
-                    
-                    // 格式化文件大小
-                    String sizeStr = L"-";
-                    if (program.estimatedSize > 0) {
-                        sizeStr = FormatFileSize(program.estimatedSize);
-                    }
-                    ListView_SetItemText(m_hListView, index, 3, const_cast<LPWSTR>(sizeStr.c_str()));
-                    
-                    // 格式化安装日期
-                    String formattedDate = FormatInstallDate(program.installDate);
-                    ListView_SetItemText(m_hListView, index, 4, const_cast<LPWSTR>(formattedDate.c_str()));
-                }
+            if (m_displayIds.empty()) {
+                SetStatusText(L"未找到已安装的程序");
+                return;
             }
             
             // 调整列宽以适应窗口宽度，避免水平滚动条
@@ -2281,33 +2506,32 @@ namespace YG {
             // 构建程序列表文本
             String listText = L"=== YG Uninstaller - 64位 Windows 系统已安装程序列表 ===\r\n\r\n";
             
-            if (uniquePrograms.empty()) {
+            if (m_displayIds.empty()) {
                 listText += L"未找到已安装的程序。请检查系统状态或重新扫描。";
             } else {
-                listText += L"扫描结果：共找到 " + std::to_wstring(uniquePrograms.size()) + L" 个已安装的程序（已去重）\r\n";
+                listText += L"扫描结果：共找到 " + std::to_wstring(m_displayIds.size()) + L" 个已安装的程序（已去重）\r\n";
                 listText += L"===============================================================================\r\n\r\n";
                 
-                for (size_t i = 0; i < uniquePrograms.size(); i++) {
-                    const auto& program = uniquePrograms[i];
+                for (size_t i = 0; i < m_displayIds.size(); i++) {
+                    ProgramId id = m_displayIds[i];
                     
                     // 格式化显示：序号. 程序名称（优先使用displayName，如果为空则使用name）
-                    String programName = !program.displayName.empty() ? program.displayName : program.name;
-                    listText += L"  " + std::to_wstring(i + 1) + L". " + programName;
+                    listText += L"  " + std::to_wstring(i + 1) + L". " + table.GetTitle(id);
                     
                     // 添加版本信息
-                    if (!program.version.empty()) {
-                        listText += L" (v" + program.version + L")";
+                    if (*table.GetVersion(id)) {
+                        listText += L" (v" + String(table.GetVersion(id)) + L")";
                     }
                     
                     // 添加发布者信息
-                    if (!program.publisher.empty()) {
-                        listText += L" - " + program.publisher;
+                    if (*table.GetPublisher(id)) {
+                        listText += L" - " + String(table.GetPublisher(id));
                     }
                     
                     listText += L"\r\n";
                     
                     // 每10个程序后添加一个空行，便于阅读
-                    if ((i + 1) % 10 == 0 && i + 1 < uniquePrograms.size()) {
+                    if ((i + 1) % 10 == 0 && i + 1 < m_displayIds.size()) {
                         listText += L"\r\n";
                     }
                 }
@@ -2331,13 +2555,151 @@ namespace YG {
         YG_LOG_INFO(L"程序列表填充完成");
     }
     
+    void MainWindow::ApplyProgramEnrichment(const std::vector<ProgramEnrichmentUpdate>& updates) {
+        // 结果以程序标识对应，列表在补全期间被重新填充或过滤时仍能找到正确的行；
+        // 整批只生成一张新表，各行Id不变，只补大小和日期时字符串与原表共享
+        ProgramTablePtr patched = m_programTable->WithEnrichment(updates);
+        if (!patched) {
+            return;
+        }
+        m_programTable = patched;
+        
+        // 版本是文本字段：搜索索引中折叠后的版本、版本排序键和版本过滤列都需要重新生成
+        bool versionChanged = std::any_of(updates.begin(), updates.end(), [](const ProgramEnrichmentUpdate& update) {
+            return (update.fields & EnrichedVersion) != 0;
+        });
+        if (versionChanged) {
+            m_searchIndex = ProgramSearchIndex::Build(*m_programTable);
+            m_searchResult = ProgramSearchResult();
+        }
+        m_programSorter->SetTable(m_programTable, versionChanged);
+        m_programFilter->SetTable(m_programTable, m_searchIndex, versionChanged);
+        
+        if (!m_isListViewMode || !m_hListView) {
+            return;
+        }
+        
+        // 只重绘受影响的行范围，大小、日期和版本列在重绘时从新表读取
+        int firstRow = -1;
+        int lastRow = -1;
+        for (const auto& update : updates) {
+            ProgramId id = m_programTable->FindByKey(update.programKey);
+            int row = (id != InvalidProgramId && id < m_rowById.size()) ? m_rowById[id] : -1;
+            if (row != -1) {
+                firstRow = firstRow == -1 ? row : (std::min)(firstRow, row);
+                lastRow = (std::max)(lastRow, row);
+            }
+        }
+        
+        if (lastRow != -1) {
+            ListView_RedrawItems(m_hListView, firstRow, lastRow);
+        }
+    }
+    
+    void MainWindow::ApplyProgramIcons(const ProgramIconUpdate& update) {
+        // 图标列表在解析期间被清空或重建时，旧的索引已经无效
+        if (!m_iconService || update.generation != m_iconService->GetGeneration() || !m_hListView) {
+            return;
+        }
+        
+        int firstRow = -1;
+        int lastRow = -1;
+        for (const auto& icon : update.icons) {
+            ProgramId id = icon.first;
+            if (id >= m_iconIndexById.size()) {
+                continue;
+            }
+            m_iconIndexById[id] = icon.second;
+            
+            int row = id < m_rowById.size() ? m_rowById[id] : -1;
+            if (row != -1) {
+                firstRow = firstRow == -1 ? row : (std::min)(firstRow, row);
+                lastRow = (std::max)(lastRow, row);
+            }
+        }
+        
+        if (lastRow != -1) {
+            ListView_RedrawItems(m_hListView, firstRow, lastRow);
+        }
+    }
+    
+    void MainWindow::OnGetDispInfo(NMLVDISPINFOW* dispInfo) {
+        LVITEMW& item = dispInfo->item;
+        ProgramId id = GetProgramIdAtRow(item.iItem);
+        if (id == InvalidProgramId) {
+            return;
+        }
+            
+        const ProgramTable& table = *m_programTable;
+        
+        if ((item.mask & LVIF_TEXT) && item.pszText && item.cchTextMax > 0) {
+            switch (item.iSubItem) {
+                case 0: // 程序名称
+                    lstrcpynW(item.pszText, table.GetTitle(id), item.cchTextMax);
+                    break;
+                case 1: // 版本
+                    lstrcpynW(item.pszText, table.GetVersion(id), item.cchTextMax);
+                    break;
+                case 2: // 发布者
+                    lstrcpynW(item.pszText, table.GetPublisher(id), item.cchTextMax);
+                    break;
+                case 3: // 大小
+                {
+                    DWORD64 estimatedSize = table.GetEstimatedSize(id);
+                    String sizeStr = estimatedSize > 0 ? FormatFileSize(estimatedSize) : L"-";
+                    lstrcpynW(item.pszText, sizeStr.c_str(), item.cchTextMax);
+                    break;
+                }
+                case 4: // 安装日期
+                {
+                    String formattedDate = FormatInstallDate(table.GetInstallDate(id));
+                    lstrcpynW(item.pszText, formattedDate.c_str(), item.cchTextMax);
+                    break;
+                }
+                default:
+                    item.pszText[0] = L'\0';
+                    break;
+            }
+        }
+        
+        if (item.mask & LVIF_IMAGE) {
+            item.iImage = GetProgramIconIndex(id);
+        }
+    }
+    
+    int MainWindow::FindProgramRow(const NMLVFINDITEMW* findItem) const {
+        const LVFINDINFOW& findInfo = findItem->lvfi;
+        if (!(findInfo.flags & (LVFI_STRING | LVFI_PARTIAL)) || !findInfo.psz || m_displayIds.empty()) {
+            return -1;
+        }
+        
+        // 从起始行开始按名称前缀查找，到末尾后回到开头
+        size_t prefixLength = wcslen(findInfo.psz);
+        size_t count = m_displayIds.size();
+        size_t start = (findItem->iStart >= 0 && static_cast<size_t>(findItem->iStart) < count) ? findItem->iStart : 0;
+        for (size_t offset = 0; offset < count; offset++) {
+            size_t row = (start + offset) % count;
+            if (_wcsnicmp(m_programTable->GetTitle(m_displayIds[row]), findInfo.psz, prefixLength) == 0) {
+                return static_cast<int>(row);
+            }
+        }
+        return -1;
+    }
+    
+    ProgramId MainWindow::GetProgramIdAtRow(int row) const {
+        if (row < 0 || static_cast<size_t>(row) >= m_displayIds.size()) {
+            return InvalidProgramId;
+        }
+        return m_displayIds[row];
+    }
+    
     bool MainWindow::GetSelectedProgram(ProgramInfo& program) {
         if (!m_hListView) {
             YG_LOG_WARNING(L"ListView句柄无效");
             return false;
         }
         
-        YG_LOG_INFO(L"开始获取选中程序，程序总数: " + std::to_wstring(m_programs.size()));
+        YG_LOG_INFO(L"开始获取选中程序，程序总数: " + std::to_wstring(m_programTable->GetCount()));
         
         // 获取选中项的索引
         int selectedIndex = ListView_GetNextItem(m_hListView, -1, LVNI_SELECTED);
@@ -2360,22 +2722,13 @@ namespace YG {
             YG_LOG_INFO(L"ListView显示的程序名称: " + String(displayText));
         }
         
-        // 获取项数据（程序索引）
-        LVITEMW item = {0};
-        item.mask = LVIF_PARAM;
-        item.iItem = selectedIndex;
-        
-        if (!ListView_GetItem(m_hListView, &item)) {
-            YG_LOG_WARNING(L"无法获取ListView项数据");
-            return false;
-        }
-        
-        size_t programIndex = static_cast<size_t>(item.lParam);
-        YG_LOG_INFO(L"存储的程序索引: " + std::to_wstring(programIndex));
+        // 行号对应的程序Id
+        ProgramId programId = GetProgramIdAtRow(selectedIndex);
+        YG_LOG_INFO(L"存储的程序Id: " + std::to_wstring(programId));
         
-        // 从存储的程序列表中获取程序信息
-        if (programIndex < m_programs.size()) {
-            program = m_programs[programIndex];
+        // 从程序表中获取程序信息
+        if (m_programTable->IsValid(programId)) {
+            program = m_programTable->GetProgram(programId);
             YG_LOG_INFO(L"成功获取选中程序: " + program.name);
             YG_LOG_INFO(L"选中程序的注册表路径: " + program.registryKey);
             
@@ -2383,7 +2736,7 @@ namespace YG {
             String debugMsg = L"程序选择调试信息:\n";
             debugMsg += L"ListView选中索引: " + std::to_wstring(selectedIndex) + L"\n";
             debugMsg += L"ListView显示名称: " + String(displayText) + L"\n";
-            debugMsg += L"存储的程序索引: " + std::to_wstring(programIndex) + L"\n";
+            debugMsg += L"存储的程序Id: " + std::to_wstring(programId) + L"\n";
             debugMsg += L"实际程序名称: " + program.name + L"\n";
             debugMsg += L"实际程序显示名称: " + program.displayName + L"\n";
             debugMsg += L"实际注册表路径: " + program.registryKey + L"\n";
@@ -2391,8 +2744,8 @@ namespace YG {
             
             return true;
         } else {
-            YG_LOG_WARNING(L"程序索引超出范围: " + std::to_wstring(programIndex) + 
-                         L", 总数: " + std::to_wstring(m_programs.size()));
+            YG_LOG_WARNING(L"程序Id无效: " + std::to_wstring(programId) + 
+                         L", 总数: " + std::to_wstring(m_programTable->GetCount()));
             return false;
         }
         
@@ -2788,68 +3141,39 @@ namespace YG {
     }
     
     void MainWindow::SortProgramList(int column, bool ascending) {
-        if (!m_isListViewMode || m_programs.empty()) {
+        if (!m_isListViewMode || m_displayIds.empty() || column < 0 || column >= SortColumnCount) {
             return;
         }
         
         YG_LOG_INFO(L"开始排序程序列表，列: " + std::to_wstring(column) + L", 升序: " + (ascending ? L"是" : L"否"));
         
-        // 排序程序列表
-        std::sort(m_programs.begin(), m_programs.end(), 
-                 [column, ascending](const ProgramInfo& a, const ProgramInfo& b) {
-                     return CompareProgramInfo(a, b, column, ascending) < 0;
-                 });
+        // 记下选中的程序，排序后按Id恢复
+        std::vector<ProgramId> selectedIds;
+        for (int row = ListView_GetNextItem(m_hListView, -1, LVNI_SELECTED); row != -1;
+             row = ListView_GetNextItem(m_hListView, row, LVNI_SELECTED)) {
+            ProgramId id = GetProgramIdAtRow(row);
+            if (id != InvalidProgramId) {
+                selectedIds.push_back(id);
+            }
+        }
         
-        // 重新填充ListView
-        PopulateProgramList(m_programs);
+        // 按预计算的排序键重排程序Id；同一列再次点击时反转上次的结果
+        bool reused = m_programSorter->Sort(m_displayIds, static_cast<ProgramSortColumn>(column), ascending);
         
-        YG_LOG_INFO(L"程序列表排序完成");
-    }
-    
-    int MainWindow::CompareProgramInfo(const ProgramInfo& program1, const ProgramInfo& program2, int column, bool ascending) {
-        int result = 0;
-        
-        switch (column) {
-            case 0: // 程序名称
-            {
-                String name1 = !program1.displayName.empty() ? program1.displayName : program1.name;
-                String name2 = !program2.displayName.empty() ? program2.displayName : program2.name;
-                result = _wcsicmp(name1.c_str(), name2.c_str());
-                break;
-            }
-            case 1: // 版本
-            {
-                result = _wcsicmp(program1.version.c_str(), program2.version.c_str());
-                break;
-            }
-            case 2: // 发布者
-            {
-                result = _wcsicmp(program1.publisher.c_str(), program2.publisher.c_str());
-                break;
-            }
-            case 3: // 大小
-            {
-                if (program1.estimatedSize < program2.estimatedSize) {
-                    result = -1;
-                } else if (program1.estimatedSize > program2.estimatedSize) {
-                    result = 1;
-                } else {
-                    result = 0;
-                }
-                break;
-            }
-            case 4: // 安装日期
-            {
-                result = _wcsicmp(program1.installDate.c_str(), program2.installDate.c_str());
-                break;
-            }
-            default:
-                result = 0;
-                break;
+        // 显示的程序不变，只更新行号映射并重绘，不重新填充列表
+        for (size_t i = 0; i < m_displayIds.size(); i++) {
+            m_rowById[m_displayIds[i]] = static_cast<int>(i);
+        }
+        ListView_SetItemState(m_hListView, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+        for (ProgramId id : selectedIds) {
+            ListView_SetItemState(m_hListView, m_rowById[id], LVIS_SELECTED, LVIS_SELECTED);
+        }
+        if (!selectedIds.empty()) {
+            ListView_EnsureVisible(m_hListView, m_rowById[selectedIds.front()], FALSE);
         }
+        ListView_RedrawItems(m_hListView, 0, static_cast<int>(m_displayIds.size()) - 1);
         
-        // 如果是降序，反转结果
-        return ascending ? result : -result;
+        YG_LOG_INFO(reused ? L"程序列表排序完成（反转上次的排序结果）" : L"程序列表排序完成");
     }
     
     ErrorCode MainWindow::CreateImageList() {
@@ -2865,109 +3189,31 @@ namespace YG {
         (void)hOldImageList; // 抑制未使用警告
         
         // 添加默认程序图标
-        HICON hDefaultIcon = LoadIcon(nullptr, IDI_APPLICATION);
-        if (hDefaultIcon) {
-            ImageList_AddIcon(m_hImageList, hDefaultIcon);
-            DestroyIcon(hDefaultIcon);
+        AddDefaultProgramIcon();
+        
+        // 程序图标在后台解析，结果投递回界面线程
+        if (!m_iconService) {
+            HWND hMainWnd = m_hWnd;
+            m_iconService = YG::MakeUnique<ProgramIconService>(ProgramIconService::GetDefaultCachePath(),
+                [hMainWnd](const ProgramIconUpdate& update) {
+                    ProgramIconUpdate* posted = new ProgramIconUpdate(update);
+                    if (!PostMessage(hMainWnd, WM_USER + 104, 0, reinterpret_cast<LPARAM>(posted))) {
+                        delete posted;
+                    }
+                });
         }
+        m_iconService->Reset(m_hImageList, GetDefaultProgramIcon());
         
         YG_LOG_INFO(L"图标列表创建成功");
         return ErrorCode::Success;
     }
     
-    int MainWindow::ExtractProgramIcon(const ProgramInfo& program) {
-        // 尝试从不同位置提取程序图标
-        HICON hIcon = nullptr;
-        
-        // 1. 优先使用注册表中的DisplayIcon字段
-        if (!program.iconPath.empty()) {
-            String iconPath = program.iconPath;
-            
-            // 处理图标路径格式：可能包含文件路径和图标索引
-            size_t commaPos = iconPath.find(L',');
-            int iconIndex = 0;
-            
-            if (commaPos != String::npos) {
-                // 有图标索引
-                iconPath = iconPath.substr(0, commaPos);
-                try {
-                    iconIndex = std::stoi(iconPath.substr(commaPos + 1));
-                } catch (...) {
-                    iconIndex = 0;
-                }
-            }
-            
-            // 移除引号
-            if (!iconPath.empty() && iconPath.front() == L'"') {
-                iconPath = iconPath.substr(1);
-            }
-            if (!iconPath.empty() && iconPath.back() == L'"') {
-                iconPath.pop_back();
-            }
-            
-            // 提取图标
-            if (!iconPath.empty()) {
-                hIcon = ExtractIcon(m_hInstance, iconPath.c_str(), iconIndex);
-            }
-        }
-        
-        // 2. 尝试从卸载字符串中提取可执行文件路径
-        if (!hIcon && !program.uninstallString.empty()) {
-            String exePath = program.uninstallString;
-            
-            // 简单解析：查找.exe文件
-            size_t exePos = exePath.find(L".exe");
-            if (exePos != String::npos) {
-                exePath = exePath.substr(0, exePos + 4);
-                
-                // 移除引号
-                if (!exePath.empty() && exePath.front() == L'"') {
-                    exePath = exePath.substr(1);
-                }
-                if (!exePath.empty() && exePath.back() == L'"') {
-                    exePath.pop_back();
-                }
-                
-                // 提取图标
-                hIcon = ExtractIcon(m_hInstance, exePath.c_str(), 0);
-            }
-        }
-        
-        // 3. 尝试从安装路径提取
-        if (!hIcon && !program.installLocation.empty()) {
-            String mainExe = program.installLocation + L"\\";
-            
-            // 根据程序名称猜测主执行文件
-            if (program.displayName.find(L"Chrome") != String::npos) {
-                mainExe += L"chrome.exe";
-            } else if (program.displayName.find(L"Office") != String::npos) {
-                mainExe += L"WINWORD.EXE";
-            } else if (program.displayName.find(L"Adobe") != String::npos) {
-                mainExe += L"AcroRd32.exe";
-            } else if (program.displayName.find(L"VLC") != String::npos) {
-                mainExe += L"vlc.exe";
-            } else if (program.displayName.find(L"7-Zip") != String::npos) {
-                mainExe += L"7zFM.exe";
-            } else if (program.displayName.find(L"Code") != String::npos) {
-                mainExe += L"Code.exe";
-            } else if (program.displayName.find(L"Notepad") != String::npos) {
-                mainExe += L"notepad++.exe";
-            } else if (program.displayName.find(L"WinRAR") != String::npos) {
-                mainExe += L"WinRAR.exe";
-            }
-            
-            hIcon = ExtractIcon(m_hInstance, mainExe.c_str(), 0);
-        }
-        
-        // 4. 如果成功提取到图标，添加到图标列表
-        if (hIcon && hIcon != (HICON)1) {
-            int iconIndex = ImageList_AddIcon(m_hImageList, hIcon);
-            DestroyIcon(hIcon);
-            return iconIndex;
+    void MainWindow::AddDefaultProgramIcon() {
+        HICON hDefaultIcon = LoadIcon(nullptr, IDI_APPLICATION);
+        if (hDefaultIcon && m_hImageList) {
+            ImageList_AddIcon(m_hImageList, hDefaultIcon);
+            DestroyIcon(hDefaultIcon);
         }
-        
-        // 5. 使用默认图标
-        return GetDefaultProgramIcon();
     }
     
     int MainWindow::GetDefaultProgramIcon() {
@@ -2975,112 +3221,31 @@ namespace YG {
         return 0;
     }
     
-    std::vector<ProgramInfo> MainWindow::RemoveDuplicatePrograms(const std::vector<ProgramInfo>& programs) {
-        std::vector<ProgramInfo> uniquePrograms;
-        
-        YG_LOG_INFO(L"开始去重处理，原始程序数量: " + std::to_wstring(programs.size()));
-        
-        for (const auto& program : programs) {
-            bool isDuplicate = false;
-            
-            // 检查是否与已有程序重复
-            for (const auto& existingProgram : uniquePrograms) {
-                if (IsSameProgram(program, existingProgram)) {
-                    isDuplicate = true;
-                    YG_LOG_INFO(L"发现重复程序: " + program.displayName + L" (版本: " + program.version + L")");
-                    break;
-                }
-            }
-            
-            // 如果不重复，添加到结果列表
-            if (!isDuplicate) {
-                uniquePrograms.push_back(program);
-            }
+    int MainWindow::GetProgramIconIndex(ProgramId id) {
+        if (id >= m_iconIndexById.size()) {
+            m_iconIndexById.resize(m_programTable->GetSlotCount(), -1);
         }
-        
-        YG_LOG_INFO(L"去重完成，去重后程序数量: " + std::to_wstring(uniquePrograms.size()) + 
-                   L", 移除重复项: " + std::to_wstring(programs.size() - uniquePrograms.size()));
-        
-        return uniquePrograms;
-    }
-    
-    // 版本比较辅助函数
-    bool MainWindow::CompareVersions(const String& version1, const String& version2) {
-        if (version1.empty() || version2.empty()) {
-            return false; // 如果任一版本为空，不认为相同
+        if (id >= m_iconIndexById.size()) {
+            return GetDefaultProgramIcon();
         }
         
-        // 简单的版本比较：完全相同的版本字符串
-        return version1 == version2;
+        // 只为实际显示过的行请求图标；解析在后台进行，完成前先显示默认图标
+        if (m_iconIndexById[id] == -1 && m_iconService) {
+            m_iconIndexById[id] = ICON_PENDING;
+            m_iconService->Request(id, m_programTable->GetProgram(id));
+        }
+        return m_iconIndexById[id] >= 0 ? m_iconIndexById[id] : GetDefaultProgramIcon();
     }
     
-    bool MainWindow::IsSameProgram(const ProgramInfo& program1, const ProgramInfo& program2) {
-        // 获取程序显示名称
-        String name1 = !program1.displayName.empty() ? program1.displayName : program1.name;
-        String name2 = !program2.displayName.empty() ? program2.displayName : program2.name;
-        
-        // 转换为小写进行比较（不区分大小写）
-        std::transform(name1.begin(), name1.end(), name1.begin(), ::towlower);
-        std::transform(name2.begin(), name2.end(), name2.begin(), ::towlower);
-        
-        // 1. 程序名称完全相同
-        if (name1 == name2) {
-            // 如果名称和版本都相同，认为是重复
-            if (program1.version == program2.version) {
-                // 进一步检查发布者，确保是同一程序
-            if (program1.publisher == program2.publisher) {
-                    return true; // 名称、版本、发布者都相同，认为是重复
-            }
-            }
-            // 注意：不再将同名但不同版本的程序视为重复，保留不同版本
-        }
-        
-        // 2. 检查是否为同一程序的不同架构版本（如x86/x64）
-        String baseName1 = name1;
-        String baseName2 = name2;
-        
-        // 移除常见的架构标识
-        const std::vector<String> archSuffixes = {
-            L" (x64)", L" (x86)", L" (64-bit)", L" (32-bit)", 
-            L" x64", L" x86", L" 64-bit", L" 32-bit"
-        };
-        
-        for (const auto& suffix : archSuffixes) {
-            size_t pos1 = baseName1.find(suffix);
-            if (pos1 != String::npos) {
-                baseName1 = baseName1.substr(0, pos1);
-            }
-            
-            size_t pos2 = baseName2.find(suffix);
-            if (pos2 != String::npos) {
-                baseName2 = baseName2.substr(0, pos2);
-            }
-        }
-        
-        // 如果移除架构标识后名称相同，且发布者相同，进一步检查版本
-        if (baseName1 == baseName2 && program1.publisher == program2.publisher) {
-            // 只有版本也相同时才认为是重复（避免移除不同版本）
-            if (program1.version == program2.version) {
-            return true;
-            }
-            // 如果版本不同，保留两个版本（可能是不同架构的同一程序）
-        }
+    void MainWindow::ResetProgramIcons() {
+        m_iconIndexById.assign(m_programTable->GetSlotCount(), -1);
         
-        // 3. 检查安装路径是否相同（可能是同一程序的不同条目）
-        if (!program1.installLocation.empty() && !program2.installLocation.empty()) {
-            String path1 = program1.installLocation;
-            String path2 = program2.installLocation;
-            
-            // 转换为小写比较
-            std::transform(path1.begin(), path1.end(), path1.begin(), ::towlower);
-            std::transform(path2.begin(), path2.end(), path2.begin(), ::towlower);
-            
-            if (path1 == path2) {
-                return true; // 安装路径相同，认为是重复
-            }
+        // 进入新的一代：保留第一个（默认）图标，其余图标与未完成的解析一起丢弃
+        if (m_iconService) {
+            m_iconService->Reset(m_hImageList, GetDefaultProgramIcon());
+        } else if (m_hImageList && ImageList_GetImageCount(m_hImageList) > 1) {
+            ImageList_SetImageCount(m_hImageList, 1);
         }
-        
-        return false; // 不是重复程序
     }
     
     int MainWindow::GetSelectedPrograms(std::vector<ProgramInfo>& programs) {
@@ -3091,23 +3256,14 @@ namespace YG {
         }
         
         int selectedCount = 0;
-        int itemCount = ListView_GetItemCount(m_hListView);
         
-        for (int i = 0; i < itemCount; i++) {
-            UINT state = ListView_GetItemState(m_hListView, i, LVIS_SELECTED);
-            if (state & LVIS_SELECTED) {
-                // 获取程序索引
-                LVITEMW item = {0};
-                item.mask = LVIF_PARAM;
-                item.iItem = i;
-                
-                if (ListView_GetItem(m_hListView, &item)) {
-                    size_t programIndex = static_cast<size_t>(item.lParam);
-                    if (programIndex < m_programs.size()) {
-                        programs.push_back(m_programs[programIndex]);
-                        selectedCount++;
-                    }
-                }
+        // 逐个取选中行，行号对应m_displayIds中的程序Id
+        int row = -1;
+        while ((row = ListView_GetNextItem(m_hListView, row, LVNI_SELECTED)) != -1) {
+            ProgramId programId = GetProgramIdAtRow(row);
+            if (m_programTable->IsValid(programId)) {
+                programs.push_back(m_programTable->GetProgram(programId));
+                selectedCount++;
             }
         }
         
@@ -3147,9 +3303,11 @@ namespace YG {
             return;
         }
         
-        // 执行批量卸载
+        // 执行批量卸载；逐个卸载完成时不单独扫描残留，全部结束后一次扫描
         int successCount = 0;
         int failedCount = 0;
+        std::vector<ProgramInfo> uninstalledPrograms;
+        m_isBatchUninstalling = true;
         
         // 显示进度
         UpdateProgress(0, true);
@@ -3183,6 +3341,7 @@ namespace YG {
             
             if (uninstallResult == ErrorCode::Success) {
                 successCount++;
+                uninstalledPrograms.push_back(program);
                 YG_LOG_INFO(L"批量卸载成功: " + programName);
             } else {
                 failedCount++;
@@ -3190,6 +3349,8 @@ namespace YG {
             }
         }
         
+        m_isBatchUninstalling = false;
+        
         // 隐藏进度条
         UpdateProgress(0, false);
         
@@ -3208,6 +3369,18 @@ namespace YG {
         
         YG_LOG_INFO(L"批量卸载完成，成功: " + std::to_wstring(successCount) + 
                    L", 失败: " + std::to_wstring(failedCount));
+        
+        // 一次扫描全部已卸载程序的残留，每个位置只遍历一次
+        if (!uninstalledPrograms.empty()) {
+            if (uninstalledPrograms.size() == 1) {
+                m_currentUninstallingProgram = uninstalledPrograms[0];
+            } else {
+                m_currentUninstallingProgram = ProgramInfo();
+                m_currentUninstallingProgram.name = L"批量卸载的 " + std::to_wstring(uninstalledPrograms.size()) + L" 个程序";
+            }
+            SetStatusText(L"批量卸载完成，正在扫描残留文件...");
+            StartResidualScan(uninstalledPrograms);
+        }
     }
     
     void MainWindow::SelectAllPrograms(bool selectAll) {
@@ -3215,11 +3388,9 @@ namespace YG {
             return;
         }
         
+        // 虚拟列表以-1一次设置全部行的状态
         int itemCount = ListView_GetItemCount(m_hListView);
-        for (int i = 0; i < itemCount; i++) {
-            ListView_SetItemState(m_hListView, i, 
-                                 selectAll ? LVIS_SELECTED : 0, LVIS_SELECTED);
-        }
+        ListView_SetItemState(m_hListView, -1, selectAll ? LVIS_SELECTED : 0, LVIS_SELECTED);
         
         YG_LOG_INFO(L"全选操作: " + String(selectAll ? L"全选" : L"取消全选") + 
                    L", 影响程序数: " + std::to_wstring(itemCount));
@@ -3239,6 +3410,11 @@ namespace YG {
         // 设置ListView视图模式
         ListView_SetView(m_hListView, mode);
         
+        // 图标列表可能被重建，先停止后台向旧列表添加图标
+        if (m_iconService && (mode == LV_VIEW_ICON || mode == LV_VIEW_SMALLICON || mode == LV_VIEW_LIST)) {
+            m_iconService->Reset(nullptr, GetDefaultProgramIcon());
+        }
+        
         // 根据不同视图模式调整布局
         switch (mode) {
             case LV_VIEW_ICON:
@@ -3248,6 +3424,7 @@ namespace YG {
                         ImageList_Destroy(m_hImageList);
                     }
                     m_hImageList = ImageList_Create(32, 32, ILC_COLOR32 | ILC_MASK, 10, 10);
+                    AddDefaultProgramIcon();
                     HIMAGELIST hOldImageList = ListView_SetImageList(m_hListView, m_hImageList, LVSIL_NORMAL);
                     (void)hOldImageList; // 抑制未使用警告
                     break;
@@ -3261,6 +3438,7 @@ namespace YG {
                         ImageList_Destroy(m_hImageList);
                     }
                     m_hImageList = ImageList_Create(16, 16, ILC_COLOR32 | ILC_MASK, 10, 10);
+                    AddDefaultProgramIcon();
                     HIMAGELIST hOldImageList2 = ListView_SetImageList(m_hListView, m_hImageList, LVSIL_SMALL);
                     (void)hOldImageList2; // 抑制未使用警告
                     break;
@@ -3274,8 +3452,9 @@ namespace YG {
                 }
         }
         
-        // 重新填充程序列表以适应新视图
-        PopulateProgramList(m_filteredPrograms.empty() ? m_programs : m_filteredPrograms);
+        // 图标列表已重建，重新填充程序列表以适应新视图
+        ResetProgramIcons();
+        ShowProgramRows();
         
         YG_LOG_INFO(L"ListView视图模式已切换");
     }
@@ -3554,7 +3733,7 @@ namespace YG {
                 0,  // 不需要额外边框，容器已有边框
                 WC_LISTVIEWW,
                 L"",
-                WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS,
+                WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | LVS_SHOWSELALWAYS | LVS_OWNERDATA,
                 leftWidth + 5, menuHeight + 5,  // 直接相对于主窗口的位置
                 rightWidth - 10, availableHeight - 10,  // 填满右侧区域
                 m_hWnd,  // 父窗口是主窗口，确保事件路由正确
@@ -4204,7 +4383,7 @@ namespace YG {
                     RegistryHelper::ReadString(hKey, L"URLUpdateInfo", urlUpdateInfo);
                     RegistryHelper::ReadString(hKey, L"Publisher", publisherURL);
                     
-                    RegCloseKey(hKey);
+                    RegistryHelper::CloseKey(hKey);
                     
                     // 选择最合适的网站链接
                     if (!helpLink.empty() && IsValidURL(helpLink)) {
@@ -5200,6 +5379,11 @@ namespace YG {
     void MainWindow::OnUninstallComplete(const ProgramInfo& program, bool success) {
         YG_LOG_INFO(L"卸载完成回调: " + program.name + L", 成功: " + std::to_wstring(success));
         
+        // 批量卸载结束后统一扫描残留
+        if (m_isBatchUninstalling) {
+            return;
+        }
+        
         // 使用PostMessage确保在主线程中安全处理
         LPARAM lParam = success ? 1 : 0;
         PostMessage(m_hWnd, WM_USER + 100, 0, lParam);
@@ -5212,46 +5396,52 @@ namespace YG {
             // 卸载成功，启动残留扫描
             SetStatusText(L"卸载完成，正在扫描残留文件...");
             
-            if (m_residualScanner) {
-                try {
-                    // 设置扫描进度回调
-                    auto progressCallback = [this](int percentage, const String& currentPath, int foundCount) {
-                        // 使用PostMessage确保线程安全
-                        PostMessage(m_hWnd, WM_USER + 101, percentage, foundCount);
-                    };
+            StartResidualScan(std::vector<ProgramInfo>(1, m_currentUninstallingProgram));
+        } else {
+            YG_LOG_WARNING(L"卸载失败，跳过残留扫描");
+            SetStatusText(L"卸载失败");
+            // 延迟刷新程序列表
+            SetTimer(m_hWnd, 4, 1000, nullptr);
+        }
+    }
                     
-                    // 启动残留扫描
-                    ErrorCode scanResult = m_residualScanner->StartScan(m_currentUninstallingProgram, progressCallback);
+    void MainWindow::StartResidualScan(const std::vector<ProgramInfo>& programs) {
+        if (!m_residualScanner) {
+            YG_LOG_WARNING(L"残留扫描器未初始化");
+            SetStatusText(L"卸载完成");
+            // 延迟刷新程序列表
+            SetTimer(m_hWnd, 4, 1000, nullptr);
+            return;
+        }
                     
-                    if (scanResult == ErrorCode::Success) {
-                        YG_LOG_INFO(L"残留扫描已启动");
-                    } else {
-                        YG_LOG_ERROR(L"残留扫描启动失败");
-                        SetStatusText(L"残留扫描启动失败");
-                        // 延迟刷新程序列表
-                        SetTimer(m_hWnd, 4, 1000, nullptr);
-                    }
-                } catch (const std::exception& e) {
-                    (void)e; // 避免未使用变量警告
-                    YG_LOG_ERROR(L"残留扫描发生异常");
-                    SetStatusText(L"残留扫描发生异常");
-                    // 延迟刷新程序列表
-                    SetTimer(m_hWnd, 4, 1000, nullptr);
-                } catch (...) {
-                    YG_LOG_ERROR(L"残留扫描发生未知异常");
-                    SetStatusText(L"残留扫描发生未知异常");
-                    // 延迟刷新程序列表
-                    SetTimer(m_hWnd, 4, 1000, nullptr);
-                }
+        try {
+            // 设置扫描进度回调
+            auto progressCallback = [this](int percentage, const String& currentPath, int foundCount) {
+                (void)currentPath;
+                // 使用PostMessage确保线程安全
+                PostMessage(m_hWnd, WM_USER + 101, percentage, foundCount);
+            };
+            
+            // 启动残留扫描
+            ErrorCode scanResult = m_residualScanner->StartBatchScan(programs, progressCallback);
+            
+            if (scanResult == ErrorCode::Success) {
+                YG_LOG_INFO(L"残留扫描已启动，程序数: " + std::to_wstring(programs.size()));
             } else {
-                YG_LOG_WARNING(L"残留扫描器未初始化");
-                SetStatusText(L"卸载完成");
+                YG_LOG_ERROR(L"残留扫描启动失败");
+                SetStatusText(L"残留扫描启动失败");
                 // 延迟刷新程序列表
                 SetTimer(m_hWnd, 4, 1000, nullptr);
             }
-        } else {
-            YG_LOG_WARNING(L"卸载失败，跳过残留扫描");
-            SetStatusText(L"卸载失败");
+        } catch (const std::exception& e) {
+            (void)e; // 避免未使用变量警告
+            YG_LOG_ERROR(L"残留扫描发生异常");
+            SetStatusText(L"残留扫描发生异常");
+            // 延迟刷新程序列表
+            SetTimer(m_hWnd, 4, 1000, nullptr);
+        } catch (...) {
+            YG_LOG_ERROR(L"残留扫描发生未知异常");
+            SetStatusText(L"残留扫描发生未知异常");
             // 延迟刷新程序列表
             SetTimer(m_hWnd, 4, 1000, nullptr);
         }
@@ -5348,4 +5538,47 @@ namespace YG {
         YG_LOG_INFO(L"清理对话框已关闭，结果: " + std::to_wstring(static_cast<int>(result)));
     }
     
+    void MainWindow::UndoLastCleanup() {
+        QuarantineStore& store = QuarantineStore::GetShared();
+        std::vector<QuarantineBatch> batches;
+        if (store.ListBatches(batches) != ErrorCode::Success || batches.empty()) {
+            MessageBox(m_hWnd, L"隔离区中没有可以恢复的清理记录。", L"撤销上次清理", MB_OK | MB_ICONINFORMATION);
+            return;
+        }
+        
+        // 最近一个批次
+        const QuarantineBatch& batch = batches.front();
+        FILETIME createdTime;
+        createdTime.dwLowDateTime = static_cast<DWORD>(batch.createdTime & 0xFFFFFFFF);
+        createdTime.dwHighDateTime = static_cast<DWORD>(batch.createdTime >> 32);
+        SYSTEMTIME utcTime, localTime;
+        String timeText;
+        if (FileTimeToSystemTime(&createdTime, &utcTime) && SystemTimeToTzSpecificLocalTime(nullptr, &utcTime, &localTime)) {
+            timeText = StringUtils::FormatDateTime(localTime);
+        }
+        
+        String confirmMsg = L"确定要恢复以下清理吗？\n\n";
+        confirmMsg += L"程序: " + batch.label + L"\n";
+        confirmMsg += L"时间: " + timeText + L"\n";
+        confirmMsg += L"项目: " + std::to_wstring(batch.entries.size()) + L" 个（" + FormatFileSize(batch.GetTotalSize()) + L"）\n\n";
+        confirmMsg += L"文件将移回原处，注册表项将重新写入。";
+        if (MessageBox(m_hWnd, confirmMsg.c_str(), L"撤销上次清理", MB_YESNO | MB_ICONQUESTION) != IDYES) {
+            return;
+        }
+        
+        size_t restoredCount = 0;
+        ErrorCode result = store.Restore(batch.id, restoredCount);
+        if (result == ErrorCode::Success) {
+            SetStatusText(L"已恢复 " + std::to_wstring(restoredCount) + L" 个残留项");
+            MessageBox(m_hWnd, L"上次清理已撤销！", L"撤销上次清理", MB_OK | MB_ICONINFORMATION);
+        } else {
+            SetStatusText(L"部分残留项未能恢复");
+            MessageBox(m_hWnd, L"已恢复部分项目，其余项目的原位置已被占用或无法写入，仍保留在隔离区中，详情请查看日志。",
+                       L"撤销上次清理", MB_OK | MB_ICONWARNING);
+        }
+        
+        // 卸载注册表项可能已恢复
+        RefreshProgramList(m_includeSystemComponents);
+    }
+
 } // namespace YG
@@ -0,0 +1,140 @@
+/**
+ * @file ResidualListModel.cpp
+ * @brief 清理对话框虚拟列表数据模型实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "ui/ResidualListModel.h"
+#include <algorithm>
+
+namespace YG {
+    
+    ResidualListModel::ResidualListModel()
+        : m_groupStarts(1, 0), m_rowCount(0), m_selectedCount(0), m_selectedSize(0), m_totalSize(0) {
+    }
+    
+    void ResidualListModel::Reset(const std::vector<ResidualGroup>& groups) {
+        m_groups = groups;
+        m_groupStarts.assign(1, 0);
+        m_rowCount = 0;
+        m_totalSize = 0;
+        for (const auto& group : m_groups) {
+            m_rowCount += group.items.size();
+            m_groupStarts.push_back(m_rowCount);
+            for (const auto& item : group.items) {
+                m_totalSize += item.size;
+            }
+        }
+        
+        m_selection.assign((m_rowCount + BitsPerWord - 1) / BitsPerWord, 0);
+        m_selectedCount = 0;
+        m_selectedSize = 0;
+        size_t row = 0;
+        for (const auto& group : m_groups) {
+            for (const auto& item : group.items) {
+                if (item.isSelected) {
+                    SetSelected(row, true);
+                }
+                ++row;
+            }
+        }
+    }
+    
+    size_t ResidualListModel::GetGroupIndex(size_t row) const {
+        // 空分组的起始行与下一个分组相同，upper_bound落在最后一个起始行不大于row的分组
+        auto it = std::upper_bound(m_groupStarts.begin(), m_groupStarts.end(), row);
+        return static_cast<size_t>(it - m_groupStarts.begin()) - 1;
+    }
+    
+    const ResidualItem& ResidualListModel::GetItem(size_t row) const {
+        size_t groupIndex = GetGroupIndex(row);
+        return m_groups[groupIndex].items[row - m_groupStarts[groupIndex]];
+    }
+    
+    bool ResidualListModel::SetSelected(size_t row, bool selected) {
+        if (row >= m_rowCount || IsSelected(row) == selected) {
+            return false;
+        }
+        
+        std::uint64_t bit = std::uint64_t(1) << (row % BitsPerWord);
+        DWORD64 size = GetItem(row).size;
+        if (selected) {
+            m_selection[row / BitsPerWord] |= bit;
+            m_selectedCount++;
+            m_selectedSize += size;
+        } else {
+            m_selection[row / BitsPerWord] &= ~bit;
+            m_selectedCount--;
+            m_selectedSize -= size;
+        }
+        return true;
+    }
+    
+    bool ResidualListModel::Toggle(size_t row) {
+        bool selected = row < m_rowCount && !IsSelected(row);
+        SetSelected(row, selected);
+        return selected;
+    }
+    
+    void ResidualListModel::SetAllSelected(bool selected) {
+        std::fill(m_selection.begin(), m_selection.end(), selected ? ~std::uint64_t(0) : 0);
+        
+        // 最后一个字中超出行数的位保持为0
+        size_t tailBits = m_rowCount % BitsPerWord;
+        if (selected && tailBits != 0) {
+            m_selection.back() = (std::uint64_t(1) << tailBits) - 1;
+        }
+        
+        m_selectedCount = selected ? m_rowCount : 0;
+        m_selectedSize = selected ? m_totalSize : 0;
+    }
+    
+    void ResidualListModel::SetRangeSelected(size_t first, size_t last, bool selected) {
+        last = (std::min)(last, m_rowCount);
+        if (first == 0 && last == m_rowCount) {
+            SetAllSelected(selected);
+            return;
+        }
+        
+        size_t row = first;
+        while (row < last) {
+            // 整个字都已是目标状态时跳过
+            if (row % BitsPerWord == 0 && row + BitsPerWord <= last &&
+                m_selection[row / BitsPerWord] == (selected ? ~std::uint64_t(0) : 0)) {
+                row += BitsPerWord;
+                continue;
+            }
+            SetSelected(row, selected);
+            ++row;
+        }
+    }
+    
+    std::vector<ResidualItem> ResidualListModel::GetSelectedItems() const {
+        std::vector<ResidualItem> items;
+        items.reserve(m_selectedCount);
+        
+        size_t row = 0;
+        for (const auto& group : m_groups) {
+            for (const auto& item : group.items) {
+                if (IsSelected(row)) {
+                    items.push_back(item);
+                    items.back().isSelected = true;
+                }
+                ++row;
+            }
+        }
+        return items;
+    }
+    
+    std::vector<ResidualItem> ResidualListModel::GetAllItems() const {
+        std::vector<ResidualItem> items;
+        items.reserve(m_rowCount);
+        for (const auto& group : m_groups) {
+            items.insert(items.end(), group.items.begin(), group.items.end());
+        }
+        return items;
+    }
+
+} // namespace YG
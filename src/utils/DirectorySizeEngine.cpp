@@ -0,0 +1,321 @@
+/**
+ * @file DirectorySizeEngine.cpp
+ * @brief 精确的并行目录大小统计实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/DirectorySizeEngine.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <thread>
+
+namespace YG {
+    
+    namespace {
+        
+        const size_t s_defaultMaxThreads = 8;               // 目录遍历受磁盘限制，线程再多收益不大
+        const size_t s_defaultMaxCacheEntries = 200000;     // 约为几十个大型安装目录的目录总数
+        const size_t s_spawnBacklog = 2;                    // 本线程队列积压超过该数量时提交辅助任务
+        const int s_idleSpinsBeforeSleep = 64;              // 空闲时先让出时间片，超过次数后短暂休眠
+        
+        struct DirectoryTask {
+            String path;                            ///< 目录路径
+            DWORD64 lastWriteTime;                  ///< 目录当前的最后写入时间
+        };
+        
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<DirectoryTask> tasks;
+        };
+        
+        String JoinPath(const String& directoryPath, const String& name) {
+            if (!directoryPath.empty() && (directoryPath.back() == L'\\' || directoryPath.back() == L'/')) {
+                return directoryPath + name;
+            }
+            return directoryPath + L"\\" + name;
+        }
+        
+        // 缓存键：小写并去掉末尾分隔符，"C:\\Dir"与"c:\\dir\\"对应同一项
+        String MakeCacheKey(const String& directoryPath) {
+            String key = StringUtils::ToLower(directoryPath);
+            while (key.size() > 1 && (key.back() == L'\\' || key.back() == L'/')) {
+                key.pop_back();
+            }
+            return key;
+        }
+    
+    } // namespace
+    
+    /**
+     * @brief 一次Calculate的遍历状态
+     *
+     * 由调用线程和提交到线程池的辅助任务共同持有：辅助任务可能在遍历结束后才开始执行，
+     * 此时pending已为0，立即返回。
+     */
+    struct DirectorySizeEngine::Traversal : std::enable_shared_from_this<Traversal> {
+        std::vector<std::unique_ptr<WorkerQueue>> queues;   ///< 每个线程一个队列
+        std::atomic<size_t> pending;                        ///< 已入队或正在处理的目录数
+        const std::atomic<bool>* cancelFlag;                ///< 取消标志
+        
+        std::atomic<DWORD64> totalBytes;
+        std::atomic<DWORD64> fileCount;
+        std::atomic<DWORD64> directoryCount;
+        std::atomic<DWORD64> skippedReparsePoints;
+        std::atomic<DWORD64> inaccessibleDirectories;
+        std::atomic<DWORD64> cacheHits;
+        
+        std::atomic<size_t> helperCount;                    ///< 已提交的辅助任务数
+        
+        explicit Traversal(size_t threadCount, const std::atomic<bool>* cancel)
+            : pending(0), cancelFlag(cancel), totalBytes(0), fileCount(0), directoryCount(0),
+              skippedReparsePoints(0), inaccessibleDirectories(0), cacheHits(0), helperCount(0) {
+            for (size_t i = 0; i < threadCount; ++i) {
+                queues.push_back(YG::MakeUnique<WorkerQueue>());
+            }
+        }
+        
+        bool IsCancelled() const {
+            return cancelFlag && cancelFlag->load();
+        }
+    };
+    
+    DirectorySizeEngine::DirectorySizeEngine(std::shared_ptr<IFileSystemSource> fileSystem, size_t maxThreads,
+                                             size_t maxCacheEntries)
+        : m_fileSystem(fileSystem), m_maxThreads(maxThreads), m_maxCacheEntries(maxCacheEntries) {
+        if (!m_fileSystem) {
+            m_fileSystem = std::make_shared<Win32FileSystemSource>();
+        }
+        if (m_maxThreads == 0) {
+            m_maxThreads = (std::min)(ThreadPool::DefaultThreadCount(), s_defaultMaxThreads);
+        }
+        if (m_maxCacheEntries == 0) {
+            m_maxCacheEntries = s_defaultMaxCacheEntries;
+        }
+        if (m_maxThreads > 1) {
+            m_pool = YG::MakeUnique<ThreadPool>(m_maxThreads - 1);
+        }
+    }
+    
+    DirectorySizeEngine::~DirectorySizeEngine() {
+    }
+    
+    DirectorySizeEngine& DirectorySizeEngine::GetShared() {
+        static DirectorySizeEngine engine;
+        return engine;
+    }
+    
+    ErrorCode DirectorySizeEngine::Calculate(const String& directoryPath, DirectorySizeResult& result,
+                                             const std::atomic<bool>* cancelFlag) {
+        result = DirectorySizeResult();
+        
+        FileSystemEntry root;
+        if (directoryPath.empty() || m_fileSystem->GetEntry(directoryPath, root) != ERROR_SUCCESS ||
+            !root.IsDirectory()) {
+            return ErrorCode::FileNotFound;
+        }
+        
+        auto traversal = std::make_shared<Traversal>(m_maxThreads, cancelFlag);
+        traversal->pending = 1;
+        traversal->queues[0]->tasks.push_back({ directoryPath, root.lastWriteTime });
+        
+        // 调用线程作为0号线程参与遍历；pending归零时所有目录都已处理完，不需要等待辅助任务退出
+        WorkerLoop(*traversal, 0);
+        
+        if (traversal->IsCancelled()) {
+            return ErrorCode::OperationCancelled;
+        }
+        
+        result.totalBytes = traversal->totalBytes;
+        result.fileCount = traversal->fileCount;
+        result.directoryCount = traversal->directoryCount;
+        result.skippedReparsePoints = traversal->skippedReparsePoints;
+        result.inaccessibleDirectories = traversal->inaccessibleDirectories;
+        result.cacheHits = traversal->cacheHits;
+        return ErrorCode::Success;
+    }
+    
+    DWORD64 DirectorySizeEngine::GetSize(const String& directoryPath) {
+        DirectorySizeResult result;
+        return Calculate(directoryPath, result) == ErrorCode::Success ? result.totalBytes : 0;
+    }
+    
+    void DirectorySizeEngine::ClearCache() {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        m_cache.clear();
+        m_recentKeys.clear();
+    }
+    
+    size_t DirectorySizeEngine::GetCacheSize() const {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_cache.size();
+    }
+    
+    const DirectorySizeEngine::DirectorySummary* DirectorySizeEngine::FindCached(const String& key, DWORD64 lastWriteTime) {
+        auto it = m_cache.find(key);
+        if (it == m_cache.end() || it->second.summary.lastWriteTime != lastWriteTime) {
+            return nullptr;
+        }
+        m_recentKeys.splice(m_recentKeys.begin(), m_recentKeys, it->second.recentPosition);
+        return &it->second.summary;
+    }
+    
+    void DirectorySizeEngine::StoreCached(const String& key, DirectorySummary summary) {
+        auto it = m_cache.find(key);
+        if (it != m_cache.end()) {
+            it->second.summary = std::move(summary);
+            m_recentKeys.splice(m_recentKeys.begin(), m_recentKeys, it->second.recentPosition);
+            return;
+        }
+        
+        m_recentKeys.push_front(key);
+        m_cache[key] = { std::move(summary), m_recentKeys.begin() };
+        
+        while (m_cache.size() > m_maxCacheEntries) {
+            m_cache.erase(m_recentKeys.back());
+            m_recentKeys.pop_back();
+        }
+    }
+    
+    void DirectorySizeEngine::WorkerLoop(Traversal& traversal, size_t workerIndex) {
+        const size_t queueCount = traversal.queues.size();
+        int idleSpins = 0;
+        
+        while (traversal.pending.load() > 0) {
+            DirectoryTask task;
+            bool found = false;
+            
+            // 优先取自己队列的末尾
+            {
+                WorkerQueue& own = *traversal.queues[workerIndex];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    found = true;
+                }
+            }
+            
+            // 否则从其他线程队列的头部窃取（靠近根的目录，子树通常更大）
+            for (size_t offset = 1; !found && offset < queueCount; ++offset) {
+                WorkerQueue& victim = *traversal.queues[(workerIndex + offset) % queueCount];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    found = true;
+                }
+            }
+            
+            if (!found) {
+                if (++idleSpins < s_idleSpinsBeforeSleep) {
+                    std::this_thread::yield();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                continue;
+            }
+            
+            idleSpins = 0;
+            
+            // 取消后继续出队但不再处理，使pending尽快归零
+            if (!traversal.IsCancelled()) {
+                ProcessDirectory(traversal, workerIndex, task.path, task.lastWriteTime);
+            }
+            
+            traversal.pending--;
+        }
+    }
+    
+    void DirectorySizeEngine::ProcessDirectory(Traversal& traversal, size_t workerIndex,
+                                               const String& directoryPath, DWORD64 lastWriteTime) {
+        traversal.directoryCount++;
+        
+        String key = MakeCacheKey(directoryPath);
+        DirectorySummary summary;
+        bool cached = false;
+        
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            if (const DirectorySummary* found = FindCached(key, lastWriteTime)) {
+                summary = *found;
+                cached = true;
+            }
+        }
+        
+        std::vector<DirectoryTask> children;
+        
+        if (cached) {
+            // 目录本身未变化，只需取得各子目录当前的时间戳
+            traversal.cacheHits++;
+            for (const auto& name : summary.subdirectories) {
+                String childPath = JoinPath(directoryPath, name);
+                FileSystemEntry child;
+                if (m_fileSystem->GetEntry(childPath, child) != ERROR_SUCCESS) {
+                    traversal.inaccessibleDirectories++;
+                } else if (child.IsReparsePoint()) {
+                    traversal.skippedReparsePoints++;
+                } else {
+                    children.push_back({ childPath, child.lastWriteTime });
+                }
+            }
+        } else {
+            std::vector<FileSystemEntry> entries;
+            if (m_fileSystem->ListDirectory(directoryPath, entries) != ERROR_SUCCESS) {
+                traversal.inaccessibleDirectories++;
+                return;
+            }
+            
+            summary.lastWriteTime = lastWriteTime;
+            for (auto& entry : entries) {
+                if (!entry.IsDirectory()) {
+                    summary.fileBytes += entry.size;
+                    summary.fileCount++;
+                } else if (entry.IsReparsePoint()) {
+                    summary.reparsePointCount++;
+                } else {
+                    children.push_back({ JoinPath(directoryPath, entry.name), entry.lastWriteTime });
+                    summary.subdirectories.push_back(std::move(entry.name));
+                }
+            }
+        }
+        
+        traversal.totalBytes += summary.fileBytes;
+        traversal.fileCount += summary.fileCount;
+        traversal.skippedReparsePoints += summary.reparsePointCount;
+        
+        if (!cached) {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            StoreCached(key, std::move(summary));
+        }
+        
+        if (children.empty()) {
+            return;
+        }
+        
+        size_t backlog = 0;
+        traversal.pending += children.size();
+        {
+            WorkerQueue& own = *traversal.queues[workerIndex];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            for (auto& child : children) {
+                own.tasks.push_back(std::move(child));
+            }
+            backlog = own.tasks.size();
+        }
+        
+        // 积压较多时按需向线程池提交辅助任务，每个队列至多一个
+        if (backlog > s_spawnBacklog && m_pool && traversal.helperCount.load() + 1 < traversal.queues.size()) {
+            size_t nextIndex = ++traversal.helperCount;
+            if (nextIndex < traversal.queues.size()) {
+                std::shared_ptr<Traversal> shared = traversal.shared_from_this();
+                m_pool->Submit([this, shared, nextIndex]() { WorkerLoop(*shared, nextIndex); });
+            }
+        }
+    }
+
+} // namespace YG
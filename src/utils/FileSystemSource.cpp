@@ -0,0 +1,467 @@
+/**
+ * @file FileSystemSource.cpp
+ * @brief 可替换的文件系统数据源实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/FileSystemSource.h"
+#include "utils/StringUtils.h"
+#include <windows.h>
+#include <algorithm>
+#include <mutex>
+
+#ifndef FIND_FIRST_EX_LARGE_FETCH
+#define FIND_FIRST_EX_LARGE_FETCH 0x00000002
+#endif
+
+namespace YG {
+    
+    namespace {
+        
+        DWORD64 FileTimeToUInt64(const FILETIME& fileTime) {
+            return (static_cast<DWORD64>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+        }
+        
+        String LastComponent(const String& path) {
+            size_t end = path.find_last_not_of(L"\\/");
+            if (end == String::npos) {
+                return L"";
+            }
+            size_t start = path.find_last_of(L"\\/", end);
+            return path.substr(start == String::npos ? 0 : start + 1, end - (start == String::npos ? 0 : start + 1) + 1);
+        }
+    
+    } // namespace
+    
+    // ==================== Win32FileSystemSource ====================
+    
+    DWORD Win32FileSystemSource::GetEntry(const String& path, FileSystemEntry& entry) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data)) {
+            return GetLastError();
+        }
+        
+        entry.name = LastComponent(path);
+        entry.attributes = data.dwFileAttributes;
+        entry.size = entry.IsDirectory() ? 0 :
+            ((static_cast<DWORD64>(data.nFileSizeHigh) << 32) | data.nFileSizeLow);
+        entry.lastWriteTime = FileTimeToUInt64(data.ftLastWriteTime);
+        entry.creationTime = FileTimeToUInt64(data.ftCreationTime);
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD Win32FileSystemSource::ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) {
+        entries.clear();
+        
+        String searchPath = directoryPath;
+        if (!searchPath.empty() && searchPath.back() != L'\\' && searchPath.back() != L'/') {
+            searchPath += L'\\';
+        }
+        searchPath += L'*';
+        
+        WIN32_FIND_DATAW findData;
+        HANDLE hFind = FindFirstFileExW(searchPath.c_str(), FindExInfoBasic, &findData,
+                                        FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+        if (hFind == INVALID_HANDLE_VALUE) {
+            return GetLastError();
+        }
+        
+        do {
+            if (wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0) {
+                continue;
+            }
+            
+            FileSystemEntry entry;
+            entry.name = findData.cFileName;
+            entry.attributes = findData.dwFileAttributes;
+            entry.size = entry.IsDirectory() ? 0 :
+                ((static_cast<DWORD64>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow);
+            entry.lastWriteTime = FileTimeToUInt64(findData.ftLastWriteTime);
+            entry.creationTime = FileTimeToUInt64(findData.ftCreationTime);
+            entries.push_back(std::move(entry));
+        } while (FindNextFileW(hFind, &findData));
+        
+        DWORD lastError = GetLastError();
+        FindClose(hFind);
+        return lastError == ERROR_NO_MORE_FILES ? ERROR_SUCCESS : lastError;
+    }
+    
+    DWORD Win32FileSystemSource::SetAttributes(const String& path, DWORD attributes) {
+        return SetFileAttributesW(path.c_str(), attributes) ? ERROR_SUCCESS : GetLastError();
+    }
+    
+    DWORD Win32FileSystemSource::RemoveEntry(const String& path, bool directory) {
+        BOOL removed = directory ? RemoveDirectoryW(path.c_str()) : DeleteFileW(path.c_str());
+        return removed ? ERROR_SUCCESS : GetLastError();
+    }
+    
+    DWORD Win32FileSystemSource::MoveEntry(const String& fromPath, const String& toPath) {
+        // 不带MOVEFILE_COPY_ALLOWED：跨卷时失败而不是退化为复制
+        return MoveFileExW(fromPath.c_str(), toPath.c_str(), 0) ? ERROR_SUCCESS : GetLastError();
+    }
+    
+    DWORD Win32FileSystemSource::MakeDirectory(const String& path) {
+        return CreateDirectoryW(path.c_str(), nullptr) ? ERROR_SUCCESS : GetLastError();
+    }
+    
+    DWORD Win32FileSystemSource::ReadFileData(const String& path, std::vector<BYTE>& data) {
+        data.clear();
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return GetLastError();
+        }
+        
+        DWORD error = ERROR_SUCCESS;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(hFile, &fileSize)) {
+            error = GetLastError();
+        } else {
+            data.resize(static_cast<size_t>(fileSize.QuadPart));
+            DWORD read = 0;
+            if (!data.empty() && (!ReadFile(hFile, data.data(), static_cast<DWORD>(data.size()), &read, nullptr) ||
+                                  read != data.size())) {
+                error = GetLastError();
+                if (error == ERROR_SUCCESS) {
+                    error = ERROR_READ_FAULT;       // 读取的字节数不足
+                }
+                data.clear();
+            }
+        }
+        CloseHandle(hFile);
+        return error;
+    }
+    
+    DWORD Win32FileSystemSource::WriteFileData(const String& path, const std::vector<BYTE>& data) {
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+                                   CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE) {
+            return GetLastError();
+        }
+        
+        DWORD error = ERROR_SUCCESS;
+        DWORD written = 0;
+        if (!data.empty() && (!WriteFile(hFile, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) ||
+                              written != data.size())) {
+            error = GetLastError();
+            if (error == ERROR_SUCCESS) {
+                error = ERROR_WRITE_FAULT;      // 写入的字节数不足
+            }
+        }
+        CloseHandle(hFile);
+        return error;
+    }
+    
+    // ==================== MemoryFileSystemSource ====================
+    
+    MemoryFileSystemSource::MemoryFileSystemSource() : m_clock(0) {
+    }
+    
+    String MemoryFileSystemSource::NormalizePath(const String& path) {
+        String normalized = StringUtils::ToLower(path);
+        std::replace(normalized.begin(), normalized.end(), L'/', L'\\');
+        while (normalized.size() > 1 && normalized.back() == L'\\') {
+            normalized.pop_back();
+        }
+        return normalized;
+    }
+    
+    DWORD64 MemoryFileSystemSource::NextWriteTime() {
+        return ++m_clock;
+    }
+    
+    bool MemoryFileSystemSource::HasParentDirectory(const String& key) const {
+        // 卷根目录（路径的第一级）总是存在
+        size_t separator = key.find_last_of(L'\\');
+        if (separator == String::npos || key.find(L'\\') == separator) {
+            return true;
+        }
+        auto parent = m_nodes.find(key.substr(0, separator));
+        return parent != m_nodes.end() && parent->second.entry.IsDirectory();
+    }
+    
+    MemoryFileSystemSource::MemoryNode& MemoryFileSystemSource::EnsureNode(const String& path, bool directory) {
+        String key = NormalizePath(path);
+        auto it = m_nodes.find(key);
+        if (it != m_nodes.end()) {
+            return it->second;
+        }
+        
+        MemoryNode node;
+        node.entry.name = LastComponent(path);
+        node.entry.attributes = directory ? FILE_ATTRIBUTE_DIRECTORY : FILE_ATTRIBUTE_NORMAL;
+        node.entry.lastWriteTime = NextWriteTime();
+        node.entry.creationTime = node.entry.lastWriteTime;
+        
+        size_t separator = key.find_last_of(L'\\');
+        if (separator != String::npos && separator > 0) {
+            size_t originalSeparator = path.find_last_of(L"\\/", path.find_last_not_of(L"\\/"));
+            MemoryNode& parent = EnsureNode(path.substr(0, originalSeparator), true);
+            parent.children.push_back(key);
+            parent.entry.lastWriteTime = NextWriteTime();
+        }
+        
+        return m_nodes.emplace(key, std::move(node)).first->second;
+    }
+    
+    void MemoryFileSystemSource::AddFile(const String& path, DWORD64 size) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        MemoryNode& node = EnsureNode(path, false);
+        node.entry.size = size;
+        node.entry.lastWriteTime = NextWriteTime();
+    }
+    
+    void MemoryFileSystemSource::AddDirectory(const String& path, DWORD attributes) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        MemoryNode& node = EnsureNode(path, true);
+        node.entry.attributes |= attributes;
+    }
+    
+    bool MemoryFileSystemSource::Remove(const String& path) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        String key = NormalizePath(path);
+        if (m_nodes.find(key) == m_nodes.end()) {
+            return false;
+        }
+        
+        // 先从父目录摘除，再删除整棵子树
+        size_t separator = key.find_last_of(L'\\');
+        if (separator != String::npos && separator > 0) {
+            auto parent = m_nodes.find(key.substr(0, separator));
+            if (parent != m_nodes.end()) {
+                auto& children = parent->second.children;
+                children.erase(std::remove(children.begin(), children.end(), key), children.end());
+                parent->second.entry.lastWriteTime = NextWriteTime();
+            }
+        }
+        
+        std::vector<String> pending(1, key);
+        while (!pending.empty()) {
+            String current = pending.back();
+            pending.pop_back();
+            
+            auto it = m_nodes.find(current);
+            if (it == m_nodes.end()) {
+                continue;
+            }
+            pending.insert(pending.end(), it->second.children.begin(), it->second.children.end());
+            m_nodes.erase(it);
+        }
+        
+        return true;
+    }
+    
+    void MemoryFileSystemSource::Clear() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_nodes.clear();
+    }
+    
+    DWORD MemoryFileSystemSource::GetEntry(const String& path, FileSystemEntry& entry) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        auto it = m_nodes.find(NormalizePath(path));
+        if (it == m_nodes.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        
+        entry = it->second.entry;
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD MemoryFileSystemSource::ListDirectory(const String& directoryPath, std::vector<FileSystemEntry>& entries) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        entries.clear();
+        
+        auto it = m_nodes.find(NormalizePath(directoryPath));
+        if (it == m_nodes.end()) {
+            return ERROR_PATH_NOT_FOUND;
+        }
+        if (!it->second.entry.IsDirectory()) {
+            return ERROR_DIRECTORY;
+        }
+        
+        entries.reserve(it->second.children.size());
+        for (const auto& childKey : it->second.children) {
+            auto child = m_nodes.find(childKey);
+            if (child != m_nodes.end()) {
+                entries.push_back(child->second.entry);
+            }
+        }
+        
+        return ERROR_SUCCESS;
+    }
+
+    DWORD MemoryFileSystemSource::SetAttributes(const String& path, DWORD attributes) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        auto it = m_nodes.find(NormalizePath(path));
+        if (it == m_nodes.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        
+        const DWORD fixedAttributes = FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_REPARSE_POINT;
+        DWORD& current = it->second.entry.attributes;
+        current = (current & fixedAttributes) | (attributes & ~fixedAttributes);
+        if (current == 0) {
+            current = FILE_ATTRIBUTE_NORMAL;
+        }
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD MemoryFileSystemSource::RemoveEntry(const String& path, bool directory) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        String key = NormalizePath(path);
+        auto it = m_nodes.find(key);
+        if (it == m_nodes.end()) {
+            return directory ? ERROR_PATH_NOT_FOUND : ERROR_FILE_NOT_FOUND;
+        }
+        
+        const FileSystemEntry& entry = it->second.entry;
+        if (entry.IsDirectory() != directory) {
+            return directory ? ERROR_DIRECTORY : ERROR_ACCESS_DENIED;
+        }
+        if (entry.attributes & FILE_ATTRIBUTE_READONLY) {
+            return ERROR_ACCESS_DENIED;
+        }
+        // 重解析点目录只删除链接本身，与RemoveDirectoryW一致
+        if (directory && !entry.IsReparsePoint() && !it->second.children.empty()) {
+            return ERROR_DIR_NOT_EMPTY;
+        }
+        
+        size_t separator = key.find_last_of(L'\\');
+        if (separator != String::npos && separator > 0) {
+            auto parent = m_nodes.find(key.substr(0, separator));
+            if (parent != m_nodes.end()) {
+                auto& children = parent->second.children;
+                children.erase(std::remove(children.begin(), children.end(), key), children.end());
+                parent->second.entry.lastWriteTime = NextWriteTime();
+            }
+        }
+        
+        // 重解析点目录下记录的子项不属于这个链接，一并丢弃
+        std::vector<String> pending(1, key);
+        while (!pending.empty()) {
+            String current = pending.back();
+            pending.pop_back();
+            
+            auto node = m_nodes.find(current);
+            if (node == m_nodes.end()) {
+                continue;
+            }
+            pending.insert(pending.end(), node->second.children.begin(), node->second.children.end());
+            m_nodes.erase(node);
+        }
+        return ERROR_SUCCESS;
+    }
+
+    DWORD MemoryFileSystemSource::MoveEntry(const String& fromPath, const String& toPath) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        String fromKey = NormalizePath(fromPath);
+        String toKey = NormalizePath(toPath);
+        if (m_nodes.find(fromKey) == m_nodes.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        if (m_nodes.find(toKey) != m_nodes.end()) {
+            return ERROR_ALREADY_EXISTS;
+        }
+        if (fromKey.substr(0, fromKey.find(L'\\')) != toKey.substr(0, toKey.find(L'\\'))) {
+            return ERROR_NOT_SAME_DEVICE;
+        }
+        if (!HasParentDirectory(toKey) || toKey.compare(0, fromKey.size() + 1, fromKey + L"\\") == 0) {
+            return ERROR_PATH_NOT_FOUND;
+        }
+        
+        // 从原父目录摘除，挂到新父目录下
+        size_t separator = fromKey.find_last_of(L'\\');
+        if (separator != String::npos && separator > 0) {
+            auto parent = m_nodes.find(fromKey.substr(0, separator));
+            if (parent != m_nodes.end()) {
+                auto& children = parent->second.children;
+                children.erase(std::remove(children.begin(), children.end(), fromKey), children.end());
+                parent->second.entry.lastWriteTime = NextWriteTime();
+            }
+        }
+        separator = toKey.find_last_of(L'\\');
+        if (separator != String::npos && separator > 0) {
+            size_t originalSeparator = toPath.find_last_of(L"\\/", toPath.find_last_not_of(L"\\/"));
+            MemoryNode& parent = EnsureNode(toPath.substr(0, originalSeparator), true);
+            parent.children.push_back(toKey);
+            parent.entry.lastWriteTime = NextWriteTime();
+        }
+        
+        // 整棵子树换上新的路径前缀
+        std::vector<String> pending(1, fromKey);
+        while (!pending.empty()) {
+            String oldKey = pending.back();
+            pending.pop_back();
+            
+            auto it = m_nodes.find(oldKey);
+            if (it == m_nodes.end()) {
+                continue;
+            }
+            MemoryNode node = std::move(it->second);
+            m_nodes.erase(it);
+            for (String& child : node.children) {
+                pending.push_back(child);
+                child = toKey + child.substr(fromKey.size());
+            }
+            m_nodes.emplace(toKey + oldKey.substr(fromKey.size()), std::move(node));
+        }
+        m_nodes[toKey].entry.name = LastComponent(toPath);
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD MemoryFileSystemSource::MakeDirectory(const String& path) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        String key = NormalizePath(path);
+        if (m_nodes.find(key) != m_nodes.end()) {
+            return ERROR_ALREADY_EXISTS;
+        }
+        if (!HasParentDirectory(key)) {
+            return ERROR_PATH_NOT_FOUND;
+        }
+        EnsureNode(path, true);
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD MemoryFileSystemSource::ReadFileData(const String& path, std::vector<BYTE>& data) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        auto it = m_nodes.find(NormalizePath(path));
+        if (it == m_nodes.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        if (it->second.entry.IsDirectory()) {
+            return ERROR_ACCESS_DENIED;
+        }
+        data = it->second.data;
+        return ERROR_SUCCESS;
+    }
+    
+    DWORD MemoryFileSystemSource::WriteFileData(const String& path, const std::vector<BYTE>& data) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        String key = NormalizePath(path);
+        auto it = m_nodes.find(key);
+        if (it != m_nodes.end() &&
+            (it->second.entry.IsDirectory() || (it->second.entry.attributes & FILE_ATTRIBUTE_READONLY))) {
+            return ERROR_ACCESS_DENIED;
+        }
+        if (it == m_nodes.end() && !HasParentDirectory(key)) {
+            return ERROR_PATH_NOT_FOUND;
+        }
+        
+        MemoryNode& node = EnsureNode(path, false);
+        node.data = data;
+        node.entry.size = data.size();
+        node.entry.lastWriteTime = NextWriteTime();
+        return ERROR_SUCCESS;
+    }
+
+} // namespace YG
@@ -0,0 +1,53 @@
+/**
+ * @file ProgressCoalescer.cpp
+ * @brief 合并后台进度并限速投递到窗口的实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/ProgressCoalescer.h"
+
+namespace YG {
+    
+    ProgressCoalescer::ProgressCoalescer(HWND targetWindow, UINT message, WPARAM tag, DWORD minIntervalMs)
+        : m_targetWindow(targetWindow), m_message(message), m_tag(tag), m_minIntervalMs(minIntervalMs),
+          m_percentage(0), m_hasUpdate(false), m_posted(false), m_lastPostTick(0) {
+    }
+    
+    void ProgressCoalescer::Report(int percentage, const String& currentItem) {
+        ULONGLONG now = GetTickCount64();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_percentage = percentage;
+            m_currentItem = currentItem;
+            m_hasUpdate = true;
+            
+            // 已有消息在队列中，或距上次投递太近：只更新最新值
+            if (m_posted || now - m_lastPostTick < m_minIntervalMs) {
+                return;
+            }
+            m_posted = true;
+            m_lastPostTick = now;
+        }
+        
+        if (!PostMessage(m_targetWindow, m_message, m_tag, 0)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_posted = false;
+        }
+    }
+    
+    bool ProgressCoalescer::Take(int& percentage, String& currentItem) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_posted = false;
+        if (!m_hasUpdate) {
+            return false;
+        }
+        
+        percentage = m_percentage;
+        currentItem.swap(m_currentItem);
+        m_hasUpdate = false;
+        return true;
+    }
+
+} // namespace YG
@@ -7,21 +7,300 @@
  */
 
 #include "utils/RegistryHelper.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadPool.h"
 #include "core/Logger.h"
 #include <windows.h>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cwctype>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace YG {
     
+    namespace {
+        
+        /**
+         * @brief 全局注册表数据源，通过std::atomic_load/atomic_store访问
+         */
+        std::shared_ptr<IRegistrySource>& SourceSlot() {
+            static std::shared_ptr<IRegistrySource> source = std::make_shared<Win32RegistrySource>();
+            return source;
+        }
+        
+        /**
+         * @brief 预定义根键名称表
+         */
+        struct PredefinedKeyName {
+            HKEY key;
+            const wchar_t* name;
+            const wchar_t* shortName;
+        };
+        
+        const PredefinedKeyName kPredefinedKeyNames[] = {
+            { HKEY_CLASSES_ROOT, L"HKEY_CLASSES_ROOT", L"HKCR" },
+            { HKEY_CURRENT_USER, L"HKEY_CURRENT_USER", L"HKCU" },
+            { HKEY_LOCAL_MACHINE, L"HKEY_LOCAL_MACHINE", L"HKLM" },
+            { HKEY_USERS, L"HKEY_USERS", L"HKU" },
+            { HKEY_CURRENT_CONFIG, L"HKEY_CURRENT_CONFIG", L"HKCC" }
+        };
+        
+        const size_t s_defaultSearchThreads = 4;        // 注册表访问有内核锁，线程再多收益不大
+        const size_t s_searchSpawnBacklog = 2;          // 本线程队列积压超过该数量时创建辅助线程
+        const int s_searchIdleSpinsBeforeSleep = 64;    // 空闲时先让出时间片，超过次数后短暂休眠
+        
+        struct KeyTask {
+            String path;                                ///< 键路径（相对于根键）
+            int depth;                                  ///< 相对于起始键的深度
+        };
+        
+        struct KeyQueue {
+            std::mutex mutex;
+            std::deque<KeyTask> tasks;
+        };
+        
+        /**
+         * @brief 一次SearchTree的遍历状态
+         */
+        struct SearchTraversal {
+            std::shared_ptr<IRegistrySource> source;            ///< 搜索开始时的数据源
+            HKEY root;                                          ///< 根键
+            const RegistryTextMatcher& matcher;                 ///< 模式集
+            const RegistrySearchOptions& options;               ///< 搜索选项
+            const RegistrySearchCallback& callback;             ///< 命中回调
+            std::vector<std::unique_ptr<KeyQueue>> queues;      ///< 每个线程一个队列
+            std::atomic<size_t> pending;                        ///< 已入队或正在处理的键数
+            std::atomic<bool> stopped;                          ///< 达到结果上限或回调要求停止
+            size_t hitCount;                                    ///< 已报告的命中数（受callbackMutex保护）
+            std::mutex callbackMutex;                           ///< 串行化回调
+            std::vector<std::thread> helpers;                   ///< 按需创建的辅助线程
+            std::mutex helperMutex;                             ///< 辅助线程列表锁
+            
+            SearchTraversal(std::shared_ptr<IRegistrySource> registry, HKEY rootKey, const RegistryTextMatcher& textMatcher,
+                            const RegistrySearchOptions& searchOptions, const RegistrySearchCallback& hitCallback,
+                            size_t threadCount)
+                : source(registry), root(rootKey), matcher(textMatcher), options(searchOptions),
+                  callback(hitCallback), pending(0), stopped(false), hitCount(0) {
+                for (size_t i = 0; i < threadCount; ++i) {
+                    queues.push_back(YG::MakeUnique<KeyQueue>());
+                }
+            }
+            
+            bool IsCancelled() const {
+                return options.cancelFlag && options.cancelFlag->load();
+            }
+            
+            bool ShouldStop() const {
+                return stopped.load() || IsCancelled();
+            }
+        };
+        
+        String JoinKeyPath(const String& parentPath, const String& name) {
+            return parentPath.empty() ? name : parentPath + L"\\" + name;
+        }
+        
+        // 字符串类型的值数据转为可匹配的文本，REG_MULTI_SZ的各项以";"连接
+        bool DecodeSearchText(DWORD type, const std::vector<BYTE>& data, String& text) {
+            if (type != REG_SZ && type != REG_EXPAND_SZ && type != REG_MULTI_SZ) {
+                return false;
+            }
+            
+            const wchar_t* chars = reinterpret_cast<const wchar_t*>(data.data());
+            size_t length = data.size() / sizeof(wchar_t);
+            while (length > 0 && chars[length - 1] == L'\0') {
+                length--;
+            }
+            text.assign(chars, length);
+            if (type == REG_MULTI_SZ) {
+                std::replace(text.begin(), text.end(), L'\0', L';');
+            } else {
+                text.resize(std::wcslen(text.c_str()));
+            }
+            return true;
+        }
+        
+        bool ReportHit(SearchTraversal& traversal, const RegistrySearchHit& hit) {
+            std::lock_guard<std::mutex> lock(traversal.callbackMutex);
+            if (traversal.stopped.load()) {
+                return false;
+            }
+            
+            bool keepGoing = traversal.callback(hit);
+            traversal.hitCount++;
+            if (!keepGoing || (traversal.options.maxResults > 0 && traversal.hitCount >= traversal.options.maxResults)) {
+                traversal.stopped.store(true);
+                return false;
+            }
+            return true;
+        }
+        
+        void SearchWorkerLoop(SearchTraversal& traversal, size_t workerIndex);
+        
+        void SearchKey(SearchTraversal& traversal, size_t workerIndex, const KeyTask& task) {
+            IRegistrySource& source = *traversal.source;
+            const RegistrySearchOptions& options = traversal.options;
+            
+            HKEY hKey;
+            if (source.OpenKey(traversal.root, task.path, KEY_READ, hKey) != ERROR_SUCCESS) {
+                return;
+            }
+            
+            std::uint32_t pattern = 0;
+            
+            // 值名称与字符串数据
+            if (options.targets & (RegistrySearchValueName | RegistrySearchValueData)) {
+                const bool matchData = (options.targets & RegistrySearchValueData) != 0;
+                String text;
+                source.EnumValues(hKey, matchData,
+                    [&](const String& valueName, DWORD type, const std::vector<BYTE>& data) {
+                        if (traversal.ShouldStop()) {
+                            return false;
+                        }
+                    
+                        RegistrySearchHit hit;
+                        if ((options.targets & RegistrySearchValueName) && traversal.matcher(valueName, pattern)) {
+                            hit.target = RegistrySearchValueName;
+                        } else if (matchData && DecodeSearchText(type, data, text) && traversal.matcher(text, pattern)) {
+                            hit.target = RegistrySearchValueData;
+                            hit.valueData = text;
+                        } else {
+                            return true;
+                        }
+                        hit.keyPath = task.path;
+                        hit.valueName = valueName;
+                        hit.pattern = pattern;
+                        hit.depth = task.depth;
+                        ReportHit(traversal, hit);
+                        return true;
+                    });
+            }
+            
+            // 子键名称在枚举时匹配，不必为取得名称打开子键
+            std::vector<KeyTask> children;
+            if (task.depth < options.maxDepth) {
+                String name;
+                for (DWORD index = 0; !traversal.ShouldStop(); ++index) {
+                    if (source.EnumKey(hKey, index, name) != ERROR_SUCCESS) {
+                        break;
+                    }
+                    
+                    String childPath = JoinKeyPath(task.path, name);
+                    bool matched = false;
+                    if ((options.targets & RegistrySearchKeyName) && traversal.matcher(name, pattern)) {
+                        matched = true;
+                        RegistrySearchHit hit;
+                        hit.keyPath = childPath;
+                        hit.target = RegistrySearchKeyName;
+                        hit.pattern = pattern;
+                        hit.depth = task.depth + 1;
+                        ReportHit(traversal, hit);
+                    }
+                    if (!(matched && options.skipMatchedSubtrees)) {
+                        children.push_back({ std::move(childPath), task.depth + 1 });
+                    }
+                }
+            }
+            
+            source.CloseKey(hKey);
+            
+            if (children.empty() || traversal.ShouldStop()) {
+                return;
+            }
+            
+            size_t backlog = 0;
+            traversal.pending += children.size();
+            {
+                KeyQueue& own = *traversal.queues[workerIndex];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                for (auto& child : children) {
+                    own.tasks.push_back(std::move(child));
+                }
+                backlog = own.tasks.size();
+            }
+            
+            // 积压较多时按需增加辅助线程；当前键尚未完成，pending不会在此期间归零
+            if (backlog > s_searchSpawnBacklog) {
+                std::lock_guard<std::mutex> lock(traversal.helperMutex);
+                size_t nextIndex = traversal.helpers.size() + 1;
+                if (nextIndex < traversal.queues.size()) {
+                    traversal.helpers.emplace_back(SearchWorkerLoop, std::ref(traversal), nextIndex);
+                }
+            }
+        }
+        
+        void SearchWorkerLoop(SearchTraversal& traversal, size_t workerIndex) {
+            const size_t queueCount = traversal.queues.size();
+            int idleSpins = 0;
+            
+            while (traversal.pending.load() > 0) {
+                KeyTask task;
+                bool found = false;
+                
+                // 优先取自己队列的末尾（深度优先）
+                {
+                    KeyQueue& own = *traversal.queues[workerIndex];
+                    std::lock_guard<std::mutex> lock(own.mutex);
+                    if (!own.tasks.empty()) {
+                        task = std::move(own.tasks.back());
+                        own.tasks.pop_back();
+                        found = true;
+                    }
+                }
+                
+                // 否则从其他线程队列的头部窃取（靠近起始键，子树通常更大）
+                for (size_t offset = 1; !found && offset < queueCount; ++offset) {
+                    KeyQueue& victim = *traversal.queues[(workerIndex + offset) % queueCount];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.tasks.empty()) {
+                        task = std::move(victim.tasks.front());
+                        victim.tasks.pop_front();
+                        found = true;
+                    }
+                }
+                
+                if (!found) {
+                    if (++idleSpins < s_searchIdleSpinsBeforeSleep) {
+                        std::this_thread::yield();
+                    } else {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    continue;
+                }
+                
+                idleSpins = 0;
+                
+                // 停止后继续出队但不再处理，使pending尽快归零
+                if (!traversal.ShouldStop()) {
+                    SearchKey(traversal, workerIndex, task);
+                }
+                
+                traversal.pending--;
+            }
+        }
+        
+    } // anonymous namespace
+    
+    void RegistryHelper::SetSource(std::shared_ptr<IRegistrySource> source) {
+        if (!source) {
+            source = std::make_shared<Win32RegistrySource>();
+        }
+        std::atomic_store(&SourceSlot(), source);
+    }
+    
+    std::shared_ptr<IRegistrySource> RegistryHelper::GetSource() {
+        return std::atomic_load(&SourceSlot());
+    }
+    
     ErrorCode RegistryHelper::ReadString(HKEY hKey, const String& valueName, String& value) {
-        wchar_t buffer[1024] = {0};
-        DWORD bufferSize = sizeof(buffer);
-        DWORD type;
+        DWORD type = REG_NONE;
+        std::vector<BYTE> data;
         
-        LONG result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &type, 
-                                (LPBYTE)buffer, &bufferSize);
+        LONG result = GetSource()->QueryValue(hKey, valueName, &type, &data);
         
-        if (result == ERROR_SUCCESS && (type == REG_SZ || type == REG_EXPAND_SZ)) {
-            value = buffer;
+        if (result == ERROR_SUCCESS && DecodeString(type, data, value)) {
             return ErrorCode::Success;
         }
         
@@ -29,36 +308,52 @@ namespace YG {
     }
     
     ErrorCode RegistryHelper::ReadDWord(HKEY hKey, const String& valueName, DWORD& value) {
-        DWORD bufferSize = sizeof(DWORD);
-        DWORD type;
+        DWORD type = REG_NONE;
+        std::vector<BYTE> data;
         
-        LONG result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &type, 
-                                (LPBYTE)&value, &bufferSize);
+        LONG result = GetSource()->QueryValue(hKey, valueName, &type, &data);
         
-        if (result == ERROR_SUCCESS && type == REG_DWORD) {
+        if (result == ERROR_SUCCESS && DecodeDWord(type, data, value)) {
             return ErrorCode::Success;
         }
         
         return ErrorCode::DataNotFound;
     }
     
+    bool RegistryHelper::DecodeString(DWORD type, const std::vector<BYTE>& data, String& value) {
+        if (type != REG_SZ && type != REG_EXPAND_SZ) {
+            return false;
+        }
+        
+        // 数据不一定以空字符结尾，按实际长度截取到第一个空字符
+        const wchar_t* text = reinterpret_cast<const wchar_t*>(data.data());
+        size_t length = data.size() / sizeof(wchar_t);
+        size_t end = 0;
+        while (end < length && text[end] != L'\0') {
+            end++;
+        }
+        value.assign(text, end);
+        return true;
+    }
+    
+    bool RegistryHelper::DecodeDWord(DWORD type, const std::vector<BYTE>& data, DWORD& value) {
+        if (type != REG_DWORD || data.size() < sizeof(DWORD)) {
+            return false;
+        }
+        
+        memcpy(&value, data.data(), sizeof(DWORD));
+        return true;
+    }
+    
     ErrorCode RegistryHelper::OpenKey(HKEY hKeyParent, const String& subKey, 
                                     REGSAM samDesired, HKEY& hKey) {
-        LONG result = RegOpenKeyExW(hKeyParent, subKey.c_str(), 0, samDesired, &hKey);
+        LONG result = GetSource()->OpenKey(hKeyParent, subKey, samDesired, hKey);
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
     ErrorCode RegistryHelper::CreateKey(HKEY hKeyParent, const String& subKey, 
                                       HKEY& hKey, bool* created) {
-        DWORD disposition;
-        LONG result = RegCreateKeyExW(hKeyParent, subKey.c_str(), 0, nullptr, 
-                                    REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, 
-                                    nullptr, &hKey, &disposition);
-        
-        if (created) {
-            *created = (disposition == REG_CREATED_NEW_KEY);
-        }
-        
+        LONG result = GetSource()->CreateKey(hKeyParent, subKey, hKey, created);
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
@@ -66,58 +361,96 @@ namespace YG {
         if (recursive) {
             return RecursiveDeleteKey(hKeyParent, subKey);
         } else {
-            LONG result = RegDeleteKeyW(hKeyParent, subKey.c_str());
+            LONG result = GetSource()->DeleteKey(hKeyParent, subKey);
             return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
         }
     }
     
     bool RegistryHelper::KeyExists(HKEY hKeyParent, const String& subKey) {
+        auto source = GetSource();
         HKEY hKey;
-        LONG result = RegOpenKeyExW(hKeyParent, subKey.c_str(), 0, KEY_READ, &hKey);
+        LONG result = source->OpenKey(hKeyParent, subKey, KEY_READ, hKey);
         if (result == ERROR_SUCCESS) {
-            RegCloseKey(hKey);
+            source->CloseKey(hKey);
             return true;
         }
         return false;
     }
     
     ErrorCode RegistryHelper::EnumerateSubKeys(HKEY hKey, StringVector& subKeys) {
+        auto source = GetSource();
         DWORD index = 0;
-        wchar_t keyName[256];
-        DWORD keyNameSize = sizeof(keyName) / sizeof(wchar_t);
+        String keyName;
         
-        while (RegEnumKeyExW(hKey, index++, keyName, &keyNameSize, 
-                           nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+        while (source->EnumKey(hKey, index++, keyName) == ERROR_SUCCESS) {
             subKeys.push_back(keyName);
-            keyNameSize = sizeof(keyName) / sizeof(wchar_t);
         }
         
         return ErrorCode::Success;
     }
     
+    ErrorCode RegistryHelper::EnumerateSubKeysInfo(HKEY hKey, std::vector<RegistryKeyInfo>& keyInfos) {
+        auto source = GetSource();
+        
+        StringVector subKeys;
+        EnumerateSubKeys(hKey, subKeys);
+        
+        for (const auto& subKey : subKeys) {
+            HKEY hSubKey;
+            if (source->OpenKey(hKey, subKey, KEY_READ, hSubKey) != ERROR_SUCCESS) {
+                continue;
+            }
+            
+            RegistryKeyInfo keyInfo;
+            if (GetKeyInfo(hSubKey, keyInfo) == ErrorCode::Success) {
+                keyInfo.name = subKey;
+                keyInfos.push_back(keyInfo);
+            }
+            source->CloseKey(hSubKey);
+        }
+        
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode RegistryHelper::GetKeyInfo(HKEY hKey, RegistryKeyInfo& keyInfo) {
+        LONG result = GetSource()->QueryInfoKey(hKey, &keyInfo.subKeyCount, &keyInfo.valueCount,
+                                                &keyInfo.lastWriteTime);
+        return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
+    }
+    
     bool RegistryHelper::ValueExists(HKEY hKey, const String& valueName) {
-        LONG result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, nullptr, nullptr, nullptr);
+        LONG result = GetSource()->QueryValue(hKey, valueName, nullptr, nullptr);
         return (result == ERROR_SUCCESS);
     }
     
     ErrorCode RegistryHelper::EnumerateValues(HKEY hKey, StringVector& valueNames) {
-        DWORD index = 0;
-        wchar_t valueName[256];
-        DWORD valueNameSize = sizeof(valueName) / sizeof(wchar_t);
-        
-        while (RegEnumValueW(hKey, index++, valueName, &valueNameSize, 
-                           nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS) {
+        GetSource()->EnumValues(hKey, false, [&valueNames](const String& valueName, DWORD, const std::vector<BYTE>&) {
             valueNames.push_back(valueName);
-            valueNameSize = sizeof(valueName) / sizeof(wchar_t);
-        }
+            return true;
+        });
+        
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode RegistryHelper::EnumerateValuesInfo(HKEY hKey, std::vector<RegistryValueInfo>& valueInfos) {
+        GetSource()->EnumValues(hKey, true, [&valueInfos](const String& name, DWORD type, const std::vector<BYTE>& data) {
+            RegistryValueInfo valueInfo;
+            valueInfo.name = name;
+            valueInfo.type = static_cast<RegistryValueType>(type);
+            valueInfo.data = data;
+            valueInfo.dataSize = static_cast<DWORD>(data.size());
+            valueInfos.push_back(std::move(valueInfo));
+            return true;
+        });
         
         return ErrorCode::Success;
     }
     
     ErrorCode RegistryHelper::RecursiveDeleteKey(HKEY hKeyParent, const String& subKey) {
         // 手动实现递归删除，因为RegDeleteTreeW可能不可用
+        auto source = GetSource();
         HKEY hKey;
-        LONG result = RegOpenKeyExW(hKeyParent, subKey.c_str(), 0, KEY_READ | KEY_WRITE, &hKey);
+        LONG result = source->OpenKey(hKeyParent, subKey, KEY_READ | KEY_WRITE, hKey);
         if (result != ERROR_SUCCESS) {
             return ErrorCode::RegistryError;
         }
@@ -130,10 +463,10 @@ namespace YG {
             RecursiveDeleteKey(hKey, childKey);
         }
         
-        RegCloseKey(hKey);
+        source->CloseKey(hKey);
         
         // 删除空的键
-        result = RegDeleteKeyW(hKeyParent, subKey.c_str());
+        result = source->DeleteKey(hKeyParent, subKey);
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
@@ -141,54 +474,61 @@ namespace YG {
         if (hKey && hKey != HKEY_CLASSES_ROOT && hKey != HKEY_CURRENT_USER && 
             hKey != HKEY_LOCAL_MACHINE && hKey != HKEY_USERS && 
             hKey != HKEY_CURRENT_CONFIG) {
-            RegCloseKey(hKey);
+            GetSource()->CloseKey(hKey);
         }
     }
     
     // 其他函数的简化实现
     ErrorCode RegistryHelper::WriteString(HKEY hKey, const String& valueName, const String& value) {
-        LONG result = RegSetValueExW(hKey, valueName.c_str(), 0, REG_SZ, 
-                                   (const BYTE*)value.c_str(), 
-                                   (DWORD)(value.length() + 1) * sizeof(wchar_t));
+        LONG result = GetSource()->SetValue(hKey, valueName, REG_SZ,
+                                          (const BYTE*)value.c_str(),
+                                          (DWORD)(value.length() + 1) * sizeof(wchar_t));
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
     ErrorCode RegistryHelper::WriteDWord(HKEY hKey, const String& valueName, DWORD value) {
-        LONG result = RegSetValueExW(hKey, valueName.c_str(), 0, REG_DWORD, 
-                                   (const BYTE*)&value, sizeof(DWORD));
+        LONG result = GetSource()->SetValue(hKey, valueName, REG_DWORD,
+                                          (const BYTE*)&value, sizeof(DWORD));
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
     ErrorCode RegistryHelper::DeleteValue(HKEY hKey, const String& valueName) {
-        LONG result = RegDeleteValueW(hKey, valueName.c_str());
+        LONG result = GetSource()->DeleteValue(hKey, valueName);
         return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
-    // 占位符实现，避免链接错误
     ErrorCode RegistryHelper::ReadQWord(HKEY hKey, const String& valueName, DWORD64& value) {
-        return ErrorCode::GeneralError;
+        DWORD type = REG_NONE;
+        std::vector<BYTE> data;
+        
+        LONG result = GetSource()->QueryValue(hKey, valueName, &type, &data);
+        
+        if (result == ERROR_SUCCESS && type == REG_QWORD && data.size() >= sizeof(DWORD64)) {
+            memcpy(&value, data.data(), sizeof(DWORD64));
+            return ErrorCode::Success;
+        }
+        
+        return ErrorCode::DataNotFound;
     }
     
     ErrorCode RegistryHelper::ReadBinary(HKEY hKey, const String& valueName, std::vector<BYTE>& data) {
-        return ErrorCode::GeneralError;
+        LONG result = GetSource()->QueryValue(hKey, valueName, nullptr, &data);
+        return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::DataNotFound;
     }
     
     ErrorCode RegistryHelper::WriteQWord(HKEY hKey, const String& valueName, DWORD64 value) {
-        return ErrorCode::GeneralError;
+        LONG result = GetSource()->SetValue(hKey, valueName, REG_QWORD,
+                                          (const BYTE*)&value, sizeof(DWORD64));
+        return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
     ErrorCode RegistryHelper::WriteBinary(HKEY hKey, const String& valueName, const std::vector<BYTE>& data) {
-        return ErrorCode::GeneralError;
-    }
-    
-    ErrorCode RegistryHelper::EnumerateSubKeysInfo(HKEY hKey, std::vector<RegistryKeyInfo>& keyInfos) {
-        return ErrorCode::GeneralError;
-    }
-    
-    ErrorCode RegistryHelper::GetKeyInfo(HKEY hKey, RegistryKeyInfo& keyInfo) {
-        return ErrorCode::GeneralError;
+        LONG result = GetSource()->SetValue(hKey, valueName, REG_BINARY,
+                                          data.data(), static_cast<DWORD>(data.size()));
+        return (result == ERROR_SUCCESS) ? ErrorCode::Success : ErrorCode::RegistryError;
     }
     
+    // 占位符实现，避免链接错误
     ErrorCode RegistryHelper::ExportKey(HKEY hKey, const String& filePath) {
         return ErrorCode::GeneralError;
     }
@@ -201,14 +541,82 @@ namespace YG {
         return ErrorCode::GeneralError;
     }
     
+    ErrorCode RegistryHelper::SearchTree(HKEY hKeyRoot, const String& subKey, const RegistryTextMatcher& matcher,
+                                         const RegistrySearchOptions& options, const RegistrySearchCallback& callback) {
+        auto source = GetSource();
+        HKEY hKey;
+        if (source->OpenKey(hKeyRoot, subKey, KEY_READ, hKey) != ERROR_SUCCESS) {
+            return ErrorCode::RegistryError;
+        }
+        source->CloseKey(hKey);
+        
+        size_t threadCount = options.maxThreads;
+        if (threadCount == 0) {
+            threadCount = (std::min)(ThreadPool::DefaultThreadCount(), s_defaultSearchThreads);
+        }
+        
+        SearchTraversal traversal(source, hKeyRoot, matcher, options, callback, threadCount);
+        traversal.pending = 1;
+        traversal.queues[0]->tasks.push_back({ subKey, 0 });
+        
+        // 调用线程作为0号线程参与遍历，返回时所有键都已处理完
+        SearchWorkerLoop(traversal, 0);
+        
+        {
+            std::lock_guard<std::mutex> lock(traversal.helperMutex);
+            for (auto& helper : traversal.helpers) {
+                helper.join();
+            }
+        }
+        
+        return traversal.IsCancelled() ? ErrorCode::OperationCancelled : ErrorCode::Success;
+    }
+    
     ErrorCode RegistryHelper::SearchKeys(HKEY hKeyRoot, const String& searchPattern, 
                                        StringVector& foundKeys, int maxResults) {
-        return ErrorCode::GeneralError;
+        RegistrySearchOptions options;
+        options.targets = RegistrySearchKeyName;
+        options.maxResults = maxResults > 0 ? static_cast<size_t>(maxResults) : 0;
+        
+        StringVector keys;
+        ErrorCode result = SearchTree(hKeyRoot, L"",
+            [&searchPattern](std::wstring_view text, std::uint32_t& pattern) {
+                pattern = 0;
+                return PatternMatch(text, searchPattern);
+            },
+            options,
+            [&keys, hKeyRoot](const RegistrySearchHit& hit) {
+                keys.push_back(FormatRegistryPath(hKeyRoot, hit.keyPath));
+                return true;
+            });
+        
+        // 并行遍历的命中顺序不固定
+        std::sort(keys.begin(), keys.end());
+        foundKeys.insert(foundKeys.end(), keys.begin(), keys.end());
+        return result;
     }
     
     ErrorCode RegistryHelper::SearchValues(HKEY hKeyRoot, const String& searchPattern, 
                                          StringVector& foundValues, int maxResults) {
-        return ErrorCode::GeneralError;
+        RegistrySearchOptions options;
+        options.targets = RegistrySearchValueName | RegistrySearchValueData;
+        options.maxResults = maxResults > 0 ? static_cast<size_t>(maxResults) : 0;
+        
+        StringVector values;
+        ErrorCode result = SearchTree(hKeyRoot, L"",
+            [&searchPattern](std::wstring_view text, std::uint32_t& pattern) {
+                pattern = 0;
+                return PatternMatch(text, searchPattern);
+            },
+            options,
+            [&values, hKeyRoot](const RegistrySearchHit& hit) {
+                values.push_back(FormatRegistryPath(hKeyRoot, hit.keyPath) + L"\\" + hit.valueName);
+                return true;
+            });
+        
+        std::sort(values.begin(), values.end());
+        foundValues.insert(foundValues.end(), values.begin(), values.end());
+        return result;
     }
     
     ErrorCode RegistryHelper::CopyKey(HKEY hKeySrc, HKEY hKeyDest, bool recursive) {
@@ -216,39 +624,86 @@ namespace YG {
     }
     
     String RegistryHelper::GetPredefinedKeyName(HKEY hKey) {
+        for (const auto& entry : kPredefinedKeyNames) {
+            if (entry.key == hKey) {
+                return entry.name;
+            }
+        }
         return L"";
     }
     
     bool RegistryHelper::ParseRegistryPath(const String& fullPath, HKEY& rootKey, String& subKey) {
+        String path = StringUtils::Trim(fullPath);
+        size_t separator = path.find(L'\\');
+        String rootName = (separator == String::npos) ? path : path.substr(0, separator);
+        
+        for (const auto& entry : kPredefinedKeyNames) {
+            if (StringUtils::CompareIgnoreCase(rootName, entry.name) == 0 ||
+                StringUtils::CompareIgnoreCase(rootName, entry.shortName) == 0) {
+                rootKey = entry.key;
+                subKey = (separator == String::npos) ? String() : path.substr(separator + 1);
+                return true;
+            }
+        }
+        
         return false;
     }
     
     String RegistryHelper::FormatRegistryPath(HKEY hKeyRoot, const String& subKey) {
-        return L"";
+        String rootName = GetPredefinedKeyName(hKeyRoot);
+        if (rootName.empty()) {
+            return subKey;
+        }
+        return subKey.empty() ? rootName : rootName + L"\\" + subKey;
     }
     
     bool RegistryHelper::HasRegistryAccess(HKEY hKeyParent, const String& subKey, REGSAM samDesired) {
-        return false;
+        auto source = GetSource();
+        HKEY hKey;
+        if (source->OpenKey(hKeyParent, subKey, samDesired, hKey) != ERROR_SUCCESS) {
+            return false;
+        }
+        source->CloseKey(hKey);
+        return true;
     }
     
     String RegistryHelper::ValueToString(const RegistryValueInfo& valueInfo) {
         return L"";
     }
     
-    void RegistryHelper::RecursiveSearchKeys(HKEY hKey, const String& currentPath, 
-                                           const String& searchPattern, StringVector& foundKeys, 
-                                           int maxResults, int& currentCount) {
-        // 占位符实现
-    }
+    bool RegistryHelper::PatternMatch(std::wstring_view text, std::wstring_view pattern) {
+        auto equal = [](wchar_t a, wchar_t b) {
+            return a == b || std::towlower(a) == std::towlower(b);
+        };
     
-    void RegistryHelper::RecursiveSearchValues(HKEY hKey, const String& currentPath, 
-                                             const String& searchPattern, StringVector& foundValues, 
-                                             int maxResults, int& currentCount) {
-        // 占位符实现
-    }
+        if (pattern.find_first_of(L"*?") == std::wstring_view::npos) {
+            auto it = std::search(text.begin(), text.end(), pattern.begin(), pattern.end(), equal);
+            return it != text.end() || pattern.empty();
+        }
     
-    bool RegistryHelper::PatternMatch(const String& text, const String& pattern) {
-        return false;
+        // 通配符：逐字符前进，失配时回到上一个*多吞一个字符
+        size_t t = 0;
+        size_t p = 0;
+        size_t starPattern = std::wstring_view::npos;
+        size_t starText = 0;
+        while (t < text.size()) {
+            if (p < pattern.size() && (pattern[p] == L'?' || (pattern[p] != L'*' && equal(pattern[p], text[t])))) {
+                ++t;
+                ++p;
+            } else if (p < pattern.size() && pattern[p] == L'*') {
+                starPattern = p++;
+                starText = t;
+            } else if (starPattern != std::wstring_view::npos) {
+                p = starPattern + 1;
+                t = ++starText;
+            } else {
+                return false;
+            }
+        }
+        while (p < pattern.size() && pattern[p] == L'*') {
+            ++p;
+        }
+        return p == pattern.size();
     }
     
-} // namespace YG
\ No newline at end of file
+} // namespace YG
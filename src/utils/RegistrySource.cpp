@@ -0,0 +1,917 @@
+/**
+ * @file RegistrySource.cpp
+ * @brief 可替换的注册表数据源实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/RegistrySource.h"
+#include "utils/RegistryHelper.h"
+#include "utils/StringUtils.h"
+#include "core/Logger.h"
+#include <windows.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+#include <mutex>
+
+namespace YG {
+    
+    namespace {
+        
+        // 注册表值名称最长16383个字符
+        const DWORD s_maxValueNameLength = 16383;
+        
+        // 值数据的初始缓冲区大小，多数值不超过此长度
+        const DWORD s_initialValueDataSize = 512;
+        
+    } // namespace
+    
+    // ==================== IRegistrySource ====================
+    
+    LONG IRegistrySource::EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor) {
+        String name;
+        DWORD type = REG_NONE;
+        std::vector<BYTE> data;
+        for (DWORD index = 0;; ++index) {
+            LONG result = EnumValue(hKey, index, name, &type, withData ? &data : nullptr);
+            if (result == ERROR_NO_MORE_ITEMS) {
+                return ERROR_SUCCESS;
+            }
+            if (result != ERROR_SUCCESS) {
+                return result;
+            }
+            if (!visitor(name, type, data)) {
+                return ERROR_SUCCESS;
+            }
+        }
+    }
+    
+    // ==================== Win32RegistrySource ====================
+    
+    LONG Win32RegistrySource::OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) {
+        return RegOpenKeyExW(hKeyParent, subKey.c_str(), 0, samDesired, &hKey);
+    }
+    
+    LONG Win32RegistrySource::CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) {
+        DWORD disposition = 0;
+        LONG result = RegCreateKeyExW(hKeyParent, subKey.c_str(), 0, nullptr,
+                                      REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS,
+                                      nullptr, &hKey, &disposition);
+        if (created) {
+            *created = (result == ERROR_SUCCESS && disposition == REG_CREATED_NEW_KEY);
+        }
+        return result;
+    }
+    
+    LONG Win32RegistrySource::CloseKey(HKEY hKey) {
+        return RegCloseKey(hKey);
+    }
+    
+    LONG Win32RegistrySource::EnumKey(HKEY hKey, DWORD index, String& name) {
+        // 注册表键名最长255个字符
+        wchar_t keyName[256];
+        DWORD keyNameSize = sizeof(keyName) / sizeof(wchar_t);
+        LONG result = RegEnumKeyExW(hKey, index, keyName, &keyNameSize,
+                                    nullptr, nullptr, nullptr, nullptr);
+        if (result == ERROR_SUCCESS) {
+            name.assign(keyName, keyNameSize);
+        }
+        return result;
+    }
+    
+    LONG Win32RegistrySource::EnumValue(HKEY hKey, DWORD index, String& name,
+                                        DWORD* type, std::vector<BYTE>* data) {
+        // 不预先查询键信息：名称和数据先按常见长度读取，不够时放大后重试（名称放大到上限，数据按返回的长度）
+        std::vector<wchar_t> nameBuffer(256);
+        DWORD capacity = data ? (std::max)(static_cast<DWORD>(data->capacity()), s_initialValueDataSize) : 0;
+        
+        for (int attempt = 0; attempt < 4; attempt++) {
+            DWORD nameSize = static_cast<DWORD>(nameBuffer.size());
+            DWORD dataSize = capacity;
+            DWORD valueType = REG_NONE;
+            if (data) {
+                data->resize(dataSize);
+            }
+            
+            LONG result = RegEnumValueW(hKey, index, nameBuffer.data(), &nameSize, nullptr, &valueType,
+                                        data ? data->data() : nullptr, data ? &dataSize : nullptr);
+            if (result == ERROR_MORE_DATA) {
+                nameBuffer.resize(s_maxValueNameLength + 1);
+                capacity = (std::max)(capacity, dataSize);
+                continue;
+            }
+            
+            if (result == ERROR_SUCCESS) {
+                name.assign(nameBuffer.data(), nameSize);
+                if (type) {
+                    *type = valueType;
+                }
+                if (data) {
+                    data->resize(dataSize);
+                }
+            }
+            return result;
+        }
+        
+        return ERROR_MORE_DATA;
+    }
+    
+    LONG Win32RegistrySource::EnumValues(HKEY hKey, bool withData, const ValueVisitor& visitor) {
+        // 整个键只查询一次最大名称和数据长度，缓冲区在各值之间复用
+        DWORD maxNameLength = 0;
+        DWORD maxDataSize = 0;
+        LONG result = RegQueryInfoKeyW(hKey, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                                       nullptr, &maxNameLength, withData ? &maxDataSize : nullptr, nullptr, nullptr);
+        if (result != ERROR_SUCCESS) {
+            return result;
+        }
+        
+        std::vector<wchar_t> nameBuffer(maxNameLength + 1);
+        std::vector<BYTE> data;
+        String name;
+        int retries = 0;
+        for (DWORD index = 0;;) {
+            DWORD nameSize = static_cast<DWORD>(nameBuffer.size());
+            DWORD dataSize = withData ? maxDataSize : 0;
+            DWORD type = REG_NONE;
+            data.resize(dataSize);
+            
+            result = RegEnumValueW(hKey, index, nameBuffer.data(), &nameSize, nullptr, &type,
+                                   withData && dataSize > 0 ? data.data() : nullptr, withData ? &dataSize : nullptr);
+            if (result == ERROR_NO_MORE_ITEMS) {
+                return ERROR_SUCCESS;
+            }
+            if (result == ERROR_MORE_DATA && ++retries < 4) {
+                // 枚举期间有值被改长，放大缓冲区后重读同一个值
+                nameBuffer.resize(s_maxValueNameLength + 1);
+                maxDataSize = (std::max)(maxDataSize, dataSize);
+                continue;
+            }
+            if (result != ERROR_SUCCESS) {
+                return result;
+            }
+            
+            data.resize(dataSize);
+            name.assign(nameBuffer.data(), nameSize);
+            if (!visitor(name, type, data)) {
+                return ERROR_SUCCESS;
+            }
+            ++index;
+            retries = 0;
+        }
+    }
+    
+    LONG Win32RegistrySource::QueryValue(HKEY hKey, const String& valueName,
+                                         DWORD* type, std::vector<BYTE>* data) {
+        DWORD valueType = REG_NONE;
+        DWORD dataSize = 0;
+        LONG result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &valueType, nullptr, &dataSize);
+        
+        // 先取长度再取数据，值在两次调用之间变长时重试
+        while (result == ERROR_SUCCESS && data) {
+            data->resize(dataSize);
+            DWORD readSize = dataSize;
+            result = RegQueryValueExW(hKey, valueName.c_str(), nullptr, &valueType,
+                                      readSize > 0 ? data->data() : nullptr, &readSize);
+            if (result == ERROR_MORE_DATA) {
+                dataSize = readSize;
+                result = ERROR_SUCCESS;
+                continue;
+            }
+            if (result == ERROR_SUCCESS) {
+                data->resize(readSize);
+            }
+            break;
+        }
+        
+        if (result == ERROR_SUCCESS && type) {
+            *type = valueType;
+        }
+        return result;
+    }
+    
+    LONG Win32RegistrySource::SetValue(HKEY hKey, const String& valueName, DWORD type,
+                                       const BYTE* data, DWORD dataSize) {
+        return RegSetValueExW(hKey, valueName.c_str(), 0, type, data, dataSize);
+    }
+    
+    LONG Win32RegistrySource::QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                                           FILETIME* lastWriteTime) {
+        return RegQueryInfoKeyW(hKey, nullptr, nullptr, nullptr, subKeyCount, nullptr, nullptr,
+                                valueCount, nullptr, nullptr, nullptr, lastWriteTime);
+    }
+    
+    LONG Win32RegistrySource::DeleteKey(HKEY hKeyParent, const String& subKey) {
+        return RegDeleteKeyW(hKeyParent, subKey.c_str());
+    }
+    
+    LONG Win32RegistrySource::DeleteValue(HKEY hKey, const String& valueName) {
+        return RegDeleteValueW(hKey, valueName.c_str());
+    }
+    
+    // ==================== MemoryRegistrySource ====================
+    
+    /**
+     * @brief 内存注册表键节点
+     */
+    struct MemoryRegistrySource::MemoryKey {
+        /**
+         * @brief 内存注册表值
+         */
+        struct Value {
+            String name;                ///< 值名称
+            DWORD type;                 ///< 值类型
+            std::vector<BYTE> data;     ///< 值数据
+        };
+        
+        String name;                                            ///< 键名称（保留原始大小写）
+        std::vector<std::shared_ptr<MemoryKey>> subKeys;        ///< 子键（按插入顺序）
+        std::unordered_map<String, size_t> subKeyIndex;         ///< 小写名称到子键下标
+        std::vector<Value> values;                              ///< 值（按插入顺序）
+        std::unordered_map<String, size_t> valueIndex;          ///< 小写名称到值下标
+        FILETIME lastWriteTime;                                 ///< 最后写入时间
+        bool deleted;                                           ///< 是否已被删除
+        
+        MemoryKey(const String& keyName, const FILETIME& writeTime)
+            : name(keyName), lastWriteTime(writeTime), deleted(false) {}
+        
+        std::shared_ptr<MemoryKey> FindSubKey(const String& keyName) const {
+            auto it = subKeyIndex.find(StringUtils::ToLower(keyName));
+            return it != subKeyIndex.end() ? subKeys[it->second] : nullptr;
+        }
+        
+        void RemoveSubKey(const String& keyName) {
+            auto it = subKeyIndex.find(StringUtils::ToLower(keyName));
+            if (it == subKeyIndex.end()) {
+                return;
+            }
+            size_t position = it->second;
+            subKeys[position]->deleted = true;
+            subKeys.erase(subKeys.begin() + position);
+            subKeyIndex.erase(it);
+            for (auto& entry : subKeyIndex) {
+                if (entry.second > position) {
+                    entry.second--;
+                }
+            }
+        }
+        
+        void RemoveValue(const String& valueName) {
+            auto it = valueIndex.find(StringUtils::ToLower(valueName));
+            if (it == valueIndex.end()) {
+                return;
+            }
+            size_t position = it->second;
+            values.erase(values.begin() + position);
+            valueIndex.erase(it);
+            for (auto& entry : valueIndex) {
+                if (entry.second > position) {
+                    entry.second--;
+                }
+            }
+        }
+    };
+    
+    /**
+     * @brief 内存注册表句柄（HKEY实际指向此结构）
+     */
+    struct MemoryRegistrySource::MemoryHandle {
+        std::shared_ptr<MemoryKey> key;     ///< 句柄引用的键节点
+    };
+    
+    namespace {
+        
+        /// 预定义根键，顺序与m_roots一致
+        const HKEY kPredefinedRoots[] = {
+            HKEY_CLASSES_ROOT,
+            HKEY_CURRENT_USER,
+            HKEY_LOCAL_MACHINE,
+            HKEY_USERS,
+            HKEY_CURRENT_CONFIG
+        };
+        
+        const size_t kPredefinedRootCount = sizeof(kPredefinedRoots) / sizeof(kPredefinedRoots[0]);
+        
+        int PredefinedRootIndex(HKEY hKey) {
+            for (size_t i = 0; i < kPredefinedRootCount; i++) {
+                if (kPredefinedRoots[i] == hKey) {
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+        
+        StringVector SplitKeyPath(const String& path) {
+            StringVector parts;
+            size_t start = 0;
+            while (start <= path.length()) {
+                size_t end = path.find(L'\\', start);
+                if (end == String::npos) {
+                    end = path.length();
+                }
+                if (end > start) {
+                    parts.push_back(path.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+            return parts;
+        }
+        
+        std::vector<BYTE> StringToRegData(const String& text) {
+            const BYTE* begin = reinterpret_cast<const BYTE*>(text.c_str());
+            return std::vector<BYTE>(begin, begin + (text.length() + 1) * sizeof(wchar_t));
+        }
+        
+        int HexDigitValue(wchar_t ch) {
+            if (ch >= L'0' && ch <= L'9') return ch - L'0';
+            if (ch >= L'a' && ch <= L'f') return ch - L'a' + 10;
+            if (ch >= L'A' && ch <= L'F') return ch - L'A' + 10;
+            return -1;
+        }
+        
+        /**
+         * @brief 解析.reg中带转义的引号字符串
+         * @param text 源文本
+         * @param pos 输入为起始引号位置，输出为结束引号之后的位置
+         * @param result 输出解析后的字符串
+         * @return bool 是否解析成功
+         */
+        bool ParseQuotedString(const String& text, size_t& pos, String& result) {
+            if (pos >= text.length() || text[pos] != L'"') {
+                return false;
+            }
+            result.clear();
+            for (size_t i = pos + 1; i < text.length(); i++) {
+                wchar_t ch = text[i];
+                if (ch == L'\\' && i + 1 < text.length()) {
+                    result.push_back(text[++i]);
+                } else if (ch == L'"') {
+                    pos = i + 1;
+                    return true;
+                } else {
+                    result.push_back(ch);
+                }
+            }
+            return false;
+        }
+        
+        /**
+         * @brief 解析逗号分隔的十六进制字节串
+         */
+        bool ParseHexBytes(const String& text, std::vector<BYTE>& bytes) {
+            bytes.clear();
+            int high = -1;
+            for (wchar_t ch : text) {
+                if (ch == L',' || ch == L' ' || ch == L'\t') {
+                    if (high >= 0) {
+                        bytes.push_back(static_cast<BYTE>(high));
+                        high = -1;
+                    }
+                    continue;
+                }
+                int digit = HexDigitValue(ch);
+                if (digit < 0) {
+                    return false;
+                }
+                if (high < 0) {
+                    high = digit;
+                } else {
+                    bytes.push_back(static_cast<BYTE>((high << 4) | digit));
+                    high = -1;
+                }
+            }
+            if (high >= 0) {
+                bytes.push_back(static_cast<BYTE>(high));
+            }
+            return true;
+        }
+    
+    } // anonymous namespace
+    
+    MemoryRegistrySource::MemoryRegistrySource() {
+        // 默认时间戳取构造时刻，夹具可通过SetDefaultWriteTime固定
+        GetSystemTimeAsFileTime(&m_defaultWriteTime);
+        Clear();
+    }
+    
+    MemoryRegistrySource::~MemoryRegistrySource() = default;
+    
+    void MemoryRegistrySource::Clear() {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        for (auto& root : m_roots) {
+            root->deleted = true;
+        }
+        m_roots.clear();
+        for (size_t i = 0; i < kPredefinedRootCount; i++) {
+            m_roots.push_back(std::make_shared<MemoryKey>(
+                RegistryHelper::GetPredefinedKeyName(kPredefinedRoots[i]), m_defaultWriteTime));
+        }
+    }
+    
+    void MemoryRegistrySource::SetDefaultWriteTime(const FILETIME& lastWriteTime) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_defaultWriteTime = lastWriteTime;
+    }
+    
+    std::shared_ptr<MemoryRegistrySource::MemoryKey> MemoryRegistrySource::ResolveKey(HKEY hKey) const {
+        if (!hKey) {
+            return nullptr;
+        }
+        int rootIndex = PredefinedRootIndex(hKey);
+        if (rootIndex >= 0) {
+            return m_roots[rootIndex];
+        }
+        auto* handle = reinterpret_cast<MemoryHandle*>(hKey);
+        if (!handle->key || handle->key->deleted) {
+            return nullptr;
+        }
+        return handle->key;
+    }
+    
+    std::shared_ptr<MemoryRegistrySource::MemoryKey> MemoryRegistrySource::WalkPath(
+            const std::shared_ptr<MemoryKey>& start, const String& subKey, bool create, bool* created) {
+        if (created) {
+            *created = false;
+        }
+        
+        std::shared_ptr<MemoryKey> current = start;
+        for (const auto& part : SplitKeyPath(subKey)) {
+            std::shared_ptr<MemoryKey> next = current->FindSubKey(part);
+            if (!next) {
+                if (!create) {
+                    return nullptr;
+                }
+                next = std::make_shared<MemoryKey>(part, m_defaultWriteTime);
+                current->subKeyIndex[StringUtils::ToLower(part)] = current->subKeys.size();
+                current->subKeys.push_back(next);
+                current->lastWriteTime = m_defaultWriteTime;
+                if (created) {
+                    *created = true;
+                }
+            }
+            current = next;
+        }
+        return current;
+    }
+    
+    LONG MemoryRegistrySource::OpenKey(HKEY hKeyParent, const String& subKey, REGSAM samDesired, HKEY& hKey) {
+        (void)samDesired; // 内存数据源不做权限检查
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> parent = ResolveKey(hKeyParent);
+        if (!parent) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        std::shared_ptr<MemoryKey> key = WalkPath(parent, subKey, false, nullptr);
+        if (!key) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        
+        hKey = reinterpret_cast<HKEY>(new MemoryHandle{ key });
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::CreateKey(HKEY hKeyParent, const String& subKey, HKEY& hKey, bool* created) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> parent = ResolveKey(hKeyParent);
+        if (!parent) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        std::shared_ptr<MemoryKey> key = WalkPath(parent, subKey, true, created);
+        hKey = reinterpret_cast<HKEY>(new MemoryHandle{ key });
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::CloseKey(HKEY hKey) {
+        if (!hKey) {
+            return ERROR_INVALID_HANDLE;
+        }
+        if (PredefinedRootIndex(hKey) >= 0) {
+            return ERROR_SUCCESS;
+        }
+        delete reinterpret_cast<MemoryHandle*>(hKey);
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::EnumKey(HKEY hKey, DWORD index, String& name) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        if (index >= key->subKeys.size()) {
+            return ERROR_NO_MORE_ITEMS;
+        }
+        
+        name = key->subKeys[index]->name;
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::EnumValue(HKEY hKey, DWORD index, String& name,
+                                         DWORD* type, std::vector<BYTE>* data) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        if (index >= key->values.size()) {
+            return ERROR_NO_MORE_ITEMS;
+        }
+        
+        const MemoryKey::Value& value = key->values[index];
+        name = value.name;
+        if (type) {
+            *type = value.type;
+        }
+        if (data) {
+            *data = value.data;
+        }
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::QueryValue(HKEY hKey, const String& valueName,
+                                          DWORD* type, std::vector<BYTE>* data) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        auto it = key->valueIndex.find(StringUtils::ToLower(valueName));
+        if (it == key->valueIndex.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        
+        const MemoryKey::Value& value = key->values[it->second];
+        if (type) {
+            *type = value.type;
+        }
+        if (data) {
+            *data = value.data;
+        }
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::SetValue(HKEY hKey, const String& valueName, DWORD type,
+                                        const BYTE* data, DWORD dataSize) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        std::vector<BYTE> bytes;
+        if (data && dataSize > 0) {
+            bytes.assign(data, data + dataSize);
+        }
+        
+        String foldedName = StringUtils::ToLower(valueName);
+        auto it = key->valueIndex.find(foldedName);
+        if (it != key->valueIndex.end()) {
+            key->values[it->second].type = type;
+            key->values[it->second].data = std::move(bytes);
+        } else {
+            key->valueIndex[foldedName] = key->values.size();
+            key->values.push_back({ valueName, type, std::move(bytes) });
+        }
+        key->lastWriteTime = m_defaultWriteTime;
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::QueryInfoKey(HKEY hKey, DWORD* subKeyCount, DWORD* valueCount,
+                                            FILETIME* lastWriteTime) {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        if (subKeyCount) {
+            *subKeyCount = static_cast<DWORD>(key->subKeys.size());
+        }
+        if (valueCount) {
+            *valueCount = static_cast<DWORD>(key->values.size());
+        }
+        if (lastWriteTime) {
+            *lastWriteTime = key->lastWriteTime;
+        }
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::DeleteKey(HKEY hKeyParent, const String& subKey) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> parent = ResolveKey(hKeyParent);
+        if (!parent) {
+            return ERROR_INVALID_HANDLE;
+        }
+        
+        StringVector parts = SplitKeyPath(subKey);
+        if (parts.empty()) {
+            return ERROR_ACCESS_DENIED;
+        }
+        
+        String leafName = parts.back();
+        parts.pop_back();
+        for (const auto& part : parts) {
+            parent = parent->FindSubKey(part);
+            if (!parent) {
+                return ERROR_FILE_NOT_FOUND;
+            }
+        }
+        
+        std::shared_ptr<MemoryKey> target = parent->FindSubKey(leafName);
+        if (!target) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        // 与RegDeleteKeyW一致：存在子键时拒绝删除
+        if (!target->subKeys.empty()) {
+            return ERROR_ACCESS_DENIED;
+        }
+        
+        parent->RemoveSubKey(leafName);
+        parent->lastWriteTime = m_defaultWriteTime;
+        return ERROR_SUCCESS;
+    }
+    
+    LONG MemoryRegistrySource::DeleteValue(HKEY hKey, const String& valueName) {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> key = ResolveKey(hKey);
+        if (!key) {
+            return ERROR_INVALID_HANDLE;
+        }
+        if (key->valueIndex.find(StringUtils::ToLower(valueName)) == key->valueIndex.end()) {
+            return ERROR_FILE_NOT_FOUND;
+        }
+        
+        key->RemoveValue(valueName);
+        key->lastWriteTime = m_defaultWriteTime;
+        return ERROR_SUCCESS;
+    }
+    
+    void MemoryRegistrySource::DeleteTree(const std::shared_ptr<MemoryKey>& root, const String& subKey) {
+        StringVector parts = SplitKeyPath(subKey);
+        if (parts.empty()) {
+            return;
+        }
+        
+        String leafName = parts.back();
+        parts.pop_back();
+        std::shared_ptr<MemoryKey> parent = root;
+        for (const auto& part : parts) {
+            parent = parent->FindSubKey(part);
+            if (!parent) {
+                return;
+            }
+        }
+        
+        // 子树中仍被句柄引用的节点通过deleted标记失效
+        std::vector<std::shared_ptr<MemoryKey>> pending;
+        if (auto target = parent->FindSubKey(leafName)) {
+            pending.push_back(target);
+        }
+        while (!pending.empty()) {
+            std::shared_ptr<MemoryKey> node = pending.back();
+            pending.pop_back();
+            node->deleted = true;
+            pending.insert(pending.end(), node->subKeys.begin(), node->subKeys.end());
+        }
+        
+        parent->RemoveSubKey(leafName);
+    }
+    
+    bool MemoryRegistrySource::ParseValueLine(const std::shared_ptr<MemoryKey>& key, const String& line) {
+        size_t pos = 0;
+        String valueName;
+        if (line[0] == L'@') {
+            pos = 1;
+        } else if (!ParseQuotedString(line, pos, valueName)) {
+            return false;
+        }
+        
+        while (pos < line.length() && (line[pos] == L' ' || line[pos] == L'\t')) pos++;
+        if (pos >= line.length() || line[pos] != L'=') {
+            return false;
+        }
+        String data = StringUtils::Trim(line.substr(pos + 1));
+        
+        String foldedName = StringUtils::ToLower(valueName);
+        if (data == L"-") {
+            key->RemoveValue(valueName);
+            return true;
+        }
+        
+        DWORD type = REG_NONE;
+        std::vector<BYTE> bytes;
+        
+        if (!data.empty() && data[0] == L'"') {
+            size_t dataPos = 0;
+            String text;
+            if (!ParseQuotedString(data, dataPos, text)) {
+                return false;
+            }
+            type = REG_SZ;
+            bytes = StringToRegData(text);
+        } else if (StringUtils::StartsWith(data, L"dword:", true)) {
+            String digits = data.substr(6);
+            if (digits.empty() || digits.length() > 8) {
+                return false;
+            }
+            DWORD value = 0;
+            for (wchar_t ch : digits) {
+                int digit = HexDigitValue(ch);
+                if (digit < 0) {
+                    return false;
+                }
+                value = (value << 4) | static_cast<DWORD>(digit);
+            }
+            type = REG_DWORD;
+            const BYTE* raw = reinterpret_cast<const BYTE*>(&value);
+            bytes.assign(raw, raw + sizeof(DWORD));
+        } else if (StringUtils::StartsWith(data, L"hex", true)) {
+            size_t colon = data.find(L':');
+            if (colon == String::npos) {
+                return false;
+            }
+            type = REG_BINARY;
+            String typeSpec = data.substr(3, colon - 3);
+            if (!typeSpec.empty()) {
+                // hex(N): N为十六进制的值类型
+                if (typeSpec.length() < 3 || typeSpec.front() != L'(' || typeSpec.back() != L')') {
+                    return false;
+                }
+                type = 0;
+                for (size_t i = 1; i + 1 < typeSpec.length(); i++) {
+                    int digit = HexDigitValue(typeSpec[i]);
+                    if (digit < 0) {
+                        return false;
+                    }
+                    type = (type << 4) | static_cast<DWORD>(digit);
+                }
+            }
+            if (!ParseHexBytes(data.substr(colon + 1), bytes)) {
+                return false;
+            }
+        } else {
+            return false;
+        }
+        
+        auto it = key->valueIndex.find(foldedName);
+        if (it != key->valueIndex.end()) {
+            key->values[it->second].type = type;
+            key->values[it->second].data = std::move(bytes);
+        } else {
+            key->valueIndex[foldedName] = key->values.size();
+            key->values.push_back({ valueName, type, std::move(bytes) });
+        }
+        key->lastWriteTime = m_defaultWriteTime;
+        return true;
+    }
+    
+    ErrorCode MemoryRegistrySource::LoadRegText(const String& regText) {
+        // 拆分行并合并以"\"结尾的续行（十六进制数据跨行）
+        StringVector lines;
+        String pending;
+        size_t start = 0;
+        while (start < regText.length()) {
+            size_t end = regText.find(L'\n', start);
+            if (end == String::npos) {
+                end = regText.length();
+            }
+            String line = regText.substr(start, end - start);
+            start = end + 1;
+            
+            if (!line.empty() && line.back() == L'\r') {
+                line.pop_back();
+            }
+            line = pending.empty() ? StringUtils::TrimRight(line) : StringUtils::Trim(line);
+            
+            bool continued = !line.empty() && line.back() == L'\\' &&
+                             line.front() != L'[' && line.find(L"=hex") != String::npos;
+            if (!pending.empty()) {
+                continued = !line.empty() && line.back() == L'\\';
+            }
+            if (continued) {
+                line.pop_back();
+                pending += line;
+                continue;
+            }
+            lines.push_back(pending + line);
+            pending.clear();
+        }
+        if (!pending.empty()) {
+            lines.push_back(pending);
+        }
+        
+        size_t lineIndex = 0;
+        while (lineIndex < lines.size() && StringUtils::Trim(lines[lineIndex]).empty()) {
+            lineIndex++;
+        }
+        if (lineIndex >= lines.size()) {
+            return ErrorCode::InvalidParameter;
+        }
+        
+        String header = StringUtils::Trim(lines[lineIndex]);
+        if (!header.empty() && header[0] == 0xFEFF) {
+            header.erase(0, 1);
+        }
+        if (header != L"Windows Registry Editor Version 5.00" && header != L"REGEDIT4") {
+            YG_LOG_WARNING(L"不支持的.reg文件头: " + header);
+            return ErrorCode::InvalidParameter;
+        }
+        
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        
+        std::shared_ptr<MemoryKey> currentKey;
+        int skippedLines = 0;
+        for (lineIndex++; lineIndex < lines.size(); lineIndex++) {
+            String line = StringUtils::Trim(lines[lineIndex]);
+            if (line.empty() || line[0] == L';') {
+                continue;
+            }
+            
+            if (line[0] == L'[') {
+                currentKey.reset();
+                if (line.back() != L']') {
+                    skippedLines++;
+                    continue;
+                }
+                
+                bool deleteKey = line.length() > 2 && line[1] == L'-';
+                String fullPath = line.substr(deleteKey ? 2 : 1, line.length() - (deleteKey ? 3 : 2));
+                
+                HKEY rootKey = nullptr;
+                String subKey;
+                if (!RegistryHelper::ParseRegistryPath(fullPath, rootKey, subKey) ||
+                    PredefinedRootIndex(rootKey) < 0) {
+                    YG_LOG_WARNING(L"无法识别的注册表路径: " + fullPath);
+                    skippedLines++;
+                    continue;
+                }
+                
+                std::shared_ptr<MemoryKey> root = m_roots[PredefinedRootIndex(rootKey)];
+                if (deleteKey) {
+                    DeleteTree(root, subKey);
+                } else {
+                    currentKey = WalkPath(root, subKey, true, nullptr);
+                }
+                continue;
+            }
+            
+            if (!currentKey || !ParseValueLine(currentKey, line)) {
+                skippedLines++;
+            }
+        }
+        
+        if (skippedLines > 0) {
+            YG_LOG_WARNING(L".reg文本中有 " + std::to_wstring(skippedLines) + L" 行无法解析，已跳过");
+        }
+        return ErrorCode::Success;
+    }
+    
+    ErrorCode MemoryRegistrySource::LoadRegFile(const String& filePath) {
+        std::ifstream file(WStringToString(filePath).c_str(), std::ios::binary);
+        if (!file.is_open()) {
+            YG_LOG_ERROR(L"无法打开.reg文件: " + filePath);
+            return ErrorCode::FileNotFound;
+        }
+        
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        
+        // regedit默认导出UTF-16LE（带BOM），REGEDIT4格式为ANSI/UTF-8
+        String text;
+        if (bytes.size() >= 2 && static_cast<unsigned char>(bytes[0]) == 0xFF &&
+            static_cast<unsigned char>(bytes[1]) == 0xFE) {
+            text.reserve((bytes.size() - 2) / 2);
+            for (size_t i = 2; i + 1 < bytes.size(); i += 2) {
+                text.push_back(static_cast<wchar_t>(static_cast<unsigned char>(bytes[i]) |
+                                                    (static_cast<unsigned char>(bytes[i + 1]) << 8)));
+            }
+        } else {
+            if (bytes.size() >= 3 && static_cast<unsigned char>(bytes[0]) == 0xEF &&
+                static_cast<unsigned char>(bytes[1]) == 0xBB && static_cast<unsigned char>(bytes[2]) == 0xBF) {
+                bytes.erase(0, 3);
+            }
+            text = StringToWString(bytes);
+        }
+        
+        ErrorCode result = LoadRegText(text);
+        if (result == ErrorCode::Success) {
+            YG_LOG_INFO(L"已加载注册表夹具: " + filePath);
+        }
+        return result;
+    }
+
+} // namespace YG
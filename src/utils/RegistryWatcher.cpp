@@ -0,0 +1,257 @@
+/**
+ * @file RegistryWatcher.cpp
+ * @brief 注册表变更通知实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/RegistryWatcher.h"
+#include "core/Logger.h"
+#include <future>
+
+namespace YG {
+    
+    // ==================== Win32RegistryChangeNotifier ====================
+    
+    Win32RegistryChangeNotifier::Win32RegistryChangeNotifier() : m_stopEvent(nullptr), m_unwatchedCount(0) {
+    }
+    
+    Win32RegistryChangeNotifier::~Win32RegistryChangeNotifier() {
+        Stop();
+    }
+    
+    ErrorCode Win32RegistryChangeNotifier::Start(const std::vector<RegistryWatchTarget>& targets,
+                                                 const ChangeCallback& callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        if (m_thread) {
+            return ErrorCode::OperationInProgress;
+        }
+        
+        // WaitForMultipleObjects最多等待MAXIMUM_WAIT_OBJECTS个句柄，其中一个留给停止事件
+        if (targets.empty() || targets.size() >= 64 || !callback) {
+            return ErrorCode::InvalidParameter;
+        }
+        
+        m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!m_stopEvent) {
+            return ErrorCode::GeneralError;
+        }
+        
+        m_targets = targets;
+        m_callback = callback;
+        
+        // 通知注册与线程绑定，必须在监视线程内完成，这里等待注册结果
+        auto ready = std::make_shared<std::promise<size_t>>();
+        std::future<size_t> armed = ready->get_future();
+        m_thread = YG::MakeUnique<std::thread>(&Win32RegistryChangeNotifier::WatchLoop, this,
+                                               [ready](size_t count) { ready->set_value(count); });
+        
+        size_t armedCount = armed.get();
+        if (armedCount == 0) {
+            YG_LOG_WARNING(L"没有可监视的注册表键");
+            m_thread->join();
+            m_thread.reset();
+            CloseHandle(m_stopEvent);
+            m_stopEvent = nullptr;
+            return ErrorCode::RegistryError;
+        }
+        
+        YG_LOG_INFO(L"注册表变更监视已启动，监视键数量: " + std::to_wstring(armedCount) +
+                   L"/" + std::to_wstring(targets.size()));
+        return ErrorCode::Success;
+    }
+    
+    void Win32RegistryChangeNotifier::Stop() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        if (!m_thread) {
+            return;
+        }
+        
+        SetEvent(m_stopEvent);
+        if (m_thread->joinable()) {
+            m_thread->join();
+        }
+        m_thread.reset();
+        
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+        
+        YG_LOG_INFO(L"注册表变更监视已停止");
+    }
+    
+    bool Win32RegistryChangeNotifier::IsRunning() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_thread != nullptr;
+    }
+    
+    bool Win32RegistryChangeNotifier::IsWatchingAll() const {
+        // 不取m_mutex：缓存在持有自身锁时查询，而Stop持有m_mutex等待回调结束
+        return m_unwatchedCount.load() == 0;
+    }
+    
+    namespace {
+        
+        const DWORD s_targetFilter = REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET;
+        
+        /**
+         * @brief 一个目标键的监视状态
+         */
+        struct WatchSlot {
+            size_t targetIndex = 0;         ///< 目标序号
+            HKEY key = nullptr;             ///< 正在监视的键（目标键或其最近的已存在上级）
+            HANDLE event = nullptr;         ///< 通知事件
+            bool onParent = false;          ///< 目标键尚不存在，正在监视上级键
+        };
+        
+        /**
+         * @brief 注册通知：目标键存在时监视整棵子树；不存在时监视最近的已存在上级键的子键增删，
+         *        上级键触发后再次调用本函数，直到目标键出现
+         * @return bool 是否注册成功
+         */
+        bool ArmSlot(WatchSlot& slot, const RegistryWatchTarget& target) {
+            if (slot.key) {
+                RegCloseKey(slot.key);
+                slot.key = nullptr;
+            }
+            
+            String path = target.path;
+            bool onParent = false;
+            while (true) {
+                HKEY hKey = nullptr;
+                LONG result = RegOpenKeyExW(target.rootKey, path.c_str(), 0, KEY_NOTIFY, &hKey);
+                if (result == ERROR_SUCCESS) {
+                    DWORD filter = onParent ? REG_NOTIFY_CHANGE_NAME : s_targetFilter;
+                    if (RegNotifyChangeKeyValue(hKey, onParent ? FALSE : TRUE, filter, slot.event, TRUE) != ERROR_SUCCESS) {
+                        RegCloseKey(hKey);
+                        return false;
+                    }
+                    slot.key = hKey;
+                    slot.onParent = onParent;
+                    return true;
+                }
+                if (result != ERROR_FILE_NOT_FOUND || path.empty()) {
+                    return false;
+                }
+                
+                size_t separator = path.find_last_of(L'\\');
+                path = separator == String::npos ? String() : path.substr(0, separator);
+                onParent = true;
+            }
+        }
+    
+    } // namespace
+    
+    void Win32RegistryChangeNotifier::WatchLoop(const std::function<void(size_t)>& readyCallback) {
+        std::vector<WatchSlot> slots;
+        std::vector<HANDLE> handles;        // handles[0]为停止事件，其余与slots一一对应
+        handles.push_back(m_stopEvent);
+        
+        for (size_t i = 0; i < m_targets.size(); ++i) {
+            WatchSlot slot;
+            slot.targetIndex = i;
+            slot.event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+            if (!slot.event || !ArmSlot(slot, m_targets[i])) {
+                YG_LOG_DEBUG(L"跳过无法监视的注册表键: " + m_targets[i].path);
+                if (slot.event) {
+                    CloseHandle(slot.event);
+                }
+                continue;
+            }
+            if (slot.onParent) {
+                YG_LOG_DEBUG(L"注册表键尚不存在，先监视其上级键: " + m_targets[i].path);
+            }
+            
+            slots.push_back(slot);
+            handles.push_back(slot.event);
+        }
+        
+        m_unwatchedCount.store(m_targets.size() - slots.size());
+        readyCallback(slots.size());
+        
+        while (!slots.empty()) {
+            DWORD wait = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+            if (wait == WAIT_OBJECT_0 || wait >= WAIT_OBJECT_0 + handles.size()) {
+                break;
+            }
+            
+            WatchSlot& slot = slots[wait - WAIT_OBJECT_0 - 1];
+            const RegistryWatchTarget& target = m_targets[slot.targetIndex];
+            
+            // 先重新注册再回调，避免回调期间的变更丢失；监视上级键时重新定位（目标键可能已出现），
+            // 目标键被删除导致无法续订时退回到监视上级键
+            bool wasOnParent = slot.onParent;
+            bool armed = !wasOnParent &&
+                RegNotifyChangeKeyValue(slot.key, TRUE, s_targetFilter, slot.event, TRUE) == ERROR_SUCCESS;
+            if (!armed && !ArmSlot(slot, target)) {
+                YG_LOG_WARNING(L"无法继续监视注册表键: " + target.path);
+                m_unwatchedCount.fetch_add(1);
+                continue;
+            }
+            
+            // 上级键下只是其他子键增删时不回调
+            if (wasOnParent && slot.onParent) {
+                continue;
+            }
+            
+            try {
+                m_callback(slot.targetIndex);
+            } catch (...) {
+                YG_LOG_ERROR(L"注册表变更回调发生异常");
+            }
+        }
+        
+        for (auto& slot : slots) {
+            if (slot.key) {
+                RegCloseKey(slot.key);
+            }
+            CloseHandle(slot.event);
+        }
+    }
+    
+    // ==================== ManualRegistryChangeNotifier ====================
+    
+    ErrorCode ManualRegistryChangeNotifier::Start(const std::vector<RegistryWatchTarget>& targets,
+                                                  const ChangeCallback& callback) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        
+        if (m_callback) {
+            return ErrorCode::OperationInProgress;
+        }
+        
+        if (targets.empty() || !callback) {
+            return ErrorCode::InvalidParameter;
+        }
+        
+        m_targetCount = targets.size();
+        m_callback = callback;
+        return ErrorCode::Success;
+    }
+    
+    void ManualRegistryChangeNotifier::Stop() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_callback = nullptr;
+        m_targetCount = 0;
+    }
+    
+    bool ManualRegistryChangeNotifier::IsRunning() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<bool>(m_callback);
+    }
+    
+    void ManualRegistryChangeNotifier::Trigger(size_t targetIndex) {
+        ChangeCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_callback || targetIndex >= m_targetCount) {
+                return;
+            }
+            callback = m_callback;
+        }
+        
+        callback(targetIndex);
+    }
+
+} // namespace YG
@@ -0,0 +1,64 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief 固定大小的工作线程池实现
+ * @author gmrchzh@gmail.com
+ * @version 1.0.1
+ * @date 2025-10-16
+ */
+
+#include "utils/ThreadPool.h"
+
+namespace YG {
+    
+    ThreadPool::ThreadPool(size_t threadCount) : m_stopping(false) {
+        if (threadCount == 0) {
+            threadCount = DefaultThreadCount();
+        }
+        
+        m_workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+        }
+    }
+    
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+        
+        for (auto& worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+    
+    size_t ThreadPool::DefaultThreadCount() {
+        unsigned int count = std::thread::hardware_concurrency();
+        return count > 0 ? static_cast<size_t>(count) : 1;
+    }
+    
+    void ThreadPool::WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                
+                // 停止时仍先执行完剩余任务，保证已返回的future都能就绪
+                if (m_tasks.empty()) {
+                    return;
+                }
+                
+                task = std::move(m_tasks.front());
+                m_tasks.pop();
+            }
+            
+            task();
+        }
+    }
+
+} // namespace YG